@@ -29,6 +29,7 @@
 #include "../../../../../event.h"
 #include "../../../../../interrupt.h"
 #include "../../../../../panic.h"
+#include "../../../../../mm/image.h"
 // process related stuff
 #include "../../../../../task/process.h"
 #include "../../../../../task/thread.h"
@@ -47,7 +48,7 @@ static uint32_t nested_data_abort = 0;
  * @todo trigger schedule when prefetch abort source is user thread
  * @todo panic when data abort is triggered from kernel
  */
-noreturn void vector_data_abort_handler( cpu_register_context_ptr_t cpu ) {
+void vector_data_abort_handler( cpu_register_context_ptr_t cpu ) {
   // nesting
   nested_data_abort++;
   assert( nested_data_abort < INTERRUPT_NESTED_MAX )
@@ -76,6 +77,20 @@ noreturn void vector_data_abort_handler( cpu_register_context_ptr_t cpu ) {
   #endif
   // kernel stack
   interrupt_ensure_kernel_stack();
+  // populate demand paged image page and retry
+  if (
+    EVENT_ORIGIN_USER == origin
+    && image_handle_fault(
+      task_thread_current_thread->process->virtual_context,
+      virt_data_fault_address()
+    )
+  ) {
+    // enqueue cleanup
+    event_enqueue( EVENT_INTERRUPT_CLEANUP, origin );
+    // decrement nested counter
+    nested_data_abort--;
+    return;
+  }
   // special debug exception handling
   #if defined( REMOTE_DEBUG )
     if ( debug_is_debug_exception() ) {
@@ -26,6 +26,7 @@
 #include "../../../../../event.h"
 #include "../../../../../interrupt.h"
 #include "../../../../../panic.h"
+#include "../../../../../mm/image.h"
 // process related stuff
 #include "../../../../../task/process.h"
 #include "../../../../../task/thread.h"
@@ -44,9 +45,6 @@ static uint32_t nested_prefetch_abort = 0;
  * @todo trigger schedule when prefetch abort source is user thread
  * @todo panic when prefetch abort is triggered from kernel
  */
-#if ! defined( REMOTE_DEBUG )
-noreturn
-#endif
 void vector_prefetch_abort_handler( cpu_register_context_ptr_t cpu ) {
   // nesting
   nested_prefetch_abort++;
@@ -68,6 +66,20 @@ void vector_prefetch_abort_handler( cpu_register_context_ptr_t cpu ) {
   #endif
   // kernel stack
   interrupt_ensure_kernel_stack();
+  // populate demand paged image page and retry
+  if (
+    EVENT_ORIGIN_USER == origin
+    && image_handle_fault(
+      task_thread_current_thread->process->virtual_context,
+      virt_prefetch_fault_address()
+    )
+  ) {
+    // enqueue cleanup
+    event_enqueue( EVENT_INTERRUPT_CLEANUP, origin );
+    // decrement nested counter
+    nested_prefetch_abort--;
+    return;
+  }
   // special debug exception handling
   #if defined( REMOTE_DEBUG )
     if ( debug_is_debug_exception() ) {
@@ -519,6 +519,36 @@ bool virt_is_mapped_in_context( virt_context_ptr_t ctx, uintptr_t addr ) {
   }
 }
 
+/**
+ * @fn bool virt_is_writable_in_context(virt_context_ptr_t, uintptr_t)
+ * @brief Method checks whether address is mapped writable without generating
+ * exceptions
+ *
+ * @param ctx
+ * @param addr
+ * @return
+ */
+bool virt_is_writable_in_context( virt_context_ptr_t ctx, uintptr_t addr ) {
+  // check context
+  if ( ! ctx ) {
+    return false;
+  }
+
+  // check for v7 long descriptor format
+  if ( ID_MMFR0_VSMA_V7_PAGING_LPAE == virt_supported_mode ) {
+    return v7_long_is_writable_in_context( ctx, addr );
+  // check v7 short descriptor format
+  } else if (
+    ( ID_MMFR0_VSMA_V7_PAGING_REMAP_ACCESS == virt_supported_mode )
+    || ( ID_MMFR0_VSMA_V7_PAGING_PXN == virt_supported_mode )
+  ) {
+    return v7_short_is_writable_in_context( ctx, addr );
+  // Panic when mode is unsupported
+  } else {
+    PANIC( "Unsupported mode!" )
+  }
+}
+
 /**
  * @fn uint64_t virt_get_mapped_address_in_context(virt_context_ptr_t, uintptr_t)
  * @brief Get mapped physical address
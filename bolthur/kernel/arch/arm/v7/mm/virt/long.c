@@ -1597,6 +1597,50 @@ bool v7_long_is_mapped_in_context( virt_context_ptr_t ctx, uintptr_t addr ) {
   return mapped;
 }
 
+/**
+ * @fn bool v7_long_is_writable_in_context(virt_context_ptr_t, uintptr_t)
+ * @brief Checks whether address is mapped writable
+ *
+ * @param ctx
+ * @param addr
+ * @return
+ */
+bool v7_long_is_writable_in_context( virt_context_ptr_t ctx, uintptr_t addr ) {
+  // get page index
+  uint32_t page_idx = LD_VIRTUAL_PAGE_INDEX( addr );
+  bool writable = false;
+
+  // determine page index
+  uint64_t table_phys = v7_long_create_table( ctx, addr, 0 );
+  if ( 0 == table_phys ) {
+    return false;
+  }
+  // map temporary
+  ld_page_table_t* table = ( ld_page_table_t* )map_temporary(
+    table_phys, PAGE_SIZE );
+  // handle error
+  if ( ! table ) {
+    return false;
+  }
+  // writable if mapped with write permission of context
+  if (
+    0 != table->page[ page_idx ].raw
+    && (
+      1 == table->page[ page_idx ].data.lower_attr_access_permission
+      || (
+        VIRT_CONTEXT_TYPE_KERNEL == ctx->type
+        && 0 == table->page[ page_idx ].data.lower_attr_access_permission
+      )
+    )
+  ) {
+    writable = true;
+  }
+  // unmap temporary
+  unmap_temporary( ( uintptr_t )table, PAGE_SIZE );
+  // return flag
+  return writable;
+}
+
 /**
  * @fn uint64_t v7_long_get_mapped_address_in_context(virt_context_ptr_t, uintptr_t)
  * @brief Get mapped physical address
@@ -54,6 +54,7 @@ void v7_long_prepare( void );
 void v7_long_flush_complete( void );
 void v7_long_flush_address( uintptr_t );
 bool v7_long_is_mapped_in_context( virt_context_ptr_t, uintptr_t );
+bool v7_long_is_writable_in_context( virt_context_ptr_t, uintptr_t );
 uint64_t v7_long_get_mapped_address_in_context( virt_context_ptr_t, uintptr_t );
 uintptr_t v7_long_prefetch_fault_address( void );
 uintptr_t v7_long_prefetch_status( void );
@@ -698,17 +698,20 @@ bool v7_short_map(
   if ( page & VIRT_PAGE_TYPE_EXECUTABLE ) {
     table->page[ page_idx ].data.execute_never = 0;
   }
+  // read only with apx set, so that privileged writes fault as well
   if ( page & VIRT_PAGE_TYPE_READ ) {
     table->page[ page_idx ].data.access_permission_0 =
       ( VIRT_CONTEXT_TYPE_KERNEL == ctx->type )
         ? SD_MAC_APX1_PRIVILEGED_RO
         : SD_MAC_APX1_USER_RO;
+    table->page[ page_idx ].data.access_permission_1 = 1;
   }
   if ( page & VIRT_PAGE_TYPE_WRITE ) {
     table->page[ page_idx ].data.access_permission_0 =
       ( VIRT_CONTEXT_TYPE_KERNEL == ctx->type )
         ? SD_MAC_APX0_PRIVILEGED_RW
         : SD_MAC_APX0_FULL_RW;
+    table->page[ page_idx ].data.access_permission_1 = 0;
   }
   // set non global flag
   table->page[ page_idx ].data.not_global =
@@ -1501,6 +1504,53 @@ bool v7_short_is_mapped_in_context( virt_context_ptr_t ctx, uintptr_t addr ) {
   return mapped;
 }
 
+/**
+ * @fn bool v7_short_is_writable_in_context(virt_context_ptr_t, uintptr_t)
+ * @brief Checks whether address is mapped writable
+ *
+ * @param ctx
+ * @param addr
+ * @return
+ */
+bool v7_short_is_writable_in_context( virt_context_ptr_t ctx, uintptr_t addr ) {
+  // get page index
+  uint32_t page_idx = SD_VIRTUAL_PAGE_INDEX( addr );
+  bool writable = false;
+
+  // get table for checking
+  sd_page_table_t* table = ( sd_page_table_t* )(
+    ( uintptr_t )v7_short_create_table( ctx, addr, 0 ) );
+  // handle error
+  if ( ! table ) {
+    return false;
+  }
+  // map temporary
+  table = ( sd_page_table_t* )map_temporary( ( uintptr_t )table, SD_TBL_SIZE );
+  // not mapped if null
+  if ( ! table ) {
+    return false;
+  }
+  // writable if mapped without apx and with write permission of context
+  if (
+    0 != table->page[ page_idx ].raw
+    && 0 == table->page[ page_idx ].data.access_permission_1
+    && (
+      SD_MAC_APX0_FULL_RW == table->page[ page_idx ].data.access_permission_0
+      || (
+        VIRT_CONTEXT_TYPE_KERNEL == ctx->type
+        && SD_MAC_APX0_PRIVILEGED_RW
+          == table->page[ page_idx ].data.access_permission_0
+      )
+    )
+  ) {
+    writable = true;
+  }
+  // unmap temporary
+  unmap_temporary( ( uintptr_t )table, SD_TBL_SIZE );
+  // return flag
+  return writable;
+}
+
 /**
  * @fn uint64_t v7_short_get_mapped_address_in_context(virt_context_ptr_t, uintptr_t)
  * @brief Get mapped physical address
@@ -130,12 +130,18 @@ rpc_backup_ptr_t rpc_backup_create(
   // prepare and backup context area
   memset( backup->context, 0, sizeof( cpu_register_context_t ) );
   memcpy( backup->context, cpu, sizeof( cpu_register_context_t ) );
+  // rpc raised within a handler is raised on behalf of the handled one
+  rpc_backup_ptr_t source_active = rpc_backup_get_active( source );
+  backup->origin = source_active
+    ? source_active->origin
+    : source->process->id;
   // backup parameter data as message
   backup->data_id = 0;
   if ( data && data_size ) {
     int err = rpc_data_queue_add(
       thread->process->id,
       source->process->id,
+      backup->origin,
       data,
       data_size,
       &backup->data_id
@@ -22,6 +22,7 @@
 #include "lib/string.h"
 #include "elf.h"
 #include "mm/phys.h"
+#include "mm/image.h"
 #include "entry.h"
 #if defined( PRINT_ELF )
   #include "debug/debug.h"
@@ -110,222 +111,142 @@ bool elf_check( uintptr_t elf ) {
 }
 
 /**
- * @fn bool load_program_header(uintptr_t, task_process_ptr_t)
- * @brief Internal helper to parse and load program header
+ * @fn bool load_program_header(image_backing_ptr_t, task_process_ptr_t)
+ * @brief Internal helper to parse program header and register segments
  *
- * @param elf elf image address
+ * @param backing elf image backing
  * @param process process
  * @return
  */
-static bool load_program_header( uintptr_t elf, task_process_ptr_t process ) {
+static bool load_program_header(
+  image_backing_ptr_t backing,
+  task_process_ptr_t process
+) {
   // get header
   #if defined( ELF32 )
-    Elf32_Ehdr* header = ( Elf32_Ehdr* )elf;
+    Elf32_Ehdr header;
   #elif defined( ELF64 )
-    Elf64_Ehdr* header = ( Elf64_Ehdr* )elf;
+    Elf64_Ehdr header;
   #endif
+  if ( ! image_backing_read( backing, 0, &header, sizeof( header ) ) ) {
+    return false;
+  }
+  // get context boundaries
+  uintptr_t min = virt_get_context_min_address( process->virtual_context );
+  uintptr_t max = virt_get_context_max_address( process->virtual_context );
 
   // parse program header
-  for ( uint32_t index = 0; index < header->e_phnum; ++index ) {
+  for ( uint32_t index = 0; index < header.e_phnum; ++index ) {
     // get program header
     #if defined( ELF32 )
-      Elf32_Phdr* program_header = ( Elf32_Phdr* )(
-        elf + header->e_phoff + header->e_phentsize * index
-      );
+      Elf32_Phdr program_header;
     #elif defined( ELF64 )
-      Elf64_Phdr* program_header = ( Elf64_Phdr* )(
-        elf + header->e_phoff + header->e_phentsize * index
-      );
+      Elf64_Phdr program_header;
     #endif
+    if ( ! image_backing_read(
+      backing,
+      header.e_phoff + header.e_phentsize * index,
+      &program_header,
+      sizeof( program_header )
+    ) ) {
+      return false;
+    }
     // debug output
     #if defined ( PRINT_ELF )
       DEBUG_OUTPUT(
         "type = %#x, vaddr = %#x, paddr = %#x, size = %#x, offset = %#x!\r\n",
-        program_header->p_type, program_header->p_vaddr, program_header->p_paddr,
-        program_header->p_memsz, program_header->p_offset )
+        program_header.p_type, program_header.p_vaddr, program_header.p_paddr,
+        program_header.p_memsz, program_header.p_offset )
     #endif
     // skip all sections except load
-    if ( PT_LOAD != program_header->p_type ) {
+    if ( PT_LOAD != program_header.p_type || 0 == program_header.p_memsz ) {
       continue;
     }
-
-    // determine start and end
-    uintptr_t start = program_header->p_vaddr;
-    uintptr_t end = start + program_header->p_memsz;
-    // debug output
-    #if defined ( PRINT_ELF )
-      DEBUG_OUTPUT( "start = %#"PRIxPTR", end = %#"PRIxPTR"\r\n", start, end )
-    #endif
-    // round down start and up end
-    start = ROUND_DOWN_TO_FULL_PAGE( start );
-    end = ROUND_UP_TO_FULL_PAGE( end );
-    // debug output
-    #if defined ( PRINT_ELF )
-      DEBUG_OUTPUT( "start = %#"PRIxPTR", end = %#"PRIxPTR"\r\n", start, end )
-    #endif
-
-    // determine copy offset and copy amount
-    uintptr_t memory_offset = program_header->p_vaddr % PAGE_SIZE;
-    uintptr_t file_offset = program_header->p_offset;
-    uintptr_t copy_size = program_header->p_memsz;
-    if ( program_header->p_memsz > program_header->p_filesz ) {
-      copy_size = program_header->p_filesz;
+    // ensure segment is within context
+    uintptr_t start = program_header.p_vaddr;
+    uintptr_t end = start + program_header.p_memsz;
+    if ( start < min || end > max || end < start ) {
+      return false;
     }
-    // debug output
-    #if defined ( PRINT_ELF )
-      DEBUG_OUTPUT(
-        "memory_offset = %#"PRIxPTR", file_offset = %#"PRIxPTR", copy_size = %#"PRIxPTR"\r\n",
-        memory_offset, file_offset, copy_size )
-    #endif
-
-    // loop from start to end, map and copy data
-    while( start < end ) {
-      // determine copy amount
-      uintptr_t to_copy = copy_size;
-      // handle page size exceeded
-      if ( to_copy > PAGE_SIZE ) {
-        to_copy = PAGE_SIZE;
-      }
-      // consider memory offset
-      if ( memory_offset > 0 ) {
-        to_copy = PAGE_SIZE - memory_offset;
-      }
-      // cap to copy size
-      if ( to_copy > copy_size ) {
-        to_copy = copy_size;
-      }
-      // debug output
-      #if defined ( PRINT_ELF )
-        DEBUG_OUTPUT(
-          "copy_size = %#"PRIxPTR", to_copy = %#"PRIxPTR", file_offset = %#"PRIxPTR"\r\n",
-          copy_size, to_copy, file_offset )
-      #endif
-
-      // physical page variable and clear flag
-      uint64_t phys;
-      bool clear = false;
-      // handle already mapped ( fetch physical page )
-      if ( virt_is_mapped_in_context( process->virtual_context, start ) ) {
-        // get physical address of already mapped one
-        phys = virt_get_mapped_address_in_context(
-          process->virtual_context,
-          start
-        );
-        // handle error
-        if ( ( uint64_t )-1 == phys ) {
-          return false;
-        }
-      // handle not mapped ( acquire new physical page )
-      } else {
-        // get new physical page
-        phys = phys_find_free_page( PAGE_SIZE );
-        // handle error
-        if ( 0 == phys ) {
-          return false;
-        }
-        // set clear flag
-        clear = true;
-      }
-      // debug output
-      #if defined ( PRINT_ELF )
-        DEBUG_OUTPUT( "phys = %#016llx\r\n", phys )
-      #endif
-
-      // map temporary
-      uintptr_t tmp = virt_map_temporary( phys, PAGE_SIZE );
-      if ( 0 == tmp ) {
-        // free phys if new page is registered
-        if ( clear ) {
-          phys_free_page( phys );
-        }
-        // return error
-        return false;
-      }
-      // handle clear
-      if ( clear ) {
-        // debug output
-        #if defined( PRINT_ELF )
-          DEBUG_OUTPUT( "clear page at address %#"PRIxPTR"\r\n", tmp )
-        #endif
-        // clear page
-        memset( ( void* )tmp, 0, PAGE_SIZE );
-      }
-      if ( 0 < to_copy ) {
-        // debug output
-        #if defined ( PRINT_ELF )
-          DEBUG_OUTPUT(
-            "memcpy( %#"PRIxPTR", %#"PRIxPTR", %#"PRIxPTR" )\r\n",
-            tmp + memory_offset,
-            ( uintptr_t )header + file_offset,
-            to_copy
-          )
-        #endif
-        // copy data
-        memcpy(
-          ( void* )( tmp + memory_offset ),
-          ( void* )( ( uintptr_t )header + file_offset ),
-          to_copy
-        );
-      }
-      // unmap temporary again
-      virt_unmap_temporary( tmp, PAGE_SIZE );
-      // map it within process context if new page
-      if ( clear ) {
-        // get mapping flag for section
-        uint32_t mapping_flag = VIRT_PAGE_TYPE_READ | VIRT_PAGE_TYPE_WRITE;
-        if ( program_header->p_flags & PF_X ) {
-          mapping_flag |= VIRT_PAGE_TYPE_EXECUTABLE;
-        }
-        // map it
-        if ( ! virt_map_address(
-            process->virtual_context,
-            start,
-            phys,
-            VIRT_MEMORY_TYPE_NORMAL,
-            mapping_flag
-          )
-        ) {
-          // free phys if new page is registered
-          phys_free_page( phys );
-          // return error
-          return false;
-        }
-      }
-
-      // set offset to 0
-      memory_offset = 0;
-      // decrease copy size
-      copy_size -= to_copy;
-      // increase file offset
-      file_offset += to_copy;
-      // increase start
-      start += PAGE_SIZE;
+    // writable segments get private pages, everything else is read only
+    uint32_t mapping_flag = VIRT_PAGE_TYPE_READ;
+    if ( program_header.p_flags & PF_W ) {
+      mapping_flag |= VIRT_PAGE_TYPE_WRITE;
+    }
+    if ( program_header.p_flags & PF_X ) {
+      mapping_flag |= VIRT_PAGE_TYPE_EXECUTABLE;
+    }
+    // register segment, pages are populated on first access
+    if ( ! image_add_segment(
+      process->virtual_context,
+      backing,
+      start,
+      program_header.p_memsz,
+      program_header.p_offset,
+      program_header.p_filesz,
+      mapping_flag
+    ) ) {
+      return false;
     }
   }
   return true;
 }
 
 /**
- * @fn uintptr_t elf_load(uintptr_t, task_process_ptr_t)
- * @brief Method to load simple elf for process ( used for init only )
+ * @fn uintptr_t elf_load_image(image_backing_ptr_t, task_process_ptr_t)
+ * @brief Method to load elf image demand paged from a backing
  *
- * @param elf address to image
+ * @param backing image backing
  * @param process process where it shall be loaded into
  * @return
  */
-uintptr_t elf_load( uintptr_t elf, task_process_ptr_t process ) {
+uintptr_t elf_load_image(
+  image_backing_ptr_t backing,
+  task_process_ptr_t process
+) {
+  // get header
+  Elf32_Ehdr header;
+  if ( ! image_backing_read( backing, 0, &header, sizeof( header ) ) ) {
+    return 0;
+  }
   // check for elf
-  if ( ! elf_check( elf ) ) {
+  if ( ! elf_check( ( uintptr_t )&header ) ) {
     return 0;
   }
-  // get header
-  Elf32_Ehdr* header = ( Elf32_Ehdr* )elf;
   // load program header
-  if ( ! load_program_header( elf, process ) ) {
+  if ( ! load_program_header( backing, process ) ) {
     return 0;
   }
   // return entry
-  return ( uintptr_t )header->e_entry;
+  return ( uintptr_t )header.e_entry;
+}
+
+/**
+ * @fn uintptr_t elf_load(uintptr_t, size_t, task_process_ptr_t)
+ * @brief Method to load simple elf for process ( used for init only )
+ *
+ * @param elf address to image within kernel context
+ * @param size image size
+ * @param process process where it shall be loaded into
+ * @return
+ */
+uintptr_t elf_load( uintptr_t elf, size_t size, task_process_ptr_t process ) {
+  // reference image pages without copying them
+  image_backing_ptr_t backing = image_backing_create(
+    virt_current_kernel_context,
+    elf,
+    size,
+    false
+  );
+  if ( ! backing ) {
+    return 0;
+  }
+  // load image
+  uintptr_t entry = elf_load_image( backing, process );
+  // drop local reference, segments keep their own
+  image_backing_release( backing );
+  // return entry
+  return entry;
 }
 
 /**
@@ -339,6 +260,7 @@ uintptr_t elf_load( uintptr_t elf, task_process_ptr_t process ) {
  */
 size_t elf_image_size( uintptr_t elf ) {
   // check header
+  image_populate_range( virt_current_user_context, elf, sizeof( Elf32_Ehdr ) );
   if (
     ! virt_is_mapped_range(
       elf,
@@ -358,6 +280,11 @@ size_t elf_image_size( uintptr_t elf ) {
       elf + header->e_shoff + header->e_shentsize * idx
     );
     // check if mapped before access
+    image_populate_range(
+      virt_current_user_context,
+      ( uintptr_t )section_header,
+      sizeof( Elf32_Shdr )
+    );
     if ( ! virt_is_mapped_range(
       ( uintptr_t )section_header,
       sizeof( Elf32_Shdr ) )
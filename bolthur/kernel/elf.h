@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "task/process.h"
+#include "mm/image.h"
 
 #if ! defined( _ELF_H )
 #define _ELF_H
@@ -117,7 +118,8 @@ typedef struct {
 
 bool elf_check( uintptr_t );
 bool elf_arch_check( uintptr_t );
-uintptr_t elf_load( uintptr_t, task_process_ptr_t );
+uintptr_t elf_load( uintptr_t, size_t, task_process_ptr_t );
+uintptr_t elf_load_image( image_backing_ptr_t, task_process_ptr_t );
 size_t elf_image_size( uintptr_t );
 
 #endif
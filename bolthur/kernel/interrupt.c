@@ -428,6 +428,10 @@ bool interrupt_register_handler(
     #if defined( PRINT_EVENT )
       DEBUG_OUTPUT( "Callback already bound, returning success\r\n" );
     #endif
+    // acquire by process again enables interrupt disabled after raise
+    if ( process && type == INTERRUPT_NORMAL && enable ) {
+      interrupt_mask_specific( ( int8_t )num );
+    }
     return true;
   }
   void* data = NULL;
@@ -538,6 +542,7 @@ void interrupt_handle( size_t num, interrupt_type_t type, void* context ) {
 
   // get first element of process handlers
   current = block->process->first;
+  bool raised = false;
   while ( current ) {
     task_process_ptr_t process = current->data;
     // get first thread
@@ -571,9 +576,19 @@ void interrupt_handle( size_t num, interrupt_type_t type, void* context ) {
       current = current->next;
       continue;
     }
+    raised = true;
     // step to next
     current = current->next;
   }
+  // keep level triggered interrupt disabled until process acquires it again
+  if (
+    raised
+    && INTERRUPT_NORMAL == type
+    && list_empty( block->handler )
+    && list_empty( block->post )
+  ) {
+    interrupt_unmask_specific( ( int8_t )num );
+  }
 
   // get first element of post callbacks
   current = block->post->first;
@@ -669,18 +684,16 @@ void interrupt_toggle( interrupt_toggle_state_t state ) {
  * @param fast
  */
 void interrupt_handle_possible( void* context, bool fast ) {
-  int8_t interrupt_bit;
+  int8_t interrupt;
   // get pending interrupt
-  while( -1 != ( interrupt_bit = interrupt_get_pending( fast ) ) ) {
-    // transform bit to interrupt
-    uint32_t interrupt = ( 1U << interrupt_bit );
+  while( -1 != ( interrupt = interrupt_get_pending( fast ) ) ) {
     // debug output
     #if defined( PRINT_INTERRUPT )
-      DEBUG_OUTPUT( "pending interrupt: %#x\r\n", interrupt );
+      DEBUG_OUTPUT( "pending interrupt: %d\r\n", interrupt );
     #endif
     // call interrupt handler
     interrupt_handle(
-      interrupt,
+      ( size_t )interrupt,
       fast ? INTERRUPT_FAST : INTERRUPT_NORMAL,
       context
     );
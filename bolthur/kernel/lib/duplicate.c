@@ -21,6 +21,7 @@
 #include "string.h"
 #include "stdlib.h"
 #include "../mm/virt.h"
+#include "../mm/image.h"
 
 /**
  * @fn char duplicate**(const char**)
@@ -49,6 +50,11 @@ char** duplicate( const char** src ) {
   // determine row count
   while ( true ) {
     // return nothing if not mapped
+    image_populate_range(
+      virt_current_user_context,
+      ( uintptr_t )&src[ src_count ],
+      sizeof( char* )
+    );
     if ( ! virt_is_mapped_range(
       ( uintptr_t )&src[ src_count ],
       sizeof( char* )
@@ -22,6 +22,7 @@
 #include "../../string.h"
 #include "../../../panic.h"
 #include "../../../mm/virt.h"
+#include "../../../mm/image.h"
 
 #define U64_BLOCK_SIZE sizeof( uint64_t )
 #define UNALIGNED(a, b) ((( uintptr_t )a & ( U64_BLOCK_SIZE - 1 )) | (( uintptr_t )b & ( U64_BLOCK_SIZE - 1 )))
@@ -76,7 +77,9 @@ void* memcpy( void* restrict dst, const void* restrict src, size_t size ) {
  * @param size
  */
 void* memcpy_unsafe( void* restrict dst, const void* restrict src, size_t size ) {
-  // check if ranges are mapped
+  // populate demand paged image and check if ranges are mapped
+  image_populate_range( virt_current_user_context, ( uintptr_t )dst, size );
+  image_populate_range( virt_current_user_context, ( uintptr_t )src, size );
   if (
     ! virt_is_mapped_range( ( uintptr_t )dst, size )
     || ! virt_is_mapped_range( ( uintptr_t )src, size )
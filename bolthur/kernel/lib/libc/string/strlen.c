@@ -22,6 +22,7 @@
 #include "../../string.h"
 #include "../../../mm/phys.h"
 #include "../../../mm/virt.h"
+#include "../../../mm/image.h"
 #include "../../../debug/debug.h"
 
 #define U64_BLOCK_SIZE sizeof( uint64_t )
@@ -82,7 +83,8 @@ size_t strlen_unsafe( const char* str ) {
   const char* start = str;
   // loop until end is reached or some memory is not mapped
   do {
-    // check page size
+    // populate demand paged image and check page size
+    image_populate_range( virt_current_user_context, last_check, PAGE_SIZE );
     if ( ! virt_is_mapped_range( last_check, PAGE_SIZE ) ) {
       return 0;
     }
@@ -32,6 +32,7 @@
 #include "mm/virt.h"
 #include "mm/heap.h"
 #include "mm/shared.h"
+#include "mm/image.h"
 #include "event.h"
 #include "task/process.h"
 #include "syscall.h"
@@ -72,6 +73,10 @@ noreturn void kernel_main( void ) {
   DEBUG_OUTPUT( "[bolthur/kernel -> interrupt] initialize ...\r\n" )
   interrupt_init();
 
+  // buffer output and transmit it interrupt driven
+  DEBUG_OUTPUT( "[bolthur/kernel -> tty] register interrupt ...\r\n" )
+  assert( tty_register_interrupt() )
+
   // remote gdb debugging
   #if defined( REMOTE_DEBUG )
     // initialize serial
@@ -107,6 +112,10 @@ noreturn void kernel_main( void ) {
   DEBUG_OUTPUT( "[bolthur/kernel -> memory -> shared] initialize ...\r\n" )
   assert( shared_memory_init() )
 
+  // Setup image
+  DEBUG_OUTPUT( "[bolthur/kernel -> memory -> image] initialize ...\r\n" )
+  assert( image_init() )
+
   // Setup multitasking
   DEBUG_OUTPUT( "[bolthur/kernel -> process] initialize ...\r\n" )
   assert( task_process_init() )
@@ -128,7 +137,7 @@ noreturn void kernel_main( void ) {
   task_process_ptr_t proc = task_process_create( 0, 0 );
   assert( proc )
   // load flat image
-  uintptr_t init_entry = elf_load( elf_file, proc );
+  uintptr_t init_entry = elf_load( elf_file, tar_size( boot ), proc );
   assert( init_entry )
   // add thread
   assert( task_thread_create( init_entry, proc, 0 ) );
@@ -0,0 +1,758 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <inttypes.h>
+
+#include "../lib/stdlib.h"
+#include "../lib/collection/list.h"
+#include "../lib/collection/avl.h"
+#include "../lib/string.h"
+#include "../mm/phys.h"
+#include "../mm/virt.h"
+#include "../mm/image.h"
+#if defined( PRINT_MM_IMAGE )
+  #include "../debug/debug.h"
+#endif
+
+/**
+ * @brief Tree of image mappings by virtual context
+ */
+avl_tree_ptr_t image_tree = NULL;
+
+/**
+ * @fn int32_t image_compare_context_callback(const avl_node_ptr_t, const avl_node_ptr_t)
+ * @brief Helper necessary for avl image mapping tree
+ *
+ * @param a node a
+ * @param b node b
+ * @return
+ */
+static int32_t image_compare_context_callback(
+  const avl_node_ptr_t a,
+  const avl_node_ptr_t b
+) {
+  // -1 if address of a->data is greater than address of b->data
+  if ( ( uintptr_t )a->data > ( uintptr_t )b->data ) {
+    return -1;
+  // 1 if address of b->data is greater than address of a->data
+  } else if ( ( uintptr_t )b->data > ( uintptr_t )a->data ) {
+    return 1;
+  }
+  // equal => return 0
+  return 0;
+}
+
+/**
+ * @fn void cleanup_segment(const list_item_ptr_t)
+ * @brief Helper to cleanup segment list
+ *
+ * @param a
+ */
+static void cleanup_segment( const list_item_ptr_t a ) {
+  // get segment
+  image_segment_ptr_t segment = ( image_segment_ptr_t )a->data;
+  // release backing and free segment
+  image_backing_release( segment->backing );
+  free( segment );
+  // default cleanup
+  list_default_cleanup( a );
+}
+
+/**
+ * @fn image_mapping_ptr_t get_mapping(virt_context_ptr_t, bool)
+ * @brief Helper to get image mapping of a context
+ *
+ * @param ctx context to get mapping for
+ * @param create create mapping if not existing
+ * @return
+ */
+static image_mapping_ptr_t get_mapping( virt_context_ptr_t ctx, bool create ) {
+  // handle not initialized or invalid
+  if ( ! image_tree || ! ctx ) {
+    return NULL;
+  }
+  // try to find existing one
+  avl_node_ptr_t node = avl_find_by_data( image_tree, ( void* )ctx );
+  if ( node ) {
+    return IMAGE_MAPPING_GET_BLOCK( node );
+  }
+  // handle no creation
+  if ( ! create ) {
+    return NULL;
+  }
+  // allocate mapping
+  image_mapping_ptr_t mapping = ( image_mapping_ptr_t )malloc(
+    sizeof( image_mapping_t )
+  );
+  if ( ! mapping ) {
+    return NULL;
+  }
+  memset( mapping, 0, sizeof( image_mapping_t ) );
+  // create segment list
+  mapping->segment = list_construct( NULL, cleanup_segment, NULL );
+  if ( ! mapping->segment ) {
+    free( mapping );
+    return NULL;
+  }
+  mapping->context = ctx;
+  // prepare node and insert
+  avl_prepare_node( &mapping->node, ( void* )ctx );
+  if ( ! avl_insert_by_node( image_tree, &mapping->node ) ) {
+    list_destruct( mapping->segment );
+    free( mapping );
+    return NULL;
+  }
+  // return mapping
+  return mapping;
+}
+
+/**
+ * @fn bool segment_covers(image_segment_ptr_t, uintptr_t, size_t)
+ * @brief Helper to check whether segment covers a range at page granularity
+ *
+ * @param segment
+ * @param start
+ * @param len
+ * @return
+ */
+static bool segment_covers(
+  image_segment_ptr_t segment,
+  uintptr_t start,
+  size_t len
+) {
+  uintptr_t segment_start = ROUND_DOWN_TO_FULL_PAGE( segment->start );
+  uintptr_t segment_end = ROUND_UP_TO_FULL_PAGE(
+    segment->start + segment->memory_size
+  );
+  return start < segment_end && start + len > segment_start;
+}
+
+/**
+ * @fn uint64_t segment_direct_page(image_segment_ptr_t, uintptr_t)
+ * @brief Get backing page to map directly or 0 when page needs a copy
+ *
+ * @param segment
+ * @param page_start
+ * @return
+ */
+static uint64_t segment_direct_page(
+  image_segment_ptr_t segment,
+  uintptr_t page_start
+) {
+  image_backing_ptr_t backing = segment->backing;
+  // writable segments are always private
+  if ( segment->page & VIRT_PAGE_TYPE_WRITE ) {
+    return 0;
+  }
+  // position of segment data within backing pages
+  size_t position = backing->offset + segment->file_offset;
+  // data has to share the page offset of the virtual address
+  if ( ROUND_PAGE_OFFSET( position ) != ROUND_PAGE_OFFSET( segment->start ) ) {
+    return 0;
+  }
+  // zero filled part has to be copied
+  if (
+    segment->memory_size != segment->file_size
+    && page_start + PAGE_SIZE > segment->start + segment->file_size
+  ) {
+    return 0;
+  }
+  // determine backing page index
+  size_t index = (
+    ROUND_DOWN_TO_FULL_PAGE( position )
+    + ( page_start - ROUND_DOWN_TO_FULL_PAGE( segment->start ) )
+  ) / PAGE_SIZE;
+  if ( index >= backing->count ) {
+    return 0;
+  }
+  // return backing page
+  return backing->address[ index ];
+}
+
+/**
+ * @fn bool image_init(void)
+ * @brief Initialize image mapping functionality
+ *
+ * @return
+ */
+bool image_init( void ) {
+  // debug output
+  #if defined( PRINT_MM_IMAGE )
+    DEBUG_OUTPUT( "image_init()\r\n" )
+  #endif
+  // create tree
+  image_tree = avl_create_tree( image_compare_context_callback, NULL, NULL );
+  if ( ! image_tree ) {
+    return false;
+  }
+  // return success
+  return true;
+}
+
+/**
+ * @fn image_backing_ptr_t image_backing_create(virt_context_ptr_t, uintptr_t, size_t, bool)
+ * @brief Create image backing from pages already mapped within a context
+ *
+ * @param ctx context the image is mapped in
+ * @param address image start address
+ * @param size image size
+ * @param steal take over physical pages by unmapping them from context
+ * @return
+ */
+image_backing_ptr_t image_backing_create(
+  virt_context_ptr_t ctx,
+  uintptr_t address,
+  size_t size,
+  bool steal
+) {
+  // debug output
+  #if defined( PRINT_MM_IMAGE )
+    DEBUG_OUTPUT( "image_backing_create( %p, %#"PRIxPTR", %zx, %d )\r\n",
+      ( void* )ctx, address, size, steal ? 1 : 0 )
+  #endif
+  // handle invalid
+  if ( ! ctx || 0 == size ) {
+    return NULL;
+  }
+  // allocate backing
+  image_backing_ptr_t backing = ( image_backing_ptr_t )malloc(
+    sizeof( image_backing_t )
+  );
+  if ( ! backing ) {
+    return NULL;
+  }
+  memset( backing, 0, sizeof( image_backing_t ) );
+  // determine page range
+  uintptr_t start = ROUND_DOWN_TO_FULL_PAGE( address );
+  uintptr_t end = ROUND_UP_TO_FULL_PAGE( address + size );
+  backing->count = ( end - start ) / PAGE_SIZE;
+  backing->offset = address - start;
+  backing->size = size;
+  backing->use_count = 1;
+  backing->owned = steal;
+  // allocate address list
+  backing->address = ( uint64_t* )calloc( backing->count, sizeof( uint64_t ) );
+  if ( ! backing->address ) {
+    free( backing );
+    return NULL;
+  }
+  // collect physical pages
+  for ( size_t idx = 0; idx < backing->count; idx++ ) {
+    backing->address[ idx ] = virt_get_mapped_address_in_context(
+      ctx,
+      start + idx * PAGE_SIZE
+    );
+    // handle error
+    if ( ( uint64_t )-1 == backing->address[ idx ] ) {
+      backing->owned = false;
+      image_backing_release( backing );
+      return NULL;
+    }
+  }
+  // unmap without freeing when taking over
+  for ( size_t idx = 0; steal && idx < backing->count; idx++ ) {
+    if ( ! virt_unmap_address( ctx, start + idx * PAGE_SIZE, false ) ) {
+      // pages still mapped remain owned by the context
+      while ( idx < backing->count ) {
+        backing->address[ idx++ ] = 0;
+      }
+      image_backing_release( backing );
+      return NULL;
+    }
+  }
+  // return backing
+  return backing;
+}
+
+/**
+ * @fn image_backing_ptr_t image_backing_copy(uintptr_t, size_t)
+ * @brief Create image backing by copying image into new pages
+ *
+ * @param address image start address
+ * @param size image size
+ * @return
+ */
+image_backing_ptr_t image_backing_copy( uintptr_t address, size_t size ) {
+  // debug output
+  #if defined( PRINT_MM_IMAGE )
+    DEBUG_OUTPUT( "image_backing_copy( %#"PRIxPTR", %zx )\r\n", address, size )
+  #endif
+  // handle invalid
+  if ( 0 == size ) {
+    return NULL;
+  }
+  // allocate backing
+  image_backing_ptr_t backing = ( image_backing_ptr_t )malloc(
+    sizeof( image_backing_t )
+  );
+  if ( ! backing ) {
+    return NULL;
+  }
+  memset( backing, 0, sizeof( image_backing_t ) );
+  backing->count = ROUND_UP_TO_FULL_PAGE( size ) / PAGE_SIZE;
+  backing->size = size;
+  backing->use_count = 1;
+  backing->owned = true;
+  // allocate address list
+  backing->address = ( uint64_t* )calloc( backing->count, sizeof( uint64_t ) );
+  if ( ! backing->address ) {
+    free( backing );
+    return NULL;
+  }
+  // allocate pages and copy content
+  for ( size_t idx = 0; idx < backing->count; idx++ ) {
+    backing->address[ idx ] = phys_find_free_page( PAGE_SIZE );
+    if ( 0 == backing->address[ idx ] ) {
+      image_backing_release( backing );
+      return NULL;
+    }
+    // map temporary
+    uintptr_t tmp = virt_map_temporary( backing->address[ idx ], PAGE_SIZE );
+    if ( ! tmp ) {
+      image_backing_release( backing );
+      return NULL;
+    }
+    // determine amount to copy
+    size_t amount = size - idx * PAGE_SIZE;
+    if ( amount > PAGE_SIZE ) {
+      amount = PAGE_SIZE;
+    }
+    // clear and copy
+    memset( ( void* )tmp, 0, PAGE_SIZE );
+    if ( ! memcpy_unsafe(
+      ( void* )tmp,
+      ( void* )( address + idx * PAGE_SIZE ),
+      amount
+    ) ) {
+      virt_unmap_temporary( tmp, PAGE_SIZE );
+      image_backing_release( backing );
+      return NULL;
+    }
+    // unmap temporary again
+    virt_unmap_temporary( tmp, PAGE_SIZE );
+  }
+  // return backing
+  return backing;
+}
+
+/**
+ * @fn void image_backing_release(image_backing_ptr_t)
+ * @brief Drop a reference of a backing and destroy it when unused
+ *
+ * @param backing
+ */
+void image_backing_release( image_backing_ptr_t backing ) {
+  // handle invalid
+  if ( ! backing ) {
+    return;
+  }
+  // handle still in use
+  if ( 1 < backing->use_count ) {
+    backing->use_count--;
+    return;
+  }
+  // free owned pages
+  if ( backing->address ) {
+    if ( backing->owned ) {
+      for ( size_t idx = 0; idx < backing->count; idx++ ) {
+        if ( 0 != backing->address[ idx ] ) {
+          phys_free_page( backing->address[ idx ] );
+        }
+      }
+    }
+    free( backing->address );
+  }
+  // free structure
+  free( backing );
+}
+
+/**
+ * @fn bool image_backing_read(image_backing_ptr_t, size_t, void*, size_t)
+ * @brief Read data from image backing
+ *
+ * @param backing backing to read from
+ * @param offset offset within image
+ * @param destination destination buffer
+ * @param size amount to read
+ * @return
+ */
+bool image_backing_read(
+  image_backing_ptr_t backing,
+  size_t offset,
+  void* destination,
+  size_t size
+) {
+  // handle invalid
+  if (
+    ! backing
+    || offset + size < offset
+    || offset + size > backing->size
+  ) {
+    return false;
+  }
+  uint8_t* dst = ( uint8_t* )destination;
+  offset += backing->offset;
+  // loop until everything is read
+  while ( 0 < size ) {
+    size_t page_offset = offset % PAGE_SIZE;
+    size_t amount = PAGE_SIZE - page_offset;
+    if ( amount > size ) {
+      amount = size;
+    }
+    // map temporary
+    uintptr_t tmp = virt_map_temporary(
+      backing->address[ offset / PAGE_SIZE ],
+      PAGE_SIZE
+    );
+    if ( ! tmp ) {
+      return false;
+    }
+    // copy and unmap again
+    memcpy( dst, ( void* )( tmp + page_offset ), amount );
+    virt_unmap_temporary( tmp, PAGE_SIZE );
+    // next part
+    dst += amount;
+    offset += amount;
+    size -= amount;
+  }
+  // return success
+  return true;
+}
+
+/**
+ * @fn bool image_add_segment(virt_context_ptr_t, image_backing_ptr_t, uintptr_t, size_t, size_t, size_t, uint32_t)
+ * @brief Register demand paged segment within context
+ *
+ * @param ctx context
+ * @param backing image backing
+ * @param start virtual start address
+ * @param memory_size size in memory
+ * @param file_offset offset within image
+ * @param file_size size within image
+ * @param page page attributes
+ * @return
+ */
+bool image_add_segment(
+  virt_context_ptr_t ctx,
+  image_backing_ptr_t backing,
+  uintptr_t start,
+  size_t memory_size,
+  size_t file_offset,
+  size_t file_size,
+  uint32_t page
+) {
+  // debug output
+  #if defined( PRINT_MM_IMAGE )
+    DEBUG_OUTPUT(
+      "image_add_segment( %p, %p, %#"PRIxPTR", %zx, %zx, %zx, %#"PRIx32" )\r\n",
+      ( void* )ctx, ( void* )backing, start, memory_size, file_offset,
+      file_size, page )
+  #endif
+  // cap file size
+  if ( file_size > memory_size ) {
+    file_size = memory_size;
+  }
+  // validate parameter
+  if (
+    ! backing
+    || 0 == memory_size
+    || start + memory_size < start
+    || file_offset + file_size < file_offset
+    || file_offset + file_size > backing->size
+  ) {
+    return false;
+  }
+  // get mapping
+  image_mapping_ptr_t mapping = get_mapping( ctx, true );
+  if ( ! mapping ) {
+    return false;
+  }
+  // allocate segment
+  image_segment_ptr_t segment = ( image_segment_ptr_t )malloc(
+    sizeof( image_segment_t )
+  );
+  if ( ! segment ) {
+    return false;
+  }
+  memset( segment, 0, sizeof( image_segment_t ) );
+  // populate segment
+  segment->start = start;
+  segment->memory_size = memory_size;
+  segment->file_offset = file_offset;
+  segment->file_size = file_size;
+  segment->page = page;
+  segment->backing = backing;
+  // push to list
+  if ( ! list_push_back( mapping->segment, segment ) ) {
+    free( segment );
+    return false;
+  }
+  // increment backing usage
+  backing->use_count++;
+  // return success
+  return true;
+}
+
+/**
+ * @fn bool image_handle_fault(virt_context_ptr_t, uintptr_t)
+ * @brief Populate not yet mapped image page
+ *
+ * @param ctx context
+ * @param address faulting address
+ * @return true if page has been populated
+ */
+bool image_handle_fault( virt_context_ptr_t ctx, uintptr_t address ) {
+  // get mapping
+  image_mapping_ptr_t mapping = get_mapping( ctx, false );
+  if ( ! mapping ) {
+    return false;
+  }
+  uintptr_t page_start = ROUND_DOWN_TO_FULL_PAGE( address );
+  // already mapped pages are no image faults
+  if ( virt_is_mapped_in_context( ctx, page_start ) ) {
+    return false;
+  }
+  // debug output
+  #if defined( PRINT_MM_IMAGE )
+    DEBUG_OUTPUT( "image_handle_fault( %p, %#"PRIxPTR" )\r\n",
+      ( void* )ctx, address )
+  #endif
+  // collect covering segments
+  image_segment_ptr_t found = NULL;
+  size_t count = 0;
+  uint32_t page = VIRT_PAGE_TYPE_READ;
+  list_item_ptr_t current = mapping->segment->first;
+  while ( current ) {
+    image_segment_ptr_t segment = ( image_segment_ptr_t )current->data;
+    if ( segment_covers( segment, page_start, PAGE_SIZE ) ) {
+      found = segment;
+      count++;
+      // merge flags of segments sharing the page
+      page |= segment->page;
+    }
+    current = current->next;
+  }
+  // handle not part of image
+  if ( 0 == count ) {
+    return false;
+  }
+  // map read only backing page directly if possible
+  if ( 1 == count ) {
+    uint64_t phys = segment_direct_page( found, page_start );
+    if ( 0 != phys ) {
+      return virt_map_address(
+        ctx,
+        page_start,
+        phys,
+        VIRT_MEMORY_TYPE_NORMAL,
+        found->page
+      );
+    }
+  }
+  // get new physical page
+  uint64_t phys = phys_find_free_page( PAGE_SIZE );
+  if ( 0 == phys ) {
+    return false;
+  }
+  // map temporary and clear
+  uintptr_t tmp = virt_map_temporary( phys, PAGE_SIZE );
+  if ( ! tmp ) {
+    phys_free_page( phys );
+    return false;
+  }
+  memset( ( void* )tmp, 0, PAGE_SIZE );
+  // copy file data of all covering segments
+  current = mapping->segment->first;
+  while ( current ) {
+    image_segment_ptr_t segment = ( image_segment_ptr_t )current->data;
+    // determine intersection with file data
+    uintptr_t low = page_start;
+    uintptr_t high = page_start + PAGE_SIZE;
+    if ( low < segment->start ) {
+      low = segment->start;
+    }
+    if ( high > segment->start + segment->file_size ) {
+      high = segment->start + segment->file_size;
+    }
+    // copy if something to copy
+    if (
+      low < high
+      && ! image_backing_read(
+        segment->backing,
+        segment->file_offset + ( low - segment->start ),
+        ( void* )( tmp + ( low - page_start ) ),
+        high - low
+      )
+    ) {
+      virt_unmap_temporary( tmp, PAGE_SIZE );
+      phys_free_page( phys );
+      return false;
+    }
+    current = current->next;
+  }
+  // unmap temporary again
+  virt_unmap_temporary( tmp, PAGE_SIZE );
+  // map private page
+  if ( ! virt_map_address(
+    ctx,
+    page_start,
+    phys,
+    VIRT_MEMORY_TYPE_NORMAL,
+    page
+  ) ) {
+    phys_free_page( phys );
+    return false;
+  }
+  // return success
+  return true;
+}
+
+/**
+ * @fn void image_populate_range(virt_context_ptr_t, uintptr_t, size_t)
+ * @brief Populate not yet mapped image pages of a range before kernel access
+ *
+ * @param ctx context
+ * @param address start address of range
+ * @param size range size
+ *
+ * @note pages outside of the image are left untouched, so mapped range checks
+ * afterwards decide about access
+ */
+void image_populate_range(
+  virt_context_ptr_t ctx,
+  uintptr_t address,
+  size_t size
+) {
+  // skip contexts without image
+  if ( ! get_mapping( ctx, false ) ) {
+    return;
+  }
+  uintptr_t start = ROUND_DOWN_TO_FULL_PAGE( address );
+  uintptr_t end = address + size;
+  // loop until end
+  while ( start < end ) {
+    image_handle_fault( ctx, start );
+    start += PAGE_SIZE;
+  }
+}
+
+/**
+ * @fn bool image_address_is_image(virt_context_ptr_t, uintptr_t, size_t)
+ * @brief Check if area overlaps some image segment
+ *
+ * @param ctx
+ * @param start
+ * @param len
+ * @return
+ */
+bool image_address_is_image(
+  virt_context_ptr_t ctx,
+  uintptr_t start,
+  size_t len
+) {
+  // get mapping
+  image_mapping_ptr_t mapping = get_mapping( ctx, false );
+  if ( ! mapping ) {
+    return false;
+  }
+  // loop through segments
+  list_item_ptr_t current = mapping->segment->first;
+  while ( current ) {
+    if ( segment_covers( ( image_segment_ptr_t )current->data, start, len ) ) {
+      return true;
+    }
+    current = current->next;
+  }
+  // nothing found
+  return false;
+}
+
+/**
+ * @fn bool image_fork(virt_context_ptr_t, virt_context_ptr_t)
+ * @brief Method to duplicate image segments during fork
+ *
+ * @param ctx_to_fork
+ * @param ctx_fork
+ * @return
+ */
+bool image_fork( virt_context_ptr_t ctx_to_fork, virt_context_ptr_t ctx_fork ) {
+  // get mapping
+  image_mapping_ptr_t mapping = get_mapping( ctx_to_fork, false );
+  if ( ! mapping ) {
+    return true;
+  }
+  // duplicate segments sharing the backing
+  list_item_ptr_t current = mapping->segment->first;
+  while ( current ) {
+    image_segment_ptr_t segment = ( image_segment_ptr_t )current->data;
+    if ( ! image_add_segment(
+      ctx_fork,
+      segment->backing,
+      segment->start,
+      segment->memory_size,
+      segment->file_offset,
+      segment->file_size,
+      segment->page
+    ) ) {
+      return false;
+    }
+    current = current->next;
+  }
+  // return success
+  return true;
+}
+
+/**
+ * @fn void image_cleanup(virt_context_ptr_t)
+ * @brief Unmap directly mapped backing pages and drop segments of context
+ *
+ * @param ctx
+ */
+void image_cleanup( virt_context_ptr_t ctx ) {
+  // get mapping
+  image_mapping_ptr_t mapping = get_mapping( ctx, false );
+  if ( ! mapping ) {
+    return;
+  }
+  // unmap backing pages without freeing them
+  list_item_ptr_t current = mapping->segment->first;
+  while ( current ) {
+    image_segment_ptr_t segment = ( image_segment_ptr_t )current->data;
+    uintptr_t start = ROUND_DOWN_TO_FULL_PAGE( segment->start );
+    uintptr_t end = ROUND_UP_TO_FULL_PAGE(
+      segment->start + segment->memory_size
+    );
+    while ( start < end ) {
+      uint64_t phys = segment_direct_page( segment, start );
+      if (
+        0 != phys
+        && virt_is_mapped_in_context( ctx, start )
+        && phys == virt_get_mapped_address_in_context( ctx, start )
+      ) {
+        virt_unmap_address( ctx, start, false );
+      }
+      start += PAGE_SIZE;
+    }
+    current = current->next;
+  }
+  // remove mapping
+  avl_remove_by_node( image_tree, &mapping->node );
+  list_destruct( mapping->segment );
+  free( mapping );
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if ! defined( _MM_IMAGE_H )
+#define _MM_IMAGE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "../lib/collection/list.h"
+#include "../lib/collection/avl.h"
+#include "virt.h"
+
+struct image_backing {
+  uint64_t* address;
+  size_t count;
+  size_t offset;
+  size_t size;
+  size_t use_count;
+  bool owned;
+};
+
+struct image_segment {
+  uintptr_t start;
+  size_t memory_size;
+  size_t file_offset;
+  size_t file_size;
+  uint32_t page;
+  struct image_backing* backing;
+};
+
+struct image_mapping {
+  avl_node_t node;
+  virt_context_ptr_t context;
+  list_manager_ptr_t segment;
+};
+
+typedef struct image_backing image_backing_t;
+typedef struct image_backing *image_backing_ptr_t;
+typedef struct image_segment image_segment_t;
+typedef struct image_segment *image_segment_ptr_t;
+typedef struct image_mapping image_mapping_t;
+typedef struct image_mapping *image_mapping_ptr_t;
+
+#define IMAGE_MAPPING_GET_BLOCK( n ) \
+  ( image_mapping_ptr_t )( ( uint8_t* )n - offsetof( image_mapping_t, node ) )
+
+bool image_init( void );
+image_backing_ptr_t image_backing_create( virt_context_ptr_t, uintptr_t, size_t, bool );
+image_backing_ptr_t image_backing_copy( uintptr_t, size_t );
+void image_backing_release( image_backing_ptr_t );
+bool image_backing_read( image_backing_ptr_t, size_t, void*, size_t );
+bool image_add_segment( virt_context_ptr_t, image_backing_ptr_t, uintptr_t, size_t, size_t, size_t, uint32_t );
+bool image_handle_fault( virt_context_ptr_t, uintptr_t );
+void image_populate_range( virt_context_ptr_t, uintptr_t, size_t );
+bool image_address_is_image( virt_context_ptr_t, uintptr_t, size_t );
+bool image_fork( virt_context_ptr_t, virt_context_ptr_t );
+void image_cleanup( virt_context_ptr_t );
+
+#endif
@@ -100,10 +100,10 @@ static void destroy_entry( shared_memory_entry_ptr_t entry ) {
   }
   // free address list
   if ( entry->address ) {
-    // free pages again
+    // free pages again if not borrowed from parent area
     for (
       size_t count = entry->size / PAGE_SIZE, idx = 0;
-      idx < count;
+      ! entry->parent && idx < count;
       idx++
     ) {
       if ( 0 != entry->address[ idx ] ) {
@@ -117,6 +117,18 @@ static void destroy_entry( shared_memory_entry_ptr_t entry ) {
   if ( entry->process_mapping ) {
     list_destruct( entry->process_mapping );
   }
+  // release parent and destroy it if no longer used
+  shared_memory_entry_ptr_t parent = entry->parent;
+  if ( parent ) {
+    parent->child_count--;
+    if (
+      0 == parent->child_count
+      && list_empty( parent->process_mapping )
+    ) {
+      avl_remove_by_node( shared_tree, &parent->node );
+      destroy_entry( parent );
+    }
+  }
   // free rest of structure
   free( entry );
 }
@@ -234,13 +246,14 @@ bool shared_memory_init( void ) {
 }
 
 /**
- * @fn size_t shared_memory_create(size_t)
+ * @fn size_t shared_memory_create(task_process_ptr_t, size_t)
  * @brief Create new shared memory area
  *
+ * @param process
  * @param len shared area size
  * @return
  */
-size_t shared_memory_create( size_t len ) {
+size_t shared_memory_create( task_process_ptr_t process, size_t len ) {
   // debug output
   #if defined( PRINT_MM_SHARED )
     DEBUG_OUTPUT( "shared_memory_create( %zu )\r\n", len )
@@ -254,6 +267,7 @@ size_t shared_memory_create( size_t len ) {
   if ( ! entry ) {
     return 0;
   }
+  entry->creator = process->id;
   // prepare node
   avl_prepare_node( &entry->node, ( void* )entry->id );
   // add new item to tree
@@ -385,6 +399,10 @@ uintptr_t shared_memory_attach(
   uintptr_t start = virt;
   uintptr_t end = start + entry->size;
   size_t idx = 0;
+  // sealed areas are mapped read only and may contain shared text
+  uint32_t page = entry->sealed
+    ? VIRT_PAGE_TYPE_READ | VIRT_PAGE_TYPE_EXECUTABLE
+    : VIRT_PAGE_TYPE_READ | VIRT_PAGE_TYPE_WRITE;
   // map addresses
   while ( start < end ) {
     // debug output
@@ -397,7 +415,7 @@ uintptr_t shared_memory_attach(
       start,
       entry->address[ idx ],
       VIRT_MEMORY_TYPE_NORMAL,
-      VIRT_PAGE_TYPE_READ | VIRT_PAGE_TYPE_WRITE
+      page
     ) ) {
       // debug output
       #if defined( PRINT_MM_SHARED )
@@ -436,6 +454,9 @@ uintptr_t shared_memory_attach(
     free( mapped );
     return 0;
   }
+  // attached areas are released by detach
+  entry->creator = 0;
+  entry->receiver = 0;
   // debug output
   #if defined( PRINT_MM_SHARED )
     DEBUG_OUTPUT( "Area %d successfully mapped to %#x\r\n", id, mapped->start )
@@ -487,6 +508,12 @@ bool shared_memory_detach( task_process_ptr_t process, size_t id ) {
     #if defined( PRINT_MM_SHARED )
       DEBUG_OUTPUT( "Process has not mapped the area\r\n" )
     #endif
+    // release never attached area by creator or receiver, such area is
+    // neither mapped nor parent of granted ones
+    if ( entry->creator == process->id || entry->receiver == process->id ) {
+      avl_remove_by_node( shared_tree, &entry->node );
+      destroy_entry( entry );
+    }
     return true;
   }
   // remove from list with destruction of item
@@ -497,8 +524,8 @@ bool shared_memory_detach( task_process_ptr_t process, size_t id ) {
     #endif
     return false;
   }
-  // handle empty ( delete shared area )
-  if ( list_empty( entry->process_mapping ) ) {
+  // handle empty and not referenced by granted areas ( delete shared area )
+  if ( list_empty( entry->process_mapping ) && 0 == entry->child_count ) {
     // debug output
     #if defined( PRINT_MM_SHARED )
       DEBUG_OUTPUT( "Remove area from available tree %#x, %#x\r\n",
@@ -517,6 +544,241 @@ bool shared_memory_detach( task_process_ptr_t process, size_t id ) {
   return true;
 }
 
+/**
+ * @fn bool shared_memory_seal(task_process_ptr_t, size_t)
+ * @brief Seal shared memory area, so that it's read only for all processes
+ *
+ * @param process
+ * @param id
+ * @return
+ *
+ * @note only a process having the area attached is allowed to seal it
+ */
+bool shared_memory_seal( task_process_ptr_t process, size_t id ) {
+  // debug output
+  #if defined( PRINT_MM_SHARED )
+    DEBUG_OUTPUT( "shared_memory_seal( %d, %zu )\r\n", process->id, id )
+  #endif
+  // handle not initialized
+  if ( ! shared_tree ) {
+    return false;
+  }
+  // try to get node by id
+  avl_node_ptr_t node = avl_find_by_data( shared_tree, ( void* )id );
+  if ( ! node ) {
+    return false;
+  }
+  shared_memory_entry_ptr_t entry = SHARED_ENTRY_GET_BLOCK( node );
+  // ensure that the process has the area attached
+  if ( ! list_lookup_data( entry->process_mapping, process ) ) {
+    return false;
+  }
+  // nothing to do if already sealed
+  if ( entry->sealed ) {
+    return true;
+  }
+  entry->sealed = true;
+  entry->owner = process->id;
+  // remap all existing mappings read only
+  list_item_ptr_t current = entry->process_mapping->first;
+  while ( current ) {
+    shared_memory_entry_mapped_ptr_t mapped = ( shared_memory_entry_mapped_ptr_t )
+      current->data;
+    virt_context_ptr_t ctx = mapped->process->virtual_context;
+    for ( size_t idx = 0; idx < entry->size / PAGE_SIZE; idx++ ) {
+      uintptr_t virt = mapped->start + idx * PAGE_SIZE;
+      // unmap without freeing physical page and map again read only
+      if (
+        ! virt_unmap_address( ctx, virt, false )
+        || ! virt_map_address(
+          ctx,
+          virt,
+          entry->address[ idx ],
+          VIRT_MEMORY_TYPE_NORMAL,
+          VIRT_PAGE_TYPE_READ | VIRT_PAGE_TYPE_EXECUTABLE
+        )
+      ) {
+        // debug output
+        #if defined( PRINT_MM_SHARED )
+          DEBUG_OUTPUT( "Error while remapping %#"PRIxPTR"\r\n", virt )
+        #endif
+        return false;
+      }
+    }
+    // next one
+    current = current->next;
+  }
+  // return success
+  return true;
+}
+
+/**
+ * @fn size_t shared_memory_grant(task_process_ptr_t, uintptr_t, size_t, pid_t)
+ * @brief Create sealed area sharing existing pages of an attached area
+ *
+ * @param process
+ * @param start page aligned start within an attached area
+ * @param len
+ * @param receiver process the area is passed to or 0
+ * @return id of new area or 0 on error
+ *
+ * @note pages stay owned by the attached area, which is kept alive until all
+ * granted areas are destroyed
+ */
+size_t shared_memory_grant(
+  task_process_ptr_t process,
+  uintptr_t start,
+  size_t len,
+  pid_t receiver
+) {
+  // debug output
+  #if defined( PRINT_MM_SHARED )
+    DEBUG_OUTPUT( "shared_memory_grant( %d, %#"PRIxPTR", %zx )\r\n",
+      process->id, start, len )
+  #endif
+  // handle not initialized or invalid
+  if (
+    ! shared_tree
+    || 0 == len
+    || ROUND_PAGE_OFFSET( start )
+    || start + len < start
+  ) {
+    return 0;
+  }
+  len = ROUND_UP_TO_FULL_PAGE( len );
+  // find attached area containing range
+  shared_memory_entry_ptr_t parent = NULL;
+  shared_memory_entry_mapped_ptr_t mapped = NULL;
+  avl_node_ptr_t node = avl_iterate_first( shared_tree );
+  while ( NULL != node && ! parent ) {
+    shared_memory_entry_ptr_t entry = SHARED_ENTRY_GET_BLOCK( node );
+    list_item_ptr_t item = list_lookup_data( entry->process_mapping, process );
+    if ( item ) {
+      mapped = ( shared_memory_entry_mapped_ptr_t )item->data;
+      if (
+        mapped->start <= start
+        && start + len <= mapped->start + mapped->size
+      ) {
+        parent = entry;
+      }
+    }
+    node = avl_iterate_next( shared_tree, node );
+  }
+  if ( ! parent ) {
+    return 0;
+  }
+  // allocate entry
+  shared_memory_entry_ptr_t entry = ( shared_memory_entry_ptr_t )malloc(
+    sizeof( shared_memory_entry_t )
+  );
+  if ( ! entry ) {
+    return 0;
+  }
+  entry = memset( entry, 0, sizeof( shared_memory_entry_t ) );
+  // borrow pages of parent
+  entry->address = ( uint64_t* )malloc( len / PAGE_SIZE * sizeof( uint64_t ) );
+  if ( ! entry->address ) {
+    free( entry );
+    return 0;
+  }
+  memcpy(
+    entry->address,
+    parent->address + ( start - mapped->start ) / PAGE_SIZE,
+    len / PAGE_SIZE * sizeof( uint64_t )
+  );
+  entry->process_mapping = list_construct( lookup_process, cleanup_process, NULL );
+  if ( ! entry->process_mapping ) {
+    free( entry->address );
+    free( entry );
+    return 0;
+  }
+  // populate remaining data
+  entry->id = generate_shared_memory_id();
+  entry->size = len;
+  entry->sealed = true;
+  entry->owner = process->id;
+  entry->creator = process->id;
+  entry->receiver = receiver;
+  // prepare node and add to tree
+  avl_prepare_node( &entry->node, ( void* )entry->id );
+  if ( ! avl_insert_by_node( shared_tree, &entry->node ) ) {
+    list_destruct( entry->process_mapping );
+    free( entry->address );
+    free( entry );
+    return 0;
+  }
+  // reference parent
+  entry->parent = parent;
+  parent->child_count++;
+  // return id of new shared area
+  return entry->id;
+}
+
+/**
+ * @fn size_t shared_memory_size(task_process_ptr_t, size_t)
+ * @brief Get size of an attached area
+ *
+ * @param process
+ * @param id
+ * @return size in bytes or 0 if not attached by process
+ */
+size_t shared_memory_size( task_process_ptr_t process, size_t id ) {
+  // debug output
+  #if defined( PRINT_MM_SHARED )
+    DEBUG_OUTPUT( "shared_memory_size( %d, %zu )\r\n", process->id, id )
+  #endif
+  // handle not initialized
+  if ( ! shared_tree ) {
+    return 0;
+  }
+  // try to get node by id
+  avl_node_ptr_t node = avl_find_by_data( shared_tree, ( void* )id );
+  if ( ! node ) {
+    return 0;
+  }
+  shared_memory_entry_ptr_t entry = SHARED_ENTRY_GET_BLOCK( node );
+  // only the mapped size is of interest
+  if ( ! list_lookup_data( entry->process_mapping, process ) ) {
+    return 0;
+  }
+  return entry->size;
+}
+
+/**
+ * @fn pid_t shared_memory_owner(task_process_ptr_t, size_t)
+ * @brief Get process that sealed or granted an attached area
+ *
+ * @param process
+ * @param id
+ * @return process id or 0 if not attached by process or not sealed
+ *
+ * @note writable areas have no owner, as every attached process may change
+ * the content
+ */
+pid_t shared_memory_owner( task_process_ptr_t process, size_t id ) {
+  // debug output
+  #if defined( PRINT_MM_SHARED )
+    DEBUG_OUTPUT( "shared_memory_owner( %d, %zu )\r\n", process->id, id )
+  #endif
+  // handle not initialized
+  if ( ! shared_tree ) {
+    return 0;
+  }
+  // try to get node by id
+  avl_node_ptr_t node = avl_find_by_data( shared_tree, ( void* )id );
+  if ( ! node ) {
+    return 0;
+  }
+  shared_memory_entry_ptr_t entry = SHARED_ENTRY_GET_BLOCK( node );
+  if (
+    ! entry->sealed
+    || ! list_lookup_data( entry->process_mapping, process )
+  ) {
+    return 0;
+  }
+  return entry->owner;
+}
+
 /**
  * @fn bool shared_memory_address_is_shared(task_process_ptr_t, uintptr_t, size_t)
  * @brief Check if area is somehow in shared
@@ -625,9 +887,18 @@ bool shared_memory_cleanup_process( task_process_ptr_t proc ) {
   while ( NULL != node ) {
     // get mapped entry
     shared_memory_entry_ptr_t entry = SHARED_ENTRY_GET_BLOCK( node );
-    // detach shared memory
-    if ( ! shared_memory_detach( proc, entry->id ) ) {
-      return false;
+    // detach and restart, as detach may destroy several areas, never
+    // attached areas of the process are released the same way
+    if (
+      list_lookup_data( entry->process_mapping, proc )
+      || entry->creator == proc->id
+      || entry->receiver == proc->id
+    ) {
+      if ( ! shared_memory_detach( proc, entry->id ) ) {
+        return false;
+      }
+      node = avl_iterate_first( shared_tree );
+      continue;
     }
     // get next
     node = avl_iterate_next( shared_tree, node );
@@ -33,6 +33,13 @@ struct shared_memory_entry {
   size_t id;
   size_t size;
   size_t use_count;
+  bool sealed;
+  pid_t owner;
+  // never attached area is destroyed when creator or receiver exits
+  pid_t creator;
+  pid_t receiver;
+  size_t child_count;
+  struct shared_memory_entry* parent;
   list_manager_ptr_t process_mapping;
 };
 
@@ -51,9 +58,13 @@ typedef struct shared_memory_entry_mapped *shared_memory_entry_mapped_ptr_t;
   ( shared_memory_entry_ptr_t )( ( uint8_t* )n - offsetof( shared_memory_entry_t, node ) )
 
 bool shared_memory_init( void );
-size_t shared_memory_create( size_t );
+size_t shared_memory_create( task_process_ptr_t, size_t );
 uintptr_t shared_memory_attach( task_process_ptr_t, task_thread_ptr_t, size_t, uintptr_t );
 bool shared_memory_detach( task_process_ptr_t, size_t );
+bool shared_memory_seal( task_process_ptr_t, size_t );
+size_t shared_memory_grant( task_process_ptr_t, uintptr_t, size_t, pid_t );
+size_t shared_memory_size( task_process_ptr_t, size_t );
+pid_t shared_memory_owner( task_process_ptr_t, size_t );
 bool shared_memory_address_is_shared( task_process_ptr_t, uintptr_t, size_t );
 bool shared_memory_fork( task_process_ptr_t, task_process_ptr_t );
 bool shared_memory_cleanup_process( task_process_ptr_t );
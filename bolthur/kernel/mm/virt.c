@@ -32,6 +32,7 @@
 #include "../mm/phys.h"
 #include "../mm/virt.h"
 #include "../mm/heap.h"
+#include "../mm/image.h"
 
 /**
  * @brief static initialized flag
@@ -104,7 +105,9 @@ void virt_init( void ) {
   // map from start to end addresses as used
   while ( start < end ) {
     virt_memory_type_t type = VIRT_MEMORY_TYPE_NORMAL;
-    uint32_t page = VIRT_PAGE_TYPE_EXECUTABLE;
+    uint32_t page = VIRT_PAGE_TYPE_READ
+      | VIRT_PAGE_TYPE_WRITE
+      | VIRT_PAGE_TYPE_EXECUTABLE;
     if ( start >= initial_heap_start && start <= initial_heap_end ) {
       type = VIRT_MEMORY_TYPE_NORMAL_NC;
       page = VIRT_PAGE_TYPE_READ | VIRT_PAGE_TYPE_WRITE;
@@ -249,8 +252,8 @@ bool virt_is_mapped_in_context_range(
   uintptr_t address,
   size_t size
 ) {
-  uintptr_t start = address;
-  uintptr_t end = start + size;
+  uintptr_t start = ROUND_DOWN_TO_FULL_PAGE( address );
+  uintptr_t end = address + size;
   // loop until end
   while ( start < end ) {
     // return false if not mapped
@@ -264,6 +267,36 @@ bool virt_is_mapped_in_context_range(
   return true;
 }
 
+/**
+ * @fn bool virt_is_writable_in_context_range(virt_context_ptr_t, uintptr_t, size_t)
+ * @brief Method to check for range is mapped writable in context
+ *
+ * @param ctx context to use
+ * @param address start address of range
+ * @param size range size
+ * @return true range is completely mapped writable
+ * @return false range is not or incompletely mapped writable
+ */
+bool virt_is_writable_in_context_range(
+  virt_context_ptr_t ctx,
+  uintptr_t address,
+  size_t size
+) {
+  uintptr_t start = ROUND_DOWN_TO_FULL_PAGE( address );
+  uintptr_t end = address + size;
+  // loop until end
+  while ( start < end ) {
+    // return false if not mapped writable
+    if ( ! virt_is_writable_in_context( ctx, start ) ) {
+      return false;
+    }
+    // get next page
+    start  += PAGE_SIZE;
+  }
+  // return success
+  return true;
+}
+
 /**
  * @brief Method to check for range is mapped
  *
@@ -273,8 +306,8 @@ bool virt_is_mapped_in_context_range(
  * @return false range is not or incompletely mapped
  */
 bool virt_is_mapped_range( uintptr_t address, size_t size ) {
-  uintptr_t start = address;
-  uintptr_t end = start + size;
+  uintptr_t start = ROUND_DOWN_TO_FULL_PAGE( address );
+  uintptr_t end = address + size;
   // loop until end
   while ( start < end ) {
     // return false if not mapped
@@ -361,8 +394,11 @@ uintptr_t virt_find_free_page_range(
   bool stop = false;
 
   while ( min <= max && !stop ) {
-    // skip if mapped
-    if ( virt_is_mapped_in_context( ctx, min ) ) {
+    // skip if mapped or reserved by demand paged image
+    if (
+      virt_is_mapped_in_context( ctx, min )
+      || image_address_is_image( ctx, min, PAGE_SIZE )
+    ) {
       // reset possible found amount and set address
       found_amount = 0;
       address = 0;
@@ -31,10 +31,11 @@ typedef enum {
   VIRT_MEMORY_TYPE_NORMAL_NC
 } virt_memory_type_t;
 
+// page types are combinable flags
 typedef enum {
-  VIRT_PAGE_TYPE_READ = 1,
-  VIRT_PAGE_TYPE_WRITE,
-  VIRT_PAGE_TYPE_EXECUTABLE,
+  VIRT_PAGE_TYPE_READ = 1 << 0,
+  VIRT_PAGE_TYPE_WRITE = 1 << 1,
+  VIRT_PAGE_TYPE_EXECUTABLE = 1 << 2,
 } virt_page_type_t;
 
 typedef enum {
@@ -93,6 +94,8 @@ bool virt_prepare_temporary( virt_context_ptr_t );
 
 bool virt_is_mapped_in_context_range( virt_context_ptr_t, uintptr_t, size_t );
 bool virt_is_mapped_in_context( virt_context_ptr_t, uintptr_t );
+bool virt_is_writable_in_context_range( virt_context_ptr_t, uintptr_t, size_t );
+bool virt_is_writable_in_context( virt_context_ptr_t, uintptr_t );
 bool virt_is_mapped_range( uintptr_t, size_t );
 bool virt_is_mapped( uintptr_t );
 
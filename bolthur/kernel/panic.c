@@ -24,12 +24,15 @@
 #include "lib/stdlib.h"
 #include "interrupt.h"
 #include "panic.h"
+#include "tty.h"
 
 /**
  * @brief Initialize panic process
  */
 void panic_init( void ) {
   interrupt_toggle( INTERRUPT_TOGGLE_OFF );
+  // interrupt driven output isn't served anymore
+  tty_sync();
 }
 
 /**
@@ -33,94 +33,74 @@
  * @param num number to validate
  * @return true if interrupt is valid
  * @return false if interrupt is invalid
+ *
+ * @note numbers 0 - 63 are gpu interrupts, 64 - 71 basic arm interrupts
  */
 bool interrupt_validate_number( size_t num ) {
   return ! (
-    num != 1 && num != 8
+    num != 1 && num != 3
     && num != 29 && num != 43
     && num != 45 && num != 46
     && num != 48 && num != 49
     && num != 50 && num != 51
     && num != 52 && num != 53
     && num != 54 && num != 55
-    && num != 57
+    && num != 57 && num != 65
   );
 }
 
 /**
- * @fn void interrupt_enable_specific(int8_t)
+ * @fn uint32_t interrupt_register_offset(int8_t, uint32_t*)
+ * @brief Helper to get enable register offset and bit of interrupt
+ *
+ * @param num interrupt number
+ * @param bit bit within register
+ * @return offset of enable register, disable register follows at 0xC
+ */
+static uint32_t interrupt_register_offset( int8_t num, uint32_t* bit ) {
+  if ( 0 > num || 72 <= num ) {
+    PANIC( "Unsupported interrupt number!" )
+  }
+  *bit = 1U << ( num % 32 );
+  if ( 32 > num ) {
+    return INTERRUPT_ENABLE_IRQ_1;
+  } else if ( 64 > num ) {
+    return INTERRUPT_ENABLE_IRQ_2;
+  }
+  return INTERRUPT_ENABLE_IRQ_BASIC;
+}
+
+/**
+ * @fn void interrupt_mask_specific(int8_t)
  * @brief Enable specific interrupt
  *
  * @param num interrupt number to enable
  */
 void interrupt_mask_specific( int8_t num ) {
-  uint32_t interrupt = ( uint32_t )num;
+  uint32_t bit;
+  uint32_t offset = interrupt_register_offset( num, &bit );
   // get peripheral base
   uintptr_t base = peripheral_base_get( PERIPHERAL_GPIO );
-  // get interrupt enable and pending
-  uintptr_t interrupt_to_enable = base;
-  uintptr_t interrupt_pending = base;
-  if ( 32 > interrupt ) {
-    interrupt_to_enable += INTERRUPT_ENABLE_IRQ_1;
-    interrupt_pending += INTERRUPT_IRQ_PENDING_1;
-  } else if ( 64 > interrupt ) {
-    interrupt_to_enable += INTERRUPT_ENABLE_IRQ_2;
-    interrupt_pending += INTERRUPT_IRQ_PENDING_2;
-  } else {
-    PANIC( "Unsupported interrupt number!" )
-  }
-  // get and set interrupt enable
-  uint32_t interrupt_line = io_in32( interrupt_to_enable );
-  // stop if already set
-  if ( interrupt_line & interrupt ) {
-    return;
-  }
-  interrupt_line |= interrupt;
-  // write changes
-  io_out32( interrupt_to_enable, interrupt_line );
-  // get and clear pending interrupt from memory
-  interrupt_line = io_in32( interrupt_pending );
-  interrupt_line &= ~interrupt;
-  // write changes
-  io_out32( interrupt_pending, interrupt_line );
+  // enable registers are write one to set
+  io_out32( base + offset, bit );
 }
 
 /**
- * @fn void interrupt_disable_specific(int8_t)
+ * @fn void interrupt_unmask_specific(int8_t)
  * @brief Disable specific interrupt
  *
  * @param num interrupt number to disable
  */
 void interrupt_unmask_specific( int8_t num ) {
-  uint32_t interrupt = ( uint32_t )num;
+  uint32_t bit;
+  uint32_t offset = interrupt_register_offset( num, &bit );
   // get peripheral base
-  uint32_t base = ( uint32_t )peripheral_base_get( PERIPHERAL_GPIO );
-  // get interrupt enable and pending
-  uint32_t interrupt_to_disable = base;
-  uint32_t interrupt_pending = base;
-  if ( 32 > interrupt ) {
-    interrupt_to_disable += INTERRUPT_ENABLE_IRQ_1;
-    interrupt_pending += INTERRUPT_IRQ_PENDING_1;
-  } else if ( 64 > interrupt ) {
-    interrupt_to_disable += INTERRUPT_ENABLE_IRQ_2;
-    interrupt_pending += INTERRUPT_IRQ_PENDING_2;
-  } else {
-    PANIC( "Unsupported interrupt number!" )
-  }
-  // get and clear interrupt enable
-  uint32_t interrupt_line = io_in32( interrupt_to_disable );
-  // stop if already set
-  if ( interrupt_line & ~interrupt ) {
-    return;
-  }
-  interrupt_line &= ~interrupt;
-  // write changes
-  io_out32( interrupt_to_disable, interrupt_line );
-  // get and clear pending interrupt from memory
-  interrupt_line = io_in32( interrupt_pending );
-  interrupt_line &= ~interrupt;
-  // write changes
-  io_out32( interrupt_pending, interrupt_line );
+  uintptr_t base = peripheral_base_get( PERIPHERAL_GPIO );
+  // disable registers are write one to clear
+  io_out32(
+    base + offset + ( INTERRUPT_DISABLE_IRQ_1 - INTERRUPT_ENABLE_IRQ_1 ),
+    bit
+  );
 }
 
 /**
@@ -152,6 +132,13 @@ int8_t interrupt_get_pending( bool fast ) {
         return ( int8_t )( i + 32 );
       }
     }
+    // arm specific interrupts like mailbox are only within basic pending
+    uint32_t basic = io_in32( base + INTERRUPT_IRQ_BASIC_PENDING ) & 0xFF;
+    for ( int8_t i = 0; i < 8; ++i ) {
+      if ( basic & ( 1U << i ) ) {
+        return ( int8_t )( i + 64 );
+      }
+    }
   // fast interrupt handling
   } else {
     // get set interrupt
@@ -29,12 +29,24 @@
 #include "../../serial.h"
 #include "../../interrupt.h"
 #include "../../event.h"
+#include "../../lib/stdio.h"
 #if defined( PRINT_SERIAL )
   #include "../../debug/debug.h"
 #endif
 
 #define MAX_SERIAL_BUFFER 500
 
+// transmit ring, size has to be a power of two
+#define SERIAL_TX_RING_SIZE 4096
+#define SERIAL_TX_RING_MASK ( SERIAL_TX_RING_SIZE - 1 )
+// slot contains published character
+#define SERIAL_TX_SLOT_VALID 0x100
+// depth of pl011 transmit fifo
+#define SERIAL_TX_BURST 16
+
+#define SERIAL_FLAG_TX_FULL ( 1 << 5 )
+#define SERIAL_INTERRUPT_TX ( 1 << 5 )
+
 /**
  * @brief Initialized flag
  */
@@ -50,6 +62,34 @@ static uint8_t serial_buffer[ MAX_SERIAL_BUFFER ];
  */
 static uint32_t index;
 
+/**
+ * @brief transmit ring, producers reserve slots via head and publish them by
+ * setting the valid flag, only one drain consumes at tail
+ */
+static volatile uint16_t serial_tx_ring[ SERIAL_TX_RING_SIZE ];
+static volatile uint32_t serial_tx_head = 0;
+static volatile uint32_t serial_tx_tail = 0;
+static volatile uint32_t serial_tx_busy = 0;
+
+/**
+ * @brief amount of characters dropped due to full ring
+ */
+static volatile size_t serial_tx_dropped = 0;
+
+/**
+ * @brief overflow policy, gdb protocol must not lose characters
+ */
+#if defined( REMOTE_DEBUG )
+  static serial_overflow_t serial_tx_overflow = SERIAL_OVERFLOW_BLOCK;
+#else
+  static serial_overflow_t serial_tx_overflow = SERIAL_OVERFLOW_DROP;
+#endif
+
+/**
+ * @brief ring is used after transmit interrupt was registered until panic
+ */
+static volatile bool serial_tx_interrupt = false;
+
 /**
  * @brief Method to get serial buffer
  *
@@ -158,6 +198,14 @@ static void serial_clear( __unused void* context ) {
   uint32_t base = ( uint32_t )peripheral_base_get( PERIPHERAL_GPIO );
   // get interrupt state
   uint32_t state = io_in32( base + UARTMIS );
+  // transmit fifo below level
+  if ( state & SERIAL_INTERRUPT_TX ) {
+    serial_tx_drain();
+    state &= ( uint32_t )~SERIAL_INTERRUPT_TX;
+    if ( ! state ) {
+      return;
+    }
+  }
 
   // loop until flag will be reset
   while (
@@ -215,6 +263,127 @@ bool serial_register_interrupt( void ) {
   return true;
 }
 
+/**
+ * @fn void serial_tx_interrupt_clear(void*)
+ * @brief Transmit interrupt callback
+ *
+ * @param context cpu context
+ */
+static void serial_tx_interrupt_clear( __unused void* context ) {
+  serial_tx_drain();
+}
+
+/**
+ * @fn bool serial_register_tx_interrupt(void)
+ * @brief Switch output to interrupt driven transmission
+ *
+ * @return
+ */
+bool serial_register_tx_interrupt( void ) {
+  // handle not initialized
+  if ( ! serial_initialized ) {
+    return true;
+  }
+  // get peripheral base
+  uint32_t base = ( uint32_t )peripheral_base_get( PERIPHERAL_GPIO );
+  // raise transmit interrupt when fifo is at most 1/8 full
+  io_out32( base + UARTIFLS, io_in32( base + UARTIFLS ) & ~0x7U );
+  // remote debugging routes uart as fast interrupt to serial_clear
+  #if ! defined( REMOTE_DEBUG )
+    if ( ! interrupt_register_handler(
+      57,
+      serial_tx_interrupt_clear,
+      NULL,
+      INTERRUPT_NORMAL,
+      false,
+      true
+    ) ) {
+      return false;
+    }
+  #else
+    ( void )serial_tx_interrupt_clear;
+  #endif
+  serial_tx_interrupt = true;
+  return true;
+}
+
+/**
+ * @fn void serial_putc_polling(uint8_t)
+ * @brief Put character by waiting for fifo space
+ *
+ * @param c character to put
+ */
+static void serial_putc_polling( uint8_t c ) {
+  // get peripheral base
+  uint32_t base = ( uint32_t )peripheral_base_get( PERIPHERAL_GPIO );
+
+  // Wait for UART to become ready to transmit.
+  while ( 0 != ( io_in32( base + UARTFR ) & SERIAL_FLAG_TX_FULL ) ) { }
+  io_out8( base + UARTDR, c );
+}
+
+/**
+ * @fn void serial_tx_drain(void)
+ * @brief Move up to one fifo burst from ring to uart
+ *
+ * @note transmit interrupt is only enabled while a published character is
+ * waiting, producers kick the drain after publishing
+ */
+void serial_tx_drain( void ) {
+  // get peripheral base
+  uint32_t base = ( uint32_t )peripheral_base_get( PERIPHERAL_GPIO );
+  while ( true ) {
+    // only one drain at a time, the running one rechecks after release
+    if ( ! __sync_bool_compare_and_swap( &serial_tx_busy, 0, 1 ) ) {
+      return;
+    }
+    uint32_t tail = serial_tx_tail;
+    for (
+      uint32_t count = 0;
+      count < SERIAL_TX_BURST
+        && tail != serial_tx_head
+        && ! ( io_in32( base + UARTFR ) & SERIAL_FLAG_TX_FULL );
+      count++
+    ) {
+      uint16_t slot = serial_tx_ring[ tail & SERIAL_TX_RING_MASK ];
+      // stop at slot reserved but not yet published
+      if ( ! ( slot & SERIAL_TX_SLOT_VALID ) ) {
+        break;
+      }
+      serial_tx_ring[ tail & SERIAL_TX_RING_MASK ] = 0;
+      io_out8( base + UARTDR, ( uint8_t )slot );
+      tail++;
+    }
+    __sync_synchronize();
+    serial_tx_tail = tail;
+    // enable transmit interrupt only if published data is waiting
+    bool waiting = tail != serial_tx_head
+      && ( serial_tx_ring[ tail & SERIAL_TX_RING_MASK ] & SERIAL_TX_SLOT_VALID );
+    uint32_t mask = io_in32( base + UARTIMSC );
+    if ( waiting ) {
+      mask |= SERIAL_INTERRUPT_TX;
+    } else {
+      mask &= ~( uint32_t )SERIAL_INTERRUPT_TX;
+    }
+    io_out32( base + UARTIMSC, mask );
+    __sync_synchronize();
+    serial_tx_busy = 0;
+    __sync_synchronize();
+    // interrupt continues with waiting data
+    if ( waiting ) {
+      return;
+    }
+    // retry if data was published after the check, its kick may have been lost
+    tail = serial_tx_tail;
+    if (
+      tail == serial_tx_head
+      || ! ( serial_tx_ring[ tail & SERIAL_TX_RING_MASK ] & SERIAL_TX_SLOT_VALID )
+    ) {
+      return;
+    }
+  }
+}
+
 /**
  * @brief Put character to serial
  *
@@ -225,13 +394,96 @@ void serial_putc( uint8_t c ) {
   if ( ! serial_initialized ) {
     return;
   }
-
+  // synchronous output until interrupt is registered or after panic
+  if ( ! serial_tx_interrupt ) {
+    serial_putc_polling( c );
+    return;
+  }
   // get peripheral base
   uint32_t base = ( uint32_t )peripheral_base_get( PERIPHERAL_GPIO );
+  // reserve slot
+  uint32_t head;
+  while ( true ) {
+    head = serial_tx_head;
+    uint32_t tail = serial_tx_tail;
+    if ( SERIAL_TX_RING_SIZE <= head - tail ) {
+      if ( SERIAL_OVERFLOW_DROP == serial_tx_overflow ) {
+        __sync_fetch_and_add( &serial_tx_dropped, 1 );
+        return;
+      }
+      // block by draining as fifo space becomes available
+      serial_tx_drain();
+      if (
+        tail != serial_tx_tail
+        || ( io_in32( base + UARTFR ) & SERIAL_FLAG_TX_FULL )
+      ) {
+        continue;
+      }
+      // drain held by interrupted code or stopped at unpublished slot, so
+      // bypass the ring instead of waiting for it
+      serial_putc_polling( c );
+      return;
+    }
+    if ( __sync_bool_compare_and_swap( &serial_tx_head, head, head + 1 ) ) {
+      break;
+    }
+  }
+  // publish character and kick drain
+  serial_tx_ring[ head & SERIAL_TX_RING_MASK ] = ( uint16_t )(
+    c | SERIAL_TX_SLOT_VALID
+  );
+  __sync_synchronize();
+  serial_tx_drain();
+}
 
-  // Wait for UART to become ready to transmit.
-  while ( 0 != ( io_in32( base + UARTFR ) & ( 1 << 5 ) ) ) { }
-  io_out8( base + UARTDR, c );
+/**
+ * @fn void serial_set_overflow(serial_overflow_t)
+ * @brief Set behaviour when transmit ring is full
+ *
+ * @param policy
+ */
+void serial_set_overflow( serial_overflow_t policy ) {
+  serial_tx_overflow = policy;
+}
+
+/**
+ * @fn size_t serial_dropped(void)
+ * @brief Get amount of characters dropped due to full transmit ring
+ *
+ * @return
+ */
+size_t serial_dropped( void ) {
+  return serial_tx_dropped;
+}
+
+/**
+ * @fn void serial_sync(void)
+ * @brief Write out published characters and switch back to polling
+ *
+ * @note used by panic, where interrupts are no longer served
+ */
+void serial_sync( void ) {
+  // handle not initialized
+  if ( ! serial_initialized || ! serial_tx_interrupt ) {
+    return;
+  }
+  serial_tx_interrupt = false;
+  __sync_synchronize();
+  uint32_t tail = serial_tx_tail;
+  while ( tail != serial_tx_head ) {
+    uint16_t slot = serial_tx_ring[ tail & SERIAL_TX_RING_MASK ];
+    // interrupted producer won't publish anymore
+    if ( ! ( slot & SERIAL_TX_SLOT_VALID ) ) {
+      break;
+    }
+    serial_putc_polling( ( uint8_t )slot );
+    tail++;
+  }
+  serial_tx_tail = tail;
+  // report output lost before
+  if ( serial_dropped() ) {
+    printf( "\r\nserial: %zu characters dropped\r\n", serial_dropped() );
+  }
 }
 
 /**
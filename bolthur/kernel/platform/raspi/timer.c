@@ -115,7 +115,7 @@ void timer_platform_init( void ) {
 
   // register handler
   interrupt_register_handler(
-    SYSTEM_TIMER_3_INTERRUPT,
+    SYSTEM_TIMER_3_IRQ,
     timer_clear,
     NULL,
     INTERRUPT_NORMAL,
@@ -134,7 +134,7 @@ void timer_platform_init( void ) {
   // enable timer 3
   io_out32( base + SYSTEM_TIMER_CONTROL, SYSTEM_TIMER_MATCH_3 );
   // enable interrupt
-  interrupt_mask_specific( SYSTEM_TIMER_3_INTERRUPT );
+  interrupt_mask_specific( SYSTEM_TIMER_3_IRQ );
 }
 
 /**
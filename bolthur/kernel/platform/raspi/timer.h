@@ -38,5 +38,8 @@
 #define SYSTEM_TIMER_2_INTERRUPT ( 1 << 2 )
 #define SYSTEM_TIMER_3_INTERRUPT ( 1 << 3 )
 
+// timer interrupt numbers
+#define SYSTEM_TIMER_3_IRQ 3
+
 
 #endif
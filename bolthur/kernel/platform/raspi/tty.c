@@ -42,3 +42,27 @@ void tty_putc( __maybe_unused uint8_t c ) {
     serial_putc( c );
   #endif
 }
+
+/**
+ * @fn bool tty_register_interrupt(void)
+ * @brief Switch TTY to interrupt driven output
+ *
+ * @return
+ */
+bool tty_register_interrupt( void ) {
+  #if defined( OUTPUT_ENABLE )
+    return serial_register_tx_interrupt();
+  #else
+    return true;
+  #endif
+}
+
+/**
+ * @fn void tty_sync(void)
+ * @brief Write out pending output and continue synchronously
+ */
+void tty_sync( void ) {
+  #if defined( OUTPUT_ENABLE )
+    serial_sync();
+  #endif
+}
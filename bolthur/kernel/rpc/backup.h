@@ -35,6 +35,7 @@ struct rpc_backup {
   bool active;
   bool sync;
   size_t origin_data_id;
+  pid_t origin;
 };
 typedef struct rpc_backup rpc_backup_t;
 typedef struct rpc_backup* rpc_backup_ptr_t;
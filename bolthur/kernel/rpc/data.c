@@ -183,11 +183,12 @@ rpc_data_queue_entry_ptr_t rpc_data_queue_allocate(
 
 
 /**
- * @fn int rpc_data_queue_add(pid_t, pid_t, const char*, size_t, size_t*)
+ * @fn int rpc_data_queue_add(pid_t, pid_t, pid_t, const char*, size_t, size_t*)
  * @brief Method to add rpc data queue entry
  *
  * @param target
  * @param sender
+ * @param origin process the request originates from
  * @param data
  * @param data_length
  * @param rpc_data_queue_id
@@ -196,6 +197,7 @@ rpc_data_queue_entry_ptr_t rpc_data_queue_allocate(
 int rpc_data_queue_add(
   pid_t target,
   pid_t sender,
+  pid_t origin,
   const char* data,
   size_t data_length,
   size_t* rpc_data_queue_id
@@ -246,6 +248,7 @@ int rpc_data_queue_add(
   }
   // prepare structure
   message->sender = sender;
+  message->origin = origin;
   // push message to process queue
   list_push_back( target_process->rpc_data_queue, message );
   // return success
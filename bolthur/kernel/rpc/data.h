@@ -28,6 +28,7 @@
 struct rpc_data_queue_entry {
   size_t id;
   pid_t sender;
+  pid_t origin;
   const char* data;
   size_t length;
 };
@@ -39,7 +40,7 @@ bool rpc_data_queue_setup( task_process_ptr_t );
 void rpc_data_queue_destroy( task_process_ptr_t );
 bool rpc_data_queue_ready( task_process_ptr_t );
 rpc_data_queue_entry_ptr_t rpc_data_queue_allocate( size_t, const char*, size_t* );
-int rpc_data_queue_add( pid_t, pid_t, const char*, size_t, size_t* );
+int rpc_data_queue_add( pid_t, pid_t, pid_t, const char*, size_t, size_t* );
 void rpc_data_queue_remove( pid_t, size_t );
 
 #endif
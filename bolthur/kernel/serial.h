@@ -21,11 +21,22 @@
 #define _SERIAL_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+typedef enum {
+  SERIAL_OVERFLOW_DROP = 0,
+  SERIAL_OVERFLOW_BLOCK,
+} serial_overflow_t;
+
 void serial_init( void );
 bool serial_register_interrupt( void );
+bool serial_register_tx_interrupt( void );
+void serial_tx_drain( void );
 void serial_putc( uint8_t );
+void serial_set_overflow( serial_overflow_t );
+size_t serial_dropped( void );
+void serial_sync( void );
 uint8_t serial_getc( void );
 void serial_flush( void );
 uint8_t* serial_get_buffer( void );
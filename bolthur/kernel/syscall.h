@@ -20,10 +20,6 @@
 #if ! defined( _SYSCALL_H )
 #define _SYSCALL_H
 
-#include <stdint.h>
-#include <stddef.h>
-#include <stdbool.h>
-
 #define SYSCALL_PROCESS_EXIT 1
 #define SYSCALL_PROCESS_ID 2
 #define SYSCALL_PROCESS_PARENT_ID 3
@@ -41,6 +37,10 @@
 #define SYSCALL_MEMORY_SHARED_ATTACH 24
 #define SYSCALL_MEMORY_SHARED_DETACH 25
 #define SYSCALL_MEMORY_TRANSLATE_PHYSICAL 26
+#define SYSCALL_MEMORY_SHARED_SEAL 27
+#define SYSCALL_MEMORY_SHARED_GRANT 28
+#define SYSCALL_MEMORY_SHARED_SIZE 29
+#define SYSCALL_MEMORY_SHARED_OWNER 30
 
 #define SYSCALL_RPC_SET_HANDLER 31
 #define SYSCALL_RPC_RAISE 32
@@ -51,6 +51,7 @@
 #define SYSCALL_RPC_SET_READY 37
 #define SYSCALL_RPC_END 38
 #define SYSCALL_RPC_WAIT_FOR_READY 39
+#define SYSCALL_RPC_GET_DATA_ORIGIN 40
 
 #define SYSCALL_INTERRUPT_ACQUIRE 41
 #define SYSCALL_INTERRUPT_RELEASE 42
@@ -63,49 +64,61 @@
 #define SYSCALL_KERNEL_PUTC 61
 #define SYSCALL_KERNEL_PUTS 62
 
-bool syscall_init( void );
-void syscall_populate_success( void*, size_t );
-void syscall_populate_error( void*, size_t );
-size_t syscall_get_parameter( void*, int32_t );
-bool syscall_validate_address( uintptr_t, size_t );
-
-void syscall_process_exit( void* );
-void syscall_process_id( void* );
-void syscall_process_parent_id( void* );
-void syscall_process_fork( void* );
-void syscall_process_replace( void* );
-void syscall_process_parent_by_id( void* );
-
-void syscall_thread_create( void* );
-void syscall_thread_exit( void* );
-void syscall_thread_id( void* );
-
-void syscall_memory_acquire( void* );
-void syscall_memory_release( void* );
-void syscall_memory_shared_create( void* );
-void syscall_memory_shared_attach( void* );
-void syscall_memory_shared_detach( void* );
-void syscall_memory_translate_physical( void* );
-
-void syscall_interrupt_acquire( void* );
-void syscall_interrupt_release( void* );
-
-void syscall_rpc_set_handler( void* );
-void syscall_rpc_raise( void* );
-void syscall_rpc_ret( void* );
-void syscall_rpc_get_data( void* );
-void syscall_rpc_get_data_size( void* );
-void syscall_rpc_wait_for_call( void* );
-void syscall_rpc_set_ready( void* );
-void syscall_rpc_end( void* );
-void syscall_rpc_wait_for_ready( void* );
-
-void syscall_timer_tick_count( void* );
-void syscall_timer_frequency( void* );
-void syscall_timer_acquire( void* );
-void syscall_timer_release( void* );
-
-void syscall_kernel_putc( void* );
-void syscall_kernel_puts( void* );
+#if ! defined( ASSEMBLER_FILE )
+  #include <stdint.h>
+  #include <stddef.h>
+  #include <stdbool.h>
+
+  bool syscall_init( void );
+  void syscall_populate_success( void*, size_t );
+  void syscall_populate_error( void*, size_t );
+  size_t syscall_get_parameter( void*, int32_t );
+  bool syscall_validate_address( uintptr_t, size_t );
+  bool syscall_validate_writable_address( uintptr_t, size_t );
+
+  void syscall_process_exit( void* );
+  void syscall_process_id( void* );
+  void syscall_process_parent_id( void* );
+  void syscall_process_fork( void* );
+  void syscall_process_replace( void* );
+  void syscall_process_parent_by_id( void* );
+
+  void syscall_thread_create( void* );
+  void syscall_thread_exit( void* );
+  void syscall_thread_id( void* );
+
+  void syscall_memory_acquire( void* );
+  void syscall_memory_release( void* );
+  void syscall_memory_shared_create( void* );
+  void syscall_memory_shared_attach( void* );
+  void syscall_memory_shared_detach( void* );
+  void syscall_memory_translate_physical( void* );
+  void syscall_memory_shared_seal( void* );
+  void syscall_memory_shared_grant( void* );
+  void syscall_memory_shared_size( void* );
+  void syscall_memory_shared_owner( void* );
+
+  void syscall_interrupt_acquire( void* );
+  void syscall_interrupt_release( void* );
+
+  void syscall_rpc_set_handler( void* );
+  void syscall_rpc_raise( void* );
+  void syscall_rpc_ret( void* );
+  void syscall_rpc_get_data( void* );
+  void syscall_rpc_get_data_size( void* );
+  void syscall_rpc_wait_for_call( void* );
+  void syscall_rpc_set_ready( void* );
+  void syscall_rpc_end( void* );
+  void syscall_rpc_wait_for_ready( void* );
+  void syscall_rpc_get_data_origin( void* );
+
+  void syscall_timer_tick_count( void* );
+  void syscall_timer_frequency( void* );
+  void syscall_timer_acquire( void* );
+  void syscall_timer_release( void* );
+
+  void syscall_kernel_putc( void* );
+  void syscall_kernel_puts( void* );
+#endif
 
 #endif
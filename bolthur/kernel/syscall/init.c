@@ -20,6 +20,7 @@
 #include "../interrupt.h"
 #include "../syscall.h"
 #include "../mm/virt.h"
+#include "../mm/image.h"
 #include "../task/process.h"
 #include "../task/thread.h"
 
@@ -183,6 +184,46 @@ bool syscall_init( void ) {
   ) ) {
     return false;
   }
+  if ( ! interrupt_register_handler(
+    SYSCALL_MEMORY_SHARED_SEAL,
+    syscall_memory_shared_seal,
+    NULL,
+    INTERRUPT_SOFTWARE,
+    false,
+    false
+  ) ) {
+    return false;
+  }
+  if ( ! interrupt_register_handler(
+    SYSCALL_MEMORY_SHARED_GRANT,
+    syscall_memory_shared_grant,
+    NULL,
+    INTERRUPT_SOFTWARE,
+    false,
+    false
+  ) ) {
+    return false;
+  }
+  if ( ! interrupt_register_handler(
+    SYSCALL_MEMORY_SHARED_SIZE,
+    syscall_memory_shared_size,
+    NULL,
+    INTERRUPT_SOFTWARE,
+    false,
+    false
+  ) ) {
+    return false;
+  }
+  if ( ! interrupt_register_handler(
+    SYSCALL_MEMORY_SHARED_OWNER,
+    syscall_memory_shared_owner,
+    NULL,
+    INTERRUPT_SOFTWARE,
+    false,
+    false
+  ) ) {
+    return false;
+  }
   // rpc related
   if ( ! interrupt_register_handler(
     SYSCALL_RPC_SET_HANDLER,
@@ -274,6 +315,16 @@ bool syscall_init( void ) {
   ) ) {
     return false;
   }
+  if ( ! interrupt_register_handler(
+    SYSCALL_RPC_GET_DATA_ORIGIN,
+    syscall_rpc_get_data_origin,
+    NULL,
+    INTERRUPT_SOFTWARE,
+    false,
+    false
+  ) ) {
+    return false;
+  }
   // interrupt related
   if ( ! interrupt_register_handler(
     SYSCALL_INTERRUPT_ACQUIRE,
@@ -371,9 +422,25 @@ bool syscall_init( void ) {
  * @return
  */
 bool syscall_validate_address( uintptr_t address, size_t len ) {
-  return virt_is_mapped_in_context_range(
-    task_thread_current_thread->process->virtual_context,
-    address,
-    len
-  );
+  virt_context_ptr_t ctx = task_thread_current_thread->process->virtual_context;
+  // demand paged image has to be resident before kernel access
+  image_populate_range( ctx, address, len );
+  return virt_is_mapped_in_context_range( ctx, address, len );
+}
+
+/**
+ * @fn bool syscall_validate_writable_address(uintptr_t, size_t)
+ * @brief Function validates that address is writable user space address
+ *
+ * @param address
+ * @param len
+ * @return
+ *
+ * @note read only mappings fault on kernel writes, so they are rejected
+ */
+bool syscall_validate_writable_address( uintptr_t address, size_t len ) {
+  virt_context_ptr_t ctx = task_thread_current_thread->process->virtual_context;
+  // demand paged image has to be resident before kernel access
+  image_populate_range( ctx, address, len );
+  return virt_is_writable_in_context_range( ctx, address, len );
 }
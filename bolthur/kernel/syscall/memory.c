@@ -26,6 +26,7 @@
 #include "../mm/phys.h"
 #include "../mm/virt.h"
 #include "../mm/shared.h"
+#include "../mm/image.h"
 #include "../task/process.h"
 #include "../task/thread.h"
 
@@ -272,6 +273,16 @@ void syscall_memory_release( void* context ) {
     return;
   }
 
+  // check for demand paged image
+  if ( image_address_is_image( virtual_context, address, len ) ) {
+    syscall_populate_error( context, ( size_t )-EADDRNOTAVAIL );
+    // debug output
+    #if defined( PRINT_SYSCALL )
+      DEBUG_OUTPUT( "Address is part of executable image!\r\n" )
+    #endif
+    return;
+  }
+
   // check if range is mapped in context
   if ( ! virt_is_mapped_in_context_range( virtual_context, address, len ) ) {
     // debug output
@@ -316,7 +327,10 @@ void syscall_memory_shared_create( void* context ) {
     DEBUG_OUTPUT( "syscall_memory_shared_acquire( %zx )\r\n", len )
   #endif
   // create shared area
-  size_t id = shared_memory_create( len );
+  size_t id = shared_memory_create(
+    task_thread_current_thread->process,
+    len
+  );
   // handle error
   if ( 0 == id ) {
     syscall_populate_error( context, ( size_t )-ENOMEM );
@@ -377,6 +391,105 @@ void syscall_memory_shared_detach( void* context ) {
   syscall_populate_success( context, 0 );
 }
 
+/**
+ * @fn void syscall_memory_shared_seal(void*)
+ * @brief Seal shared memory area, so that it's mapped read only
+ *
+ * @param context
+ */
+void syscall_memory_shared_seal( void* context ) {
+  // get parameters
+  size_t id = ( size_t )syscall_get_parameter( context, 0 );
+  // debug output
+  #if defined( PRINT_SYSCALL )
+    DEBUG_OUTPUT( "syscall_memory_shared_seal( %d )\r\n", id )
+  #endif
+  // try to seal
+  if ( ! shared_memory_seal( task_thread_current_thread->process, id ) ) {
+    syscall_populate_error( context, ( size_t )-EINVAL );
+    return;
+  }
+  // return success
+  syscall_populate_success( context, 0 );
+}
+
+/**
+ * @fn void syscall_memory_shared_grant(void*)
+ * @brief Create sealed area sharing pages of an attached area
+ *
+ * @param context
+ */
+void syscall_memory_shared_grant( void* context ) {
+  // get parameters
+  uintptr_t address = ( uintptr_t )syscall_get_parameter( context, 0 );
+  size_t len = ( size_t )syscall_get_parameter( context, 1 );
+  pid_t receiver = ( pid_t )syscall_get_parameter( context, 2 );
+  // debug output
+  #if defined( PRINT_SYSCALL )
+    DEBUG_OUTPUT( "syscall_memory_shared_grant( %#"PRIxPTR", %zx, %d )\r\n",
+      address, len, receiver )
+  #endif
+  // try to grant
+  size_t id = shared_memory_grant(
+    task_thread_current_thread->process,
+    address,
+    len,
+    receiver
+  );
+  if ( 0 == id ) {
+    syscall_populate_error( context, ( size_t )-EINVAL );
+    return;
+  }
+  // return id of new area
+  syscall_populate_success( context, id );
+}
+
+/**
+ * @fn void syscall_memory_shared_size(void*)
+ * @brief Get size of an attached shared area
+ *
+ * @param context
+ */
+void syscall_memory_shared_size( void* context ) {
+  // get parameters
+  size_t id = ( size_t )syscall_get_parameter( context, 0 );
+  // debug output
+  #if defined( PRINT_SYSCALL )
+    DEBUG_OUTPUT( "syscall_memory_shared_size( %zu )\r\n", id )
+  #endif
+  // get size
+  size_t size = shared_memory_size( task_thread_current_thread->process, id );
+  if ( 0 == size ) {
+    syscall_populate_error( context, ( size_t )-EINVAL );
+    return;
+  }
+  // return size of area
+  syscall_populate_success( context, size );
+}
+
+/**
+ * @fn void syscall_memory_shared_owner(void*)
+ * @brief Get process that sealed an attached shared area
+ *
+ * @param context
+ */
+void syscall_memory_shared_owner( void* context ) {
+  // get parameters
+  size_t id = ( size_t )syscall_get_parameter( context, 0 );
+  // debug output
+  #if defined( PRINT_SYSCALL )
+    DEBUG_OUTPUT( "syscall_memory_shared_owner( %zu )\r\n", id )
+  #endif
+  // get owner
+  pid_t owner = shared_memory_owner( task_thread_current_thread->process, id );
+  if ( 0 == owner ) {
+    syscall_populate_error( context, ( size_t )-EINVAL );
+    return;
+  }
+  // return owner of area
+  syscall_populate_success( context, ( size_t )owner );
+}
+
 /**
  * @fn void syscall_memory_translate_physical(void*)
  * @brief Translate virtual into physical address
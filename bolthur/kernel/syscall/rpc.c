@@ -255,14 +255,31 @@ void syscall_rpc_ret( void* context ) {
   }
   // overwrite target in case original rpc id is set for correct unblock
   task_thread_ptr_t target = active->source;
+  task_process_ptr_t target_process = target->process;
   size_t blocked_data_id = active->data_id;
+  size_t origin_data_id = active->data_id;
+  bool synchronous = active->sync;
+  list_item_ptr_t deferred = NULL;
   if ( original_rpc_id ) {
+    target_process = NULL;
     target = task_thread_get_blocked(
       TASK_THREAD_STATE_RPC_WAIT_FOR_RETURN,
       ( task_state_data_t ){ .data_size = original_rpc_id }
     );
-    // handle no target
+    // deferred return to async request with data kept via peek
     if ( ! target ) {
+      deferred = list_lookup_data(
+        task_thread_current_thread->process->rpc_data_queue,
+        ( void* )original_rpc_id
+      );
+      if ( deferred ) {
+        target_process = task_process_get_by_id(
+          ( ( rpc_data_queue_entry_ptr_t )deferred->data )->sender
+        );
+      }
+    }
+    // handle no target
+    if ( ! target && ! target_process ) {
       #if defined( PRINT_SYSCALL )
         DEBUG_OUTPUT( "No blocked thread found with %d / %d\r\n",
           TASK_THREAD_STATE_RPC_WAIT_FOR_RETURN,
@@ -276,10 +293,15 @@ void syscall_rpc_ret( void* context ) {
     }
     // overwrite blocked data id
     blocked_data_id = original_rpc_id;
+    origin_data_id = original_rpc_id;
+    if ( target ) {
+      target_process = target->process;
+      synchronous = true;
+    }
   }
 
   // handle synchronous stuff
-  if ( active->sync ) {
+  if ( synchronous ) {
     #if defined( PRINT_SYSCALL )
       DEBUG_OUTPUT( "Sync return!\r\n" )
     #endif
@@ -288,6 +310,7 @@ void syscall_rpc_ret( void* context ) {
     int err = rpc_data_queue_add(
       target->process->id,
       active->thread->process->id,
+      active->origin,
       dup_data,
       length,
       &data_id
@@ -330,13 +353,13 @@ void syscall_rpc_ret( void* context ) {
     // raise target
     rpc_backup_ptr_t backup = rpc_generic_raise(
       active->thread,
-      target->process,
+      target_process,
       type,
       dup_data,
       length,
       NULL,
       true,
-      active->data_id
+      origin_data_id
     );
     #if defined( PRINT_SYSCALL )
       DEBUG_OUTPUT(
@@ -353,6 +376,10 @@ void syscall_rpc_ret( void* context ) {
       syscall_populate_error( context, ( size_t )-EAGAIN );
       return;
     }
+    // deferred request is answered now
+    if ( deferred ) {
+      list_remove( task_thread_current_thread->process->rpc_data_queue, deferred );
+    }
   }
   // free duplicate
   free( dup_data );
@@ -413,8 +440,8 @@ void syscall_rpc_get_data( void* context ) {
   #if defined( PRINT_SYSCALL )
     DEBUG_OUTPUT( "validate address!\r\n" )
   #endif
-  // validate addresses
-  if ( ! syscall_validate_address( ( uintptr_t )data, len ) ) {
+  // validate addresses, data is copied into
+  if ( ! syscall_validate_writable_address( ( uintptr_t )data, len ) ) {
     // debug output
     #if defined( PRINT_SYSCALL )
       DEBUG_OUTPUT( "Invalid parameters received / not mapped!\r\n" )
@@ -589,6 +616,41 @@ void syscall_rpc_get_data_size( void* context ) {
   syscall_populate_success( context, found->length );
 }
 
+/**
+ * @fn void syscall_rpc_get_data_origin(void*)
+ * @brief Get process a rpc data block originates from
+ *
+ * @param context
+ *
+ * @note differs from sender when the rpc was forwarded by a handler, e.g.
+ * ioctl requests passed through vfs
+ */
+void syscall_rpc_get_data_origin( void* context ) {
+  size_t rpc_data_id = ( size_t )syscall_get_parameter( context, 0 );
+  #if defined( PRINT_SYSCALL )
+    DEBUG_OUTPUT( "syscall_rpc_get_data_origin( %#x )\r\n", rpc_data_id )
+  #endif
+  // cache process
+  task_process_ptr_t target_process = task_thread_current_thread->process;
+  // handle target not yet ready
+  if ( ! rpc_generic_ready( target_process ) ) {
+    syscall_populate_error( context, ( size_t )-EINVAL );
+    return;
+  }
+  // Get message by id
+  list_item_ptr_t item = target_process->rpc_data_queue->first;
+  while( item ) {
+    rpc_data_queue_entry_ptr_t rpc = ( rpc_data_queue_entry_ptr_t )item->data;
+    if( rpc_data_id == rpc->id ) {
+      syscall_populate_success( context, ( size_t )rpc->origin );
+      return;
+    }
+    // head over to next
+    item = item->next;
+  }
+  syscall_populate_error( context, ( size_t )-ENOMSG );
+}
+
 /**
  * @fn void syscall_rpc_wait_for_call(void*)
  * @brief Halt thread and wait for rpc call
@@ -33,6 +33,7 @@
 #include "../mm/phys.h"
 #include "../mm/virt.h"
 #include "../mm/shared.h"
+#include "../mm/image.h"
 #if defined( PRINT_PROCESS )
   #include "../debug/debug.h"
 #endif
@@ -124,6 +125,8 @@ static void task_process_free( task_process_ptr_t proc ) {
   avl_remove_by_node( process_manager->process_id, &proc->node_id );
   // destroy context if existing
   if ( proc->virtual_context ) {
+    // unmap directly mapped image pages
+    image_cleanup( proc->virtual_context );
     // unmap all mapped shared memory areas
     assert( shared_memory_cleanup_process( proc ) );
     // destroy context
@@ -408,6 +411,11 @@ task_process_ptr_t task_process_fork( task_thread_ptr_t thread_calling ) {
     task_process_free( forked );
     return NULL;
   }
+  // fork demand paged image segments
+  if ( ! image_fork( proc->virtual_context, forked->virtual_context ) ) {
+    task_process_free( forked );
+    return NULL;
+  }
 
   // prepare node
   avl_prepare_node( &forked->node_id, ( void* )forked->id );
@@ -780,7 +788,28 @@ int task_process_replace(
   #if defined( PRINT_PROCESS )
     DEBUG_OUTPUT( "image_size = %#x\r\n", image_size )
   #endif
-  void* image = ( void* )malloc( sizeof( char ) * image_size );
+  image_backing_ptr_t image;
+  // take over pages of the image buffer, copy if they're not private
+  if (
+    replace_current_thread
+    && ! shared_memory_address_is_shared( proc, elf, image_size )
+    && ! image_address_is_image( proc->virtual_context, elf, image_size )
+  ) {
+    image = image_backing_create( proc->virtual_context, elf, image_size, true );
+    // fall back to copy when pages cannot be taken over
+    if (
+      ! image
+      && virt_is_mapped_in_context_range(
+        proc->virtual_context,
+        elf,
+        image_size
+      )
+    ) {
+      image = image_backing_copy( elf, image_size );
+    }
+  } else {
+    image = image_backing_copy( elf, image_size );
+  }
   // handle error
   if ( ! image ) {
     free( tmp_argv );
@@ -788,15 +817,17 @@ int task_process_replace(
     return -ENOMEM;
   }
   #if defined( PRINT_PROCESS )
-    DEBUG_OUTPUT( "image = %#p\r\n", image )
+    DEBUG_OUTPUT( "image = %#p\r\n", ( void* )image )
   #endif
-  memcpy_unsafe( image, ( void* )elf, image_size );
+
+  // unmap image pages of old executable
+  image_cleanup( proc->virtual_context );
 
   // clear all assigned shared areas
   if ( ! shared_memory_cleanup_process( proc ) ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
@@ -808,7 +839,7 @@ int task_process_replace(
   ) ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
@@ -833,7 +864,7 @@ int task_process_replace(
   if ( ! proc->thread_manager ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
@@ -841,17 +872,17 @@ int task_process_replace(
   if ( ! proc->thread_stack_manager ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
 
   // load elf image
-  uintptr_t init_entry = elf_load( ( uintptr_t )image, proc );
+  uintptr_t init_entry = elf_load_image( image, proc );
   if ( ! init_entry ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
@@ -860,7 +891,7 @@ int task_process_replace(
   if ( ! new_current ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
@@ -872,7 +903,7 @@ int task_process_replace(
   if ( ! task_thread_push_arguments( new_current, tmp_argv, tmp_env ) ) {
     free( tmp_argv );
     free( tmp_env );
-    free( image );
+    image_backing_release( image );
     task_process_prepare_kill( context, proc );
     return -ENOMEM;
   }
@@ -880,7 +911,7 @@ int task_process_replace(
   // free temporary stuff
   free( tmp_argv );
   free( tmp_env );
-  free( image );
+  image_backing_release( image );
 
   // replace new current thread
   if ( replace_current_thread ) {
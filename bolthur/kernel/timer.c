@@ -143,6 +143,7 @@ timer_callback_entry_ptr_t timer_register_callback(
     return NULL;
   }
   // push back information
+  entry->id = timer_generate_id();
   entry->rpc = rpc_num;
   entry->thread = thread;
   entry->expire = timeout;
@@ -24,6 +24,8 @@
 #include <stdint.h>
 
 void tty_init( void );
+bool tty_register_interrupt( void );
 void tty_putc( uint8_t );
+void tty_sync( void );
 
 #endif
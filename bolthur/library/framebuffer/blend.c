@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined( __ARM_NEON )
+  #include <arm_neon.h>
+#endif
+#include "framebuffer.h"
+
+/**
+ * @fn uint32_t framebuffer_div255(uint32_t)
+ * @brief Rounded division by 255 matching the neon variant
+ *
+ * @param value
+ * @return
+ */
+static inline uint32_t framebuffer_div255( uint32_t value ) {
+  value += 128;
+  return ( value + ( value >> 8 ) ) >> 8;
+}
+
+#if defined( __ARM_NEON )
+/**
+ * @fn uint8x8_t framebuffer_blend_channel(uint8x8_t, uint8x8_t, uint8x8_t, uint8x8_t)
+ * @brief Blend one channel of eight pixel
+ *
+ * @param source
+ * @param destination
+ * @param alpha
+ * @param inverse
+ * @return
+ */
+static inline uint8x8_t framebuffer_blend_channel(
+  uint8x8_t source,
+  uint8x8_t destination,
+  uint8x8_t alpha,
+  uint8x8_t inverse
+) {
+  uint16x8_t sum = vmlal_u8( vmull_u8( source, alpha ), destination, inverse );
+  return vrshrn_n_u16( vaddq_u16( sum, vrshrq_n_u16( sum, 8 ) ), 8 );
+}
+#endif
+
+/**
+ * @fn void framebuffer_blend(uint32_t*, size_t, const uint32_t*, size_t, uint32_t, uint32_t)
+ * @brief Blend argb source over destination using source alpha
+ *
+ * @param destination
+ * @param destination_pitch
+ * @param source
+ * @param source_pitch
+ * @param width
+ * @param height
+ */
+void framebuffer_blend(
+  uint32_t* destination,
+  size_t destination_pitch,
+  const uint32_t* source,
+  size_t source_pitch,
+  uint32_t width,
+  uint32_t height
+) {
+  for ( uint32_t y = 0; y < height; y++ ) {
+    uint32_t x = 0;
+    #if defined( __ARM_NEON )
+      // eight pixel per iteration, channels deinterleaved
+      for ( ; x + 8 <= width; x += 8 ) {
+        uint8x8x4_t s = vld4_u8( ( const uint8_t* )( source + x ) );
+        uint8x8x4_t d = vld4_u8( ( const uint8_t* )( destination + x ) );
+        uint8x8_t alpha = s.val[ 3 ];
+        uint8x8_t inverse = vmvn_u8( alpha );
+        d.val[ 0 ] = framebuffer_blend_channel( s.val[ 0 ], d.val[ 0 ], alpha, inverse );
+        d.val[ 1 ] = framebuffer_blend_channel( s.val[ 1 ], d.val[ 1 ], alpha, inverse );
+        d.val[ 2 ] = framebuffer_blend_channel( s.val[ 2 ], d.val[ 2 ], alpha, inverse );
+        d.val[ 3 ] = framebuffer_blend_channel( alpha, d.val[ 3 ], vdup_n_u8( 255 ), inverse );
+        vst4_u8( ( uint8_t* )( destination + x ), d );
+      }
+    #endif
+    for ( ; x < width; x++ ) {
+      uint32_t s = source[ x ];
+      uint32_t d = destination[ x ];
+      uint32_t alpha = s >> 24;
+      uint32_t inverse = 255 - alpha;
+      uint32_t result = 0;
+      for ( uint32_t shift = 0; shift < 24; shift += 8 ) {
+        uint32_t channel = framebuffer_div255(
+          ( ( s >> shift ) & 0xff ) * alpha + ( ( d >> shift ) & 0xff ) * inverse );
+        result |= channel << shift;
+      }
+      // alpha channel itself is composed as a + da * ( 1 - a )
+      result |= framebuffer_div255( alpha * 255 + ( d >> 24 ) * inverse ) << 24;
+      destination[ x ] = result;
+    }
+    destination = ( uint32_t* )( ( uint8_t* )destination + destination_pitch );
+    source = ( const uint32_t* )( ( const uint8_t* )source + source_pitch );
+  }
+}
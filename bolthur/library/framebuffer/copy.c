@@ -0,0 +1,70 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#if defined( __ARM_NEON )
+  #include <arm_neon.h>
+#endif
+#include "framebuffer.h"
+
+/**
+ * @fn void framebuffer_copy_rect(uint32_t*, size_t, const uint32_t*, size_t, uint32_t, uint32_t)
+ * @brief Copy rectangle, areas must not overlap
+ *
+ * @param destination
+ * @param destination_pitch
+ * @param source
+ * @param source_pitch
+ * @param width
+ * @param height
+ */
+void framebuffer_copy_rect(
+  uint32_t* destination,
+  size_t destination_pitch,
+  const uint32_t* source,
+  size_t source_pitch,
+  uint32_t width,
+  uint32_t height
+) {
+  for ( uint32_t y = 0; y < height; y++ ) {
+    #if defined( __ARM_NEON )
+      uint32_t x = 0;
+      // sixteen pixel per iteration
+      for ( ; x + 16 <= width; x += 16 ) {
+        uint32x4_t a = vld1q_u32( source + x );
+        uint32x4_t b = vld1q_u32( source + x + 4 );
+        uint32x4_t c = vld1q_u32( source + x + 8 );
+        uint32x4_t d = vld1q_u32( source + x + 12 );
+        vst1q_u32( destination + x, a );
+        vst1q_u32( destination + x + 4, b );
+        vst1q_u32( destination + x + 8, c );
+        vst1q_u32( destination + x + 12, d );
+      }
+      for ( ; x < width; x++ ) {
+        destination[ x ] = source[ x ];
+      }
+    #else
+      memcpy( destination, source, width * sizeof( uint32_t ) );
+    #endif
+    destination = ( uint32_t* )( ( uint8_t* )destination + destination_pitch );
+    source = ( const uint32_t* )( ( const uint8_t* )source + source_pitch );
+  }
+}
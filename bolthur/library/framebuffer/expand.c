@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined( __ARM_NEON )
+  #include <arm_neon.h>
+#endif
+#include "framebuffer.h"
+
+/**
+ * @fn void framebuffer_expand_1bpp(uint32_t*, size_t, const uint8_t*, size_t, uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Expand msb first 1 bit bitmap like psf glyphs into 32 bit pixels
+ *
+ * @param destination
+ * @param destination_pitch
+ * @param source
+ * @param source_pitch
+ * @param width
+ * @param height
+ * @param fg color for set bits
+ * @param bg color for cleared bits
+ */
+void framebuffer_expand_1bpp(
+  uint32_t* destination,
+  size_t destination_pitch,
+  const uint8_t* source,
+  size_t source_pitch,
+  uint32_t width,
+  uint32_t height,
+  uint32_t fg,
+  uint32_t bg
+) {
+  #if defined( __ARM_NEON )
+    static const uint8_t bit[ 8 ] = {
+      0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    uint8x8_t bits = vld1_u8( bit );
+    uint32x4_t foreground = vdupq_n_u32( fg );
+    uint32x4_t background = vdupq_n_u32( bg );
+  #endif
+  for ( uint32_t y = 0; y < height; y++ ) {
+    uint32_t x = 0;
+    #if defined( __ARM_NEON )
+      // one source byte per iteration
+      for ( ; x + 8 <= width; x += 8 ) {
+        // lanes become 0xff for set bits
+        uint8x8_t set = vtst_u8( vdup_n_u8( source[ x / 8 ] ), bits );
+        // sign extend to full 32 bit masks
+        int16x8_t wide = vmovl_s8( vreinterpret_s8_u8( set ) );
+        uint32x4_t low = vreinterpretq_u32_s32(
+          vmovl_s16( vget_low_s16( wide ) ) );
+        uint32x4_t high = vreinterpretq_u32_s32(
+          vmovl_s16( vget_high_s16( wide ) ) );
+        vst1q_u32( destination + x, vbslq_u32( low, foreground, background ) );
+        vst1q_u32( destination + x + 4, vbslq_u32( high, foreground, background ) );
+      }
+    #endif
+    for ( ; x < width; x++ ) {
+      destination[ x ] = ( source[ x / 8 ] & ( 0x80 >> ( x & 7 ) ) ) ? fg : bg;
+    }
+    destination = ( uint32_t* )( ( uint8_t* )destination + destination_pitch );
+    source += source_pitch;
+  }
+}
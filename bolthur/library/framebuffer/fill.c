@@ -0,0 +1,62 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined( __ARM_NEON )
+  #include <arm_neon.h>
+#endif
+#include "framebuffer.h"
+
+/**
+ * @fn void framebuffer_fill(uint32_t*, size_t, uint32_t, uint32_t, uint32_t)
+ * @brief Fill rectangle with color
+ *
+ * @param destination
+ * @param pitch
+ * @param width
+ * @param height
+ * @param color
+ */
+void framebuffer_fill(
+  uint32_t* destination,
+  size_t pitch,
+  uint32_t width,
+  uint32_t height,
+  uint32_t color
+) {
+  #if defined( __ARM_NEON )
+    uint32x4_t value = vdupq_n_u32( color );
+  #endif
+  for ( uint32_t y = 0; y < height; y++ ) {
+    uint32_t* row = destination;
+    uint32_t x = 0;
+    #if defined( __ARM_NEON )
+      // eight pixel per iteration
+      for ( ; x + 8 <= width; x += 8 ) {
+        vst1q_u32( row + x, value );
+        vst1q_u32( row + x + 4, value );
+      }
+    #endif
+    for ( ; x < width; x++ ) {
+      row[ x ] = color;
+    }
+    destination = ( uint32_t* )( ( uint8_t* )destination + pitch );
+  }
+}
@@ -17,7 +17,20 @@
  * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#if ! defined( _FRAMEBUFFER_H )
-#define _FRAMEBUFFER_H
+#include <stddef.h>
+#include <stdint.h>
+
+#if ! defined( _FRAMEBUFFER_FRAMEBUFFER_H )
+#define _FRAMEBUFFER_FRAMEBUFFER_H
+
+/*
+ * 32 bit pixel kernels, pitches are in bytes. NEON variants are used when
+ * the compiler targets NEON, scalar fallbacks otherwise.
+ */
+
+void framebuffer_fill( uint32_t*, size_t, uint32_t, uint32_t, uint32_t );
+void framebuffer_copy_rect( uint32_t*, size_t, const uint32_t*, size_t, uint32_t, uint32_t );
+void framebuffer_expand_1bpp( uint32_t*, size_t, const uint8_t*, size_t, uint32_t, uint32_t, uint32_t, uint32_t );
+void framebuffer_blend( uint32_t*, size_t, const uint32_t*, size_t, uint32_t, uint32_t );
 
 #endif
@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../framebuffer.h"
+
+// screen size used by the framebuffer server
+#define BENCH_WIDTH 640
+#define BENCH_HEIGHT 480
+#define BENCH_PITCH ( BENCH_WIDTH * sizeof( uint32_t ) )
+#define BENCH_ITERATIONS 200
+
+static uint32_t destination[ BENCH_WIDTH * BENCH_HEIGHT ];
+static uint32_t source[ BENCH_WIDTH * BENCH_HEIGHT ];
+static uint8_t bitmap[ BENCH_WIDTH / 8 * BENCH_HEIGHT ];
+
+/**
+ * @fn double bench_now(void)
+ * @brief Get monotonic time in seconds
+ *
+ * @return
+ */
+static double bench_now( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( double )ts.tv_sec + ( double )ts.tv_nsec / 1e9;
+}
+
+/**
+ * @fn void bench_report(const char*, double)
+ * @brief Print throughput of a kernel
+ *
+ * @param name
+ * @param start
+ */
+static void bench_report( const char* name, double start ) {
+  double elapsed = bench_now() - start;
+  double pixel = ( double )BENCH_WIDTH * BENCH_HEIGHT * BENCH_ITERATIONS;
+  printf(
+    "%-8s %8.3f ms/frame %10.1f Mpixel/s\n",
+    name,
+    elapsed * 1e3 / BENCH_ITERATIONS,
+    pixel / elapsed / 1e6 );
+}
+
+/**
+ * @fn int main(void)
+ * @brief Measure kernels on a full screen
+ *
+ * @return
+ */
+int main( void ) {
+  for ( size_t i = 0; i < BENCH_WIDTH * BENCH_HEIGHT; i++ ) {
+    source[ i ] = ( uint32_t )( i * 2654435761u );
+  }
+  memset( bitmap, 0xA5, sizeof( bitmap ) );
+  double start = bench_now();
+  for ( int i = 0; i < BENCH_ITERATIONS; i++ ) {
+    framebuffer_fill(
+      destination, BENCH_PITCH, BENCH_WIDTH, BENCH_HEIGHT, ( uint32_t )i );
+  }
+  bench_report( "fill", start );
+  start = bench_now();
+  for ( int i = 0; i < BENCH_ITERATIONS; i++ ) {
+    framebuffer_copy_rect(
+      destination, BENCH_PITCH, source, BENCH_PITCH, BENCH_WIDTH, BENCH_HEIGHT );
+  }
+  bench_report( "copy", start );
+  start = bench_now();
+  for ( int i = 0; i < BENCH_ITERATIONS; i++ ) {
+    framebuffer_expand_1bpp(
+      destination, BENCH_PITCH, bitmap, BENCH_WIDTH / 8,
+      BENCH_WIDTH, BENCH_HEIGHT, 0xFFFFFFFF, ( uint32_t )i );
+  }
+  bench_report( "expand", start );
+  start = bench_now();
+  for ( int i = 0; i < BENCH_ITERATIONS; i++ ) {
+    framebuffer_blend(
+      destination, BENCH_PITCH, source, BENCH_PITCH, BENCH_WIDTH, BENCH_HEIGHT );
+  }
+  bench_report( "blend", start );
+  // keep result alive
+  return destination[ BENCH_WIDTH ] == 0x12345678 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../framebuffer.h"
+
+// console of the framebuffer server at 1080p with 8x16 font
+#define CONSOLE_WIDTH 1920
+#define CONSOLE_HEIGHT 1080
+#define CONSOLE_PITCH ( CONSOLE_WIDTH * sizeof( uint32_t ) )
+#define CONSOLE_GLYPH_WIDTH 8
+#define CONSOLE_GLYPH_HEIGHT 16
+#define CONSOLE_COLUMNS ( CONSOLE_WIDTH / CONSOLE_GLYPH_WIDTH )
+#define CONSOLE_ROWS ( CONSOLE_HEIGHT / CONSOLE_GLYPH_HEIGHT )
+#define CONSOLE_MIN_TIME 0.5
+
+static uint32_t back[ CONSOLE_WIDTH * CONSOLE_HEIGHT ];
+static uint32_t screen[ CONSOLE_WIDTH * CONSOLE_HEIGHT ];
+static uint8_t font[ 256 ][ CONSOLE_GLYPH_HEIGHT ];
+static size_t cursor = 0;
+
+typedef void ( *console_write_t )( size_t );
+
+/**
+ * @fn double console_now(void)
+ * @brief Get monotonic time in seconds
+ *
+ * @return
+ */
+static double console_now( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( double )ts.tv_sec + ( double )ts.tv_nsec / 1e9;
+}
+
+/**
+ * @fn uint32_t* console_cell(uint32_t*, size_t)
+ * @brief Get address of a character cell
+ *
+ * @param buffer
+ * @param cell
+ * @return
+ */
+static uint32_t* console_cell( uint32_t* buffer, size_t cell ) {
+  size_t column = cell % CONSOLE_COLUMNS;
+  size_t row = cell / CONSOLE_COLUMNS % CONSOLE_ROWS;
+  return buffer
+    + row * CONSOLE_GLYPH_HEIGHT * CONSOLE_WIDTH
+    + column * CONSOLE_GLYPH_WIDTH;
+}
+
+/**
+ * @fn void console_render(size_t)
+ * @brief Render glyph at cursor into back buffer
+ *
+ * @param cell
+ */
+static void console_render( size_t cell ) {
+  framebuffer_expand_1bpp(
+    console_cell( back, cell ),
+    CONSOLE_PITCH,
+    font[ ( cell * 7 ) & 0xFF ],
+    1,
+    CONSOLE_GLYPH_WIDTH,
+    CONSOLE_GLYPH_HEIGHT,
+    0xFFFFFFFF,
+    0
+  );
+}
+
+/**
+ * @fn void console_write_full(size_t)
+ * @brief One flip per character copying whole back buffer
+ *
+ * @param count
+ */
+static void console_write_full( size_t count ) {
+  for ( size_t idx = 0; idx < count; idx++, cursor++ ) {
+    console_render( cursor );
+    memcpy( screen, back, sizeof( back ) );
+  }
+}
+
+/**
+ * @fn void console_write_damage(size_t)
+ * @brief One flip per character copying the damaged cell only
+ *
+ * @param count
+ */
+static void console_write_damage( size_t count ) {
+  for ( size_t idx = 0; idx < count; idx++, cursor++ ) {
+    console_render( cursor );
+    framebuffer_copy_rect(
+      console_cell( screen, cursor ),
+      CONSOLE_PITCH,
+      console_cell( back, cursor ),
+      CONSOLE_PITCH,
+      CONSOLE_GLYPH_WIDTH,
+      CONSOLE_GLYPH_HEIGHT
+    );
+  }
+}
+
+/**
+ * @fn void console_write_line(size_t)
+ * @brief One flip per written line, damaged rows coalesced to one block
+ *
+ * @param count
+ */
+static void console_write_line( size_t count ) {
+  while ( count ) {
+    size_t first = cursor;
+    size_t chunk = CONSOLE_COLUMNS - cursor % CONSOLE_COLUMNS;
+    if ( chunk > count ) {
+      chunk = count;
+    }
+    for ( size_t idx = 0; idx < chunk; idx++, cursor++ ) {
+      console_render( cursor );
+    }
+    framebuffer_copy_rect(
+      console_cell( screen, first ),
+      CONSOLE_PITCH,
+      console_cell( back, first ),
+      CONSOLE_PITCH,
+      ( uint32_t )chunk * CONSOLE_GLYPH_WIDTH,
+      CONSOLE_GLYPH_HEIGHT
+    );
+    count -= chunk;
+  }
+}
+
+/**
+ * @fn void console_measure(const char*, console_write_t)
+ * @brief Print characters per second of a write strategy
+ *
+ * @param name
+ * @param write
+ */
+static void console_measure( const char* name, console_write_t write ) {
+  size_t total = 0;
+  size_t count = 16;
+  double start = console_now();
+  double elapsed;
+  // grow batch until measurement is long enough
+  do {
+    write( count );
+    total += count;
+    count *= 2;
+    elapsed = console_now() - start;
+  } while ( elapsed < CONSOLE_MIN_TIME );
+  printf(
+    "%-28s %12.0f chars/s\n",
+    name,
+    ( double )total / elapsed
+  );
+}
+
+/**
+ * @fn int main(void)
+ * @brief Measure console output at 1920x1080
+ *
+ * @return
+ */
+int main( void ) {
+  for ( size_t glyph = 0; glyph < 256; glyph++ ) {
+    for ( size_t row = 0; row < CONSOLE_GLYPH_HEIGHT; row++ ) {
+      font[ glyph ][ row ] = ( uint8_t )( glyph * 31 + row * 17 );
+    }
+  }
+  printf(
+    "console %dx%d, %dx%d glyphs\n",
+    CONSOLE_WIDTH,
+    CONSOLE_HEIGHT,
+    CONSOLE_GLYPH_WIDTH,
+    CONSOLE_GLYPH_HEIGHT
+  );
+  console_measure( "full copy per character", console_write_full );
+  console_measure( "damage copy per character", console_write_damage );
+  console_measure( "damage copy per line", console_write_line );
+  // keep result alive
+  return screen[ CONSOLE_WIDTH ] == 0x12345678 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../framebuffer.h"
+
+// destination with padding per row and guard rows to detect overruns
+#define TEST_MAX_WIDTH 37
+#define TEST_MAX_HEIGHT 5
+#define TEST_PADDING 3
+#define TEST_GUARD 0xDEADBEEF
+#define TEST_PITCH ( ( TEST_MAX_WIDTH + TEST_PADDING ) * sizeof( uint32_t ) )
+#define TEST_WORDS ( ( TEST_MAX_WIDTH + TEST_PADDING ) * ( TEST_MAX_HEIGHT + 1 ) )
+
+static uint32_t destination[ TEST_WORDS ];
+static uint32_t expected[ TEST_WORDS ];
+static uint32_t source[ TEST_WORDS ];
+static uint8_t bitmap[ TEST_MAX_HEIGHT * 8 ];
+static size_t failed = 0;
+
+/**
+ * @fn uint32_t test_random(void)
+ * @brief Deterministic pseudo random generator
+ *
+ * @return
+ */
+static uint32_t test_random( void ) {
+  static uint32_t state = 0x12345678;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/**
+ * @fn void test_prepare(void)
+ * @brief Fill buffers with random data and destination copies with guard
+ */
+static void test_prepare( void ) {
+  for ( size_t i = 0; i < TEST_WORDS; i++ ) {
+    source[ i ] = test_random();
+    destination[ i ] = i % 2 ? test_random() : TEST_GUARD;
+    expected[ i ] = destination[ i ];
+  }
+  for ( size_t i = 0; i < sizeof( bitmap ); i++ ) {
+    bitmap[ i ] = ( uint8_t )test_random();
+  }
+}
+
+/**
+ * @fn void test_check(const char*, uint32_t, uint32_t)
+ * @brief Compare result against reference including untouched padding
+ *
+ * @param name
+ * @param width
+ * @param height
+ */
+static void test_check( const char* name, uint32_t width, uint32_t height ) {
+  if ( 0 == memcmp( destination, expected, sizeof( destination ) ) ) {
+    return;
+  }
+  for ( size_t i = 0; i < TEST_WORDS; i++ ) {
+    if ( destination[ i ] != expected[ i ] ) {
+      printf(
+        "FAIL %s %ux%u: word %zu is %08x, expected %08x\n",
+        name, width, height, i, destination[ i ], expected[ i ] );
+      break;
+    }
+  }
+  failed++;
+}
+
+/**
+ * @fn uint32_t* test_row(uint32_t*, uint32_t)
+ * @brief Get row of test buffer
+ *
+ * @param buffer
+ * @param y
+ * @return
+ */
+static uint32_t* test_row( uint32_t* buffer, uint32_t y ) {
+  return buffer + y * ( TEST_MAX_WIDTH + TEST_PADDING );
+}
+
+/**
+ * @fn uint32_t test_div255(uint32_t)
+ * @brief Exact rounded division by 255
+ *
+ * @param value
+ * @return
+ */
+static uint32_t test_div255( uint32_t value ) {
+  return ( value * 2 + 255 ) / 510;
+}
+
+/**
+ * @fn void test_fill(uint32_t, uint32_t)
+ * @brief Test fill against reference
+ *
+ * @param width
+ * @param height
+ */
+static void test_fill( uint32_t width, uint32_t height ) {
+  test_prepare();
+  uint32_t color = test_random();
+  for ( uint32_t y = 0; y < height; y++ ) {
+    for ( uint32_t x = 0; x < width; x++ ) {
+      test_row( expected, y )[ x ] = color;
+    }
+  }
+  framebuffer_fill( destination, TEST_PITCH, width, height, color );
+  test_check( "fill", width, height );
+}
+
+/**
+ * @fn void test_copy(uint32_t, uint32_t)
+ * @brief Test copy rectangle against reference
+ *
+ * @param width
+ * @param height
+ */
+static void test_copy( uint32_t width, uint32_t height ) {
+  test_prepare();
+  for ( uint32_t y = 0; y < height; y++ ) {
+    for ( uint32_t x = 0; x < width; x++ ) {
+      test_row( expected, y )[ x ] = test_row( source, y )[ x ];
+    }
+  }
+  framebuffer_copy_rect(
+    destination, TEST_PITCH, source, TEST_PITCH, width, height );
+  test_check( "copy", width, height );
+}
+
+/**
+ * @fn void test_expand(uint32_t, uint32_t)
+ * @brief Test 1 bit expansion against reference
+ *
+ * @param width
+ * @param height
+ */
+static void test_expand( uint32_t width, uint32_t height ) {
+  test_prepare();
+  uint32_t fg = test_random();
+  uint32_t bg = test_random();
+  for ( uint32_t y = 0; y < height; y++ ) {
+    for ( uint32_t x = 0; x < width; x++ ) {
+      bool set = ( bitmap[ y * 8 + x / 8 ] >> ( 7 - x % 8 ) ) & 1;
+      test_row( expected, y )[ x ] = set ? fg : bg;
+    }
+  }
+  framebuffer_expand_1bpp(
+    destination, TEST_PITCH, bitmap, 8, width, height, fg, bg );
+  test_check( "expand", width, height );
+}
+
+/**
+ * @fn void test_blend(uint32_t, uint32_t)
+ * @brief Test source over blend against exact reference
+ *
+ * @param width
+ * @param height
+ */
+static void test_blend( uint32_t width, uint32_t height ) {
+  test_prepare();
+  // force fully transparent and opaque pixels as well
+  test_row( source, 0 )[ 0 ] &= 0x00FFFFFF;
+  test_row( source, 0 )[ 1 ] |= 0xFF000000;
+  for ( uint32_t y = 0; y < height; y++ ) {
+    for ( uint32_t x = 0; x < width; x++ ) {
+      uint32_t s = test_row( source, y )[ x ];
+      uint32_t d = test_row( expected, y )[ x ];
+      uint32_t alpha = s >> 24;
+      uint32_t result = test_div255( alpha * 255 + ( d >> 24 ) * ( 255 - alpha ) ) << 24;
+      for ( uint32_t shift = 0; shift < 24; shift += 8 ) {
+        uint32_t channel = test_div255(
+          ( ( s >> shift ) & 0xFF ) * alpha
+          + ( ( d >> shift ) & 0xFF ) * ( 255 - alpha ) );
+        result |= channel << shift;
+      }
+      test_row( expected, y )[ x ] = result;
+    }
+  }
+  framebuffer_blend(
+    destination, TEST_PITCH, source, TEST_PITCH, width, height );
+  test_check( "blend", width, height );
+}
+
+/**
+ * @fn int main(void)
+ * @brief Run kernels for all widths, covering vector bodies and tails
+ *
+ * @return
+ */
+int main( void ) {
+  for ( uint32_t height = 0; height <= TEST_MAX_HEIGHT; height++ ) {
+    for ( uint32_t width = 0; width <= TEST_MAX_WIDTH; width++ ) {
+      test_fill( width, height );
+      test_copy( width, height );
+      test_expand( width, height );
+      test_blend( width, height );
+    }
+  }
+  // exhaustive check of rounding used by blend
+  for ( uint32_t alpha = 0; alpha < 256; alpha++ ) {
+    for ( uint32_t value = 0; value < 256; value++ ) {
+      uint32_t s = alpha << 24 | value;
+      uint32_t d = 0xFF000000 | ( 255 - value );
+      uint32_t channel = test_div255( value * alpha + ( 255 - value ) * ( 255 - alpha ) );
+      framebuffer_blend( &d, 0, &s, 0, 1, 1 );
+      if ( ( d & 0xFF ) != channel || ( d >> 24 ) != 0xFF ) {
+        printf( "FAIL blend rounding a=%u v=%u: %08x\n", alpha, value, d );
+        failed++;
+        break;
+      }
+    }
+  }
+  printf( "%s: %zu failed\n", failed ? "FAIL" : "PASS", failed );
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -24,14 +24,17 @@
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
-#include <libgen.h>
 #include <sys/stat.h>
 #include <sys/bolthur.h>
 #include <sys/sysmacros.h>
 #include <libfdt.h>
 #include <assert.h>
+#include "manifest.h"
 #include "ramdisk.h"
+#include "scheduler.h"
 #include "../libhelper.h"
+#include "../libsyscall.h"
+#include "../libvfs.h"
 
 uintptr_t ramdisk_compressed;
 size_t ramdisk_compressed_size;
@@ -42,24 +45,15 @@ pid_t pid = 0;
 TAR *disk = NULL;
 
 /**
- * @brief Simulate open, by decompressing ramdisk tar image
+ * @brief Simulate open, by preparing access to ramdisk tar image
  *
  * @param path
  * @param b
  * @return
  */
 static int my_tar_open( __unused const char* path, __unused int b, ... ) {
-  // get extract size
-  ramdisk_decompressed_size = ramdisk_extract_size(
-    ramdisk_compressed,
-    ramdisk_compressed_size );
-  // deflate
-  ramdisk_decompressed = ( uintptr_t )ramdisk_extract(
-    ramdisk_compressed,
-    ramdisk_compressed_size,
-    ramdisk_decompressed_size );
   // handle error
-  if ( ! ramdisk_decompressed ) {
+  if ( ! ramdisk_setup() ) {
     return -1;
   }
   // use 0 as file descriptor
@@ -67,18 +61,18 @@ static int my_tar_open( __unused const char* path, __unused int b, ... ) {
 }
 
 /**
- * @brief Simulate close by freeing decompressed ramdisk image
+ * @brief Simulate close by freeing decompressed ramdisk data
  *
  * @param fd
  * @return
  */
 static int my_tar_close( __unused int fd ) {
-  free( ( void* )ramdisk_decompressed );
+  ramdisk_teardown();
   return 0;
 }
 
 /**
- * @brief Simulate read as operation on ramdisk address
+ * @brief Simulate read as operation on ramdisk
  *
  * @param fd
  * @param buffer
@@ -86,28 +80,13 @@ static int my_tar_close( __unused int fd ) {
  * @return
  */
 static ssize_t my_tar_read( __unused int fd, void* buffer, size_t count ) {
-  uint8_t* src = ( uint8_t* )ramdisk_decompressed + ramdisk_read_offset;
-  uint8_t* dst = ( uint8_t* )buffer;
-
-  uintptr_t end = ( uintptr_t )ramdisk_decompressed + ramdisk_decompressed_size;
-  // handle end reached
-  if ( ramdisk_decompressed + ramdisk_read_offset >= end ) {
-    return 0;
-  }
-  // cap amount
-  if ( ramdisk_decompressed + ramdisk_read_offset + count > end ) {
-    size_t diff = ramdisk_decompressed + ramdisk_read_offset + count - end;
-    count -= diff;
-  }
-
-  // move from src to destination
-  for ( size_t i = 0; i < count; i++ ) {
-    dst[ i ] = src[ i ];
+  ssize_t length = ramdisk_read( ramdisk_read_offset, buffer, count );
+  // increase offset
+  if ( 0 < length ) {
+    ramdisk_read_offset += ( size_t )length;
   }
-  // increase count
-  ramdisk_read_offset += count;
   // return read count
-  return ( ssize_t )count;
+  return length;
 }
 
 /**
@@ -127,27 +106,67 @@ static ssize_t my_tar_write(
 }
 
 /**
- * @fn bool path_exists(const char*)
- * @brief Method to check if path exists
- *
- * @param path
- * @return
- */
-static bool device_exists( const char* path ) {
-  struct stat buffer;
-  return stat( path, &buffer ) == 0;
-}
-
-/**
- * @fn void wait_for_device(const char*)
- * @brief Wait for device exists by querying vfs with a sleep between
+ * @fn void rpc_handle_map(size_t, pid_t, size_t, size_t)
+ * @brief Helper to handle read only mapping request of a ramdisk file
  *
- * @param path
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
  */
-static void wait_for_device( const char* path ) {
-  while( ! device_exists( path ) ) {
-    sleep( 5 );
+static void rpc_handle_map(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  // validate origin
+  if ( ! bolthur_rpc_validate_origin( origin, data_info ) ) {
+    return;
+  }
+  vfs_map_request_t request;
+  vfs_map_response_t response = { .status = -EINVAL };
+  memset( &request, 0, sizeof( request ) );
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( &request, sizeof( request ), data_info, false );
+  if ( errno || 0 > request.offset ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // strip leading slash
+  char* file = request.file_path;
+  if ( '/' == *file ) {
+    file++;
+  }
+  // lookup within ramdisk
+  ramdisk_file_ptr_t entry = ramdisk_lookup_file( file );
+  if ( ! entry ) {
+    response.status = -ENOENT;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
   }
+  // share pages of file range with process the request originates from
+  pid_t receiver = _rpc_get_data_origin( data_info );
+  if ( errno ) {
+    response.status = -EIO;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  response.status = ramdisk_map(
+    entry,
+    ( size_t )request.offset,
+    request.len,
+    receiver,
+    &response.shm_id,
+    &response.offset,
+    &response.len
+  );
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
 }
 
 /**
@@ -202,7 +221,6 @@ static void rpc_handle_read(
   }
   // get rid of mount point
   char* file = request->file_path;
-  char* buf = NULL;
   void* shm_addr = NULL;
   // map shared if set
   if ( 0 != request->shm_id ) {
@@ -226,35 +244,10 @@ static void rpc_handle_read(
   if ( '/' == *file ) {
     file++;
   }
-  size_t total_size = 0;
-  // reset read offset
-  ramdisk_read_offset = 0;
-  // try to find within ramdisk
-  while ( th_read( disk ) == 0 ) {
-    if ( TH_ISREG( disk ) ) {
-      // get filename
-      char* ramdisk_file = th_get_pathname( disk );
-      //EARLY_STARTUP_PRINT( "ramdisk_file = %s\r\n", ramdisk_file )
-      // check for match
-      if ( 0 == strcmp( file, ramdisk_file ) ) {
-        // set vfs image addr
-        total_size = th_get_size( disk );
-        //EARLY_STARTUP_PRINT( "total byte size = %#x\r\n", total_size )
-        buf = ( char* )( ( uint8_t* )ramdisk_decompressed + ramdisk_read_offset );
-        break;
-      }
-      // skip to next file
-      if ( tar_skip_regfile( disk ) != 0 ) {
-        EARLY_STARTUP_PRINT( "tar_skip_regfile(): %s\n", strerror( errno ) );
-        // return response
-        response->len = -EIO;
-        bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-        return;
-      }
-    }
-  }
+  // lookup within ramdisk
+  ramdisk_file_ptr_t entry = ramdisk_lookup_file( file );
   // handle error
-  if ( ! buf ) {
+  if ( ! entry ) {
     // prepare response
     response->len = -EIO;
     // return response
@@ -267,21 +260,22 @@ static void rpc_handle_read(
 
   // read until end / size
   size_t amount = request->len;
-  size_t total = amount + ( size_t )request->offset;
-  if ( total > total_size ) {
-    amount -= ( total - total_size );
+  if ( ( size_t )request->offset >= entry->size ) {
+    amount = 0;
+  } else if ( amount > entry->size - ( size_t )request->offset ) {
+    amount = entry->size - ( size_t )request->offset;
   }
   /*EARLY_STARTUP_PRINT(
     "read amount = %d ( %#x ), offset = %ld ( %#lx ), total = %d ( %#x ), "
     "first two byte = %#"PRIx16"\r\n",
     amount, amount, request->offset, request->offset, total, total,
     *( ( uint16_t* )( buf + request->offset ) ) )*/
-  // now copy
-  if ( shm_addr ) {
-    memcpy( shm_addr, buf + request->offset, amount );
-  } else {
-    memcpy( response->data, buf + request->offset, amount );
-  }
+  // now copy, decompressing only the necessary blocks
+  ssize_t length = ramdisk_read(
+    entry->offset + ( size_t )request->offset,
+    shm_addr ? shm_addr : response->data,
+    amount
+  );
 
   // detach shared area
   if ( request->shm_id ) {
@@ -299,7 +293,7 @@ static void rpc_handle_read(
     }
   }
   // prepare read amount
-  response->len = ( ssize_t )amount;
+  response->len = 0 > length ? -EIO : length;
   // return response
   bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
   // free stuff
@@ -307,75 +301,26 @@ static void rpc_handle_read(
   free( response );
 }
 
-/**
- * @fn int execute_driver(char*)
- * @brief Helper to execute specific driver from ramdisk
- *
- * @param name
- * @return
- */
-static pid_t execute_driver( char* name ) {
-  // pure kernel fork necessary here
-  pid_t forked_process = _process_fork();
-  if ( errno ) {
-    EARLY_STARTUP_PRINT(
-      "Unable to fork process for image replace: %s\r\n",
-      strerror( errno )
-    )
-    return -1;
-  }
-  // fork only
-  if ( 0 == forked_process ) {
-    char* base = basename( name );
-    if ( ! base ) {
-      EARLY_STARTUP_PRINT( "Basename failed!\r\n" )
-      exit( -1 );
-    }
-    // build command
-    char* cmd[] = { base, NULL, };
-    // exec to replace
-    if ( -1 == execv( name, cmd ) ) {
-      EARLY_STARTUP_PRINT( "Exec failed: %s\r\n", strerror( errno ) )
-      exit( 1 );
-    }
-  }
-  // non fork return 0
-  return forked_process;
-}
-
 /**
  * @fn void stage2(void)
  * @brief Helper to get up the necessary additional drivers for a running system
  */
 static void stage2( void ) {
-  // start mailbox server
-  EARLY_STARTUP_PRINT( "Starting and waiting for mailbox server...\r\n" )
-  pid_t mailbox = execute_driver( "/ramdisk/server/io/mailbox" );
-  wait_for_device( "/dev/mailbox" );
-
-  // start mmio server
-  EARLY_STARTUP_PRINT( "Starting and waiting for mmio server...\r\n" )
-  pid_t mmio = execute_driver( "/ramdisk/server/io/mmio" );
-  wait_for_device( "/dev/mmio" );
-
-  // start framebuffer driver and wait for device to come up
-  EARLY_STARTUP_PRINT( "Starting and waiting for framebuffer server...\r\n" )
-  pid_t framebuffer = execute_driver( "/ramdisk/server/framebuffer" );
-  wait_for_device( "/dev/framebuffer" );
-
-  // start system console and wait for device to come up
-  EARLY_STARTUP_PRINT( "Starting and waiting for console server...\r\n" )
-  pid_t console = execute_driver( "/ramdisk/server/console" );
-  wait_for_device( "/dev/console" );
-
-  // start tty and wait for device to come up
-  EARLY_STARTUP_PRINT( "Starting and waiting for terminal server...\r\n" )
-  pid_t terminal = execute_driver( "/ramdisk/server/terminal" );
-  wait_for_device( "/dev/terminal" );
-
-  EARLY_STARTUP_PRINT(
-    "mailbox = %d, mmio = %d, console = %d, terminal = %d, framebuffer = %d\r\n",
-    mailbox, mmio, console, terminal, framebuffer )
+  // load driver manifest
+  manifest_ptr_t manifest = manifest_load( MANIFEST_PATH );
+  if ( ! manifest ) {
+    EARLY_STARTUP_PRINT( "Unable to load driver manifest\r\n" )
+    exit( 1 );
+  }
+  // start drivers in parallel as far as dependencies allow
+  EARLY_STARTUP_PRINT( "Starting and waiting for drivers...\r\n" )
+  bool started = scheduler_run( manifest );
+  scheduler_timeline( manifest );
+  manifest_destroy( manifest );
+  if ( ! started ) {
+    EARLY_STARTUP_PRINT( "Unable to start all drivers\r\n" )
+    exit( 1 );
+  }
 
   // ORDER NECESSARY HERE DUE TO THE DEFINES
   EARLY_STARTUP_PRINT( "Rerouting stdin, stdout and stderr\r\n" )
@@ -565,13 +510,27 @@ int main( int argc, char* argv[] ) {
 
   // dump ramdisk
   //ramdisk_dump( disk );
+  // build file lookup
+  if ( ! ramdisk_index_init( disk ) ) {
+    EARLY_STARTUP_PRINT( "ERROR: Cannot build ramdisk file lookup!\r\n" );
+    return -1;
+  }
   // get vfs image
-  size_t vfs_size;
-  void* vfs_image = ramdisk_lookup_file( disk, "ramdisk/server/fs/vfs", &vfs_size );
-  if ( ! vfs_image ) {
+  ramdisk_file_ptr_t vfs_file = ramdisk_lookup_file( "ramdisk/server/fs/vfs" );
+  if ( ! vfs_file ) {
     EARLY_STARTUP_PRINT( "VFS not found for start!\r\n" );
     return -1;
   }
+  void* vfs_image = malloc( vfs_file->size );
+  if (
+    ! vfs_image
+    || ramdisk_read( vfs_file->offset, vfs_image, vfs_file->size )
+      != ( ssize_t )vfs_file->size
+  ) {
+    EARLY_STARTUP_PRINT( "Unable to read vfs image!\r\n" );
+    free( vfs_image );
+    return -1;
+  }
   EARLY_STARTUP_PRINT( "VFS image: %p!\r\n", vfs_image );
   // fork process and handle possible error
   EARLY_STARTUP_PRINT( "Forking process for vfs start!\r\n" );
@@ -596,6 +555,7 @@ int main( int argc, char* argv[] ) {
       return -1;
     }
   }
+  free( vfs_image );
   // handle unexpected vfs id returned
   if ( VFS_DAEMON_ID != forked_process ) {
     EARLY_STARTUP_PRINT( "Invalid process id for vfs daemon!\r\n" )
@@ -610,6 +570,17 @@ int main( int argc, char* argv[] ) {
   ramdisk_read_offset = 0;
   // loop and add folders
   while ( th_read( disk ) == 0 ) {
+    // skip ramdisk index
+    if (
+      TH_ISREG( disk )
+      && 0 == strcmp( th_get_pathname( disk ), RAMDISK_INDEX_NAME )
+    ) {
+      if ( ramdisk_skip_regfile( disk ) != 0 ) {
+        EARLY_STARTUP_PRINT( "ramdisk_skip_regfile(): %s\n", strerror( errno ) );
+        return -1;
+      }
+      continue;
+    }
     // handle directory, hard links, symbolic links and normal entries
     // clear message structures
     memset( msg, 0, sizeof( vfs_add_request_t ) );
@@ -649,8 +620,8 @@ int main( int argc, char* argv[] ) {
     // send add request
     send_vfs_add_request( msg, 0, 2 );
     // skip to next file
-    if ( TH_ISREG( disk ) && tar_skip_regfile( disk ) != 0 ) {
-      EARLY_STARTUP_PRINT( "tar_skip_regfile(): %s\n", strerror( errno ) );
+    if ( TH_ISREG( disk ) && ramdisk_skip_regfile( disk ) != 0 ) {
+      EARLY_STARTUP_PRINT( "ramdisk_skip_regfile(): %s\n", strerror( errno ) );
       return -1;
     }
   }
@@ -663,6 +634,11 @@ int main( int argc, char* argv[] ) {
     EARLY_STARTUP_PRINT( "Unable to register handler add!\r\n" )
     return -1;
   }
+  bolthur_rpc_bind( RPC_VFS_MAP, rpc_handle_map );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler map!\r\n" )
+    return -1;
+  }
 
   // fork process and handle possible error
   EARLY_STARTUP_PRINT( "Forking process for further init!\r\n" );
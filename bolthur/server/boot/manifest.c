@@ -0,0 +1,275 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <confini.h>
+#include <sys/bolthur.h>
+#include "manifest.h"
+
+/**
+ * @fn void manifest_copy(char*, const char*, size_t)
+ * @brief Copy value into fixed size buffer with termination
+ *
+ * @param destination
+ * @param source
+ * @param size
+ */
+static void manifest_copy( char* destination, const char* source, size_t size ) {
+  strncpy( destination, source, size - 1 );
+  destination[ size - 1 ] = '\0';
+}
+
+/**
+ * @fn manifest_driver_ptr_t manifest_driver_get(manifest_ptr_t, const char*, bool)
+ * @brief Get driver by name and create it if requested
+ *
+ * @param manifest
+ * @param name
+ * @param create
+ * @return
+ */
+static manifest_driver_ptr_t manifest_driver_get(
+  manifest_ptr_t manifest,
+  const char* name,
+  bool create
+) {
+  for ( size_t i = 0; i < manifest->count; i++ ) {
+    if ( 0 == strcmp( manifest->driver[ i ].name, name ) ) {
+      return &manifest->driver[ i ];
+    }
+  }
+  if (
+    ! create
+    || MANIFEST_DRIVER_MAX <= manifest->count
+    || MANIFEST_NAME_MAX <= strlen( name )
+  ) {
+    return NULL;
+  }
+  manifest_driver_ptr_t driver = &manifest->driver[ manifest->count++ ];
+  manifest_copy( driver->name, name, MANIFEST_NAME_MAX );
+  return driver;
+}
+
+/**
+ * @fn bool manifest_list_next(const char**, char*)
+ * @brief Get next name of comma separated list
+ *
+ * @param list current list position, updated on return
+ * @param name buffer of MANIFEST_NAME_MAX, empty if name is too long
+ * @return false if end of list is reached
+ */
+static bool manifest_list_next( const char** list, char* name ) {
+  const char* current = *list;
+  // skip separators and whitespace
+  while ( ',' == *current || isspace( ( unsigned char )*current ) ) {
+    current++;
+  }
+  if ( ! *current ) {
+    return false;
+  }
+  size_t length = 0;
+  while ( current[ length ] && ',' != current[ length ] ) {
+    length++;
+  }
+  *list = current + length;
+  // strip trailing whitespace
+  while ( length && isspace( ( unsigned char )current[ length - 1 ] ) ) {
+    length--;
+  }
+  if ( MANIFEST_NAME_MAX <= length ) {
+    length = 0;
+  }
+  memcpy( name, current, length );
+  name[ length ] = '\0';
+  return true;
+}
+
+/**
+ * @fn int manifest_dispatch(IniDispatch*, void*)
+ * @brief Handle key of manifest
+ *
+ * @param dispatch
+ * @param user_data
+ * @return
+ */
+static int manifest_dispatch( IniDispatch* dispatch, void* user_data ) {
+  manifest_ptr_t manifest = user_data;
+  // only keys are from interest
+  if ( INI_KEY != dispatch->type || ! *dispatch->append_to ) {
+    return 0;
+  }
+  const char* value = dispatch->value ? dispatch->value : "";
+  // platform section
+  if ( 0 == strcmp( dispatch->append_to, MANIFEST_PLATFORM ) ) {
+    if ( 0 == strcmp( dispatch->data, "name" ) ) {
+      manifest_copy( manifest->name, value, MANIFEST_LIST_MAX );
+    } else if ( 0 == strcmp( dispatch->data, "startup" ) ) {
+      manifest_copy( manifest->startup, value, MANIFEST_LIST_MAX );
+    } else if ( 0 == strcmp( dispatch->data, "ready" ) ) {
+      manifest_copy( manifest->ready, value, MANIFEST_NAME_MAX );
+    }
+    return 0;
+  }
+  // every other section declares a driver
+  manifest_driver_ptr_t driver = manifest_driver_get(
+    manifest,
+    dispatch->append_to,
+    true
+  );
+  if ( ! driver ) {
+    EARLY_STARTUP_PRINT(
+      "Unable to add driver \"%s\" from manifest\r\n",
+      dispatch->append_to
+    )
+    return 1;
+  }
+  if ( 0 == strcmp( dispatch->data, "path" ) ) {
+    manifest_copy( driver->path, value, PATH_MAX );
+  } else if ( 0 == strcmp( dispatch->data, "provides" ) ) {
+    manifest_copy( driver->provides, value, PATH_MAX );
+  } else if ( 0 == strcmp( dispatch->data, "depends" ) ) {
+    manifest_copy( driver->depends, value, MANIFEST_LIST_MAX );
+  }
+  return 0;
+}
+
+/**
+ * @fn bool manifest_resolve(manifest_ptr_t)
+ * @brief Reduce drivers to startup list and resolve dependencies
+ *
+ * @param manifest
+ * @return
+ */
+static bool manifest_resolve( manifest_ptr_t manifest ) {
+  char name[ MANIFEST_NAME_MAX ];
+  const char* list = manifest->startup;
+  // enable drivers listed for startup
+  while ( manifest_list_next( &list, name ) ) {
+    manifest_driver_ptr_t driver = manifest_driver_get( manifest, name, false );
+    if ( ! driver || ! *driver->path ) {
+      EARLY_STARTUP_PRINT( "Startup driver \"%s\" not declared\r\n", name )
+      return false;
+    }
+    driver->enabled = true;
+  }
+  // drop drivers not started by scheduler
+  size_t count = 0;
+  for ( size_t i = 0; i < manifest->count; i++ ) {
+    if ( ! manifest->driver[ i ].enabled ) {
+      continue;
+    }
+    if ( i != count ) {
+      manifest->driver[ count ] = manifest->driver[ i ];
+    }
+    count++;
+  }
+  manifest->count = count;
+  if ( ! count ) {
+    EARLY_STARTUP_PRINT( "No startup drivers within manifest\r\n" )
+    return false;
+  }
+  // resolve dependencies to index
+  for ( size_t i = 0; i < manifest->count; i++ ) {
+    manifest_driver_ptr_t driver = &manifest->driver[ i ];
+    list = driver->depends;
+    while ( manifest_list_next( &list, name ) ) {
+      manifest_driver_ptr_t depend = manifest_driver_get(
+        manifest,
+        name,
+        false
+      );
+      if ( ! depend || MANIFEST_DEPEND_MAX <= driver->depend_count ) {
+        EARLY_STARTUP_PRINT(
+          "Invalid dependency \"%s\" of driver \"%s\"\r\n",
+          name, driver->name
+        )
+        return false;
+      }
+      driver->depend[ driver->depend_count++ ] = ( size_t )(
+        depend - manifest->driver
+      );
+    }
+  }
+  // boot is completed with ready driver, defaults to last one
+  manifest->ready_index = manifest->count - 1;
+  if ( *manifest->ready ) {
+    manifest_driver_ptr_t ready = manifest_driver_get(
+      manifest,
+      manifest->ready,
+      false
+    );
+    if ( ! ready ) {
+      EARLY_STARTUP_PRINT(
+        "Ready driver \"%s\" not started\r\n",
+        manifest->ready
+      )
+      return false;
+    }
+    manifest->ready_index = ( size_t )( ready - manifest->driver );
+  }
+  return true;
+}
+
+/**
+ * @fn manifest_ptr_t manifest_load(const char*)
+ * @brief Load driver manifest
+ *
+ * @param path
+ * @return
+ */
+manifest_ptr_t manifest_load( const char* path ) {
+  manifest_ptr_t manifest = malloc( sizeof( manifest_t ) );
+  if ( ! manifest ) {
+    return NULL;
+  }
+  memset( manifest, 0, sizeof( manifest_t ) );
+  // parse ini
+  int result = load_ini_path(
+    path,
+    INI_DEFAULT_FORMAT,
+    NULL,
+    manifest_dispatch,
+    manifest
+  );
+  if ( 0 != result ) {
+    EARLY_STARTUP_PRINT(
+      "Unable to parse manifest \"%s\" ( %d )\r\n",
+      path, result
+    )
+    free( manifest );
+    return NULL;
+  }
+  if ( ! manifest_resolve( manifest ) ) {
+    free( manifest );
+    return NULL;
+  }
+  return manifest;
+}
+
+/**
+ * @fn void manifest_destroy(manifest_ptr_t)
+ * @brief Destroy loaded manifest
+ *
+ * @param manifest
+ */
+void manifest_destroy( manifest_ptr_t manifest ) {
+  free( manifest );
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+#include <sys/types.h>
+
+#if !defined( _MANIFEST_H )
+#define _MANIFEST_H
+
+#define MANIFEST_PATH "/ramdisk/config/boot.ini"
+#define MANIFEST_PLATFORM "platform"
+#define MANIFEST_DRIVER_MAX 16
+#define MANIFEST_DEPEND_MAX 8
+#define MANIFEST_NAME_MAX 32
+#define MANIFEST_LIST_MAX 256
+
+enum manifest_driver_state {
+  MANIFEST_DRIVER_WAITING = 0,
+  MANIFEST_DRIVER_STARTED,
+  MANIFEST_DRIVER_READY,
+  MANIFEST_DRIVER_FAILED,
+};
+typedef enum manifest_driver_state manifest_driver_state_t;
+
+struct manifest_driver {
+  // declared within manifest
+  char name[ MANIFEST_NAME_MAX ];
+  char path[ PATH_MAX ];
+  char provides[ PATH_MAX ];
+  char depends[ MANIFEST_LIST_MAX ];
+  // resolved dependencies as index into driver list
+  size_t depend[ MANIFEST_DEPEND_MAX ];
+  size_t depend_count;
+  bool enabled;
+  // runtime state maintained by scheduler
+  manifest_driver_state_t state;
+  pid_t pid;
+  size_t tick_start;
+  size_t tick_ready;
+};
+typedef struct manifest_driver manifest_driver_t;
+typedef struct manifest_driver* manifest_driver_ptr_t;
+
+struct manifest {
+  char name[ MANIFEST_LIST_MAX ];
+  char startup[ MANIFEST_LIST_MAX ];
+  char ready[ MANIFEST_NAME_MAX ];
+  manifest_driver_t driver[ MANIFEST_DRIVER_MAX ];
+  size_t count;
+  // driver marking boot as completed
+  size_t ready_index;
+};
+typedef struct manifest manifest_t;
+typedef struct manifest* manifest_ptr_t;
+
+manifest_ptr_t manifest_load( const char* );
+void manifest_destroy( manifest_ptr_t );
+
+#endif
@@ -19,14 +19,20 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include <zlib.h>
 #include <errno.h>
 #include <tar.h>
 #include <sys/bolthur.h>
 #include "ramdisk.h"
+#include "../libsyscall.h"
 
 #define INFLATE_CHUNK 32
 
+// file lookup table
+static ramdisk_file_ptr_t ramdisk_file_table = NULL;
+static uint32_t ramdisk_file_mask = 0;
+
 size_t ramdisk_extract_size( uintptr_t address, size_t size ) {
   int err;
   char out[ INFLATE_CHUNK ] = { '\0' };
@@ -77,15 +83,25 @@ size_t ramdisk_extract_size( uintptr_t address, size_t size ) {
   return extract_len;
 }
 
-void* ramdisk_extract( uintptr_t address, size_t size, size_t extract_size ) {
+/**
+ * @fn bool ramdisk_inflate(uintptr_t, size_t, void*, size_t)
+ * @brief Inflate compressed image in one step into destination
+ *
+ * @param address
+ * @param size
+ * @param dec
+ * @param extract_size
+ * @return
+ */
+static bool ramdisk_inflate(
+  uintptr_t address,
+  size_t size,
+  void* dec,
+  size_t extract_size
+) {
   int err;
   // decompress
   z_stream stream = { 0 };
-  void* dec = malloc( extract_size );
-  // handle allocate error
-  if ( ! dec ) {
-    return NULL;
-  }
 
   // prepare stream
   stream.total_in = stream.avail_in = size;
@@ -101,55 +117,684 @@ void* ramdisk_extract( uintptr_t address, size_t size, size_t extract_size ) {
   if ( Z_OK != err ) {
     EARLY_STARTUP_PRINT( "ERROR ON INIT = %d!\r\n", err )
     inflateEnd( &stream );
-    free( dec );
-    return NULL;
+    return false;
   }
   // inflate in one step
   err = inflate( &stream, Z_FINISH);
   if ( err != Z_STREAM_END ) {
     EARLY_STARTUP_PRINT( "ERROR ON INFLATE = %d!\r\n", err )
     inflateEnd( &stream );
-    free( dec );
-    return NULL;
+    return false;
   }
   // end inflate
   inflateEnd( &stream );
+  return true;
+}
 
+void* ramdisk_extract( uintptr_t address, size_t size, size_t extract_size ) {
+  void* dec = malloc( extract_size );
+  // handle allocate error
+  if ( ! dec ) {
+    return NULL;
+  }
+  // decompress
+  if ( ! ramdisk_inflate( address, size, dec, extract_size ) ) {
+    free( dec );
+    return NULL;
+  }
   // return decompressed
   return dec;
 }
 
-void* ramdisk_lookup_file( TAR* t, const char* name, size_t* size ) {
-  // variables
-  ramdisk_read_offset = 0;
-  void* file = NULL;
+// shared area containing extracted ramdisk, 0 if allocated via malloc
+static size_t ramdisk_shared_id = 0;
 
-  // loop through ramdisk and lookup file
+/**
+ * @fn void* ramdisk_extract_shared(uintptr_t, size_t, size_t)
+ * @brief Extract ramdisk into a shared area, so that clients may map files
+ * without copy
+ *
+ * @param address
+ * @param size
+ * @param extract_size
+ * @return
+ */
+static void* ramdisk_extract_shared(
+  uintptr_t address,
+  size_t size,
+  size_t extract_size
+) {
+  size_t id = _memory_shared_create( extract_size );
+  if ( errno || 0 == id ) {
+    return NULL;
+  }
+  void* dec = _memory_shared_attach( id, ( uintptr_t )NULL );
+  if ( errno || ! dec ) {
+    return NULL;
+  }
+  // decompress
+  if ( ! ramdisk_inflate( address, size, dec, extract_size ) ) {
+    _memory_shared_detach( id );
+    return NULL;
+  }
+  ramdisk_shared_id = id;
+  // return decompressed
+  return dec;
+}
+
+// block wise compressed ramdisk
+static const ramdisk_block_header_t* ramdisk_block_header = NULL;
+static const uint32_t* ramdisk_block_offset = NULL;
+static z_stream ramdisk_block_stream;
+// cache of decompressed blocks
+static ramdisk_cache_t ramdisk_cache[ RAMDISK_CACHE_SIZE ];
+static uint32_t ramdisk_cache_clock = 0;
+
+/**
+ * @fn bool ramdisk_block_setup(const ramdisk_block_header_t*)
+ * @brief Validate block header and offset table and prepare inflate
+ *
+ * @param header
+ * @return
+ */
+static bool ramdisk_block_setup( const ramdisk_block_header_t* header ) {
+  size_t table_offset = sizeof( *header );
+  // validate geometry
+  if (
+    ! header->block_size
+    || header->block_size > RAMDISK_BLOCK_SIZE_MAX
+    || ! header->size
+    || header->block_count != ( header->size - 1 ) / header->block_size + 1
+    || header->block_count >= (
+      ramdisk_compressed_size - table_offset ) / sizeof( uint32_t )
+  ) {
+    EARLY_STARTUP_PRINT( "Invalid ramdisk block header!\r\n" )
+    return false;
+  }
+  const uint32_t* offset = ( const uint32_t* )(
+    ramdisk_compressed + table_offset
+  );
+  size_t data_offset = table_offset
+    + ( header->block_count + 1 ) * sizeof( uint32_t );
+  // offsets have to be ascending and within image
+  if ( offset[ 0 ] < data_offset ) {
+    EARLY_STARTUP_PRINT( "Invalid ramdisk block offset table!\r\n" )
+    return false;
+  }
+  for ( uint32_t i = 0; i < header->block_count; i++ ) {
+    if (
+      offset[ i ] >= offset[ i + 1 ]
+      || offset[ i + 1 ] > ramdisk_compressed_size
+    ) {
+      EARLY_STARTUP_PRINT( "Invalid ramdisk block offset table!\r\n" )
+      return false;
+    }
+  }
+  // single inflate stream reset per block
+  memset( &ramdisk_block_stream, 0, sizeof( ramdisk_block_stream ) );
+  int err = inflateInit2( &ramdisk_block_stream, 15 + 32 );
+  if ( Z_OK != err ) {
+    EARLY_STARTUP_PRINT( "error on init zlib ( %d )!\r\n", err )
+    inflateEnd( &ramdisk_block_stream );
+    return false;
+  }
+  memset( ramdisk_cache, 0, sizeof( ramdisk_cache ) );
+  ramdisk_block_header = header;
+  ramdisk_block_offset = offset;
+  ramdisk_decompressed_size = header->size;
+  return true;
+}
+
+/**
+ * @fn uint8_t* ramdisk_block_get(uint32_t)
+ * @brief Get decompressed block from cache or inflate it into least recently
+ * used cache entry
+ *
+ * @param block
+ * @return
+ */
+static uint8_t* ramdisk_block_get( uint32_t block ) {
+  ramdisk_cache_ptr_t victim = NULL;
+  // lookup cache and remember entry to replace
+  for ( size_t i = 0; i < RAMDISK_CACHE_SIZE; i++ ) {
+    ramdisk_cache_ptr_t entry = &ramdisk_cache[ i ];
+    if ( entry->valid && block == entry->block ) {
+      entry->age = ++ramdisk_cache_clock;
+      return entry->data;
+    }
+    if (
+      ! victim
+      || ( victim->valid && ! entry->valid )
+      || ( victim->valid && entry->age < victim->age )
+    ) {
+      victim = entry;
+    }
+  }
+  // allocate block buffer lazily
+  if ( ! victim->data ) {
+    victim->data = malloc( ramdisk_block_header->block_size );
+    if ( ! victim->data ) {
+      return NULL;
+    }
+  }
+  victim->valid = false;
+  // expected size, last block may be shorter
+  size_t expected = ramdisk_block_header->block_size;
+  size_t start = ( size_t )block * ramdisk_block_header->block_size;
+  if ( expected > ramdisk_block_header->size - start ) {
+    expected = ramdisk_block_header->size - start;
+  }
+  // inflate block
+  if ( Z_OK != inflateReset( &ramdisk_block_stream ) ) {
+    return NULL;
+  }
+  ramdisk_block_stream.next_in = ( Bytef* )(
+    ramdisk_compressed + ramdisk_block_offset[ block ]
+  );
+  ramdisk_block_stream.avail_in = ramdisk_block_offset[ block + 1 ]
+    - ramdisk_block_offset[ block ];
+  ramdisk_block_stream.next_out = ( Bytef* )victim->data;
+  ramdisk_block_stream.avail_out = ramdisk_block_header->block_size;
+  int err = inflate( &ramdisk_block_stream, Z_FINISH );
+  if ( Z_STREAM_END != err || ramdisk_block_stream.total_out != expected ) {
+    EARLY_STARTUP_PRINT( "error during inflate of block %"PRIu32" ( %d )!\r\n",
+      block, err )
+    return NULL;
+  }
+  victim->block = block;
+  victim->age = ++ramdisk_cache_clock;
+  victim->valid = true;
+  return victim->data;
+}
+
+/**
+ * @fn bool ramdisk_setup(void)
+ * @brief Prepare ramdisk access, seekable images are inflated on demand,
+ * plain gzip images are extracted completely
+ *
+ * @return
+ */
+bool ramdisk_setup( void ) {
+  const ramdisk_block_header_t* header = ( const ramdisk_block_header_t* )
+    ramdisk_compressed;
+  if (
+    sizeof( *header ) <= ramdisk_compressed_size
+    && 0 == memcmp(
+      header->magic,
+      RAMDISK_BLOCK_MAGIC,
+      RAMDISK_BLOCK_MAGIC_SIZE
+    )
+  ) {
+    return ramdisk_block_setup( header );
+  }
+  if ( 4 > ramdisk_compressed_size ) {
+    return false;
+  }
+  // size from gzip trailer to avoid an additional inflate pass
+  const uint8_t* trailer = ( const uint8_t* )(
+    ramdisk_compressed + ramdisk_compressed_size - 4
+  );
+  ramdisk_decompressed_size = ( size_t )trailer[ 0 ]
+    | ( size_t )trailer[ 1 ] << 8
+    | ( size_t )trailer[ 2 ] << 16
+    | ( size_t )trailer[ 3 ] << 24;
+  if ( ramdisk_decompressed_size ) {
+    ramdisk_decompressed = ( uintptr_t )ramdisk_extract_shared(
+      ramdisk_compressed,
+      ramdisk_compressed_size,
+      ramdisk_decompressed_size
+    );
+  }
+  // fallback to counting when trailer doesn't fit
+  if ( ! ramdisk_decompressed ) {
+    ramdisk_decompressed_size = ramdisk_extract_size(
+      ramdisk_compressed,
+      ramdisk_compressed_size
+    );
+    ramdisk_decompressed = ( uintptr_t )ramdisk_extract(
+      ramdisk_compressed,
+      ramdisk_compressed_size,
+      ramdisk_decompressed_size
+    );
+  }
+  return ramdisk_decompressed;
+}
+
+/**
+ * @fn void ramdisk_teardown(void)
+ * @brief Free extracted ramdisk or block cache
+ */
+void ramdisk_teardown( void ) {
+  if ( ramdisk_decompressed && ramdisk_shared_id ) {
+    _memory_shared_detach( ramdisk_shared_id );
+    ramdisk_shared_id = 0;
+    ramdisk_decompressed = 0;
+  } else if ( ramdisk_decompressed ) {
+    free( ( void* )ramdisk_decompressed );
+    ramdisk_decompressed = 0;
+  }
+  if ( ramdisk_block_header ) {
+    for ( size_t i = 0; i < RAMDISK_CACHE_SIZE; i++ ) {
+      free( ramdisk_cache[ i ].data );
+    }
+    memset( ramdisk_cache, 0, sizeof( ramdisk_cache ) );
+    inflateEnd( &ramdisk_block_stream );
+    ramdisk_block_header = NULL;
+    ramdisk_block_offset = NULL;
+  }
+}
+
+/**
+ * @fn ssize_t ramdisk_read(size_t, void*, size_t)
+ * @brief Read from decompressed ramdisk
+ *
+ * @param offset offset within decompressed ramdisk
+ * @param buffer
+ * @param count
+ * @return amount read or -1 on error
+ */
+ssize_t ramdisk_read( size_t offset, void* buffer, size_t count ) {
+  // handle end reached and cap amount
+  if ( offset >= ramdisk_decompressed_size ) {
+    return 0;
+  }
+  if ( count > ramdisk_decompressed_size - offset ) {
+    count = ramdisk_decompressed_size - offset;
+  }
+  // completely extracted image
+  if ( ramdisk_decompressed ) {
+    memcpy( buffer, ( uint8_t* )ramdisk_decompressed + offset, count );
+    return ( ssize_t )count;
+  }
+  if ( ! ramdisk_block_header ) {
+    return -1;
+  }
+  // copy block wise
+  uint8_t* dst = buffer;
+  size_t remaining = count;
+  while ( remaining ) {
+    uint32_t block = ( uint32_t )( offset / ramdisk_block_header->block_size );
+    size_t block_offset = offset % ramdisk_block_header->block_size;
+    uint8_t* data = ramdisk_block_get( block );
+    if ( ! data ) {
+      return -1;
+    }
+    size_t amount = ramdisk_block_header->block_size - block_offset;
+    if ( amount > remaining ) {
+      amount = remaining;
+    }
+    memcpy( dst, data + block_offset, amount );
+    dst += amount;
+    offset += amount;
+    remaining -= amount;
+  }
+  return ( ssize_t )count;
+}
+
+/**
+ * @fn int ramdisk_skip_regfile(TAR*)
+ * @brief Skip file content by moving read offset without reading data
+ *
+ * @param t
+ * @return
+ */
+int ramdisk_skip_regfile( TAR* t ) {
+  size_t size = th_get_size( t );
+  size_t skip = ( size / T_BLOCKSIZE + ( size % T_BLOCKSIZE ? 1 : 0 ) )
+    * T_BLOCKSIZE;
+  if ( skip > ramdisk_decompressed_size - ramdisk_read_offset ) {
+    errno = EINVAL;
+    return -1;
+  }
+  ramdisk_read_offset += skip;
+  return 0;
+}
+
+/**
+ * @fn uint32_t ramdisk_hash(const char*)
+ * @brief FNV-1a hash of path, has to match ramdisk tool
+ *
+ * @param path
+ * @return
+ */
+uint32_t ramdisk_hash( const char* path ) {
+  uint32_t hash = 0x811c9dc5;
+  while ( *path ) {
+    hash ^= ( uint8_t )*path++;
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
+/**
+ * @fn bool ramdisk_file_insert(const char*, uint32_t, size_t, size_t)
+ * @brief Insert file into lookup table, first entry wins
+ *
+ * @param path
+ * @param hash
+ * @param offset
+ * @param size
+ * @return
+ */
+static bool ramdisk_file_insert(
+  const char* path,
+  uint32_t hash,
+  size_t offset,
+  size_t size
+) {
+  // ignore files exceeding ramdisk
+  if (
+    offset > ramdisk_decompressed_size
+    || size > ramdisk_decompressed_size - offset
+  ) {
+    return false;
+  }
+  uint32_t idx = hash & ramdisk_file_mask;
+  while ( ramdisk_file_table[ idx ].path ) {
+    if (
+      hash == ramdisk_file_table[ idx ].hash
+      && 0 == strcmp( path, ramdisk_file_table[ idx ].path )
+    ) {
+      return false;
+    }
+    idx = ( idx + 1 ) & ramdisk_file_mask;
+  }
+  ramdisk_file_table[ idx ].path = path;
+  ramdisk_file_table[ idx ].hash = hash;
+  ramdisk_file_table[ idx ].offset = offset;
+  ramdisk_file_table[ idx ].size = size;
+  return true;
+}
+
+/**
+ * @fn bool ramdisk_file_allocate(size_t)
+ * @brief Allocate lookup table for amount of files
+ *
+ * @param count
+ * @return
+ */
+static bool ramdisk_file_allocate( size_t count ) {
+  // keep load factor at or below one half
+  size_t capacity = 16;
+  while ( capacity < count * 2 ) {
+    capacity <<= 1;
+  }
+  ramdisk_file_table = malloc( capacity * sizeof( ramdisk_file_t ) );
+  if ( ! ramdisk_file_table ) {
+    return false;
+  }
+  memset( ramdisk_file_table, 0, capacity * sizeof( ramdisk_file_t ) );
+  ramdisk_file_mask = ( uint32_t )capacity - 1;
+  return true;
+}
+
+/**
+ * @fn bool ramdisk_index_load(const uint8_t*, size_t)
+ * @brief Fill lookup table from index generated by ramdisk tool
+ *
+ * @param data
+ * @param size
+ * @return
+ */
+static bool ramdisk_index_load( const uint8_t* data, size_t size ) {
+  const ramdisk_index_header_t* header = ( const ramdisk_index_header_t* )data;
+  // validate header
+  if (
+    sizeof( *header ) > size
+    || 0 != memcmp(
+      header->magic,
+      RAMDISK_INDEX_MAGIC,
+      RAMDISK_INDEX_MAGIC_SIZE
+    )
+  ) {
+    return false;
+  }
+  size_t entry_size = header->count * sizeof( ramdisk_index_entry_t );
+  if (
+    header->count > size / sizeof( ramdisk_index_entry_t )
+    || entry_size + sizeof( *header ) > size
+    || header->string_size > size - entry_size - sizeof( *header )
+    || ! header->string_size
+  ) {
+    return false;
+  }
+  const ramdisk_index_entry_t* entry = ( const ramdisk_index_entry_t* )(
+    data + sizeof( *header )
+  );
+  const char* string = ( const char* )( entry + header->count );
+  // string table has to be terminated
+  if ( '\0' != string[ header->string_size - 1 ] ) {
+    return false;
+  }
+  if ( ! ramdisk_file_allocate( header->count ) ) {
+    return false;
+  }
+  for ( uint32_t i = 0; i < header->count; i++ ) {
+    if ( entry[ i ].path >= header->string_size ) {
+      continue;
+    }
+    ramdisk_file_insert(
+      string + entry[ i ].path,
+      entry[ i ].hash,
+      entry[ i ].offset,
+      entry[ i ].size
+    );
+  }
+  return true;
+}
+
+/**
+ * @fn bool ramdisk_index_scan(TAR*)
+ * @brief Fill lookup table by a single scan for images without index
+ *
+ * @param t
+ * @return
+ */
+static bool ramdisk_index_scan( TAR* t ) {
+  size_t count = 0;
+  // count regular files
+  ramdisk_read_offset = 0;
   while ( th_read( t ) == 0 ) {
     if ( TH_ISREG( t ) ) {
-      // get filename
-      char* filename = th_get_pathname( t );
-      // check for vfs
-      if ( 0 == strcmp( name, filename ) ) {
-        // set vfs image addr
-        file = ( void* )(
-          ( uint8_t* )ramdisk_decompressed + ramdisk_read_offset
-        );
-        if ( size ) {
-          *size = th_get_size( t );
-        }
-        EARLY_STARTUP_PRINT( "%s size = %#zx\r\n", filename, th_get_size( t ) )
-        break;
+      count++;
+      if ( ramdisk_skip_regfile( t ) != 0 ) {
+        return false;
       }
-      // skip to next file
-      if ( tar_skip_regfile( t ) != 0 ) {
-        EARLY_STARTUP_PRINT( "tar_skip_regfile(): %s\n", strerror( errno ) )
-        break;
+    }
+  }
+  if ( ! ramdisk_file_allocate( count ) ) {
+    return false;
+  }
+  // insert regular files
+  ramdisk_read_offset = 0;
+  while ( th_read( t ) == 0 ) {
+    if ( TH_ISREG( t ) ) {
+      char* path = strdup( th_get_pathname( t ) );
+      if ( ! path ) {
+        return false;
+      }
+      if ( ! ramdisk_file_insert(
+        path,
+        ramdisk_hash( path ),
+        ramdisk_read_offset,
+        th_get_size( t )
+      ) ) {
+        free( path );
+      }
+      if ( ramdisk_skip_regfile( t ) != 0 ) {
+        return false;
       }
     }
   }
+  return true;
+}
 
-  return file;
+/**
+ * @fn bool ramdisk_index_init(TAR*)
+ * @brief Build file lookup table from index if existing, else by scanning tar
+ *
+ * @param t
+ * @return
+ */
+bool ramdisk_index_init( TAR* t ) {
+  bool result = false;
+  // index is expected as first member
+  ramdisk_read_offset = 0;
+  if (
+    th_read( t ) == 0
+    && TH_ISREG( t )
+    && 0 == strcmp( th_get_pathname( t ), RAMDISK_INDEX_NAME )
+  ) {
+    size_t size = th_get_size( t );
+    // index stays allocated, lookup table references its strings
+    uint8_t* index = malloc( size );
+    if (
+      index
+      && ramdisk_read( ramdisk_read_offset, index, size ) == ( ssize_t )size
+    ) {
+      result = ramdisk_index_load( index, size );
+    }
+    if ( ! result ) {
+      free( index );
+      if ( ramdisk_file_table ) {
+        free( ramdisk_file_table );
+        ramdisk_file_table = NULL;
+      }
+    }
+  }
+  // fallback to plain tar
+  if ( ! result ) {
+    EARLY_STARTUP_PRINT( "No valid ramdisk index, scanning tar\r\n" )
+    result = ramdisk_index_scan( t );
+  }
+  // reset read offset
+  ramdisk_read_offset = 0;
+  return result;
+}
+
+/**
+ * @fn ramdisk_file_ptr_t ramdisk_lookup_file(const char*)
+ * @brief Lookup regular file within ramdisk
+ *
+ * @param name path within ramdisk without leading slash
+ * @return file entry with offset and size or NULL
+ */
+ramdisk_file_ptr_t ramdisk_lookup_file( const char* name ) {
+  if ( ! ramdisk_file_table ) {
+    return NULL;
+  }
+  uint32_t hash = ramdisk_hash( name );
+  uint32_t idx = hash & ramdisk_file_mask;
+  while ( ramdisk_file_table[ idx ].path ) {
+    ramdisk_file_ptr_t file = &ramdisk_file_table[ idx ];
+    if ( hash == file->hash && 0 == strcmp( name, file->path ) ) {
+      return file;
+    }
+    idx = ( idx + 1 ) & ramdisk_file_mask;
+  }
+  return NULL;
+}
+
+/**
+ * @fn bool ramdisk_map_file_area(ramdisk_file_ptr_t)
+ * @brief Fill per file shared area when ramdisk isn't extracted completely
+ *
+ * @param file
+ * @return
+ */
+static bool ramdisk_map_file_area( ramdisk_file_ptr_t file ) {
+  // area stays attached as mapping source
+  if ( file->shm_id ) {
+    return true;
+  }
+  size_t id = _memory_shared_create( file->size );
+  if ( errno || 0 == id ) {
+    return false;
+  }
+  void* address = _memory_shared_attach( id, ( uintptr_t )NULL );
+  if ( errno || ! address ) {
+    // release never attached area
+    _memory_shared_detach( id );
+    return false;
+  }
+  ssize_t length = ramdisk_read( file->offset, address, file->size );
+  if ( length != ( ssize_t )file->size ) {
+    _memory_shared_detach( id );
+    return false;
+  }
+  file->shm_id = id;
+  file->shm_address = ( uintptr_t )address;
+  return true;
+}
+
+/**
+ * @fn int ramdisk_map(ramdisk_file_ptr_t, size_t, size_t, pid_t, size_t*, size_t*, size_t*)
+ * @brief Provide read only area containing range of a file
+ *
+ * @param file
+ * @param offset offset within file
+ * @param len requested length
+ * @param receiver process the area is passed to
+ * @param shm_id created sealed area or 0 if nothing is left to map
+ * @param area_offset offset of requested data within area
+ * @param amount length capped at end of file
+ * @return 0 on success, negative errno otherwise
+ *
+ * @note areas cover whole pages, so neighbouring ramdisk data at the borders
+ * is visible to the client
+ */
+int ramdisk_map(
+  ramdisk_file_ptr_t file,
+  size_t offset,
+  size_t len,
+  pid_t receiver,
+  size_t* shm_id,
+  size_t* area_offset,
+  size_t* amount
+) {
+  *shm_id = 0;
+  *area_offset = 0;
+  *amount = 0;
+  // handle end reached and cap amount
+  if ( offset >= file->size || 0 == len ) {
+    return 0;
+  }
+  if ( len > file->size - offset ) {
+    len = file->size - offset;
+  }
+  // determine page aligned base and position of data
+  uintptr_t base;
+  size_t position;
+  if ( ramdisk_decompressed && ramdisk_shared_id ) {
+    base = ramdisk_decompressed;
+    position = file->offset + offset;
+  } else if ( ramdisk_block_header ) {
+    if ( ! ramdisk_map_file_area( file ) ) {
+      return -ENOMEM;
+    }
+    base = file->shm_address;
+    position = offset;
+  } else {
+    return -ENOTSUP;
+  }
+  size_t page_offset = position % RAMDISK_PAGE_SIZE;
+  size_t page_len = page_offset + len;
+  if ( page_len % RAMDISK_PAGE_SIZE ) {
+    page_len += RAMDISK_PAGE_SIZE - page_len % RAMDISK_PAGE_SIZE;
+  }
+  // share existing pages read only
+  size_t id = _memory_shared_grant(
+    base + position - page_offset,
+    page_len,
+    receiver
+  );
+  if ( 0 == id ) {
+    return -EIO;
+  }
+  *shm_id = id;
+  *area_offset = page_offset;
+  *amount = len;
+  return 0;
 }
 
 void ramdisk_dump( TAR* t ) {
@@ -162,8 +807,8 @@ void ramdisk_dump( TAR* t ) {
       char* filename = th_get_pathname( t );
       EARLY_STARTUP_PRINT( "%10s - %s\r\n", "file", filename )
       // skip to next file
-      if ( tar_skip_regfile( t ) != 0 ) {
-        EARLY_STARTUP_PRINT( "tar_skip_regfile(): %s\n", strerror( errno ) )
+      if ( ramdisk_skip_regfile( t ) != 0 ) {
+        EARLY_STARTUP_PRINT( "ramdisk_skip_regfile(): %s\n", strerror( errno ) )
         break;
       }
     } else if ( TH_ISSYM( t ) ) {
@@ -17,11 +17,77 @@
  * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
 #include <libtar.h>
 
 #if !defined( _RAMDISK_H )
 #define _RAMDISK_H
 
+// index placed as first member of ramdisk by ramdisk tool
+#define RAMDISK_INDEX_NAME "ramdisk.idx"
+#define RAMDISK_INDEX_MAGIC "BRDIDX01"
+#define RAMDISK_INDEX_MAGIC_SIZE 8
+
+struct ramdisk_index_header {
+  char magic[ RAMDISK_INDEX_MAGIC_SIZE ];
+  uint32_t count;
+  uint32_t string_size;
+};
+typedef struct ramdisk_index_header ramdisk_index_header_t;
+typedef struct ramdisk_index_header* ramdisk_index_header_ptr_t;
+
+// offsets are relative to begin of decompressed ramdisk and string table
+struct ramdisk_index_entry {
+  uint32_t hash;
+  uint32_t path;
+  uint32_t offset;
+  uint32_t size;
+};
+typedef struct ramdisk_index_entry ramdisk_index_entry_t;
+typedef struct ramdisk_index_entry* ramdisk_index_entry_ptr_t;
+
+// seekable ramdisk with independently compressed blocks
+#define RAMDISK_BLOCK_MAGIC "BRDBLK01"
+#define RAMDISK_BLOCK_MAGIC_SIZE 8
+#define RAMDISK_BLOCK_SIZE_MAX 0x100000
+#define RAMDISK_CACHE_SIZE 8
+
+// granularity of read only mappings handed out to clients
+#define RAMDISK_PAGE_SIZE 0x1000
+
+// header is followed by block_count + 1 compressed offsets from image start
+struct ramdisk_block_header {
+  char magic[ RAMDISK_BLOCK_MAGIC_SIZE ];
+  uint32_t block_size;
+  uint32_t block_count;
+  uint32_t size;
+};
+typedef struct ramdisk_block_header ramdisk_block_header_t;
+typedef struct ramdisk_block_header* ramdisk_block_header_ptr_t;
+
+struct ramdisk_cache {
+  uint8_t* data;
+  uint32_t block;
+  uint32_t age;
+  bool valid;
+};
+typedef struct ramdisk_cache ramdisk_cache_t;
+typedef struct ramdisk_cache* ramdisk_cache_ptr_t;
+
+struct ramdisk_file {
+  const char* path;
+  uint32_t hash;
+  size_t offset;
+  size_t size;
+  // per file area used for mappings of block wise compressed ramdisk
+  size_t shm_id;
+  uintptr_t shm_address;
+};
+typedef struct ramdisk_file ramdisk_file_t;
+typedef struct ramdisk_file* ramdisk_file_ptr_t;
+
 extern uintptr_t ramdisk_compressed;
 extern size_t ramdisk_compressed_size;
 extern uintptr_t ramdisk_decompressed;
@@ -30,7 +96,14 @@ extern size_t ramdisk_read_offset;
 
 size_t ramdisk_extract_size( uintptr_t, size_t );
 void* ramdisk_extract( uintptr_t, size_t, size_t );
-void* ramdisk_lookup_file( TAR*, const char*, size_t* );
+bool ramdisk_setup( void );
+void ramdisk_teardown( void );
+ssize_t ramdisk_read( size_t, void*, size_t );
+int ramdisk_skip_regfile( TAR* );
+uint32_t ramdisk_hash( const char* );
+bool ramdisk_index_init( TAR* );
+ramdisk_file_ptr_t ramdisk_lookup_file( const char* );
+int ramdisk_map( ramdisk_file_ptr_t, size_t, size_t, pid_t, size_t*, size_t*, size_t* );
 void ramdisk_dump( TAR* );
 
 #endif
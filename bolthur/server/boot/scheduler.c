@@ -0,0 +1,335 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <sys/stat.h>
+#include <sys/bolthur.h>
+#include "../libvfs.h"
+#include "scheduler.h"
+
+// incremented with every wake up
+static volatile uint32_t scheduler_generation = 0;
+// pending fallback timer
+static volatile size_t scheduler_timer = 0;
+
+/**
+ * @fn void scheduler_handle_wakeup(size_t, pid_t, size_t, size_t)
+ * @brief Handle device notification of vfs and fallback timer
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+static void scheduler_handle_wakeup(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  // ready list is not needed, devices are checked by scheduler
+  if ( data_info ) {
+    bolthur_rpc_remove_data( data_info );
+  }
+  if ( VFS_DAEMON_ID != origin && getpid() != origin ) {
+    return;
+  }
+  if ( SCHEDULER_WAKEUP == type ) {
+    scheduler_timer = 0;
+  }
+  scheduler_generation++;
+}
+
+/**
+ * @fn bool scheduler_device_exists(const char*)
+ * @brief Method to check if path exists
+ *
+ * @param path
+ * @return
+ */
+static bool scheduler_device_exists( const char* path ) {
+  struct stat buffer;
+  return stat( path, &buffer ) == 0;
+}
+
+/**
+ * @fn pid_t scheduler_execute(char*)
+ * @brief Helper to execute specific driver from ramdisk
+ *
+ * @param name
+ * @return
+ */
+static pid_t scheduler_execute( char* name ) {
+  // pure kernel fork necessary here
+  pid_t forked_process = _process_fork();
+  if ( errno ) {
+    EARLY_STARTUP_PRINT(
+      "Unable to fork process for image replace: %s\r\n",
+      strerror( errno )
+    )
+    return -1;
+  }
+  // fork only
+  if ( 0 == forked_process ) {
+    char* base = basename( name );
+    if ( ! base ) {
+      EARLY_STARTUP_PRINT( "Basename failed!\r\n" )
+      exit( -1 );
+    }
+    // build command
+    char* cmd[] = { base, NULL, };
+    // exec to replace
+    if ( -1 == execv( name, cmd ) ) {
+      EARLY_STARTUP_PRINT( "Exec failed: %s\r\n", strerror( errno ) )
+      exit( 1 );
+    }
+  }
+  // non fork return 0
+  return forked_process;
+}
+
+/**
+ * @fn int scheduler_watch(void)
+ * @brief Watch device directory for added nodes
+ *
+ * @return handle of watched directory or -1
+ */
+static int scheduler_watch( void ) {
+  int fd = open( SCHEDULER_DEVICE_PATH, O_RDONLY );
+  if ( -1 == fd ) {
+    return -1;
+  }
+  vfs_notify_register_request_t request;
+  memset( &request, 0, sizeof( request ) );
+  request.count = 1;
+  request.entry[ 0 ].handle = fd;
+  request.entry[ 0 ].events = VFS_NOTIFY_CHILD;
+  // register interest
+  size_t response_id = bolthur_rpc_raise(
+    RPC_VFS_NOTIFY_REGISTER,
+    VFS_DAEMON_ID,
+    &request,
+    sizeof( request ),
+    true,
+    false,
+    RPC_VFS_NOTIFY_REGISTER,
+    &request,
+    sizeof( request ),
+    0,
+    0
+  );
+  if ( errno ) {
+    close( fd );
+    return -1;
+  }
+  vfs_notify_ready_t response;
+  memset( &response, 0, sizeof( response ) );
+  _rpc_get_data( &response, sizeof( response ), response_id, false );
+  if ( errno || 0 > response.status ) {
+    close( fd );
+    return -1;
+  }
+  return fd;
+}
+
+/**
+ * @fn bool scheduler_launchable(manifest_ptr_t, manifest_driver_ptr_t)
+ * @brief Check dependencies of waiting driver, marks driver as failed if a
+ * dependency failed
+ *
+ * @param manifest
+ * @param driver
+ * @return
+ */
+static bool scheduler_launchable(
+  manifest_ptr_t manifest,
+  manifest_driver_ptr_t driver
+) {
+  for ( size_t i = 0; i < driver->depend_count; i++ ) {
+    manifest_driver_ptr_t depend = &manifest->driver[ driver->depend[ i ] ];
+    if ( MANIFEST_DRIVER_FAILED == depend->state ) {
+      EARLY_STARTUP_PRINT(
+        "Skipping %s due to failed dependency %s\r\n",
+        driver->name, depend->name
+      )
+      driver->state = MANIFEST_DRIVER_FAILED;
+      return false;
+    }
+    if ( MANIFEST_DRIVER_READY != depend->state ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @fn bool scheduler_run(manifest_ptr_t)
+ * @brief Start all drivers of manifest, each one as soon as its dependencies
+ * are ready
+ *
+ * @param manifest
+ * @return
+ *
+ * @note Scheduler is woken up by vfs when a device is added, with a timer as
+ * fallback when notification isn't available
+ */
+bool scheduler_run( manifest_ptr_t manifest ) {
+  size_t interval = _timer_get_frequency() * SCHEDULER_WAKEUP_INTERVAL / 1000;
+  if ( ! interval ) {
+    interval = 1;
+  }
+  // register wake up handler
+  bolthur_rpc_bind( RPC_VFS_NOTIFY_READY, scheduler_handle_wakeup );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register notify handler!\r\n" )
+    return false;
+  }
+  bolthur_rpc_bind( SCHEDULER_WAKEUP, scheduler_handle_wakeup );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register wakeup handler!\r\n" )
+    return false;
+  }
+  int watch = scheduler_watch();
+  if ( -1 == watch ) {
+    EARLY_STARTUP_PRINT( "Device notification unavailable, polling!\r\n" )
+  }
+  bool result = true;
+  while ( true ) {
+    uint32_t generation = scheduler_generation;
+    // collect drivers which came up
+    for ( size_t i = 0; i < manifest->count; i++ ) {
+      manifest_driver_ptr_t driver = &manifest->driver[ i ];
+      if (
+        MANIFEST_DRIVER_STARTED == driver->state
+        && (
+          ! *driver->provides
+          || scheduler_device_exists( driver->provides )
+        )
+      ) {
+        driver->tick_ready = _timer_get_tick();
+        driver->state = MANIFEST_DRIVER_READY;
+      }
+    }
+    // launch everything with satisfied dependencies
+    for ( size_t i = 0; i < manifest->count; i++ ) {
+      manifest_driver_ptr_t driver = &manifest->driver[ i ];
+      if (
+        MANIFEST_DRIVER_WAITING != driver->state
+        || ! scheduler_launchable( manifest, driver )
+      ) {
+        continue;
+      }
+      EARLY_STARTUP_PRINT( "Starting %s server...\r\n", driver->name )
+      driver->tick_start = _timer_get_tick();
+      driver->pid = scheduler_execute( driver->path );
+      driver->state = -1 == driver->pid
+        ? MANIFEST_DRIVER_FAILED
+        : MANIFEST_DRIVER_STARTED;
+    }
+    size_t started = 0;
+    size_t waiting = 0;
+    for ( size_t i = 0; i < manifest->count; i++ ) {
+      if ( MANIFEST_DRIVER_STARTED == manifest->driver[ i ].state ) {
+        started++;
+      } else if ( MANIFEST_DRIVER_WAITING == manifest->driver[ i ].state ) {
+        waiting++;
+      }
+    }
+    // nothing running means nothing can change anymore
+    if ( ! started ) {
+      for ( size_t i = 0; waiting && i < manifest->count; i++ ) {
+        if ( MANIFEST_DRIVER_WAITING == manifest->driver[ i ].state ) {
+          EARLY_STARTUP_PRINT(
+            "Unresolvable dependencies of %s\r\n",
+            manifest->driver[ i ].name
+          )
+          manifest->driver[ i ].state = MANIFEST_DRIVER_FAILED;
+        }
+      }
+      break;
+    }
+    // wait for notification, timer catches a wake up missed before waiting
+    if ( generation == scheduler_generation ) {
+      if ( ! scheduler_timer ) {
+        scheduler_timer = _timer_acquire(
+          SCHEDULER_WAKEUP,
+          _timer_get_tick() + interval
+        );
+      }
+      if ( scheduler_timer && generation == scheduler_generation ) {
+        _rpc_wait_for_call();
+      }
+    }
+  }
+  // cleanup
+  if ( scheduler_timer ) {
+    _timer_release( scheduler_timer );
+    scheduler_timer = 0;
+  }
+  if ( -1 != watch ) {
+    close( watch );
+  }
+  for ( size_t i = 0; i < manifest->count; i++ ) {
+    if ( MANIFEST_DRIVER_READY != manifest->driver[ i ].state ) {
+      result = false;
+    }
+  }
+  return result;
+}
+
+/**
+ * @fn void scheduler_timeline(manifest_ptr_t)
+ * @brief Print start and ready tick of all drivers
+ *
+ * @param manifest
+ */
+void scheduler_timeline( manifest_ptr_t manifest ) {
+  size_t frequency = _timer_get_frequency();
+  EARLY_STARTUP_PRINT(
+    "Boot timeline of %s ( %zu ticks per second ):\r\n",
+    manifest->name, frequency
+  )
+  for ( size_t i = 0; i < manifest->count; i++ ) {
+    manifest_driver_ptr_t driver = &manifest->driver[ i ];
+    if ( MANIFEST_DRIVER_READY != driver->state ) {
+      EARLY_STARTUP_PRINT( "%12s - failed\r\n", driver->name )
+      continue;
+    }
+    EARLY_STARTUP_PRINT(
+      "%12s - pid %3d, start %10zu, ready %10zu, took %10zu\r\n",
+      driver->name, driver->pid, driver->tick_start, driver->tick_ready,
+      driver->tick_ready - driver->tick_start
+    )
+  }
+  manifest_driver_ptr_t ready = &manifest->driver[ manifest->ready_index ];
+  if ( MANIFEST_DRIVER_READY != ready->state || ! frequency ) {
+    return;
+  }
+  EARLY_STARTUP_PRINT(
+    "%s ready %zu ticks ( %"PRIu64" ms ) after kernel entry\r\n",
+    ready->name, ready->tick_ready,
+    ( uint64_t )ready->tick_ready * 1000 / frequency
+  )
+}
@@ -0,0 +1,36 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <sys/bolthur.h>
+#include "manifest.h"
+
+#if !defined( _SCHEDULER_H )
+#define _SCHEDULER_H
+
+// timer rpc used as fallback wake up of scheduler
+#define SCHEDULER_WAKEUP RPC_CUSTOM_START
+#define SCHEDULER_WAKEUP_INTERVAL 50
+// directory of provided devices
+#define SCHEDULER_DEVICE_PATH "/dev"
+
+bool scheduler_run( manifest_ptr_t );
+void scheduler_timeline( manifest_ptr_t );
+
+#endif
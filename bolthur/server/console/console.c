@@ -19,6 +19,10 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/bolthur.h>
 #include "console.h"
 
 /**
@@ -34,6 +38,9 @@ void console_destroy( console_ptr_t console ) {
   if ( console->path ) {
     free( console->path );
   }
+  if ( console->buffer ) {
+    free( console->buffer );
+  }
   free( console );
 }
 
@@ -73,3 +80,177 @@ console_ptr_t console_get_by_path( const char* path ) {
   }
   return NULL;
 }
+
+/**
+ * @fn ssize_t console_raise(console_ptr_t, size_t, terminal_write_request_ptr_t)
+ * @brief Raise write request at terminal of console
+ *
+ * @param console
+ * @param rpc_num
+ * @param terminal
+ * @return
+ */
+static ssize_t console_raise(
+  console_ptr_t console,
+  size_t rpc_num,
+  terminal_write_request_ptr_t terminal
+) {
+  if ( 0 == console->fd ) {
+    // open path
+    int fd = open( console->path, O_RDWR );
+    // handle error
+    if ( -1 == fd ) {
+      EARLY_STARTUP_PRINT( "Unable to open %s\r\n", console->path )
+      return -EIO;
+    }
+    // push back file handle
+    console->fd = fd;
+  }
+  strncpy( terminal->terminal, console->path, PATH_MAX - 1 );
+  // raise write request
+  int result = ioctl(
+    console->fd,
+    IOCTL_BUILD_REQUEST(
+      rpc_num,
+      sizeof( terminal_write_request_t ),
+      IOCTL_RDWR
+    ),
+    terminal
+  );
+  // handle error
+  if ( -1 == result ) {
+    EARLY_STARTUP_PRINT( "ioctl error!\r\n" )
+    return -EIO;
+  }
+  return *( ( int* )terminal );
+}
+
+/**
+ * @fn ssize_t console_write(console_ptr_t, size_t, const char*, size_t)
+ * @brief Write data unbuffered to terminal of console
+ *
+ * @param console
+ * @param rpc_num
+ * @param data
+ * @param len
+ * @return
+ */
+ssize_t console_write(
+  console_ptr_t console,
+  size_t rpc_num,
+  const char* data,
+  size_t len
+) {
+  // keep order with buffered output
+  console_flush( console );
+  // build terminal command
+  terminal_write_request_ptr_t terminal = malloc( sizeof( terminal_write_request_t ) );
+  if ( ! terminal ) {
+    return -EIO;
+  }
+  memset( terminal, 0, sizeof( terminal_write_request_t ) );
+  if ( len > MAX_WRITE_LEN ) {
+    len = MAX_WRITE_LEN;
+  }
+  terminal->len = len;
+  memcpy( terminal->data, data, len );
+  ssize_t result = console_raise( console, rpc_num, terminal );
+  free( terminal );
+  return result;
+}
+
+/**
+ * @fn void console_flush(console_ptr_t)
+ * @brief Flush buffered output of console
+ *
+ * @param console
+ */
+void console_flush( console_ptr_t console ) {
+  if ( ! console->buffer || ! console->buffer->len ) {
+    return;
+  }
+  console->buffer->data[ console->buffer->len ] = '\0';
+  // errors cannot be reported anymore as the write returned already
+  if ( 0 > console_raise( console, console->out, console->buffer ) ) {
+    EARLY_STARTUP_PRINT( "Unable to flush %s\r\n", console->path )
+  }
+  console->buffer->len = 0;
+  console->buffer_newline = 0;
+  console->buffer_writes = 0;
+  console->flush_tick = _timer_get_tick();
+}
+
+/**
+ * @fn ssize_t console_write_buffered(console_ptr_t, const char*, size_t)
+ * @brief Append data to output buffer of console and flush if necessary
+ *
+ * @param console
+ * @param data
+ * @param len
+ * @return
+ *
+ * @note The buffer is flushed when full, after a burst of newlines or when
+ * the flush timer expires. A newline written after the console has been
+ * idle for the maximum interval is flushed immediately.
+ */
+ssize_t console_write_buffered(
+  console_ptr_t console,
+  const char* data,
+  size_t len
+) {
+  // allocate buffer on first use
+  if ( ! console->buffer ) {
+    console->buffer = malloc( sizeof( terminal_write_request_t ) );
+    if ( ! console->buffer ) {
+      return console_write( console, console->out, data, len );
+    }
+    memset( console->buffer, 0, sizeof( terminal_write_request_t ) );
+  }
+  // write oversized data directly
+  if ( len > CONSOLE_BUFFER_SIZE ) {
+    return console_write( console, console->out, data, len );
+  }
+  // flush if data doesn't fit
+  if ( len > CONSOLE_BUFFER_SIZE - console->buffer->len ) {
+    console_flush( console );
+  }
+  size_t tick = _timer_get_tick();
+  size_t frequency = _timer_get_frequency();
+  bool idle = ! console->buffer->len && tick - console->flush_tick
+    >= frequency * CONSOLE_FLUSH_INTERVAL_MAX / 1000;
+  // append data and count newlines
+  memcpy( console->buffer->data + console->buffer->len, data, len );
+  console->buffer->len += len;
+  console->buffer_writes++;
+  const char* end = data + len;
+  for (
+    const char* nl = memchr( data, '\n', len );
+    nl;
+    nl = memchr( nl + 1, '\n', ( size_t )( end - nl - 1 ) )
+  ) {
+    console->buffer_newline++;
+  }
+  // flush when full, on newline burst or on newline after idle
+  if (
+    CONSOLE_BUFFER_SIZE == console->buffer->len
+    || CONSOLE_FLUSH_NEWLINE <= console->buffer_newline
+    || ( idle && console->buffer_newline )
+  ) {
+    console_flush( console );
+    return ( ssize_t )len;
+  }
+  // arm flush timer
+  if ( ! console->flush_pending ) {
+    size_t timeout = tick + frequency * console->flush_interval / 1000;
+    if ( timeout <= tick ) {
+      timeout = tick + 1;
+    }
+    // flush directly on error or when timeout passed already
+    if ( ! _timer_acquire( CONSOLE_FLUSH, timeout ) || errno ) {
+      console_flush( console );
+      return ( ssize_t )len;
+    }
+    console->flush_pending = true;
+  }
+  return ( ssize_t )len;
+}
@@ -20,10 +20,22 @@
 #include <stdbool.h>
 #include <unistd.h>
 #include "list.h"
+#include "../libterminal.h"
+#include "../libconsole.h"
 
 #if ! defined( _CONSOLE_H )
 #define _CONSOLE_H
 
+// internal rpc raised by timer to flush buffered output
+#define CONSOLE_FLUSH CONSOLE_SELECT + 1
+// buffered output limits, data is passed as terminated string
+#define CONSOLE_BUFFER_SIZE ( MAX_WRITE_LEN - 1 )
+#define CONSOLE_FLUSH_NEWLINE 16
+// flush interval in milliseconds adapting to write bursts
+#define CONSOLE_FLUSH_INTERVAL_MIN 2
+#define CONSOLE_FLUSH_INTERVAL_MAX 32
+#define CONSOLE_FLUSH_BURST 4
+
 struct console {
   bool active;
   pid_t handler;
@@ -32,6 +44,13 @@ struct console {
   size_t out;
   size_t err;
   int fd;
+  // buffered stdout
+  terminal_write_request_ptr_t buffer;
+  size_t buffer_newline;
+  size_t buffer_writes;
+  size_t flush_interval;
+  size_t flush_tick;
+  bool flush_pending;
 };
 typedef struct console console_t;
 typedef struct console* console_ptr_t;
@@ -41,5 +60,8 @@ extern list_manager_ptr_t console_list;
 void console_destroy( console_ptr_t );
 console_ptr_t console_get_active( void );
 console_ptr_t console_get_by_path( const char* );
+ssize_t console_write( console_ptr_t, size_t, const char*, size_t );
+ssize_t console_write_buffered( console_ptr_t, const char*, size_t );
+void console_flush( console_ptr_t );
 
 #endif
@@ -101,6 +101,7 @@ void handler_console_add(
   console->in = command->in;
   console->out = command->out;
   console->err = command->err;
+  console->flush_interval = CONSOLE_FLUSH_INTERVAL_MIN;
   // push to list
   if ( ! list_push_back( console_list, console ) ) {
     console_destroy( console );
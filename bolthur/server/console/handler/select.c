@@ -81,6 +81,7 @@ void handler_console_select(
   // get active console and deactivate
   console_ptr_t console = console_get_active();
   if ( console ) {
+    console_flush( console );
     console->active = false;
   }
   // activate found console
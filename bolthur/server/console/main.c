@@ -80,6 +80,12 @@ int main( __unused int argc, __unused char* argv[] ) {
     EARLY_STARTUP_PRINT( "Unable to register handler stat!\r\n" )
     return -1;
   }
+  // set handler for buffered output flush timer
+  bolthur_rpc_bind( CONSOLE_FLUSH, rpc_handle_flush );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler flush!\r\n" )
+    return -1;
+  }
   // FIXME: SET READ HANDLER FOR STDIN
 
   console_list = list_construct( console_lookup, console_cleanup );
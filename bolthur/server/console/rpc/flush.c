@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unistd.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../list.h"
+#include "../console.h"
+
+/**
+ * @fn void rpc_handle_flush(size_t, pid_t, size_t, size_t)
+ * @brief Handle expired flush timer
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_flush(
+  __unused size_t type,
+  pid_t origin,
+  __unused size_t data_info,
+  __unused size_t response_info
+) {
+  // timer rpc is raised with own process as origin
+  if ( getpid() != origin ) {
+    return;
+  }
+  list_item_ptr_t current = console_list->first;
+  while ( current ) {
+    console_ptr_t console = current->data;
+    if ( console->flush_pending ) {
+      console->flush_pending = false;
+      // grow interval while writes arrive in bursts, shrink otherwise
+      if ( CONSOLE_FLUSH_BURST <= console->buffer_writes ) {
+        console->flush_interval *= 2;
+        if ( CONSOLE_FLUSH_INTERVAL_MAX < console->flush_interval ) {
+          console->flush_interval = CONSOLE_FLUSH_INTERVAL_MAX;
+        }
+      } else {
+        console->flush_interval /= 2;
+        if ( CONSOLE_FLUSH_INTERVAL_MIN > console->flush_interval ) {
+          console->flush_interval = CONSOLE_FLUSH_INTERVAL_MIN;
+        }
+      }
+      console_flush( console );
+    }
+    current = current->next;
+  }
+}
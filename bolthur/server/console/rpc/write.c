@@ -19,9 +19,7 @@
 
 #include <errno.h>
 #include <unistd.h>
-#include <sys/ioctl.h>
 #include <sys/bolthur.h>
-#include <fcntl.h>
 #include "../../libterminal.h"
 #include "../../libconsole.h"
 #include "../rpc.h"
@@ -79,59 +77,22 @@ void rpc_handle_write(
     free( request );
     return;
   }
-  // get rpc to raise
-  size_t rpc_num = 0 == strcmp( "/dev/stdout", request->file_path )
-    ? console->out
-    : console->err;
-  // build terminal command
-  terminal_write_request_ptr_t terminal = malloc( sizeof( terminal_write_request_t ) );
-  if ( ! terminal ) {
-    response.len = -EIO;
-    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
-    return;
+  // stdout is buffered while stderr is passed through directly
+  if ( 0 == strcmp( "/dev/stdout", request->file_path ) ) {
+    response.len = console_write_buffered(
+      console,
+      request->data,
+      request->len
+    );
+  } else {
+    response.len = console_write(
+      console,
+      console->err,
+      request->data,
+      request->len
+    );
   }
-  memset( terminal, 0, sizeof( terminal_write_request_t ) );
-  terminal->len = request->len;
-  memcpy( terminal->data, request->data, request->len );
-  strncpy( terminal->terminal, console->path, PATH_MAX - 1 );
-
-  if ( 0 == console->fd ) {
-    // open path
-    int fd = open( console->path, O_RDWR );
-    // handle error
-    if ( -1 == fd ) {
-      EARLY_STARTUP_PRINT( "Unable to open %s\r\n", console->path )
-      response.len = -EIO;
-      bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-      free( request );
-      return;
-    }
-    // push back file handle
-    console->fd = fd;
-  }
-  // raise write request
-  int result = ioctl(
-    console->fd,
-    IOCTL_BUILD_REQUEST(
-      rpc_num,
-      sizeof( terminal_write_request_t ),
-      IOCTL_RDWR
-    ),
-    terminal
-  );
-  // handle error
-  if ( -1 == result ) {
-    EARLY_STARTUP_PRINT( "ioctl error!\r\n" )
-    response.len = -EIO;
-    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
-    return;
-  }
-  // prepare return
-  response.len = *( ( int* )terminal );
   bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-  free( terminal );
   free( request );
 
   // FIXME: Remove when ioctl is battle proved
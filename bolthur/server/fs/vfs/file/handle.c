@@ -21,6 +21,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <unistd.h>
 #include "handle.h"
 #include "../collection/avl.h"
 
@@ -227,6 +228,11 @@ bool handle_duplicate(
   memset( new_container, 0, sizeof( handle_container_t ) );
   // copy content
   memcpy( new_container, container, sizeof( handle_container_t ) );
+  // point to own copy of target for files below a mount point
+  if ( container->target == &container->mounted ) {
+    new_container->target = &new_container->mounted;
+    new_container->mounted.st = &new_container->mounted_st;
+  }
   // prepare and insert avl node
   avl_prepare_node( &new_container->node, ( void* )new_container->handle );
   if ( ! avl_insert_by_node( new_pid_container->tree, &new_container->node ) ) {
@@ -276,67 +282,17 @@ int handle_generate(
   strncpy( ( *container )->path, path, PATH_MAX - 1 );
   // special handling for symlinks
   if ( S_ISLNK( target->st->st_mode ) ) {
-    while ( target && S_ISLNK( target->st->st_mode ) ) {
-      if ( '/' == target->target[ 0 ] ) {
-        target = vfs_node_by_path( target->target );
-      } else {
-        // allocate target
-        char* link_path = malloc( sizeof( char ) * PATH_MAX );
-        if ( ! link_path ) {
-          free( *container );
-          return -ENOMEM;
-        }
-        char* target_path = vfs_path_bottom_up( target );
-        if ( ! target_path ) {
-          free( link_path );
-          free( *container );
-          return -ENOMEM;
-        }
-        // dir
-        char* dir = dirname( target_path );
-        if ( ! dir ) {
-          free( target_path );
-          free( link_path );
-          free( *container );
-          return -ENOMEM;
-        }
-        // build target path
-        link_path = strncpy( link_path, dir, PATH_MAX - 1 );
-        link_path = strncat(
-          link_path,
-          "/",
-          PATH_MAX - strlen( link_path ) - 1
-        );
-        link_path = strncat(
-          link_path,
-          target->target,
-          PATH_MAX - strlen( link_path ) - 1
-        );
-        // free up base path again
-        free( target_path );
-        free( dir );
-        // overwrite target
-        target = vfs_node_by_path( link_path );
-        // free built link path
-        free( link_path );
-      }
-    }
-    // get link destination
-    char* destination = vfs_path_bottom_up( target ) ;
-    if ( ! destination ) {
+    // resolve link, handle path is used as scratch buffer
+    int result = vfs_resolve_link( target, &target, ( *container )->path );
+    if ( 0 > result ) {
       free( *container );
-      return -ENOENT;
+      return result;
     }
-    // ensure max path
-    if ( PATH_MAX < strlen( destination ) ) {
+    // copy link destination
+    if ( ! vfs_path_into( target, ( *container )->path, PATH_MAX ) ) {
       free( *container );
-      free( destination );
       return -EINVAL;
     }
-    // copy link destination
-    strncpy( ( *container )->path, destination, PATH_MAX - 1 );
-    // free again after copy
-    free( destination );
   }
   // special handling for stdin, stdout and stderr
   bool is_stdin = 0 == strcmp( path, "/dev/stdin" );
@@ -381,6 +337,66 @@ int handle_generate(
   return 0;
 }
 
+/**
+ * @fn int handle_generate_mounted(handle_container_ptr_t*, pid_t, pid_t, const char*, int, int, struct stat*)
+ * @brief Generate new handle for a file below a mount point
+ *
+ * @param container
+ * @param process
+ * @param handler
+ * @param path
+ * @param flags
+ * @param mode
+ * @param st
+ * @return
+ *
+ * @note Files below a mount point aren't part of the vfs tree, so the handle
+ * keeps an own node with the information returned by the handling process.
+ */
+int handle_generate_mounted(
+  handle_container_ptr_t* container,
+  pid_t process,
+  pid_t handler,
+  const char* path,
+  int flags,
+  int mode,
+  struct stat* st
+) {
+  handle_pid_ptr_t process_handle = handle_generate_container( process );
+  if ( ! process_handle ) {
+    return -ENOMEM;
+  }
+  // ensure max path
+  if ( PATH_MAX <= strlen( path ) ) {
+    return -EINVAL;
+  }
+  // allocate and clear structure
+  *container = malloc( sizeof( handle_container_t ) );
+  if ( ! *container ) {
+    return -ENOMEM;
+  }
+  memset( *container, 0, sizeof( handle_container_t ) );
+  // copy path and stat
+  strncpy( ( *container )->path, path, PATH_MAX - 1 );
+  memcpy( &( *container )->mounted_st, st, sizeof( struct stat ) );
+  // populate structure
+  ( *container )->mounted.pid = handler;
+  ( *container )->mounted.st = &( *container )->mounted_st;
+  ( *container )->handle = generate_handle( process_handle );
+  ( *container )->flags = flags;
+  ( *container )->mode = mode;
+  ( *container )->target = &( *container )->mounted;
+  // prepare and insert avl node
+  avl_prepare_node( &(*container)->node, ( void* )(*container)->handle );
+  if ( ! avl_insert_by_node( process_handle->tree, &(*container)->node ) ) {
+    free( *container );
+    *container = NULL;
+    return -ENOMEM;
+  }
+  // return success
+  return 0;
+}
+
 /**
  * @fn void handle_destory_all(pid_t)
  * @brief Destroy all handles of a process
@@ -472,6 +488,40 @@ int handle_get( handle_container_ptr_t* container, pid_t process, int handle ) {
   return 0;
 }
 
+/**
+ * @fn off_t handle_seek(handle_container_ptr_t, off_t, int)
+ * @brief Move position of handle
+ *
+ * @param container
+ * @param offset
+ * @param whence
+ * @return new position or negative errno
+ */
+off_t handle_seek( handle_container_ptr_t container, off_t offset, int whence ) {
+  off_t new_pos;
+  // determine what to do
+  switch( whence ) {
+    case SEEK_SET:
+      new_pos = offset;
+      break;
+    case SEEK_CUR:
+      new_pos = container->pos + offset;
+      break;
+    case SEEK_END:
+      new_pos = ( off_t )container->target->st->st_size;
+      break;
+    default:
+      new_pos = -1;
+  }
+  // validate new position
+  if ( 0 > new_pos || new_pos > container->target->st->st_size ) {
+    return -EINVAL;
+  }
+  // set new position in handle
+  container->pos = new_pos;
+  return new_pos;
+}
+
 /**
  * @fn handle_pid_ptr_t handle_get_process_container(pid_t)
  * @brief
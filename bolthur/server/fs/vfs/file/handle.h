@@ -40,6 +40,8 @@ struct handle_container {
   off_t pos;
   char path[ PATH_MAX ];
   vfs_node_ptr_t target;
+  vfs_node_t mounted;
+  struct stat mounted_st;
 };
 
 typedef struct handle_pid handle_pid_t;
@@ -64,9 +66,11 @@ typedef struct handle_container *handle_container_ptr_t;
 
 bool handle_init( void );
 int handle_generate( handle_container_ptr_t*, pid_t, vfs_node_ptr_t, vfs_node_ptr_t, const char*, int, int );
+int handle_generate_mounted( handle_container_ptr_t*, pid_t, pid_t, const char*, int, int, struct stat* );
 int handle_destory( pid_t, int );
 void handle_destory_all( pid_t );
 int handle_get( handle_container_ptr_t*, pid_t, int );
+off_t handle_seek( handle_container_ptr_t, off_t, int );
 handle_pid_ptr_t handle_get_process_container( pid_t );
 handle_pid_ptr_t handle_generate_container( pid_t );
 bool handle_duplicate( handle_container_ptr_t, handle_pid_ptr_t );
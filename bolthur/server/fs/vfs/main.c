@@ -24,6 +24,11 @@
 #include "vfs.h"
 #include "rpc.h"
 #include "ioctl/handler.h"
+#include "queue/queue.h"
+#include "mount/mount.h"
+#include "pool/pool.h"
+#include "notify/notify.h"
+#include "shared/shared.h"
 
 pid_t pid = 0;
 
@@ -55,6 +60,26 @@ int main( __unused int argc, __unused char* argv[] ) {
     EARLY_STARTUP_PRINT( "Unable to setup ioctl handler structures!\r\n" )
     return -1;
   }
+  if ( ! queue_init() ) {
+    EARLY_STARTUP_PRINT( "Unable to setup queue structures!\r\n" )
+    return -1;
+  }
+  if ( ! pool_init() ) {
+    EARLY_STARTUP_PRINT( "Unable to setup request pool!\r\n" )
+    return -1;
+  }
+  if ( ! mount_init() ) {
+    EARLY_STARTUP_PRINT( "Unable to setup mount structures!\r\n" )
+    return -1;
+  }
+  if ( ! notify_init() ) {
+    EARLY_STARTUP_PRINT( "Unable to setup notify structures!\r\n" )
+    return -1;
+  }
+  if ( ! shared_init() ) {
+    EARLY_STARTUP_PRINT( "Unable to setup shared area structures!\r\n" )
+    return -1;
+  }
   if ( ! vfs_setup( pid ) ) {
     EARLY_STARTUP_PRINT( "Unable to setup vfs structures!\r\n" )
     return -1;
@@ -91,6 +116,16 @@ int main( __unused int argc, __unused char* argv[] ) {
     EARLY_STARTUP_PRINT( "Unable to register handler write!\r\n" )
     return -1;
   }
+  bolthur_rpc_bind( RPC_VFS_READV, rpc_handle_readv );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler readv!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_WRITEV, rpc_handle_writev );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler writev!\r\n" )
+    return -1;
+  }
   bolthur_rpc_bind( RPC_VFS_SEEK, rpc_handle_seek );
   if ( errno ) {
     EARLY_STARTUP_PRINT( "Unable to register handler seek!\r\n" )
@@ -116,6 +151,51 @@ int main( __unused int argc, __unused char* argv[] ) {
     EARLY_STARTUP_PRINT( "Unable to register handler exit!\r\n" )
     return -1;
   }
+  bolthur_rpc_bind( RPC_VFS_QUEUE_SETUP, rpc_handle_queue_setup );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler queue setup!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_QUEUE_SUBMIT, rpc_handle_queue_submit );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler queue submit!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_MOUNT, rpc_handle_mount );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler mount!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_UMOUNT, rpc_handle_umount );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler umount!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_LOOKUP, rpc_handle_lookup );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler lookup!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_NOTIFY_PUBLISH, rpc_handle_notify_publish );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler notify publish!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_NOTIFY_REGISTER, rpc_handle_notify_register );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler notify register!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_SHARED_AREA, rpc_handle_shared_area );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler shared area!\r\n" )
+    return -1;
+  }
+  bolthur_rpc_bind( RPC_VFS_MAP, rpc_handle_map );
+  if ( errno ) {
+    EARLY_STARTUP_PRINT( "Unable to register handler map!\r\n" )
+    return -1;
+  }
 
   EARLY_STARTUP_PRINT( "entering wait for rpc loop!\r\n" )
   // enable rpc and wait
@@ -0,0 +1,396 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/syslimits.h>
+#include "../collection/list.h"
+#include "mount.h"
+
+/**
+ * @brief Compressed radix trie of mount points, edges are path fragments
+ */
+static mount_node_ptr_t mount_root = NULL;
+
+/**
+ * @fn mount_node_ptr_t mount_create_node(const char*, size_t, mount_node_ptr_t)
+ * @brief Create trie node and append it to parent
+ *
+ * @param prefix
+ * @param length
+ * @param parent
+ * @return
+ */
+static mount_node_ptr_t mount_create_node(
+  const char* prefix,
+  size_t length,
+  mount_node_ptr_t parent
+) {
+  mount_node_ptr_t node = malloc( sizeof( mount_node_t ) );
+  if ( ! node ) {
+    return NULL;
+  }
+  memset( node, 0, sizeof( mount_node_t ) );
+  // copy prefix
+  node->prefix = strndup( prefix, length );
+  if ( ! node->prefix ) {
+    free( node );
+    return NULL;
+  }
+  node->length = length;
+  // create children list
+  node->children = list_construct( NULL, NULL );
+  if ( ! node->children ) {
+    free( node->prefix );
+    free( node );
+    return NULL;
+  }
+  // append to parent
+  if ( parent ) {
+    if ( ! list_push_back( parent->children, node ) ) {
+      list_destruct( node->children );
+      free( node->prefix );
+      free( node );
+      return NULL;
+    }
+    node->parent = parent;
+  }
+  return node;
+}
+
+/**
+ * @fn void mount_destroy_node(mount_node_ptr_t)
+ * @brief Destroy trie node without children
+ *
+ * @param node
+ */
+static void mount_destroy_node( mount_node_ptr_t node ) {
+  if ( node->parent ) {
+    list_remove_data( node->parent->children, node );
+  }
+  list_destruct( node->children );
+  free( node->prefix );
+  free( node );
+}
+
+/**
+ * @fn size_t mount_common_length(const char*, size_t, const char*)
+ * @brief Get length of common prefix
+ *
+ * @param a
+ * @param length
+ * @param b
+ * @return
+ */
+static size_t mount_common_length(
+  const char* a,
+  size_t length,
+  const char* b
+) {
+  size_t idx = 0;
+  while ( idx < length && b[ idx ] && a[ idx ] == b[ idx ] ) {
+    idx++;
+  }
+  return idx;
+}
+
+/**
+ * @fn mount_node_ptr_t mount_find_child(mount_node_ptr_t, char)
+ * @brief Get child by first character, unique within a compressed trie
+ *
+ * @param node
+ * @param c
+ * @return
+ */
+static mount_node_ptr_t mount_find_child( mount_node_ptr_t node, char c ) {
+  list_item_ptr_t current = node->children->first;
+  while ( current ) {
+    mount_node_ptr_t child = ( mount_node_ptr_t )current->data;
+    if ( child->prefix[ 0 ] == c ) {
+      return child;
+    }
+    current = current->next;
+  }
+  return NULL;
+}
+
+/**
+ * @fn mount_node_ptr_t mount_find_exact(const char*, size_t)
+ * @brief Find node matching path exactly
+ *
+ * @param path
+ * @param length
+ * @return
+ */
+static mount_node_ptr_t mount_find_exact( const char* path, size_t length ) {
+  mount_node_ptr_t node = mount_root;
+  while ( length ) {
+    node = mount_find_child( node, *path );
+    if (
+      ! node
+      || node->length > length
+      || 0 != strncmp( node->prefix, path, node->length )
+    ) {
+      return NULL;
+    }
+    path += node->length;
+    length -= node->length;
+  }
+  return node;
+}
+
+/**
+ * @fn mount_node_ptr_t mount_prune_node(mount_node_ptr_t)
+ * @brief Remove unused leaf or merge node with a single child
+ *
+ * @param node
+ * @return parent if node has been removed, else NULL
+ */
+static mount_node_ptr_t mount_prune_node( mount_node_ptr_t node ) {
+  if ( ! node || node == mount_root || node->mounted ) {
+    return NULL;
+  }
+  mount_node_ptr_t parent = node->parent;
+  // remove leaf
+  if ( list_empty( node->children ) ) {
+    mount_destroy_node( node );
+    return parent;
+  }
+  // nothing to do if there are multiple children
+  if ( node->children->first != node->children->last ) {
+    return NULL;
+  }
+  // merge single child into node
+  mount_node_ptr_t child = ( mount_node_ptr_t )node->children->first->data;
+  char* prefix = malloc( node->length + child->length + 1 );
+  if ( ! prefix ) {
+    return NULL;
+  }
+  memcpy( prefix, node->prefix, node->length );
+  memcpy( prefix + node->length, child->prefix, child->length + 1 );
+  // move child to parent
+  if ( ! list_push_back( parent->children, child ) ) {
+    free( prefix );
+    return NULL;
+  }
+  list_remove_data( node->children, child );
+  free( child->prefix );
+  child->prefix = prefix;
+  child->length += node->length;
+  child->parent = parent;
+  mount_destroy_node( node );
+  return NULL;
+}
+
+/**
+ * @fn void mount_prune(mount_node_ptr_t)
+ * @brief Prune node and all ancestors becoming unused
+ *
+ * @param node
+ */
+static void mount_prune( mount_node_ptr_t node ) {
+  while ( node ) {
+    node = mount_prune_node( node );
+  }
+}
+
+/**
+ * @fn size_t mount_normalize_length(const char*)
+ * @brief Get path length without trailing slashes
+ *
+ * @param path
+ * @return
+ */
+static size_t mount_normalize_length( const char* path ) {
+  size_t length = strlen( path );
+  while ( 1 < length && '/' == path[ length - 1 ] ) {
+    length--;
+  }
+  return length;
+}
+
+/**
+ * @fn bool mount_init(void)
+ * @brief Setup mount trie
+ *
+ * @return
+ */
+bool mount_init( void ) {
+  mount_root = mount_create_node( "", 0, NULL );
+  return mount_root;
+}
+
+/**
+ * @fn int mount_add(const char*, pid_t)
+ * @brief Add mount point handled by process
+ *
+ * @param path
+ * @param handler
+ * @return
+ */
+int mount_add( const char* path, pid_t handler ) {
+  size_t length = mount_normalize_length( path );
+  // only absolute paths and root is managed by vfs itself
+  if ( '/' != path[ 0 ] ) {
+    return -EINVAL;
+  }
+  if ( 1 == length ) {
+    return -EBUSY;
+  }
+  if ( PATH_MAX <= length ) {
+    return -ENAMETOOLONG;
+  }
+  mount_node_ptr_t node = mount_root;
+  while ( length ) {
+    mount_node_ptr_t child = mount_find_child( node, *path );
+    // no matching edge, add leaf
+    if ( ! child ) {
+      node = mount_create_node( path, length, node );
+      if ( ! node ) {
+        return -ENOMEM;
+      }
+      break;
+    }
+    size_t common = mount_common_length( child->prefix, child->length, path );
+    if ( common > length ) {
+      common = length;
+    }
+    // split edge if only partially matching
+    if ( common < child->length ) {
+      mount_node_ptr_t split = mount_create_node( path, common, node );
+      if ( ! split ) {
+        return -ENOMEM;
+      }
+      char* rest = strdup( child->prefix + common );
+      if ( ! rest ) {
+        mount_destroy_node( split );
+        return -ENOMEM;
+      }
+      // move child below split node
+      list_remove_data( node->children, child );
+      if ( ! list_push_back( split->children, child ) ) {
+        list_push_back( node->children, child );
+        mount_destroy_node( split );
+        free( rest );
+        return -ENOMEM;
+      }
+      free( child->prefix );
+      child->prefix = rest;
+      child->length -= common;
+      child->parent = split;
+      child = split;
+    }
+    node = child;
+    path += common;
+    length -= common;
+  }
+  // handle already mounted
+  if ( node->mounted ) {
+    return -EBUSY;
+  }
+  node->mounted = true;
+  node->pid = handler;
+  return 0;
+}
+
+/**
+ * @fn int mount_remove(const char*, pid_t)
+ * @brief Remove mount point
+ *
+ * @param path
+ * @param handler
+ * @return
+ */
+int mount_remove( const char* path, pid_t handler ) {
+  mount_node_ptr_t node = mount_find_exact(
+    path,
+    mount_normalize_length( path )
+  );
+  if ( ! node || ! node->mounted ) {
+    return -EINVAL;
+  }
+  if ( node->pid != handler ) {
+    return -EPERM;
+  }
+  node->mounted = false;
+  node->pid = 0;
+  mount_prune( node );
+  return 0;
+}
+
+/**
+ * @fn void mount_remove_all_recursive(mount_node_ptr_t, pid_t)
+ * @brief Remove all mounts of process below node
+ *
+ * @param node
+ * @param handler
+ */
+static void mount_remove_all_recursive( mount_node_ptr_t node, pid_t handler ) {
+  list_item_ptr_t current = node->children->first;
+  while ( current ) {
+    list_item_ptr_t next = current->next;
+    mount_remove_all_recursive( ( mount_node_ptr_t )current->data, handler );
+    current = next;
+  }
+  if ( node->mounted && node->pid == handler ) {
+    node->mounted = false;
+    node->pid = 0;
+  }
+  // prune only current node, parents are handled by caller
+  mount_prune_node( node );
+}
+
+/**
+ * @fn void mount_remove_all(pid_t)
+ * @brief Remove all mount points handled by process
+ *
+ * @param handler
+ */
+void mount_remove_all( pid_t handler ) {
+  mount_remove_all_recursive( mount_root, handler );
+}
+
+/**
+ * @fn mount_node_ptr_t mount_resolve(const char*)
+ * @brief Get mount with longest prefix for a path strictly below it
+ *
+ * @param path
+ * @return mount or NULL if path isn't below any mount point
+ */
+mount_node_ptr_t mount_resolve( const char* path ) {
+  mount_node_ptr_t node = mount_root;
+  mount_node_ptr_t found = NULL;
+  // skip lookup if nothing is mounted
+  if ( list_empty( mount_root->children ) ) {
+    return NULL;
+  }
+  while ( *path ) {
+    node = mount_find_child( node, *path );
+    if ( ! node || 0 != strncmp( node->prefix, path, node->length ) ) {
+      break;
+    }
+    path += node->length;
+    // mount matches only at component boundary with remaining path
+    if ( node->mounted && '/' == *path && '\0' != path[ 1 ] ) {
+      found = node;
+    }
+  }
+  return found;
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include "../collection/list.h"
+
+#if !defined( _MOUNT_H )
+#define _MOUNT_H
+
+typedef struct mount_node mount_node_t;
+typedef struct mount_node *mount_node_ptr_t;
+
+struct mount_node {
+  char* prefix;
+  size_t length;
+  list_manager_ptr_t children;
+  mount_node_ptr_t parent;
+  bool mounted;
+  pid_t pid;
+};
+
+bool mount_init( void );
+int mount_add( const char*, pid_t );
+int mount_remove( const char*, pid_t );
+void mount_remove_all( pid_t );
+mount_node_ptr_t mount_resolve( const char* );
+
+#endif
@@ -0,0 +1,378 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/bolthur.h>
+#include "../collection/avl.h"
+#include "../collection/list.h"
+#include "../vfs.h"
+#include "../../../libvfs.h"
+#include "notify.h"
+
+/**
+ * @brief tree of watched vfs nodes
+ */
+static avl_tree_ptr_t notify_tree = NULL;
+
+/**
+ * @brief current batch mark used to group ready events per process
+ */
+static uint32_t notify_mark = 0;
+
+/**
+ * @fn int32_t compare_notify(const avl_node_ptr_t, const avl_node_ptr_t)
+ * @brief Compare notify callback necessary for avl tree insert / delete
+ *
+ * @param node_a
+ * @param node_b
+ * @return
+ */
+static int32_t compare_notify(
+  const avl_node_ptr_t node_a,
+  const avl_node_ptr_t node_b
+) {
+  notify_target_ptr_t target_a = NOTIFY_GET_TARGET( node_a );
+  notify_target_ptr_t target_b = NOTIFY_GET_TARGET( node_b );
+  // return 0 if equal
+  if ( target_a->target == target_b->target ) {
+    return 0;
+  }
+  // return -1 or 1 depending on what is greater
+  return target_a->target > target_b->target ? -1 : 1;
+}
+
+/**
+ * @fn int32_t lookup_notify(const avl_node_ptr_t, const void*)
+ * @brief Lookup notify callback necessary for avl tree search operations
+ *
+ * @param node
+ * @param value
+ * @return
+ */
+static int32_t lookup_notify(
+  const avl_node_ptr_t node,
+  const void* value
+) {
+  notify_target_ptr_t target = NOTIFY_GET_TARGET( node );
+  // return 0 if equal
+  if ( target->target == value ) {
+    return 0;
+  }
+  // return -1 or 1 depending on what is greater
+  return ( void* )target->target > value ? -1 : 1;
+}
+
+/**
+ * @fn void cleanup_notify(avl_node_ptr_t)
+ * @brief notify target cleanup
+ *
+ * @param node
+ */
+static void cleanup_notify( avl_node_ptr_t node ) {
+  notify_target_ptr_t target = NOTIFY_GET_TARGET( node );
+  list_destruct( target->watch );
+  free( target );
+}
+
+/**
+ * @fn void notify_watch_cleanup(const list_item_ptr_t)
+ * @brief Cleanup of watch list entries
+ *
+ * @param item
+ */
+static void notify_watch_cleanup( const list_item_ptr_t item ) {
+  free( item->data );
+  list_default_cleanup( item );
+}
+
+/**
+ * @fn notify_target_ptr_t notify_get(vfs_node_ptr_t)
+ * @brief Get notify target of vfs node
+ *
+ * @param node
+ * @return
+ */
+static notify_target_ptr_t notify_get( vfs_node_ptr_t node ) {
+  avl_node_ptr_t found = avl_find_by_data( notify_tree, node );
+  if ( ! found ) {
+    return NULL;
+  }
+  return NOTIFY_GET_TARGET( found );
+}
+
+/**
+ * @fn notify_watch_ptr_t notify_get_watch(notify_target_ptr_t, pid_t, int)
+ * @brief Get watch of process handle
+ *
+ * @param target
+ * @param pid
+ * @param handle
+ * @return
+ */
+static notify_watch_ptr_t notify_get_watch(
+  notify_target_ptr_t target,
+  pid_t pid,
+  int handle
+) {
+  for ( list_item_ptr_t item = target->watch->first; item; item = item->next ) {
+    notify_watch_ptr_t watch = item->data;
+    if ( watch->pid == pid && watch->handle == handle ) {
+      return watch;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @fn void notify_drop_empty(notify_target_ptr_t)
+ * @brief Remove target from tree when there is no watch left
+ *
+ * @param target
+ */
+static void notify_drop_empty( notify_target_ptr_t target ) {
+  if ( ! list_empty( target->watch ) ) {
+    return;
+  }
+  avl_remove_by_node( notify_tree, &target->node );
+  cleanup_notify( &target->node );
+}
+
+/**
+ * @fn uint32_t notify_ready(notify_watch_ptr_t, uint32_t, uint32_t)
+ * @brief Get events to report for a watch
+ *
+ * @param watch
+ * @param previous
+ * @param current
+ * @return
+ */
+static uint32_t notify_ready(
+  notify_watch_ptr_t watch,
+  uint32_t previous,
+  uint32_t current
+) {
+  uint32_t mask = watch->events & ~VFS_NOTIFY_EDGE;
+  // edge triggered watches only report transitions to set
+  if ( watch->events & VFS_NOTIFY_EDGE ) {
+    return current & ~previous & mask;
+  }
+  // level triggered report state, error and hangup always
+  return current & ( mask | VFS_NOTIFY_ERROR | VFS_NOTIFY_HANGUP );
+}
+
+/**
+ * @fn bool notify_init(void)
+ * @brief Setup notify structures
+ *
+ * @return
+ */
+bool notify_init( void ) {
+  notify_tree = avl_create_tree( compare_notify, lookup_notify, cleanup_notify );
+  return notify_tree;
+}
+
+/**
+ * @fn int notify_watch(vfs_node_ptr_t, pid_t, int, uint32_t, uint32_t*)
+ * @brief Add, update or remove watch of process handle
+ *
+ * @param node
+ * @param pid
+ * @param handle
+ * @param events
+ * @param ready current ready state of watch
+ * @return
+ */
+int notify_watch(
+  vfs_node_ptr_t node,
+  pid_t pid,
+  int handle,
+  uint32_t events,
+  uint32_t* ready
+) {
+  *ready = 0;
+  // empty mask removes the watch
+  if ( ! ( events & ~VFS_NOTIFY_EDGE ) ) {
+    notify_unwatch( node, pid, handle );
+    return 0;
+  }
+  notify_target_ptr_t target = notify_get( node );
+  // create target if not yet existing
+  if ( ! target ) {
+    target = malloc( sizeof( *target ) );
+    if ( ! target ) {
+      return -ENOMEM;
+    }
+    memset( target, 0, sizeof( *target ) );
+    target->target = node;
+    target->watch = list_construct( NULL, notify_watch_cleanup );
+    if ( ! target->watch ) {
+      free( target );
+      return -ENOMEM;
+    }
+    avl_prepare_node( &target->node, node );
+    if ( ! avl_insert_by_node( notify_tree, &target->node ) ) {
+      cleanup_notify( &target->node );
+      return -ENOMEM;
+    }
+  }
+  notify_watch_ptr_t watch = notify_get_watch( target, pid, handle );
+  // create watch if not yet existing
+  if ( ! watch ) {
+    watch = malloc( sizeof( *watch ) );
+    if ( ! watch ) {
+      notify_drop_empty( target );
+      return -ENOMEM;
+    }
+    memset( watch, 0, sizeof( *watch ) );
+    watch->pid = pid;
+    watch->handle = handle;
+    if ( ! list_push_back( target->watch, watch ) ) {
+      free( watch );
+      notify_drop_empty( target );
+      return -ENOMEM;
+    }
+  }
+  watch->events = events;
+  // registration always reports the current state once
+  *ready = node->events & ( events | VFS_NOTIFY_ERROR | VFS_NOTIFY_HANGUP )
+    & ~VFS_NOTIFY_EDGE;
+  return 0;
+}
+
+/**
+ * @fn void notify_unwatch(vfs_node_ptr_t, pid_t, int)
+ * @brief Remove watch of process handle
+ *
+ * @param node
+ * @param pid
+ * @param handle
+ */
+void notify_unwatch( vfs_node_ptr_t node, pid_t pid, int handle ) {
+  notify_target_ptr_t target = notify_get( node );
+  if ( ! target ) {
+    return;
+  }
+  notify_watch_ptr_t watch = notify_get_watch( target, pid, handle );
+  if ( ! watch ) {
+    return;
+  }
+  list_remove_data( target->watch, watch );
+  notify_drop_empty( target );
+}
+
+/**
+ * @fn void notify_unwatch_all(pid_t)
+ * @brief Remove all watches of a process
+ *
+ * @param pid
+ */
+void notify_unwatch_all( pid_t pid ) {
+  avl_node_ptr_t iter = avl_iterate_first( notify_tree );
+  while ( iter ) {
+    notify_target_ptr_t target = NOTIFY_GET_TARGET( iter );
+    // fetch next before target may be dropped
+    iter = avl_iterate_next( notify_tree, iter );
+    list_item_ptr_t item = target->watch->first;
+    while ( item ) {
+      notify_watch_ptr_t watch = item->data;
+      item = item->next;
+      if ( watch->pid == pid ) {
+        list_remove_data( target->watch, watch );
+      }
+    }
+    notify_drop_empty( target );
+  }
+}
+
+/**
+ * @fn void notify_publish(vfs_node_ptr_t, uint32_t)
+ * @brief Update event state of node and wake up watching processes
+ *
+ * @param node
+ * @param events
+ *
+ * @note Ready events are batched, so that each watching process gets one
+ * RPC_VFS_NOTIFY_READY per publish
+ */
+void notify_publish( vfs_node_ptr_t node, uint32_t events ) {
+  uint32_t previous = node->events;
+  node->events = events & ~VFS_NOTIFY_EDGE;
+  notify_target_ptr_t target = notify_get( node );
+  if ( ! target ) {
+    return;
+  }
+  vfs_notify_ready_t ready;
+  uint32_t mark = ++notify_mark;
+  for ( list_item_ptr_t item = target->watch->first; item; item = item->next ) {
+    notify_watch_ptr_t watch = item->data;
+    // skip processes already handled within this publish
+    if ( watch->mark == mark ) {
+      continue;
+    }
+    memset( &ready, 0, sizeof( ready ) );
+    // collect all watches of the process
+    for ( list_item_ptr_t inner = item; inner; inner = inner->next ) {
+      notify_watch_ptr_t current = inner->data;
+      if ( current->pid != watch->pid ) {
+        continue;
+      }
+      current->mark = mark;
+      uint32_t revents = notify_ready( current, previous, node->events );
+      if ( ! revents || ready.count >= VFS_NOTIFY_MAX ) {
+        continue;
+      }
+      ready.entry[ ready.count ].handle = current->handle;
+      ready.entry[ ready.count ].events = revents;
+      ready.count++;
+    }
+    if ( ! ready.count ) {
+      continue;
+    }
+    // single wake up without waiting for a return
+    bolthur_rpc_raise(
+      RPC_VFS_NOTIFY_READY,
+      watch->pid,
+      &ready,
+      sizeof( ready ),
+      false,
+      true,
+      RPC_VFS_NOTIFY_READY,
+      &ready,
+      sizeof( ready ),
+      0,
+      0
+    );
+  }
+}
+
+/**
+ * @fn void notify_pulse(vfs_node_ptr_t, uint32_t)
+ * @brief Publish transient events, which are cleared again after watching
+ * processes were woken up
+ *
+ * @param node
+ * @param events
+ */
+void notify_pulse( vfs_node_ptr_t node, uint32_t events ) {
+  events &= ~VFS_NOTIFY_EDGE;
+  notify_publish( node, node->events | events );
+  node->events &= ~events;
+}
@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "../collection/avl.h"
+#include "../collection/list.h"
+#include "../vfs.h"
+
+#if !defined( _NOTIFY_H )
+#define _NOTIFY_H
+
+struct notify_watch {
+  pid_t pid;
+  int handle;
+  uint32_t events;
+  uint32_t mark;
+};
+typedef struct notify_watch notify_watch_t;
+typedef struct notify_watch *notify_watch_ptr_t;
+
+struct notify_target {
+  avl_node_t node;
+  vfs_node_ptr_t target;
+  list_manager_ptr_t watch;
+};
+typedef struct notify_target notify_target_t;
+typedef struct notify_target *notify_target_ptr_t;
+
+#define NOTIFY_GET_TARGET( n ) \
+  ( notify_target_ptr_t )( ( uint8_t* )n - offsetof( notify_target_t, node ) )
+
+bool notify_init( void );
+int notify_watch( vfs_node_ptr_t, pid_t, int, uint32_t, uint32_t* );
+void notify_unwatch( vfs_node_ptr_t, pid_t, int );
+void notify_unwatch_all( pid_t );
+void notify_publish( vfs_node_ptr_t, uint32_t );
+void notify_pulse( vfs_node_ptr_t, uint32_t );
+
+#endif
@@ -0,0 +1,271 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../collection/avl.h"
+#include "pool.h"
+
+/**
+ * @brief preallocated contexts and list of free ones
+ */
+static pool_context_ptr_t pool = NULL;
+static pool_context_ptr_t pool_free = NULL;
+
+/**
+ * @brief tree of forwarded contexts by response id
+ */
+static avl_tree_ptr_t pool_pending = NULL;
+
+/**
+ * @fn int32_t compare_context(const avl_node_ptr_t, const avl_node_ptr_t)
+ * @brief Compare context callback necessary for avl tree insert / delete
+ *
+ * @param node_a
+ * @param node_b
+ * @return
+ */
+static int32_t compare_context(
+  const avl_node_ptr_t node_a,
+  const avl_node_ptr_t node_b
+) {
+  pool_context_ptr_t context_a = POOL_GET_CONTEXT( node_a );
+  pool_context_ptr_t context_b = POOL_GET_CONTEXT( node_b );
+  // return 0 if equal
+  if ( context_a->response_id == context_b->response_id ) {
+    return 0;
+  }
+  // return -1 or 1 depending on what is greater
+  return context_a->response_id > context_b->response_id ? -1 : 1;
+}
+
+/**
+ * @fn int32_t lookup_context(const avl_node_ptr_t, const void*)
+ * @brief Lookup context callback necessary for avl tree search operations
+ *
+ * @param node
+ * @param value
+ * @return
+ */
+static int32_t lookup_context(
+  const avl_node_ptr_t node,
+  const void* value
+) {
+  size_t response_id = ( size_t )value;
+  pool_context_ptr_t context = POOL_GET_CONTEXT( node );
+  // return 0 if equal
+  if ( context->response_id == response_id ) {
+    return 0;
+  }
+  // return -1 or 1 depending on what is greater
+  return context->response_id > response_id ? -1 : 1;
+}
+
+/**
+ * @fn void cleanup_context(avl_node_ptr_t)
+ * @brief context cleanup
+ *
+ * @param node
+ */
+static void cleanup_context( avl_node_ptr_t node ) {
+  pool_release( POOL_GET_CONTEXT( node ) );
+}
+
+/**
+ * @fn bool pool_init(void)
+ * @brief Preallocate request contexts
+ *
+ * @return
+ */
+bool pool_init( void ) {
+  // create pending tree
+  pool_pending = avl_create_tree(
+    compare_context,
+    lookup_context,
+    cleanup_context
+  );
+  if ( ! pool_pending ) {
+    return false;
+  }
+  // allocate contexts at once
+  pool = malloc( sizeof( pool_context_t ) * POOL_SIZE );
+  if ( ! pool ) {
+    avl_destroy_tree( pool_pending );
+    return false;
+  }
+  memset( pool, 0, sizeof( pool_context_t ) * POOL_SIZE );
+  // build free list
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    pool[ idx ].next = pool_free;
+    pool_free = &pool[ idx ];
+  }
+  return true;
+}
+
+/**
+ * @fn pool_context_ptr_t pool_acquire(size_t, pid_t, size_t)
+ * @brief Get free context, allocates a new one if the pool is exhausted
+ *
+ * @param type type of request to answer
+ * @param origin
+ * @param rpc_id data info of request, used for deferred return
+ * @return
+ */
+pool_context_ptr_t pool_acquire( size_t type, pid_t origin, size_t rpc_id ) {
+  pool_context_ptr_t context = pool_free;
+  // take from free list
+  if ( context ) {
+    pool_free = context->next;
+  } else {
+    context = malloc( sizeof( pool_context_t ) );
+    if ( ! context ) {
+      return NULL;
+    }
+    context->allocated = true;
+    context->buffer = NULL;
+    context->buffer_size = 0;
+  }
+  // reset state, payload and buffer are overwritten by each handler
+  context->next = NULL;
+  context->state = POOL_STATE_ACTIVE;
+  context->type = type;
+  context->rpc_id = rpc_id;
+  context->response_id = 0;
+  context->origin = origin;
+  context->target = 0;
+  context->abort = NULL;
+  context->handle = -1;
+  return context;
+}
+
+/**
+ * @fn void pool_release(pool_context_ptr_t)
+ * @brief Release context
+ *
+ * @param context
+ */
+void pool_release( pool_context_ptr_t context ) {
+  // free contexts allocated beyond pool
+  if ( context->allocated ) {
+    free( context->buffer );
+    free( context );
+    return;
+  }
+  // push back to free list, buffer is kept for following requests
+  context->state = POOL_STATE_FREE;
+  context->next = pool_free;
+  pool_free = context;
+}
+
+/**
+ * @fn void* pool_buffer(pool_context_ptr_t, size_t)
+ * @brief Get buffer for variable sized requests
+ *
+ * @param context
+ * @param size
+ * @return request storage of context if big enough, else buffer of context
+ *  which grows if necessary and is kept across requests
+ */
+void* pool_buffer( pool_context_ptr_t context, size_t size ) {
+  if ( sizeof( context->request ) >= size ) {
+    return &context->request;
+  }
+  if ( context->buffer_size < size ) {
+    void* buffer = realloc( context->buffer, size );
+    if ( ! buffer ) {
+      return NULL;
+    }
+    context->buffer = buffer;
+    context->buffer_size = size;
+  }
+  return context->buffer;
+}
+
+/**
+ * @fn bool pool_forward(pool_context_ptr_t, pid_t, size_t, pool_abort_t)
+ * @brief Park context until response of forwarded request arrives
+ *
+ * @param context
+ * @param target process handling the forwarded request
+ * @param response_id
+ * @param abort callback answering the request with an error and releasing
+ *  the context, used when origin or target exits
+ * @return
+ */
+bool pool_forward(
+  pool_context_ptr_t context,
+  pid_t target,
+  size_t response_id,
+  pool_abort_t abort
+) {
+  context->state = POOL_STATE_FORWARDED;
+  context->target = target;
+  context->response_id = response_id;
+  context->abort = abort;
+  // prepare and insert node
+  avl_prepare_node( &context->node, ( void* )response_id );
+  if ( ! avl_insert_by_node( pool_pending, &context->node ) ) {
+    abort( context );
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @fn pool_context_ptr_t pool_complete(size_t)
+ * @brief Get parked context by response id
+ *
+ * @param response_id
+ * @return
+ */
+pool_context_ptr_t pool_complete( size_t response_id ) {
+  avl_node_ptr_t found = avl_find_by_data(
+    pool_pending,
+    ( void* )response_id
+  );
+  if ( ! found ) {
+    return NULL;
+  }
+  pool_context_ptr_t context = POOL_GET_CONTEXT( found );
+  avl_remove_by_node( pool_pending, &context->node );
+  context->state = POOL_STATE_ACTIVE;
+  return context;
+}
+
+/**
+ * @fn void pool_release_process(pid_t)
+ * @brief Abort forwarded requests of an exited client or handling process
+ *
+ * @param process
+ */
+void pool_release_process( pid_t process ) {
+  avl_node_ptr_t iter = avl_iterate_first( pool_pending );
+  while ( iter ) {
+    pool_context_ptr_t context = POOL_GET_CONTEXT( iter );
+    iter = avl_iterate_next( pool_pending, iter );
+    if ( context->origin != process && context->target != process ) {
+      continue;
+    }
+    avl_remove_by_node( pool_pending, &context->node );
+    context->state = POOL_STATE_ACTIVE;
+    context->abort( context );
+    // removal may rebalance, so restart
+    iter = avl_iterate_first( pool_pending );
+  }
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include <sys/bolthur.h>
+#include "../collection/avl.h"
+#include "../../../libvfs.h"
+
+#if !defined( _POOL_H )
+#define _POOL_H
+
+// amount of preallocated request contexts
+#define POOL_SIZE 8
+
+typedef struct pool_context pool_context_t;
+typedef struct pool_context *pool_context_ptr_t;
+typedef void ( *pool_abort_t )( pool_context_ptr_t );
+
+enum pool_state {
+  POOL_STATE_FREE = 0,
+  POOL_STATE_ACTIVE,
+  POOL_STATE_FORWARDED,
+};
+
+struct pool_context {
+  avl_node_t node;
+  pool_context_ptr_t next;
+  enum pool_state state;
+  bool allocated;
+  void* buffer;
+  size_t buffer_size;
+  size_t type;
+  size_t rpc_id;
+  size_t response_id;
+  pid_t origin;
+  pid_t target;
+  pool_abort_t abort;
+  int handle;
+  union {
+    vfs_open_request_t open;
+    vfs_close_request_t close;
+    vfs_read_request_t read;
+    vfs_readv_request_t readv;
+    vfs_write_request_t write;
+    vfs_writev_request_t writev;
+    vfs_seek_request_t seek;
+    vfs_stat_request_t stat;
+    vfs_map_request_t map;
+  } request;
+  union {
+    vfs_read_request_t read;
+    vfs_write_request_t write;
+    vfs_stat_request_t stat;
+    vfs_map_request_t map;
+  } nested;
+  union {
+    vfs_read_response_t read;
+    vfs_write_response_t write;
+  } response;
+};
+
+#define POOL_GET_CONTEXT( n ) \
+  ( pool_context_ptr_t )( ( uint8_t* )n - offsetof( pool_context_t, node ) )
+
+bool pool_init( void );
+pool_context_ptr_t pool_acquire( size_t, pid_t, size_t );
+void pool_release( pool_context_ptr_t );
+void* pool_buffer( pool_context_ptr_t, size_t );
+bool pool_forward( pool_context_ptr_t, pid_t, size_t, pool_abort_t );
+pool_context_ptr_t pool_complete( size_t );
+void pool_release_process( pid_t );
+
+#endif
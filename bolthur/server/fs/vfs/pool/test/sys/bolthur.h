@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// minimal host replacement of the libc header for pool tests
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#if ! defined( _SYS_BOLTHUR_H )
+#define _SYS_BOLTHUR_H
+
+#define __unused __attribute__( ( unused ) )
+#define __maybe_unused __attribute__( ( unused ) )
+#define EARLY_STARTUP_PRINT( ... ) printf( __VA_ARGS__ );
+
+#define RPC_CUSTOM_START 1000
+#define MAX_READ_LEN 4096
+#define MAX_WRITE_LEN 4096
+
+typedef struct {
+  char path[ PATH_MAX ];
+  int flags;
+  int mode;
+} vfs_open_request_t;
+typedef struct {
+  int handle;
+} vfs_close_request_t;
+typedef struct {
+  int handle;
+  size_t len;
+  off_t offset;
+  size_t shm_id;
+  char file_path[ PATH_MAX ];
+} vfs_read_request_t;
+typedef struct {
+  ssize_t len;
+  uint8_t data[ MAX_READ_LEN ];
+} vfs_read_response_t;
+typedef struct {
+  int handle;
+  size_t len;
+  off_t offset;
+  char file_path[ PATH_MAX ];
+  char data[ MAX_WRITE_LEN ];
+} vfs_write_request_t;
+typedef struct {
+  ssize_t len;
+} vfs_write_response_t;
+typedef struct {
+  int handle;
+  off_t offset;
+  int whence;
+} vfs_seek_request_t;
+typedef struct {
+  int handle;
+  char file_path[ PATH_MAX ];
+} vfs_stat_request_t;
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../pool.h"
+
+// amount of requests for steady state measurement
+#define TEST_ITERATIONS 1000000
+// size exceeding inline request storage
+#define TEST_OVERSIZED ( sizeof( ( ( pool_context_ptr_t )0 )->request ) + 64 )
+
+// heap calls counted by linker wrapped allocator
+static size_t heap_calls = 0;
+static size_t aborted = 0;
+static size_t failed = 0;
+
+void* __real_malloc( size_t );
+void* __real_realloc( void*, size_t );
+void __real_free( void* );
+
+void* __wrap_malloc( size_t size ) {
+  heap_calls++;
+  return __real_malloc( size );
+}
+
+void* __wrap_realloc( void* ptr, size_t size ) {
+  heap_calls++;
+  return __real_realloc( ptr, size );
+}
+
+void __wrap_free( void* ptr ) {
+  if ( ptr ) {
+    heap_calls++;
+  }
+  __real_free( ptr );
+}
+
+/**
+ * @fn void test_expect(bool, const char*)
+ * @brief Record failed expectation
+ *
+ * @param condition
+ * @param message
+ */
+static void test_expect( bool condition, const char* message ) {
+  if ( ! condition ) {
+    printf( "FAIL %s\n", message );
+    failed++;
+  }
+}
+
+/**
+ * @fn void test_abort(pool_context_ptr_t)
+ * @brief Abort callback, answers nothing and releases
+ *
+ * @param context
+ */
+static void test_abort( pool_context_ptr_t context ) {
+  aborted++;
+  pool_release( context );
+}
+
+/**
+ * @fn double test_now(void)
+ * @brief Get monotonic time in seconds
+ *
+ * @return
+ */
+static double test_now( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( double )ts.tv_sec + ( double )ts.tv_nsec / 1e9;
+}
+
+/**
+ * @fn void test_steady_state(void)
+ * @brief Forward and complete requests, heap must not be touched after warm up
+ */
+static void test_steady_state( void ) {
+  // warm up oversized buffer of every pooled context
+  pool_context_ptr_t warm[ POOL_SIZE ];
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    warm[ idx ] = pool_acquire( 1, 2, idx );
+    test_expect( NULL != pool_buffer( warm[ idx ], TEST_OVERSIZED ), "buffer" );
+  }
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    pool_release( warm[ idx ] );
+  }
+  size_t before = heap_calls;
+  double start = test_now();
+  for ( size_t idx = 1; idx <= TEST_ITERATIONS; idx++ ) {
+    pool_context_ptr_t context = pool_acquire( 1, 2, idx );
+    void* buffer = pool_buffer( context, idx % 2 ? 16 : TEST_OVERSIZED );
+    test_expect( NULL != buffer, "steady buffer" );
+    pool_forward( context, 3, idx, test_abort );
+    test_expect( context == pool_complete( idx ), "complete" );
+    pool_release( context );
+  }
+  double elapsed = test_now() - start;
+  test_expect( before == heap_calls, "heap used in steady state" );
+  printf(
+    "steady state: %zu heap calls, %.1f ns/request\n",
+    heap_calls - before,
+    elapsed * 1e9 / TEST_ITERATIONS
+  );
+}
+
+/**
+ * @fn void test_exhausted(void)
+ * @brief Contexts beyond pool come from heap and are freed on release
+ */
+static void test_exhausted( void ) {
+  pool_context_ptr_t context[ POOL_SIZE + 1 ];
+  size_t before = heap_calls;
+  for ( size_t idx = 0; idx <= POOL_SIZE; idx++ ) {
+    context[ idx ] = pool_acquire( 1, 2, idx );
+    test_expect( NULL != context[ idx ], "acquire" );
+  }
+  test_expect( before + 1 == heap_calls, "single allocation beyond pool" );
+  for ( size_t idx = 0; idx <= POOL_SIZE; idx++ ) {
+    pool_release( context[ idx ] );
+  }
+  test_expect( before + 2 == heap_calls, "allocation beyond pool freed" );
+}
+
+/**
+ * @fn void test_release_process(void)
+ * @brief Parked contexts of exited clients and handlers are aborted
+ */
+static void test_release_process( void ) {
+  // client 10 and 11 forward to handler 20 and 21 alternating
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    pool_context_ptr_t context = pool_acquire( 1, 10 + idx % 2, idx );
+    pool_forward( context, 20 + ( idx / 2 ) % 2, 100 + idx, test_abort );
+  }
+  aborted = 0;
+  // exit of client 10 aborts its four requests
+  pool_release_process( 10 );
+  test_expect( POOL_SIZE / 2 == aborted, "client exit" );
+  // exit of handler 21 aborts remaining requests towards it
+  pool_release_process( 21 );
+  test_expect( POOL_SIZE / 2 + POOL_SIZE / 4 == aborted, "handler exit" );
+  test_expect( NULL == pool_complete( 103 ), "aborted context completed" );
+  // remaining requests complete normally
+  size_t completed = 0;
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    pool_context_ptr_t context = pool_complete( 100 + idx );
+    if ( context ) {
+      completed++;
+      pool_release( context );
+    }
+  }
+  test_expect( POOL_SIZE / 4 == completed, "remaining complete" );
+  // everything is back within free list
+  size_t before = heap_calls;
+  pool_context_ptr_t context[ POOL_SIZE ];
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    context[ idx ] = pool_acquire( 1, 2, idx );
+  }
+  test_expect( before == heap_calls, "contexts reclaimed" );
+  for ( size_t idx = 0; idx < POOL_SIZE; idx++ ) {
+    pool_release( context[ idx ] );
+  }
+}
+
+/**
+ * @fn int main(void)
+ * @brief Run pool tests and steady state benchmark
+ *
+ * @return
+ */
+int main( void ) {
+  if ( ! pool_init() ) {
+    printf( "FAIL init\n" );
+    return EXIT_FAILURE;
+  }
+  test_exhausted();
+  test_release_process();
+  test_steady_state();
+  printf( "%s: %zu failed\n", failed ? "FAIL" : "PASS", failed );
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
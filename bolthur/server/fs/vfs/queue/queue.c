@@ -0,0 +1,752 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/bolthur.h>
+#include "../../../libsyscall.h"
+#include "../collection/avl.h"
+#include "../file/handle.h"
+#include "../vfs.h"
+#include "../mount/mount.h"
+#include "queue.h"
+
+/**
+ * @brief tree managing attached queues per process
+ */
+static avl_tree_ptr_t queue_tree = NULL;
+
+/**
+ * @fn int32_t compare_queue(const avl_node_ptr_t, const avl_node_ptr_t)
+ * @brief Compare queue callback necessary for avl tree insert / delete
+ *
+ * @param node_a
+ * @param node_b
+ * @return
+ */
+static int32_t compare_queue(
+  const avl_node_ptr_t node_a,
+  const avl_node_ptr_t node_b
+) {
+  queue_context_ptr_t context_a = QUEUE_GET_CONTEXT( node_a );
+  queue_context_ptr_t context_b = QUEUE_GET_CONTEXT( node_b );
+  // return 0 if equal
+  if ( context_a->pid == context_b->pid ) {
+    return 0;
+  }
+  // return -1 or 1 depending on what is greater
+  return context_a->pid > context_b->pid ? -1 : 1;
+}
+
+/**
+ * @fn int32_t lookup_queue(const avl_node_ptr_t, const void*)
+ * @brief Lookup queue callback necessary for avl tree search operations
+ *
+ * @param node
+ * @param value
+ * @return
+ */
+static int32_t lookup_queue(
+  const avl_node_ptr_t node,
+  const void* value
+) {
+  pid_t pid = ( pid_t )value;
+  queue_context_ptr_t context = QUEUE_GET_CONTEXT( node );
+  // return 0 if equal
+  if ( context->pid == pid ) {
+    return 0;
+  }
+  // return -1 or 1 depending on what is greater
+  return context->pid > pid ? -1 : 1;
+}
+
+/**
+ * @fn void cleanup_queue(avl_node_ptr_t)
+ * @brief queue cleanup
+ *
+ * @param node
+ */
+static void cleanup_queue( avl_node_ptr_t node ) {
+  queue_context_ptr_t context = QUEUE_GET_CONTEXT( node );
+  // detach shared area
+  _memory_shared_detach( context->shm_id );
+  // free context
+  free( context );
+}
+
+/**
+ * @fn queue_context_ptr_t queue_get(pid_t)
+ * @brief Get queue context of process
+ *
+ * @param process
+ * @return
+ */
+static queue_context_ptr_t queue_get( pid_t process ) {
+  avl_node_ptr_t found = avl_find_by_data( queue_tree, ( void* )process );
+  if ( ! found ) {
+    return NULL;
+  }
+  return QUEUE_GET_CONTEXT( found );
+}
+
+/**
+ * @fn bool queue_data_valid(size_t, size_t)
+ * @brief Check whether range is within data area of queue
+ *
+ * @param offset
+ * @param len
+ * @return
+ */
+static bool queue_data_valid( size_t offset, size_t len ) {
+  return offset <= VFS_QUEUE_DATA_SIZE && len <= VFS_QUEUE_DATA_SIZE - offset;
+}
+
+/**
+ * @fn bool queue_complete(queue_context_ptr_t, size_t, ssize_t)
+ * @brief Push completion into completion ring
+ *
+ * @param context
+ * @param user_data
+ * @param result
+ */
+static void queue_complete(
+  queue_context_ptr_t context,
+  size_t user_data,
+  ssize_t result
+) {
+  vfs_queue_ptr_t queue = context->queue;
+  vfs_queue_completion_ptr_t completion = &queue->complete[
+    QUEUE_SLOT( context->complete_tail ) ];
+  // populate completion
+  completion->user_data = user_data;
+  completion->result = result;
+  // publish, shared index is never read back as client may modify it
+  context->complete_tail++;
+  queue->complete_tail = context->complete_tail;
+}
+
+/**
+ * @fn bool queue_copy_path(queue_context_ptr_t, size_t, char*)
+ * @brief Copy path out of data area, as client may modify it concurrently
+ *
+ * @param context
+ * @param offset
+ * @param path buffer of PATH_MAX bytes
+ * @return
+ */
+static bool queue_copy_path(
+  queue_context_ptr_t context,
+  size_t offset,
+  char* path
+) {
+  if ( ! queue_data_valid( offset, PATH_MAX ) ) {
+    return false;
+  }
+  memcpy( path, context->queue->data + offset, PATH_MAX );
+  return memchr( path, '\0', PATH_MAX );
+}
+
+/**
+ * @fn ssize_t queue_open(queue_context_ptr_t, vfs_queue_entry_ptr_t)
+ * @brief Open file referenced by entry
+ *
+ * @param context
+ * @param entry
+ * @return
+ */
+static ssize_t queue_open(
+  queue_context_ptr_t context,
+  vfs_queue_entry_ptr_t entry
+) {
+  char path[ PATH_MAX ];
+  // validate path
+  if ( ! queue_copy_path( context, entry->data, path ) ) {
+    return -EINVAL;
+  }
+  // delegated lookups below mount points need a round trip
+  if ( mount_resolve( path ) ) {
+    return -EXDEV;
+  }
+  // get node by path
+  vfs_node_ptr_t node = vfs_node_by_path( path );
+  if ( ! node ) {
+    return ( entry->flags & O_CREAT ) ? -ENOSYS : -ENOENT;
+  }
+  if ( ( entry->flags & O_CREAT ) && ( entry->flags & O_EXCL ) ) {
+    return -EEXIST;
+  }
+  // handle target directory with write or read write flags
+  if (
+    S_ISDIR( node->st->st_mode )
+    && ( ( entry->flags & O_WRONLY ) || ( entry->flags & O_RDWR ) )
+  ) {
+    return -EISDIR;
+  }
+  // generate handle
+  handle_container_ptr_t container = NULL;
+  int result = handle_generate(
+    &container,
+    context->pid,
+    node->parent,
+    node,
+    path,
+    entry->flags,
+    entry->mode
+  );
+  if ( ! container ) {
+    return result;
+  }
+  return container->handle;
+}
+
+/**
+ * @fn ssize_t queue_stat(queue_context_ptr_t, vfs_queue_entry_ptr_t)
+ * @brief Stat file by handle or path and store result within data area
+ *
+ * @param context
+ * @param entry
+ * @return
+ */
+static ssize_t queue_stat(
+  queue_context_ptr_t context,
+  vfs_queue_entry_ptr_t entry
+) {
+  vfs_node_ptr_t target = NULL;
+  // validate data area
+  if ( ! queue_data_valid( entry->data, PATH_MAX ) ) {
+    return -EINVAL;
+  }
+  // get node by handle or by path
+  if ( 0 <= entry->handle ) {
+    handle_container_ptr_t container;
+    int result = handle_get( &container, context->pid, entry->handle );
+    if ( 0 > result ) {
+      return result;
+    }
+    target = container->target;
+  } else {
+    char path[ PATH_MAX ];
+    if ( ! queue_copy_path( context, entry->data, path ) ) {
+      return -EINVAL;
+    }
+    target = vfs_node_by_path( path );
+  }
+  if ( ! target ) {
+    return -ENOENT;
+  }
+  // copy stat into data area
+  memcpy(
+    context->queue->data + entry->data,
+    target->st,
+    sizeof( struct stat )
+  );
+  return 0;
+}
+
+/**
+ * @fn ssize_t queue_seek(queue_context_ptr_t, vfs_queue_entry_ptr_t)
+ * @brief Seek handle referenced by entry
+ *
+ * @param context
+ * @param entry
+ * @return
+ */
+static ssize_t queue_seek(
+  queue_context_ptr_t context,
+  vfs_queue_entry_ptr_t entry
+) {
+  handle_container_ptr_t container;
+  int result = handle_get( &container, context->pid, entry->handle );
+  if ( 0 > result ) {
+    return result;
+  }
+  return handle_seek( container, entry->offset, entry->flags );
+}
+
+/**
+ * @fn bool queue_group_push(queue_group_ptr_t, vfs_queue_entry_ptr_t)
+ * @brief Try to merge entry into current group
+ *
+ * @param group
+ * @param entry
+ * @return
+ */
+static bool queue_group_push(
+  queue_group_ptr_t group,
+  vfs_queue_entry_ptr_t entry
+) {
+  size_t limit = VFS_QUEUE_READ == entry->operation
+    ? MAX_READ_LEN : MAX_WRITE_LEN;
+  size_t total = 0;
+  // only consecutive entries with same operation and handle are merged
+  if ( group->count ) {
+    if (
+      group->operation != entry->operation
+      || group->handle != entry->handle
+      || VFS_IOV_MAX == group->count
+    ) {
+      return false;
+    }
+    for ( size_t idx = 0; idx < group->count; idx++ ) {
+      total += group->len[ idx ];
+    }
+  }
+  if ( entry->len > limit - total ) {
+    return false;
+  }
+  // add to group
+  group->operation = entry->operation;
+  group->handle = entry->handle;
+  group->user_data[ group->count ] = entry->user_data;
+  group->len[ group->count ] = entry->len;
+  group->data[ group->count ] = entry->data;
+  group->count++;
+  return true;
+}
+
+/**
+ * @fn void queue_group_complete(queue_context_ptr_t, ssize_t, uint8_t*)
+ * @brief Complete all entries of a group, scatter read data if passed
+ *
+ * @param context
+ * @param result
+ * @param data
+ */
+static void queue_group_complete(
+  queue_context_ptr_t context,
+  ssize_t result,
+  uint8_t* data
+) {
+  queue_group_ptr_t group = &context->group;
+  size_t offset = 0;
+  for ( size_t idx = 0; idx < group->count; idx++ ) {
+    ssize_t entry_result = result;
+    if ( 0 <= result ) {
+      // calculate part of the result belonging to entry
+      size_t remaining = ( size_t )result > offset
+        ? ( size_t )result - offset : 0;
+      size_t len = remaining < group->len[ idx ]
+        ? remaining : group->len[ idx ];
+      // scatter read data
+      if ( data && len ) {
+        memcpy( context->queue->data + group->data[ idx ], data + offset, len );
+      }
+      entry_result = ( ssize_t )len;
+      offset += group->len[ idx ];
+    }
+    queue_complete( context, group->user_data[ idx ], entry_result );
+  }
+  // reset group
+  memset( group, 0, sizeof( queue_group_t ) );
+}
+
+/**
+ * @fn int queue_group_forward(queue_context_ptr_t)
+ * @brief Forward merged group to handling process
+ *
+ * @param context
+ * @return 0 if forwarded, 1 if completed locally, else negative errno
+ */
+static int queue_group_forward( queue_context_ptr_t context ) {
+  queue_group_ptr_t group = &context->group;
+  handle_container_ptr_t container;
+  size_t total = 0;
+  // get handle
+  int result = handle_get( &container, context->pid, group->handle );
+  if ( 0 > result ) {
+    return result;
+  }
+  for ( size_t idx = 0; idx < group->count; idx++ ) {
+    total += group->len[ idx ];
+  }
+  // special handling for null device
+  if ( 0 == strcmp( container->path, "/dev/null" ) ) {
+    queue_group_complete(
+      context,
+      VFS_QUEUE_READ == group->operation ? 0 : ( ssize_t )total,
+      NULL
+    );
+    return 1;
+  }
+  // handle read
+  if ( VFS_QUEUE_READ == group->operation ) {
+    vfs_read_request_ptr_t request = malloc( sizeof( vfs_read_request_t ) );
+    if ( ! request ) {
+      return -ENOMEM;
+    }
+    memset( request, 0, sizeof( vfs_read_request_t ) );
+    // prepare structure
+    strncpy( request->file_path, container->path, PATH_MAX );
+    request->handle = group->handle;
+    request->offset = container->pos;
+    request->len = total;
+    // perform async rpc
+    context->response_id = bolthur_rpc_raise(
+      RPC_VFS_READ,
+      container->target->pid,
+      request,
+      sizeof( vfs_read_request_t ),
+      false,
+      false,
+      RPC_VFS_READ,
+      request,
+      sizeof( vfs_read_request_t ),
+      context->pid,
+      context->data_info
+    );
+    free( request );
+    return errno ? -EIO : 0;
+  }
+  // handle write
+  vfs_write_request_ptr_t request = malloc( sizeof( vfs_write_request_t ) );
+  if ( ! request ) {
+    return -ENOMEM;
+  }
+  memset( request, 0, sizeof( vfs_write_request_t ) );
+  // prepare structure and gather data
+  strncpy( request->file_path, container->path, PATH_MAX );
+  request->handle = group->handle;
+  request->offset = container->pos;
+  request->len = total;
+  total = 0;
+  for ( size_t idx = 0; idx < group->count; idx++ ) {
+    memcpy(
+      request->data + total,
+      context->queue->data + group->data[ idx ],
+      group->len[ idx ]
+    );
+    total += group->len[ idx ];
+  }
+  // perform async rpc
+  context->response_id = bolthur_rpc_raise(
+    RPC_VFS_WRITE,
+    container->target->pid,
+    request,
+    sizeof( vfs_write_request_t ),
+    false,
+    false,
+    RPC_VFS_WRITE,
+    request,
+    sizeof( vfs_write_request_t ),
+    context->pid,
+    context->data_info
+  );
+  free( request );
+  return errno ? -EIO : 0;
+}
+
+/**
+ * @fn bool queue_drain(queue_context_ptr_t)
+ * @brief Drain submission ring until empty or until a group is forwarded
+ *
+ * @param context
+ * @return true if a group is in flight, else false
+ */
+static bool queue_drain( queue_context_ptr_t context ) {
+  vfs_queue_ptr_t queue = context->queue;
+  while ( true ) {
+    vfs_queue_entry_t entry;
+    // indices produced by client are read once and checked
+    uint32_t submit_tail = queue->submit_tail;
+    uint32_t complete_head = queue->complete_head;
+    // treat corrupted submission ring as empty
+    bool empty = VFS_QUEUE_ENTRIES < submit_tail - context->submit_head
+      || context->submit_head == submit_tail;
+    // stop if completion ring would overflow
+    bool full = VFS_QUEUE_ENTRIES <= context->complete_tail
+      - complete_head + context->group.count;
+    // copy entry to prevent modification by client during processing
+    if ( ! empty && ! full ) {
+      memcpy(
+        &entry,
+        &queue->submit[ QUEUE_SLOT( context->submit_head ) ],
+        sizeof( vfs_queue_entry_t )
+      );
+      // validate data of read and write
+      if (
+        (
+          VFS_QUEUE_READ == entry.operation
+          || VFS_QUEUE_WRITE == entry.operation
+        ) && ! queue_data_valid( entry.data, entry.len )
+      ) {
+        entry.operation = VFS_QUEUE_NOP;
+        entry.handle = -EINVAL;
+      }
+      // try to merge entry into pending group
+      if (
+        (
+          VFS_QUEUE_READ == entry.operation
+          || VFS_QUEUE_WRITE == entry.operation
+        ) && queue_group_push( &context->group, &entry )
+      ) {
+        queue->submit_head = ++context->submit_head;
+        context->consumed++;
+        continue;
+      }
+    }
+    // forward pending group before handling anything else
+    if ( context->group.count ) {
+      int result = queue_group_forward( context );
+      if ( 0 == result ) {
+        return true;
+      }
+      if ( 0 > result ) {
+        queue_group_complete( context, result, NULL );
+      }
+      continue;
+    }
+    // nothing left to do
+    if ( empty || full ) {
+      return false;
+    }
+    // handle synchronous operations locally
+    ssize_t result;
+    switch ( entry.operation ) {
+      case VFS_QUEUE_OPEN:
+        result = queue_open( context, &entry );
+        break;
+      case VFS_QUEUE_CLOSE:
+        result = handle_destory( context->pid, entry.handle );
+        break;
+      case VFS_QUEUE_SEEK:
+        result = queue_seek( context, &entry );
+        break;
+      case VFS_QUEUE_STAT:
+        result = queue_stat( context, &entry );
+        break;
+      case VFS_QUEUE_NOP:
+        result = 0 > entry.handle ? entry.handle : 0;
+        break;
+      // read and write exceeding the maximum length
+      case VFS_QUEUE_READ:
+      case VFS_QUEUE_WRITE:
+        result = -EINVAL;
+        break;
+      default:
+        result = -ENOSYS;
+    }
+    queue_complete( context, entry.user_data, result );
+    queue->submit_head = ++context->submit_head;
+    context->consumed++;
+  }
+}
+
+/**
+ * @fn bool queue_init(void)
+ * @brief Initialize queue handling
+ *
+ * @return
+ */
+bool queue_init( void ) {
+  queue_tree = avl_create_tree(
+    compare_queue,
+    lookup_queue,
+    cleanup_queue
+  );
+  return queue_tree;
+}
+
+/**
+ * @fn int queue_setup(pid_t, size_t)
+ * @brief Attach shared queue of process
+ *
+ * @param process
+ * @param shm_id
+ * @return
+ */
+int queue_setup( pid_t process, size_t shm_id ) {
+  queue_context_ptr_t context = queue_get( process );
+  // handle queue with pending submit
+  if ( context && context->busy ) {
+    return -EBUSY;
+  }
+  // remove previously attached queue
+  if ( context ) {
+    avl_remove_by_node( queue_tree, &context->node );
+    cleanup_queue( &context->node );
+  }
+  // allocate context
+  context = malloc( sizeof( queue_context_t ) );
+  if ( ! context ) {
+    return -ENOMEM;
+  }
+  memset( context, 0, sizeof( queue_context_t ) );
+  context->pid = process;
+  context->shm_id = shm_id;
+  // attach shared area
+  context->queue = _memory_shared_attach( shm_id, ( uintptr_t )NULL );
+  if ( errno || ! context->queue ) {
+    free( context );
+    return -EIO;
+  }
+  // area has to hold the whole queue
+  size_t size = _memory_shared_size( shm_id );
+  if ( errno || sizeof( vfs_queue_t ) > size ) {
+    cleanup_queue( &context->node );
+    return -EINVAL;
+  }
+  // take over current state, afterwards only private copies are used
+  context->submit_head = context->queue->submit_head;
+  context->complete_tail = context->queue->complete_tail;
+  // prepare and insert node
+  avl_prepare_node( &context->node, ( void* )process );
+  if ( ! avl_insert_by_node( queue_tree, &context->node ) ) {
+    cleanup_queue( &context->node );
+    return -ENOMEM;
+  }
+  return 0;
+}
+
+/**
+ * @fn void queue_destroy(pid_t)
+ * @brief Detach queue of process
+ *
+ * @param process
+ */
+void queue_destroy( pid_t process ) {
+  queue_context_ptr_t context = queue_get( process );
+  if ( ! context ) {
+    return;
+  }
+  avl_remove_by_node( queue_tree, &context->node );
+  cleanup_queue( &context->node );
+}
+
+/**
+ * @fn int queue_submit(pid_t, size_t)
+ * @brief Drain submitted entries of process
+ *
+ * @param process
+ * @param data_info
+ * @return amount of consumed entries, -EINPROGRESS if a group has been
+ *  forwarded and the submit is answered on completion, else negative errno
+ */
+int queue_submit( pid_t process, size_t data_info ) {
+  queue_context_ptr_t context = queue_get( process );
+  if ( ! context ) {
+    return -ENXIO;
+  }
+  if ( context->busy ) {
+    return -EBUSY;
+  }
+  // prepare context
+  context->data_info = data_info;
+  context->consumed = 0;
+  // drain and return consumed amount if everything was done locally
+  if ( ! queue_drain( context ) ) {
+    return context->consumed;
+  }
+  context->busy = true;
+  return -EINPROGRESS;
+}
+
+/**
+ * @fn bool queue_handle_response(size_t, size_t, size_t)
+ * @brief Handle response of forwarded group
+ *
+ * @param type
+ * @param data_info
+ * @param response_info
+ * @return false if response doesn't belong to a queue, else true
+ */
+bool queue_handle_response(
+  size_t type,
+  size_t data_info,
+  size_t response_info
+) {
+  queue_context_ptr_t context = NULL;
+  avl_node_ptr_t iter;
+  // find context waiting for response
+  for (
+    iter = avl_iterate_first( queue_tree );
+    iter;
+    iter = avl_iterate_next( queue_tree, iter )
+  ) {
+    queue_context_ptr_t current = QUEUE_GET_CONTEXT( iter );
+    if ( current->busy && current->response_id == response_info ) {
+      context = current;
+      break;
+    }
+  }
+  if ( ! context ) {
+    return false;
+  }
+  // get matching async data
+  bolthur_async_data_ptr_t async_data = bolthur_rpc_pop_async(
+    type,
+    response_info
+  );
+  vfs_read_response_ptr_t response = malloc( sizeof( vfs_read_response_t ) );
+  if ( ! response ) {
+    bolthur_rpc_remove_data( data_info );
+    queue_group_complete( context, -ENOMEM, NULL );
+  } else {
+    memset( response, 0, sizeof( vfs_read_response_t ) );
+    response->len = -EIO;
+    // read and write response both start with len
+    _rpc_get_data(
+      response,
+      RPC_VFS_READ == type
+        ? sizeof( vfs_read_response_t ) : sizeof( vfs_write_response_t ),
+      data_info,
+      false
+    );
+    if ( errno ) {
+      bolthur_rpc_remove_data( data_info );
+    }
+    // update position of handle
+    handle_container_ptr_t container;
+    if (
+      0 < response->len
+      && 0 == handle_get( &container, context->pid, context->group.handle )
+    ) {
+      container->pos += ( off_t )response->len;
+    }
+    queue_group_complete(
+      context,
+      response->len,
+      RPC_VFS_READ == type ? response->data : NULL
+    );
+    free( response );
+  }
+  // continue draining, answer submit when nothing is in flight any longer
+  if ( queue_drain( context ) ) {
+    // release async data of intermediate completion
+    if ( async_data ) {
+      free( async_data->original_data );
+      free( async_data );
+    }
+    return true;
+  }
+  context->busy = false;
+  // no async data means no way to answer
+  if ( ! async_data ) {
+    return true;
+  }
+  vfs_queue_submit_response_t submit = { .status = context->consumed };
+  bolthur_rpc_return(
+    RPC_VFS_QUEUE_SUBMIT,
+    &submit,
+    sizeof( submit ),
+    async_data
+  );
+  return true;
+}
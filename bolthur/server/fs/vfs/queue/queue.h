@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include "../collection/avl.h"
+#include "../../../libvfs.h"
+
+#if !defined( _QUEUE_H )
+#define _QUEUE_H
+
+struct queue_group {
+  uint32_t operation;
+  int handle;
+  size_t count;
+  size_t user_data[ VFS_IOV_MAX ];
+  size_t len[ VFS_IOV_MAX ];
+  size_t data[ VFS_IOV_MAX ];
+};
+typedef struct queue_group queue_group_t;
+typedef struct queue_group *queue_group_ptr_t;
+
+struct queue_context {
+  avl_node_t node;
+  pid_t pid;
+  size_t shm_id;
+  vfs_queue_ptr_t queue;
+  // private copies of indices produced by vfs
+  uint32_t submit_head;
+  uint32_t complete_tail;
+  size_t data_info;
+  size_t response_id;
+  int consumed;
+  bool busy;
+  queue_group_t group;
+};
+typedef struct queue_context queue_context_t;
+typedef struct queue_context *queue_context_ptr_t;
+
+// ring slot of an index, indices are free running
+#define QUEUE_SLOT( n ) ( ( n ) & ( VFS_QUEUE_ENTRIES - 1 ) )
+
+#define QUEUE_GET_CONTEXT( n ) \
+  ( queue_context_ptr_t )( ( uint8_t* )n - offsetof( queue_context_t, node ) )
+
+bool queue_init( void );
+int queue_setup( pid_t, size_t );
+void queue_destroy( pid_t );
+int queue_submit( pid_t, size_t );
+bool queue_handle_response( size_t, size_t, size_t );
+
+#endif
@@ -18,6 +18,7 @@
  */
 
 #include <sys/bolthur.h>
+#include "pool/pool.h"
 
 #if !defined( _RPC_H )
 #define _RPC_H
@@ -28,13 +29,28 @@ void rpc_handle_open( size_t, pid_t, size_t, size_t );
 void rpc_handle_close( size_t, pid_t, size_t, size_t );
 void rpc_handle_read( size_t, pid_t, size_t, size_t );
 void rpc_handle_read_async( size_t, pid_t, size_t, size_t );
+void rpc_handle_read_abort( pool_context_ptr_t );
+void rpc_handle_readv( size_t, pid_t, size_t, size_t );
 void rpc_handle_write( size_t, pid_t, size_t, size_t );
 void rpc_handle_write_async( size_t, pid_t, size_t, size_t );
+void rpc_handle_write_abort( pool_context_ptr_t );
+void rpc_handle_writev( size_t, pid_t, size_t, size_t );
 void rpc_handle_seek( size_t, pid_t, size_t, size_t );
 void rpc_handle_stat( size_t, pid_t, size_t, size_t );
+void rpc_handle_stat_async( size_t, pid_t, size_t, size_t );
 void rpc_handle_ioctl( size_t, pid_t, size_t, size_t );
 void rpc_handle_ioctl_async( size_t, pid_t, size_t, size_t );
 void rpc_handle_fork( size_t, pid_t, size_t, size_t );
 void rpc_handle_exit( size_t, pid_t, size_t, size_t );
+void rpc_handle_queue_setup( size_t, pid_t, size_t, size_t );
+void rpc_handle_queue_submit( size_t, pid_t, size_t, size_t );
+void rpc_handle_mount( size_t, pid_t, size_t, size_t );
+void rpc_handle_umount( size_t, pid_t, size_t, size_t );
+void rpc_handle_lookup( size_t, pid_t, size_t, size_t );
+void rpc_handle_notify_publish( size_t, pid_t, size_t, size_t );
+void rpc_handle_notify_register( size_t, pid_t, size_t, size_t );
+void rpc_handle_shared_area( size_t, pid_t, size_t, size_t );
+void rpc_handle_map( size_t, pid_t, size_t, size_t );
+void rpc_handle_map_async( size_t, pid_t, size_t, size_t );
 
 #endif
@@ -26,6 +26,8 @@
 #include "../vfs.h"
 #include "../file/handle.h"
 #include "../ioctl/handler.h"
+#include "../notify/notify.h"
+#include "../../../libvfs.h"
 
 /**
  * @fn void rpc_handle_add(size_t, pid_t, size_t, size_t)
@@ -161,6 +163,8 @@ void rpc_handle_add(
       }
     }
   }
+  // wake up processes waiting for nodes within parent
+  notify_pulse( node, VFS_NOTIFY_CHILD );
   //EARLY_STARTUP_PRINT( "-------->VFS DEBUG_DUMP<--------\r\n" )
   //vfs_dump( NULL, NULL );
   free( str );
@@ -25,6 +25,8 @@
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../pool/pool.h"
+#include "../notify/notify.h"
 
 /**
  * @fn void rpc_handle_close(size_t, pid_t, size_t, size_t)
@@ -42,17 +44,18 @@ void rpc_handle_close(
   __unused size_t response_info
 ) {
   vfs_close_response_t response = { .status = -EINVAL };
-  vfs_close_request_ptr_t request = malloc( sizeof( vfs_close_request_t ) );
-  if ( ! request ) {
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     return;
   }
+  vfs_close_request_ptr_t request = &context->request.close;
   // clear variables
   memset( request, 0, sizeof( vfs_close_request_t ) );
   // handle no data
   if( ! data_info ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // fetch rpc data
@@ -60,10 +63,15 @@ void rpc_handle_close(
   // handle error
   if ( errno ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
+  // drop possible readiness watch of handle
+  handle_container_ptr_t container;
+  if ( 0 == handle_get( &container, origin, request->handle ) ) {
+    notify_unwatch( container->target, origin, request->handle );
+  }
   response.status = handle_destory( origin, request->handle );
   bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-  free( request );
+  pool_release( context );
 }
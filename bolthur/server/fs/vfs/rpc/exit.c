@@ -25,6 +25,10 @@
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../queue/queue.h"
+#include "../mount/mount.h"
+#include "../notify/notify.h"
+#include "../pool/pool.h"
 
 /**
  * @fn void rpc_handle_exit(size_t, pid_t, size_t, size_t)
@@ -42,8 +46,16 @@ void rpc_handle_exit(
   __unused size_t response_info
 ) {
   vfs_close_response_t response = { .status = -EINVAL };
+  // remove readiness watches of origin
+  notify_unwatch_all( origin );
   // destroy all handles of origin
   handle_destory_all( origin );
+  // detach possibly attached queue
+  queue_destroy( origin );
+  // remove mount points handled by origin
+  mount_remove_all( origin );
+  // abort forwarded requests from or towards origin
+  pool_release_process( origin );
   // FIXME: Destroy all handles where current origin is handler
   // FIXME: Remove all files added by origin
   // return
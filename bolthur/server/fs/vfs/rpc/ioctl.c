@@ -28,10 +28,41 @@
 #include "../vfs.h"
 #include "../file/handle.h"
 #include "../ioctl/handler.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
 
 /**
- * @fn void rpc_handle_read_async(size_t, pid_t, size_t, size_t)
- * @brief Internal helper to continue asynchronous started read
+ * @fn void rpc_handle_ioctl_respond(pool_context_ptr_t, int)
+ * @brief Internal helper to answer forwarded ioctl with an error and release
+ * the context
+ *
+ * @param context
+ * @param status
+ */
+static void rpc_handle_ioctl_respond( pool_context_ptr_t context, int status ) {
+  vfs_ioctl_perform_response_t err_response = { .status = status };
+  _rpc_ret_deferred(
+    context->type,
+    &err_response,
+    sizeof( err_response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_ioctl_abort(pool_context_ptr_t)
+ * @brief Answer forwarded ioctl with an error and release context
+ *
+ * @param context
+ */
+static void rpc_handle_ioctl_abort( pool_context_ptr_t context ) {
+  rpc_handle_ioctl_respond( context, -EIO );
+}
+
+/**
+ * @fn void rpc_handle_ioctl_async(size_t, pid_t, size_t, size_t)
+ * @brief Internal helper to continue asynchronous started ioctl
  *
  * @param type
  * @param origin
@@ -39,7 +70,7 @@
  * @param response_info
  */
 void rpc_handle_ioctl_async(
-  size_t type,
+  __unused size_t type,
   __maybe_unused pid_t origin,
   size_t data_info,
   size_t response_info
@@ -48,59 +79,43 @@ void rpc_handle_ioctl_async(
   if( ! data_info ) {
     return;
   }
-  // dummy error response
-  vfs_ioctl_perform_response_t err_response = { .status = -EINVAL };
-  // get matching async data
-  bolthur_async_data_ptr_t async_data = bolthur_rpc_pop_async(
-    type,
-    response_info
-  );
-  if ( ! async_data ) {
+  // get parked context
+  pool_context_ptr_t context = pool_complete( response_info );
+  if ( ! context ) {
     bolthur_rpc_remove_data( data_info );
     return;
   }
   // get message size
   size_t rpc_response_size = _rpc_get_data_size( data_info );
   if ( errno ) {
-    err_response.status = -EIO;
     bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, &err_response, sizeof( err_response ), async_data );
+    rpc_handle_ioctl_respond( context, -EIO );
     return;
   }
-  // get data
-  char* rpc_response = malloc( rpc_response_size );
-  if ( ! rpc_response ) {
-    err_response.status = -ENOMEM;
+  // build return request
+  size_t response_size = sizeof( vfs_ioctl_perform_response_t )
+    + ( sizeof( char ) * rpc_response_size );
+  vfs_ioctl_perform_response_ptr_t response = pool_buffer(
+    context,
+    response_size
+  );
+  if ( ! response ) {
     bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, &err_response, sizeof( err_response ), async_data );
+    rpc_handle_ioctl_respond( context, -ENOMEM );
     return;
   }
-  memset( rpc_response, 0, rpc_response_size );
-  _rpc_get_data( rpc_response, rpc_response_size, data_info, false );
+  // fetch data directly into response
+  _rpc_get_data( response->container, rpc_response_size, data_info, false );
   if ( errno ) {
-    err_response.status = -EIO;
     bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, &err_response, sizeof( err_response ), async_data );
-    free( rpc_response );
-    return;
-  }
-  // build return request
-  size_t response_size = sizeof( vfs_ioctl_perform_response_t )
-    + ( sizeof( char ) * rpc_response_size );
-  vfs_ioctl_perform_response_ptr_t response = malloc( response_size );
-  if ( ! response ) {
-    err_response.status = -ENOMEM;
-    bolthur_rpc_return( type, &err_response, sizeof( err_response ), async_data );
-    free( rpc_response );
+    rpc_handle_ioctl_respond( context, -EIO );
     return;
   }
   // fill response structure
   response->status = 0;
-  memcpy( response->container, rpc_response, rpc_response_size );
   // return response
-  bolthur_rpc_return( type, response, response_size, async_data );
-  free( rpc_response );
-  free( response );
+  _rpc_ret_deferred( context->type, response, response_size, context->rpc_id );
+  pool_release( context );
 }
 
 /**
@@ -137,11 +152,18 @@ void rpc_handle_ioctl(
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
     return;
   }
-  // get request
-  vfs_ioctl_perform_request_ptr_t request = malloc( data_size );
+  // get context and request storage
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
+    err_response.status = -ENOMEM;
+    bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
+    return;
+  }
+  vfs_ioctl_perform_request_ptr_t request = pool_buffer( context, data_size );
   if ( ! request ) {
     err_response.status = -ENOMEM;
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
+    pool_release( context );
     return;
   }
   memset( request, 0, data_size );
@@ -149,7 +171,7 @@ void rpc_handle_ioctl(
   if ( errno ) {
     err_response.status = -EIO;
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // get handle
@@ -160,7 +182,7 @@ void rpc_handle_ioctl(
   if ( 0 > result ) {
     err_response.status = -EBADF;
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // get ioctl container
@@ -171,7 +193,7 @@ void rpc_handle_ioctl(
   if ( ! ioctl_container ) {
     err_response.status = -EIO;
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // respond result if type is not none or write only
@@ -192,28 +214,27 @@ void rpc_handle_ioctl(
     // set status depending on errno
     err_response.status = errno ? -EIO : 0;
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // raise async rpc
-  bolthur_rpc_raise(
+  size_t response_id = _rpc_raise_async(
     ioctl_container->command,
     handle_container->target->pid,
     request->container,
-    data_size - sizeof( vfs_ioctl_perform_request_t ),
-    false,
-    false,
-    type,
-    request,
-    data_size,
-    origin,
-    data_info
+    data_size - sizeof( vfs_ioctl_perform_request_t )
   );
   if ( errno ) {
     err_response.status = -EIO;
     bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
-  free( request );
+  // park context until response arrives
+  pool_forward(
+    context,
+    handle_container->target->pid,
+    response_id,
+    rpc_handle_ioctl_abort
+  );
 }
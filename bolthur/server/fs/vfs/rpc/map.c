@@ -0,0 +1,191 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../vfs.h"
+#include "../file/handle.h"
+#include "../pool/pool.h"
+#include "../shared/shared.h"
+#include "../../../libsyscall.h"
+
+/**
+ * @fn void rpc_handle_map_abort(pool_context_ptr_t)
+ * @brief Answer delegated map with an error and release context
+ *
+ * @param context
+ */
+static void rpc_handle_map_abort( pool_context_ptr_t context ) {
+  vfs_map_response_t response = { .status = -EIO };
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_map_async(size_t, pid_t, size_t, size_t)
+ * @brief Internal helper to continue map delegated to the handling process
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_map_async(
+  __unused size_t type,
+  __maybe_unused pid_t origin,
+  size_t data_info,
+  size_t response_info
+) {
+  vfs_map_response_t response = { .status = -EIO };
+  // handle no data
+  if( ! data_info ) {
+    return;
+  }
+  // get parked context
+  pool_context_ptr_t context = pool_complete( response_info );
+  if ( ! context ) {
+    bolthur_rpc_remove_data( data_info );
+    return;
+  }
+  // fetch response
+  _rpc_get_data( &response, sizeof( response ), data_info, false );
+  if ( errno ) {
+    bolthur_rpc_remove_data( data_info );
+    rpc_handle_map_abort( context );
+    return;
+  }
+  // register pages covering the whole range as shared text of the file
+  vfs_map_request_ptr_t request = &context->request.map;
+  handle_container_ptr_t container;
+  if (
+    0 == response.status
+    && response.shm_id
+    && 0 == response.offset
+    && request->len == response.len
+    && 0 == handle_get( &container, context->origin, request->handle )
+    && container->target->pid == context->target
+  ) {
+    size_t shm_id = response.shm_id;
+    shared_publish(
+      container->target,
+      container->path,
+      VFS_SHARED_TEXT,
+      request->offset,
+      request->len,
+      context->target,
+      &shm_id
+    );
+  }
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_map(size_t, pid_t, size_t, size_t)
+ * @brief Handle read only mapping request of an opened file
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_map(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  size_t response_info
+) {
+  // handle async return in case response info is set
+  if ( response_info ) {
+    rpc_handle_map_async( type, origin, data_info, response_info );
+    return;
+  }
+  vfs_map_response_t response = { .status = -EINVAL };
+  // allocate message structures
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
+    response.status = -ENOMEM;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  vfs_map_request_ptr_t request = &context->request.map;
+  vfs_map_request_ptr_t nested_request = &context->nested.map;
+  handle_container_ptr_t container;
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( request, sizeof( vfs_map_request_t ), data_info, false );
+  // handle error
+  if ( errno ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // try to get handle information
+  int result = handle_get( &container, origin, request->handle );
+  if ( 0 > result ) {
+    response.status = result;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // prepare structure
+  memset( nested_request, 0, sizeof( vfs_map_request_t ) );
+  strncpy( nested_request->file_path, container->path, PATH_MAX - 1 );
+  nested_request->handle = request->handle;
+  nested_request->offset = request->offset;
+  nested_request->len = request->len;
+  // perform async rpc
+  size_t response_id = _rpc_raise_async(
+    type,
+    container->target->pid,
+    nested_request,
+    sizeof( vfs_map_request_t )
+  );
+  if ( errno ) {
+    response.status = -EIO;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // park context until response arrives
+  pool_forward(
+    context,
+    container->target->pid,
+    response_id,
+    rpc_handle_map_abort
+  );
+}
@@ -0,0 +1,231 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../vfs.h"
+#include "../file/handle.h"
+#include "../mount/mount.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_mount(size_t, pid_t, size_t, size_t)
+ * @brief Handle mount request
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_mount(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_mount_response_t response = { .status = -EINVAL };
+  vfs_mount_request_ptr_t request = malloc( sizeof( vfs_mount_request_t ) );
+  if ( ! request ) {
+    response.status = -ENOMEM;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // clear variables
+  memset( request, 0, sizeof( vfs_mount_request_t ) );
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( request, sizeof( vfs_mount_request_t ), data_info, false );
+  // handle error
+  if ( errno ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  request->path[ PATH_MAX - 1 ] = '\0';
+  // mount point has to be an existing directory
+  vfs_node_ptr_t node = vfs_node_by_path( request->path );
+  if ( ! node || ! S_ISDIR( node->st->st_mode ) ) {
+    response.status = node ? -ENOTDIR : -ENOENT;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  // add mount point
+  response.status = mount_add( request->path, origin );
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+  free( request );
+}
+
+/**
+ * @fn void rpc_handle_umount(size_t, pid_t, size_t, size_t)
+ * @brief Handle umount request
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_umount(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_mount_response_t response = { .status = -EINVAL };
+  vfs_mount_request_ptr_t request = malloc( sizeof( vfs_mount_request_t ) );
+  if ( ! request ) {
+    response.status = -ENOMEM;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // clear variables
+  memset( request, 0, sizeof( vfs_mount_request_t ) );
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( request, sizeof( vfs_mount_request_t ), data_info, false );
+  // handle error
+  if ( errno ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  request->path[ PATH_MAX - 1 ] = '\0';
+  // remove mount point
+  response.status = mount_remove( request->path, origin );
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+  free( request );
+}
+
+/**
+ * @fn void rpc_handle_lookup_respond(pool_context_ptr_t, int)
+ * @brief Internal helper to finish delegated open and release the context
+ *
+ * @param context
+ * @param handle
+ */
+static void rpc_handle_lookup_respond( pool_context_ptr_t context, int handle ) {
+  vfs_open_response_t response = { .handle = handle };
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_lookup(size_t, pid_t, size_t, size_t)
+ * @brief Handle lookup response of a mount handling process and finish open
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_lookup(
+  size_t type,
+  __maybe_unused pid_t origin,
+  size_t data_info,
+  size_t response_info
+) {
+  vfs_open_response_t response = { .handle = -EINVAL };
+  // lookup is only raised by vfs itself
+  if ( ! response_info ) {
+    if ( data_info ) {
+      bolthur_rpc_remove_data( data_info );
+    }
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // handle no data
+  if( ! data_info ) {
+    return;
+  }
+  // get parked context
+  pool_context_ptr_t context = pool_complete( response_info );
+  if ( ! context ) {
+    bolthur_rpc_remove_data( data_info );
+    return;
+  }
+  // original request
+  vfs_open_request_ptr_t request = &context->request.open;
+  // fetch lookup response
+  vfs_stat_response_t lookup = { .success = false };
+  _rpc_get_data( &lookup, sizeof( lookup ), data_info, false );
+  if ( errno ) {
+    bolthur_rpc_remove_data( data_info );
+    rpc_handle_lookup_respond( context, -EIO );
+    return;
+  }
+  // handle not existing
+  if ( ! lookup.success ) {
+    rpc_handle_lookup_respond(
+      context,
+      ( request->flags & O_CREAT ) ? -ENOSYS : -ENOENT
+    );
+    return;
+  }
+  if ( ( request->flags & O_CREAT ) && ( request->flags & O_EXCL ) ) {
+    rpc_handle_lookup_respond( context, -EEXIST );
+    return;
+  }
+  // handle target directory with write or read write flags
+  if (
+    S_ISDIR( lookup.info.st_mode )
+    && ( ( request->flags & O_WRONLY ) || ( request->flags & O_RDWR ) )
+  ) {
+    rpc_handle_lookup_respond( context, -EISDIR );
+    return;
+  }
+  // ensure that mount point still exists
+  mount_node_ptr_t mount = mount_resolve( request->path );
+  if ( ! mount ) {
+    rpc_handle_lookup_respond( context, -ENOENT );
+    return;
+  }
+  // generate handle
+  handle_container_ptr_t container = NULL;
+  int result = handle_generate_mounted(
+    &container,
+    context->origin,
+    mount->pid,
+    request->path,
+    request->flags,
+    request->mode,
+    &lookup.info
+  );
+  rpc_handle_lookup_respond( context, container ? container->handle : result );
+}
@@ -0,0 +1,192 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../vfs.h"
+#include "../file/handle.h"
+#include "../notify/notify.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_notify_publish(size_t, pid_t, size_t, size_t)
+ * @brief Handle readiness state published by the handler of a path
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_notify_publish(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_notify_publish_response_t response = { .status = -EINVAL };
+  vfs_notify_publish_request_ptr_t request = malloc(
+    sizeof( vfs_notify_publish_request_t )
+  );
+  if ( ! request ) {
+    response.status = -ENOMEM;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // clear variables
+  memset( request, 0, sizeof( vfs_notify_publish_request_t ) );
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data(
+    request,
+    sizeof( vfs_notify_publish_request_t ),
+    data_info,
+    false
+  );
+  // handle error
+  if ( errno ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  request->path[ PATH_MAX - 1 ] = '\0';
+  vfs_node_ptr_t node = vfs_node_by_path( request->path );
+  if ( ! node ) {
+    response.status = -ENOENT;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  // only the handling process is allowed to publish state
+  if ( node->pid != origin ) {
+    response.status = -EPERM;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    free( request );
+    return;
+  }
+  // update state and wake up watchers
+  notify_publish( node, request->events );
+  response.status = 0;
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+  free( request );
+}
+
+/**
+ * @fn void rpc_handle_notify_register(size_t, pid_t, size_t, size_t)
+ * @brief Handle register of an interest set, returns currently ready handles
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_notify_register(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_notify_ready_ptr_t response = malloc( sizeof( vfs_notify_ready_t ) );
+  if ( ! response ) {
+    vfs_notify_ready_t err_response = { .status = -ENOMEM };
+    bolthur_rpc_return( type, &err_response, sizeof( err_response ), NULL );
+    return;
+  }
+  memset( response, 0, sizeof( vfs_notify_ready_t ) );
+  response->status = -EINVAL;
+  vfs_notify_register_request_ptr_t request = malloc(
+    sizeof( vfs_notify_register_request_t )
+  );
+  if ( ! request ) {
+    response->status = -ENOMEM;
+    bolthur_rpc_return( type, response, sizeof( *response ), NULL );
+    free( response );
+    return;
+  }
+  // clear variables
+  memset( request, 0, sizeof( vfs_notify_register_request_t ) );
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, response, sizeof( *response ), NULL );
+    free( request );
+    free( response );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data(
+    request,
+    sizeof( vfs_notify_register_request_t ),
+    data_info,
+    false
+  );
+  // handle error
+  if ( errno || request->count > VFS_NOTIFY_MAX ) {
+    bolthur_rpc_return( type, response, sizeof( *response ), NULL );
+    free( request );
+    free( response );
+    return;
+  }
+  response->status = 0;
+  for ( size_t index = 0; index < request->count; index++ ) {
+    vfs_notify_entry_ptr_t entry = &request->entry[ index ];
+    handle_container_ptr_t container;
+    uint32_t ready = 0;
+    // get handle
+    int result = handle_get( &container, origin, entry->handle );
+    // handles below a mount point are not backed by a vfs node
+    if (
+      0 == result
+      && container->target == &container->mounted
+    ) {
+      result = -EXDEV;
+    }
+    if ( 0 == result ) {
+      result = notify_watch(
+        container->target,
+        origin,
+        entry->handle,
+        entry->events,
+        &ready
+      );
+    }
+    // report first error, but keep processing remaining entries
+    if ( 0 > result ) {
+      if ( 0 == response->status ) {
+        response->status = result;
+      }
+      ready = VFS_NOTIFY_ERROR;
+    }
+    if ( ! ready ) {
+      continue;
+    }
+    response->entry[ response->count ].handle = entry->handle;
+    response->entry[ response->count ].events = ready;
+    response->count++;
+  }
+  bolthur_rpc_return( type, response, sizeof( *response ), NULL );
+  free( request );
+  free( response );
+}
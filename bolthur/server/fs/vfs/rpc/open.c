@@ -17,7 +17,6 @@
  * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <libgen.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -26,6 +25,27 @@
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../mount/mount.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_open_abort(pool_context_ptr_t)
+ * @brief Answer open delegated to a mount with an error and release context
+ *
+ * @param context
+ */
+static void rpc_handle_open_abort( pool_context_ptr_t context ) {
+  vfs_open_response_t response = { .handle = -EIO };
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
 
 /**
  * @fn void rpc_handle_open(size_t, pid_t, size_t, size_t)
@@ -45,22 +65,20 @@ void rpc_handle_open(
   size_t data_info,
   __unused size_t response_info
 ) {
-  vfs_open_response_t response = { .handle = -EINVAL };
-  vfs_open_request_ptr_t request = malloc( sizeof( vfs_open_request_t ) );
-  if ( ! request ) {
+  vfs_open_response_t response = { .handle = -ENOMEM };
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     return;
   }
-  char* dir = NULL;
-  char* base = NULL;
-  char* dir_old = NULL;
-  char* base_old = NULL;
+  vfs_open_request_ptr_t request = &context->request.open;
+  response.handle = -EINVAL;
   // clear variables
   memset( request, 0, sizeof( vfs_open_request_t ) );
   // handle no data
   if( ! data_info ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // fetch rpc data
@@ -68,83 +86,87 @@ void rpc_handle_open(
   // handle error
   if ( errno ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
+  request->path[ PATH_MAX - 1 ] = '\0';
 
   // output
   // EARLY_STARTUP_PRINT( "Try to open %s\r\n", request->path )
   // check path name components
-  do {
-    // extract base and dir
-    base = basename( !dir ? request->path : dir );
-    dir = dirname( !dir ? request->path : dir );
-    // EARLY_STARTUP_PRINT( "base = %s, dir = %s\r\n", base, dir )
-    // cleanup previous dir / base stuff
-    if ( dir_old ) {
-      free( dir_old );
-    }
-    if ( base_old ) {
-      free( base_old );
-    }
+  char* part = request->path;
+  while ( *part ) {
+    size_t part_length = strcspn( part, "/" );
     // handle part to long
-    if ( NAME_MAX < strlen( base ) ) {
-      // free stuff
-      free( base );
-      free( dir );
+    if ( NAME_MAX < part_length ) {
       // prepare error return
       response.handle = -ENAMETOOLONG;
       bolthur_rpc_return( type, &response, sizeof( response ), NULL );
       // free message structures
-      free( request );
+      pool_release( context );
       return;
     }
-    // set old
-    dir_old = dir;
-    base_old = base;
-  } while ( dir && 1 < strlen( dir ) );
-  // free dir and base again
-  if ( dir ) {
-    free( dir );
-  }
-  if ( base ) {
-    free( base );
+    part += part_length;
+    part += strspn( part, "/" );
   }
 
-  // extract dir and base names
-  dir = dirname( request->path );
-  base = basename( request->path );
+  // delegate lookup of files below a mount point to handling process
+  mount_node_ptr_t mount = mount_resolve( request->path );
+  if ( mount ) {
+    vfs_stat_request_ptr_t nested_request = &context->nested.stat;
+    memset( nested_request, 0, sizeof( vfs_stat_request_t ) );
+    strncpy( nested_request->file_path, request->path, PATH_MAX - 1 );
+    // perform async rpc, completion is handled by rpc_handle_lookup
+    size_t response_id = _rpc_raise_async(
+      RPC_VFS_LOOKUP,
+      mount->pid,
+      nested_request,
+      sizeof( vfs_stat_request_t )
+    );
+    if ( errno ) {
+      response.handle = -EIO;
+      bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+      pool_release( context );
+      return;
+    }
+    // park context until response arrives
+    pool_forward( context, mount->pid, response_id, rpc_handle_open_abort );
+    return;
+  }
 
-  // get parent node by dir
-  vfs_node_ptr_t dir_node = vfs_node_by_path( dir );
+  // strip trailing slashes
+  size_t length = strlen( request->path );
+  while ( 1 < length && '/' == request->path[ length - 1 ] ) {
+    request->path[ --length ] = '\0';
+  }
+  // split into dir and base name in place
+  char* base = strrchr( request->path, '/' );
+  vfs_node_ptr_t dir_node;
+  if ( ! base ) {
+    dir_node = vfs_node_by_path( "/" );
+    base = request->path;
+  } else if ( base == request->path ) {
+    dir_node = vfs_node_by_path( "/" );
+    base++;
+  } else {
+    *base = '\0';
+    dir_node = vfs_node_by_path( request->path );
+    *base++ = '/';
+  }
+  // handle parent not existing
   if ( ! dir_node ) {
     // debug output
-    EARLY_STARTUP_PRINT( "Error: \"%s/%s\" doesn't exist!\r\n", dir, base )
-    free( dir );
-    free( base );
+    EARLY_STARTUP_PRINT( "Error: \"%s\" doesn't exist!\r\n", request->path )
     // prepare error return
     response.handle = ( request->flags & O_CREAT ) ? -ENOENT : -ENOTDIR;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free message structures
-    free( request );
+    pool_release( context );
     return;
   }
 
   // get file node of dir
   vfs_node_ptr_t base_node = vfs_node_by_name( dir_node, base );
-  if ( ! base_node && ! ( request->flags & O_CREAT ) ) {
-    free( dir );
-    free( base );
-    // prepare error return
-    response.handle = -ENOENT;
-    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    // free message structures
-    free( request );
-    return;
-  }
-  // free dir and base strings
-  free( dir );
-  free( base );
 
   if (
     ! base_node
@@ -154,7 +176,7 @@ void rpc_handle_open(
     response.handle = -ENOENT;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free message structures
-    free( request );
+    pool_release( context );
     return;
   }
 
@@ -167,7 +189,7 @@ void rpc_handle_open(
     response.handle = -EEXIST;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free message structures
-    free( request );
+    pool_release( context );
     return;
   }
 
@@ -177,7 +199,7 @@ void rpc_handle_open(
     response.handle = -ENOSYS;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free message structures
-    free( request );
+    pool_release( context );
     return;
   }
 
@@ -201,7 +223,7 @@ void rpc_handle_open(
     response.handle = -EISDIR;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free message structures
-    free( request );
+    pool_release( context );
     return;
   }
 
@@ -221,13 +243,11 @@ void rpc_handle_open(
   if ( ! container ) {
     // debug output
     EARLY_STARTUP_PRINT( "Error: Unable to generate new handle container!\r\n" )
-    free( dir );
-    free( base );
     // prepare error return
     response.handle = result;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free message structures
-    free( request );
+    pool_release( context );
     return;
   }
 
@@ -235,5 +255,5 @@ void rpc_handle_open(
   response.handle = container->handle;
   bolthur_rpc_return( type, &response, sizeof( response ), NULL );
   // free message structures
-  free( request );
+  pool_release( context );
 }
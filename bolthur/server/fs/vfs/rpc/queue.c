@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../queue/queue.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_queue_setup(size_t, pid_t, size_t, size_t)
+ * @brief Handle queue setup request
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_queue_setup(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_queue_setup_response_t response = { .status = -EINVAL };
+  vfs_queue_setup_request_t request;
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( &request, sizeof( request ), data_info, false );
+  // handle error
+  if ( errno ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // attach queue and return
+  response.status = queue_setup( origin, request.shm_id );
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+}
+
+/**
+ * @fn void rpc_handle_queue_submit(size_t, pid_t, size_t, size_t)
+ * @brief Handle queue submit request
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ *
+ * @note Response is deferred until forwarded requests are completed
+ */
+void rpc_handle_queue_submit(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_queue_submit_response_t response = { .status = -EINVAL };
+  // drain queue
+  response.status = queue_submit( origin, data_info );
+  // skip return if request has been forwarded
+  if ( -EINPROGRESS == response.status ) {
+    return;
+  }
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+}
@@ -21,11 +21,54 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
-#include <errno.h>
 #include <sys/bolthur.h>
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../queue/queue.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+
+/**
+ * @fn void rpc_handle_read_respond(size_t, pool_context_ptr_t, ssize_t)
+ * @brief Internal helper to respond without data and release the context
+ *
+ * @param type
+ * @param context
+ * @param len
+ */
+static void rpc_handle_read_respond(
+  size_t type,
+  pool_context_ptr_t context,
+  ssize_t len
+) {
+  vfs_read_response_ptr_t response = &context->response.read;
+  // clear response to not leak data of previous requests
+  memset( response, 0, sizeof( vfs_read_response_t ) );
+  response->len = len;
+  bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_read_abort(pool_context_ptr_t)
+ * @brief Answer forwarded read or readv with an error and release context
+ *
+ * @param context
+ */
+void rpc_handle_read_abort( pool_context_ptr_t context ) {
+  vfs_read_response_ptr_t response = &context->response.read;
+  // clear response to not leak data of previous requests
+  memset( response, 0, sizeof( vfs_read_response_t ) );
+  response->len = -EIO;
+  _rpc_ret_deferred(
+    context->type,
+    response,
+    sizeof( vfs_read_response_t ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
 
 /**
  * @fn void rpc_handle_read_async(size_t, pid_t, size_t, size_t)
@@ -37,7 +80,7 @@
  * @param response_info
  */
 void rpc_handle_read_async(
-  size_t type,
+  __unused size_t type,
   __maybe_unused pid_t origin,
   size_t data_info,
   size_t response_info
@@ -46,58 +89,35 @@ void rpc_handle_read_async(
   if( ! data_info ) {
     return;
   }
-  vfs_read_response_ptr_t response = malloc( sizeof( vfs_read_response_t ) );
-  if ( ! response ) {
+  // get parked context
+  pool_context_ptr_t context = pool_complete( response_info );
+  if ( ! context ) {
     bolthur_rpc_remove_data( data_info );
     return;
   }
-  memset( response, 0, sizeof( vfs_read_response_t ) );
-  response->len = -EINVAL;
-  // get matching async data
-  bolthur_async_data_ptr_t async_data = bolthur_rpc_pop_async(
-    type,
-    response_info
-  );
-  if ( ! async_data ) {
-    bolthur_rpc_remove_data( data_info );
-    free( response );
-    return;
-  }
-  // original request
-  vfs_read_request_ptr_t request = async_data->original_data;
-  if ( ! request ) {
-    bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), async_data );
-    return;
-  }
+  vfs_read_response_ptr_t response = &context->response.read;
   // fetch response
   _rpc_get_data( response, sizeof( vfs_read_response_t ), data_info, false );
   if ( errno ) {
     bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), async_data );
-    free( response );
+    rpc_handle_read_abort( context );
     return;
   }
+  // update offset if handle is still existing
   handle_container_ptr_t container;
-  // try to get handle information
-  int result = handle_get(
-    &container,
-    async_data->original_origin,
-    request->handle
-  );
-  // handle error
-  if ( 0 > result ) {
-    response->len = result;
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), async_data );
-    free( response );
-    return;
-  }
-  // update offsets and return
-  if ( 0 < response->len ) {
+  if (
+    0 < response->len
+    && 0 == handle_get( &container, context->origin, context->handle )
+  ) {
     container->pos += ( off_t )response->len;
   }
-  bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), async_data );
-  free( response );
+  _rpc_ret_deferred(
+    context->type,
+    response,
+    sizeof( vfs_read_response_t ),
+    context->rpc_id
+  );
+  pool_release( context );
 }
 
 /**
@@ -117,101 +137,70 @@ void rpc_handle_read(
 ) {
   // handle async return in case response info is set
   if ( response_info ) {
+    // check for response of forwarded queue entries
+    if ( queue_handle_response( type, data_info, response_info ) ) {
+      return;
+    }
     rpc_handle_read_async( type, origin, data_info, response_info );
     return;
   }
-  vfs_read_response_ptr_t response = malloc( sizeof( vfs_read_response_t ) );
-  if ( ! response ) {
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
     bolthur_rpc_remove_data( data_info );
     return;
   }
-  memset( response, 0, sizeof( vfs_read_response_t ) );
-  response->len = -ENOMEM;
-  vfs_read_request_ptr_t request = malloc( sizeof( vfs_read_request_t ) );
-  if ( ! request ) {
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    return;
-  }
-  vfs_read_request_ptr_t nested_request = malloc( sizeof( vfs_read_request_t ) );
-  if ( ! nested_request ) {
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    free( request );
-    return;
-  }
+  vfs_read_request_ptr_t request = &context->request.read;
+  vfs_read_request_ptr_t nested_request = &context->nested.read;
   handle_container_ptr_t container;
-  // clear variables
-  memset( request, 0, sizeof( vfs_read_request_t ) );
-  memset( nested_request, 0, sizeof( vfs_read_request_t ) );
-  response->len = -EINVAL;
   // handle no data
   if( ! data_info ) {
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    free( request );
-    free( nested_request );
+    rpc_handle_read_respond( type, context, -EINVAL );
     return;
   }
   // fetch rpc data
   _rpc_get_data( request, sizeof( vfs_read_request_t ), data_info, false );
   // handle error
   if ( errno ) {
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    free( request );
-    free( nested_request );
+    rpc_handle_read_respond( type, context, -EINVAL );
     return;
   }
   // try to get handle information
   int result = handle_get( &container, origin, request->handle );
   // handle error
   if ( 0 > result ) {
-    response->len = result;
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    free( request );
-    free( nested_request );
+    rpc_handle_read_respond( type, context, result );
     return;
   }
   // special handling for null device
   if ( 0 == strcmp( container->path, "/dev/null" ) ) {
-    response->len = 0;
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    free( request );
-    free( nested_request );
+    rpc_handle_read_respond( type, context, 0 );
     return;
   }
-  // get handling process
-  pid_t handling_process = container->target->pid;
   // prepare structure
+  memset( nested_request, 0, sizeof( vfs_read_request_t ) );
   strncpy( nested_request->file_path, container->path, PATH_MAX );
+  nested_request->handle = request->handle;
   nested_request->offset = container->pos;
   nested_request->len = request->len;
   nested_request->shm_id = request->shm_id;
+  // keep necessary state for completion within context
+  context->handle = request->handle;
   // perform async rpc
-  bolthur_rpc_raise(
+  size_t response_id = _rpc_raise_async(
     type,
-    handling_process,
+    container->target->pid,
     nested_request,
-    sizeof( vfs_read_request_t ),
-    false,
-    false,
-    type,
-    request,
-    sizeof( vfs_read_request_t ),
-    origin,
-    data_info
+    sizeof( vfs_read_request_t )
   );
   if ( errno ) {
-    bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
-    free( response );
-    free( request );
-    free( nested_request );
+    rpc_handle_read_respond( type, context, -EIO );
     return;
   }
-  free( response );
-  free( request );
-  free( nested_request );
+  // park context until response arrives
+  pool_forward(
+    context,
+    container->target->pid,
+    response_id,
+    rpc_handle_read_abort
+  );
 }
@@ -0,0 +1,140 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../vfs.h"
+#include "../file/handle.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_readv_respond(size_t, pool_context_ptr_t, ssize_t)
+ * @brief Internal helper to respond without data and release the context
+ *
+ * @param type
+ * @param context
+ * @param len
+ */
+static void rpc_handle_readv_respond(
+  size_t type,
+  pool_context_ptr_t context,
+  ssize_t len
+) {
+  vfs_read_response_ptr_t response = &context->response.read;
+  // clear response to not leak data of previous requests
+  memset( response, 0, sizeof( vfs_read_response_t ) );
+  response->len = len;
+  bolthur_rpc_return( type, response, sizeof( vfs_read_response_t ), NULL );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_readv(size_t, pid_t, size_t, size_t)
+ * @brief Handle vectored read request
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ *
+ * @note All vectors are merged into one read request towards the handling
+ * process, the packed result is returned in one response and scattered by
+ * the caller. Completion is handled by rpc_handle_read_async.
+ */
+void rpc_handle_readv(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
+    bolthur_rpc_remove_data( data_info );
+    return;
+  }
+  vfs_readv_request_ptr_t request = &context->request.readv;
+  vfs_read_request_ptr_t nested_request = &context->nested.read;
+  handle_container_ptr_t container;
+  // handle no data
+  if( ! data_info ) {
+    rpc_handle_readv_respond( type, context, -EINVAL );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( request, sizeof( vfs_readv_request_t ), data_info, false );
+  // handle error
+  if ( errno || VFS_IOV_MAX < request->count ) {
+    rpc_handle_readv_respond( type, context, -EINVAL );
+    return;
+  }
+  // sum up vector lengths
+  size_t total = 0;
+  for ( size_t idx = 0; idx < request->count; idx++ ) {
+    total += request->len[ idx ];
+  }
+  // ensure that inline result fits into response
+  if ( ! request->shm_id && sizeof( context->response.read.data ) < total ) {
+    rpc_handle_readv_respond( type, context, -EINVAL );
+    return;
+  }
+  // try to get handle information
+  int result = handle_get( &container, origin, request->handle );
+  // handle error
+  if ( 0 > result ) {
+    rpc_handle_readv_respond( type, context, result );
+    return;
+  }
+  // special handling for null device and empty vectors
+  if ( 0 == strcmp( container->path, "/dev/null" ) || ! total ) {
+    rpc_handle_readv_respond( type, context, 0 );
+    return;
+  }
+  // prepare structure
+  memset( nested_request, 0, sizeof( vfs_read_request_t ) );
+  strncpy( nested_request->file_path, container->path, PATH_MAX );
+  nested_request->handle = request->handle;
+  nested_request->offset = container->pos;
+  nested_request->len = total;
+  nested_request->shm_id = request->shm_id;
+  // keep necessary state for completion within context
+  context->handle = request->handle;
+  // perform async rpc
+  size_t response_id = _rpc_raise_async(
+    RPC_VFS_READ,
+    container->target->pid,
+    nested_request,
+    sizeof( vfs_read_request_t )
+  );
+  if ( errno ) {
+    rpc_handle_readv_respond( type, context, -EIO );
+    return;
+  }
+  // park context until response arrives
+  pool_forward(
+    context,
+    container->target->pid,
+    response_id,
+    rpc_handle_read_abort
+  );
+}
@@ -25,6 +25,7 @@
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../pool/pool.h"
 
 /**
  * @fn void rpc_handle_seek(size_t, pid_t, size_t, size_t)
@@ -42,18 +43,19 @@ void rpc_handle_seek(
   __unused size_t response_info
 ) {
   vfs_seek_response_t response = { .position = -EINVAL };
-  vfs_seek_request_ptr_t request = malloc( sizeof( vfs_seek_request_t ) );
-  if ( ! request ) {
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     return;
   }
+  vfs_seek_request_ptr_t request = &context->request.seek;
   handle_container_ptr_t container;
   // clear variables
   memset( request, 0, sizeof( vfs_seek_request_t ) );
   // handle no data
   if( ! data_info ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // fetch rpc data
@@ -61,7 +63,7 @@ void rpc_handle_seek(
   // handle error
   if ( errno ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // try to get handle information
@@ -72,47 +74,19 @@ void rpc_handle_seek(
     response.position = result;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     // free stuff
-    free( request );
+    pool_release( context );
     // skip rest
     return;
   }
 
-  /*EARLY_STARTUP_PRINT(
-    "%s - request->whence = %d, request->handle = %d, request->offset = %#lx\r\n",
-    container->path, request->whence, request->handle, request->offset
-  )*/
-
-  // get current position
-  off_t new_pos;
-  // determine what to do
-  switch( request->whence ) {
-    case SEEK_SET:
-      new_pos = request->offset;
-      break;
-    case SEEK_CUR:
-      new_pos = container->pos + ( off_t )request->offset;
-      break;
-    case SEEK_END:
-      new_pos = ( off_t )container->target->st->st_size;
-      break;
-    default:
-      new_pos = -1;
-  }
-
-  //EARLY_STARTUP_PRINT( "container->pos = %#lx\r\n", new_pos )
-  // build response
-  if ( 0 > new_pos || new_pos > container->target->st->st_size ) {
-    // send errno via negative len
-    response.position = -EINVAL;
-  } else {
-    // set new position in handle
-    container->pos = new_pos;
-    // push into response
-    response.position = new_pos;
-  }
-  //EARLY_STARTUP_PRINT( "container->pos = %#lx\r\n", new_pos )
+  // move position, negative result is passed through as errno
+  response.position = handle_seek(
+    container,
+    ( off_t )request->offset,
+    request->whence
+  );
   // return response
   bolthur_rpc_return( type, &response, sizeof( response ), NULL );
   // free stuff
-  free( request );
+  pool_release( context );
 }
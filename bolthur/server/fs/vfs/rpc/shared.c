@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../vfs.h"
+#include "../file/handle.h"
+#include "../shared/shared.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_shared_area(size_t, pid_t, size_t, size_t)
+ * @brief Handle lookup and publish of shared read only areas of a file
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_shared_area(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_shared_area_response_t response = { .status = -EINVAL };
+  vfs_shared_area_request_t request;
+  // clear variables
+  memset( &request, 0, sizeof( request ) );
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( &request, sizeof( request ), data_info, false );
+  // handle error
+  if ( errno ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // get handle information
+  handle_container_ptr_t container;
+  int result = handle_get( &container, origin, request.handle );
+  if ( 0 != result ) {
+    response.status = result;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // only regular files have shared areas
+  if (
+    ! S_ISREG( container->target->st->st_mode )
+    || VFS_SHARED_RELOCATION < request.type
+    || ( VFS_SHARED_TEXT == request.type && ! request.size )
+  ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // text is only registered from mappings of the handling process
+  if ( request.shm_id && VFS_SHARED_TEXT == request.type ) {
+    response.status = -EPERM;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  // lookup or publish
+  if ( ! request.shm_id ) {
+    response.shm_id = shared_lookup(
+      container->target,
+      container->path,
+      request.type,
+      request.offset,
+      request.size
+    );
+    response.status = 0;
+  } else {
+    response.shm_id = request.shm_id;
+    response.status = shared_publish(
+      container->target,
+      container->path,
+      request.type,
+      request.offset,
+      request.size,
+      origin,
+      &response.shm_id
+    );
+  }
+  bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+}
@@ -25,6 +25,68 @@
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../mount/mount.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+
+/**
+ * @fn void rpc_handle_stat_abort(pool_context_ptr_t)
+ * @brief Answer delegated stat with an error and release context
+ *
+ * @param context
+ */
+static void rpc_handle_stat_abort( pool_context_ptr_t context ) {
+  vfs_stat_response_t response = { .success = false };
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
+
+/**
+ * @fn void rpc_handle_stat_async(size_t, pid_t, size_t, size_t)
+ * @brief Internal helper to continue stat delegated to a mount
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void rpc_handle_stat_async(
+  __unused size_t type,
+  __maybe_unused pid_t origin,
+  size_t data_info,
+  size_t response_info
+) {
+  vfs_stat_response_t response = { .success = false };
+  // handle no data
+  if( ! data_info ) {
+    return;
+  }
+  // get parked context
+  pool_context_ptr_t context = pool_complete( response_info );
+  if ( ! context ) {
+    bolthur_rpc_remove_data( data_info );
+    return;
+  }
+  // fetch response
+  _rpc_get_data( &response, sizeof( response ), data_info, false );
+  if ( errno ) {
+    bolthur_rpc_remove_data( data_info );
+    rpc_handle_stat_abort( context );
+    return;
+  }
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
 
 /**
  * @fn void rpc_handle_stat(size_t, pid_t, size_t, size_t)
@@ -39,21 +101,27 @@ void rpc_handle_stat(
   size_t type,
   pid_t origin,
   size_t data_info,
-  __unused size_t response_info
+  size_t response_info
 ) {
+  // handle async return in case response info is set
+  if ( response_info ) {
+    rpc_handle_stat_async( type, origin, data_info, response_info );
+    return;
+  }
   vfs_stat_response_t response = { .success = false };
   // allocate message structures
-  vfs_stat_request_ptr_t request = malloc( sizeof( vfs_stat_request_t ) );
-  if ( ! request ) {
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     return;
   }
+  vfs_stat_request_ptr_t request = &context->request.stat;
   // clear variables
   memset( request, 0, sizeof( vfs_stat_request_t ) );
   // handle no data
   if( ! data_info ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
     return;
   }
   // fetch rpc data
@@ -61,7 +129,27 @@ void rpc_handle_stat(
   // handle error
   if ( errno ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
+    pool_release( context );
+    return;
+  }
+  // delegate stat of files below a mount point to handling process
+  mount_node_ptr_t mount = 0 < strlen( request->file_path )
+    ? mount_resolve( request->file_path ) : NULL;
+  if ( mount ) {
+    // perform async rpc
+    size_t response_id = _rpc_raise_async(
+      type,
+      mount->pid,
+      request,
+      sizeof( vfs_stat_request_t )
+    );
+    if ( errno ) {
+      bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+      pool_release( context );
+      return;
+    }
+    // park context until response arrives
+    pool_forward( context, mount->pid, response_id, rpc_handle_stat_abort );
     return;
   }
   // get target node
@@ -89,5 +177,5 @@ void rpc_handle_stat(
     EARLY_STARTUP_PRINT( "return error = %s\r\n", strerror( errno ) )
   }
   // free message structures
-  free( request );
+  pool_release( context );
 }
@@ -25,6 +25,26 @@
 #include "../rpc.h"
 #include "../vfs.h"
 #include "../file/handle.h"
+#include "../queue/queue.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+
+/**
+ * @fn void rpc_handle_write_abort(pool_context_ptr_t)
+ * @brief Answer forwarded write or writev with an error and release context
+ *
+ * @param context
+ */
+void rpc_handle_write_abort( pool_context_ptr_t context ) {
+  vfs_write_response_t response = { .len = -EIO };
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
+}
 
 /**
  * @fn void rpc_handle_write_async(size_t, pid_t, size_t, size_t)
@@ -36,58 +56,44 @@
  * @param response_info
  */
 void rpc_handle_write_async(
-  size_t type,
+  __unused size_t type,
   __maybe_unused pid_t origin,
   size_t data_info,
   size_t response_info
 ) {
-  vfs_write_response_t response = { .len = -ENOMEM };
+  vfs_write_response_t response = { .len = -EIO };
   // handle no data
   if( ! data_info ) {
     return;
   }
-  // get matching async data
-  bolthur_async_data_ptr_t async_data = bolthur_rpc_pop_async(
-    type,
-    response_info
-  );
-  if ( ! async_data ) {
+  // get parked context
+  pool_context_ptr_t context = pool_complete( response_info );
+  if ( ! context ) {
     bolthur_rpc_remove_data( data_info );
     return;
   }
-  // original request
-  vfs_write_request_ptr_t request = async_data->original_data;
-  // cache origin and rpc necessary for getting handle and return to correct target
-  if ( ! request ) {
-    bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, &response, sizeof( response ), async_data );
-    return;
-  }
   // fetch response
   _rpc_get_data( &response, sizeof( response ), data_info, false );
   if ( errno ) {
     bolthur_rpc_remove_data( data_info );
-    bolthur_rpc_return( type, &response, sizeof( response ), async_data );
+    rpc_handle_write_abort( context );
     return;
   }
+  // update offset if handle is still existing
   handle_container_ptr_t container;
-  // try to get handle information
-  int result = handle_get(
-    &container,
-    async_data->original_origin,
-    request->handle
-  );
-  // handle error
-  if ( 0 > result ) {
-    response.len = result;
-    bolthur_rpc_return( type, &response, sizeof( response ), async_data );
-    return;
-  }
-  // update offsets and return
-  if ( 0 < response.len ) {
+  if (
+    0 < response.len
+    && 0 == handle_get( &container, context->origin, context->handle )
+  ) {
     container->pos += ( off_t )response.len;
   }
-  bolthur_rpc_return( type, &response, sizeof( response ), async_data );
+  _rpc_ret_deferred(
+    context->type,
+    &response,
+    sizeof( response ),
+    context->rpc_id
+  );
+  pool_release( context );
 }
 
 /**
@@ -107,42 +113,37 @@ void rpc_handle_write(
 ) {
   // handle async return in case response info is set
   if ( response_info ) {
+    // check for response of forwarded queue entries
+    if ( queue_handle_response( type, data_info, response_info ) ) {
+      return;
+    }
     rpc_handle_write_async( type, origin, data_info, response_info );
     return;
   }
   // normal request handling starts here
   vfs_write_response_t response = { .len = -ENOMEM };
-  vfs_write_request_ptr_t request = malloc( sizeof( vfs_write_request_t ) );
-  if ( ! request ) {
-    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    return;
-  }
-  vfs_write_request_ptr_t nested_request = malloc( sizeof( vfs_write_request_t ) );
-  if ( ! nested_request ) {
-    free( request );
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
     return;
   }
+  vfs_write_request_ptr_t request = &context->request.write;
+  vfs_write_request_ptr_t nested_request = &context->nested.write;
   handle_container_ptr_t container;
-  // clear variables
-  memset( request, 0, sizeof( vfs_write_request_t ) );
-  memset( nested_request, 0, sizeof( vfs_write_request_t ) );
   // switch error return
   response.len = -EINVAL;
   // handle no data
   if( ! data_info ) {
-    free( request );
-    free( nested_request );
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
     return;
   }
   // fetch rpc data
   _rpc_get_data( request, sizeof( vfs_write_request_t ), data_info, false );
   // handle error
-  if ( errno ) {
-    free( request );
-    free( nested_request );
+  if ( errno || sizeof( request->data ) < request->len ) {
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
     return;
   }
   // try to get handle information
@@ -151,45 +152,48 @@ void rpc_handle_write(
   if ( 0 > result ) {
     response.len = result;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
-    free( nested_request );
+    pool_release( context );
     return;
   }
   // special handling for null device
   if ( 0 == strcmp( container->path, "/dev/null" ) ) {
     response.len = ( ssize_t )request->len;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
-    free( nested_request );
+    pool_release( context );
     return;
   }
-  // get handling process
-  pid_t handling_process = container->target->pid;
   // prepare structure
   strncpy( nested_request->file_path, container->path, PATH_MAX );
   memcpy( nested_request->data, request->data, request->len );
+  // clear remaining data to not leak previous requests
+  memset(
+    nested_request->data + request->len,
+    0,
+    sizeof( nested_request->data ) - request->len
+  );
+  nested_request->handle = request->handle;
   nested_request->offset = container->pos;
   nested_request->len = request->len;
+  // keep necessary state for completion within context
+  context->handle = request->handle;
   // perform async rpc
-  bolthur_rpc_raise(
+  size_t response_id = _rpc_raise_async(
     type,
-    handling_process,
+    container->target->pid,
     nested_request,
-    sizeof( vfs_write_request_t ),
-    false,
-    false,
-    type,
-    nested_request,
-    sizeof( vfs_write_request_t ),
-    origin,
-    data_info
+    sizeof( vfs_write_request_t )
   );
   if ( errno ) {
+    response.len = -EIO;
     bolthur_rpc_return( type, &response, sizeof( response ), NULL );
-    free( request );
-    free( nested_request );
+    pool_release( context );
     return;
   }
-  free( request );
-  free( nested_request );
+  // park context until response arrives
+  pool_forward(
+    context,
+    container->target->pid,
+    response_id,
+    rpc_handle_write_abort
+  );
 }
@@ -0,0 +1,135 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "../rpc.h"
+#include "../vfs.h"
+#include "../file/handle.h"
+#include "../pool/pool.h"
+#include "../../../libsyscall.h"
+#include "../../../libvfs.h"
+
+/**
+ * @fn void rpc_handle_writev(size_t, pid_t, size_t, size_t)
+ * @brief Handle vectored write request
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ *
+ * @note Vectors are passed packed within data and forwarded as one write
+ * request to the handling process. Completion is handled by
+ * rpc_handle_write_async.
+ */
+void rpc_handle_writev(
+  size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  vfs_write_response_t response = { .len = -ENOMEM };
+  pool_context_ptr_t context = pool_acquire( type, origin, data_info );
+  if ( ! context ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    return;
+  }
+  vfs_writev_request_ptr_t request = &context->request.writev;
+  vfs_write_request_ptr_t nested_request = &context->nested.write;
+  handle_container_ptr_t container;
+  // switch error return
+  response.len = -EINVAL;
+  // handle no data
+  if( ! data_info ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( request, sizeof( vfs_writev_request_t ), data_info, false );
+  // handle error
+  if ( errno || VFS_IOV_MAX < request->count ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // sum up vector lengths
+  size_t total = 0;
+  for ( size_t idx = 0; idx < request->count; idx++ ) {
+    total += request->len[ idx ];
+  }
+  if ( sizeof( request->data ) < total ) {
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // try to get handle information
+  int result = handle_get( &container, origin, request->handle );
+  // handle error
+  if ( 0 > result ) {
+    response.len = result;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // special handling for null device and empty vectors
+  if ( 0 == strcmp( container->path, "/dev/null" ) || ! total ) {
+    response.len = ( ssize_t )total;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // prepare structure
+  strncpy( nested_request->file_path, container->path, PATH_MAX );
+  memcpy( nested_request->data, request->data, total );
+  // clear remaining data to not leak previous requests
+  memset(
+    nested_request->data + total,
+    0,
+    sizeof( nested_request->data ) - total
+  );
+  nested_request->handle = request->handle;
+  nested_request->offset = container->pos;
+  nested_request->len = total;
+  // keep necessary state for completion within context
+  context->handle = request->handle;
+  // perform async rpc
+  size_t response_id = _rpc_raise_async(
+    RPC_VFS_WRITE,
+    container->target->pid,
+    nested_request,
+    sizeof( vfs_write_request_t )
+  );
+  if ( errno ) {
+    response.len = -EIO;
+    bolthur_rpc_return( type, &response, sizeof( response ), NULL );
+    pool_release( context );
+    return;
+  }
+  // park context until response arrives
+  pool_forward(
+    context,
+    container->target->pid,
+    response_id,
+    rpc_handle_write_abort
+  );
+}
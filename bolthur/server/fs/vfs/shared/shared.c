@@ -0,0 +1,228 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/bolthur.h>
+#include "../collection/list.h"
+#include "../vfs.h"
+#include "../../../libvfs.h"
+#include "../../../libsyscall.h"
+#include "shared.h"
+
+/**
+ * @brief list of registered shared areas
+ */
+static list_manager_ptr_t shared_list = NULL;
+
+/**
+ * @brief amount of registered shared areas
+ */
+static size_t shared_count = 0;
+
+/**
+ * @fn void shared_cleanup(const list_item_ptr_t)
+ * @brief Cleanup of shared area entries, releases the area reference
+ *
+ * @param item
+ */
+static void shared_cleanup( const list_item_ptr_t item ) {
+  shared_area_ptr_t area = item->data;
+  _memory_shared_detach( area->shm_id );
+  free( area->path );
+  free( area );
+  shared_count--;
+  list_default_cleanup( item );
+}
+
+/**
+ * @fn list_item_ptr_t shared_get(vfs_node_ptr_t, const char*, uint32_t, off_t, size_t)
+ * @brief Get registered area of file, drops entries of changed files
+ *
+ * @param node
+ * @param path
+ * @param type
+ * @param offset
+ * @param size
+ * @return
+ *
+ * @note relocation caches are matched by file only
+ */
+static list_item_ptr_t shared_get(
+  vfs_node_ptr_t node,
+  const char* path,
+  uint32_t type,
+  off_t offset,
+  size_t size
+) {
+  list_item_ptr_t item = shared_list->first;
+  while ( item ) {
+    list_item_ptr_t next = item->next;
+    shared_area_ptr_t area = item->data;
+    if ( area->pid == node->pid && 0 == strcmp( area->path, path ) ) {
+      // file has been replaced, so the area is stale
+      if (
+        area->file_size != node->st->st_size
+        || area->file_mtime != node->st->st_mtime
+      ) {
+        list_remove( shared_list, item );
+      } else if (
+        area->type == type
+        && (
+          VFS_SHARED_RELOCATION == type
+          || ( area->offset == offset && area->size == size )
+        )
+      ) {
+        return item;
+      }
+    }
+    item = next;
+  }
+  return NULL;
+}
+
+/**
+ * @fn bool shared_init(void)
+ * @brief Setup shared area structures
+ *
+ * @return
+ */
+bool shared_init( void ) {
+  shared_list = list_construct( NULL, shared_cleanup );
+  return shared_list;
+}
+
+/**
+ * @fn size_t shared_lookup(vfs_node_ptr_t, const char*, uint32_t, off_t, size_t)
+ * @brief Lookup shared area of file
+ *
+ * @param node
+ * @param path
+ * @param type
+ * @param offset
+ * @param size
+ * @return area id or 0 if not registered
+ */
+size_t shared_lookup(
+  vfs_node_ptr_t node,
+  const char* path,
+  uint32_t type,
+  off_t offset,
+  size_t size
+) {
+  list_item_ptr_t item = shared_get( node, path, type, offset, size );
+  return item ? ( ( shared_area_ptr_t )item->data )->shm_id : 0;
+}
+
+/**
+ * @fn int shared_publish(vfs_node_ptr_t, const char*, uint32_t, off_t, size_t, pid_t, size_t*)
+ * @brief Register shared area of file
+ *
+ * @param node
+ * @param path
+ * @param type
+ * @param offset
+ * @param size
+ * @param publisher process the area has to be sealed by
+ * @param shm_id area to publish, overwritten with the registered area
+ * @return
+ *
+ * @note an already registered text wins, a relocation cache is replaced by
+ * its publisher or once the publisher exited
+ */
+int shared_publish(
+  vfs_node_ptr_t node,
+  const char* path,
+  uint32_t type,
+  off_t offset,
+  size_t size,
+  pid_t publisher,
+  size_t* shm_id
+) {
+  list_item_ptr_t item = shared_get( node, path, type, offset, size );
+  if ( item ) {
+    shared_area_ptr_t registered = item->data;
+    if ( VFS_SHARED_TEXT == type ) {
+      *shm_id = registered->shm_id;
+      return 0;
+    }
+    // relocation cache is only replaced by its publisher or after its exit
+    if ( registered->publisher != publisher ) {
+      _process_parent_by_id( registered->publisher );
+      if ( ! errno ) {
+        *shm_id = registered->shm_id;
+        return -EPERM;
+      }
+    }
+  }
+  if ( ! item && VFS_SHARED_AREA_MAX <= shared_count ) {
+    return -ENOSPC;
+  }
+  shared_area_ptr_t area = malloc( sizeof( *area ) );
+  if ( ! area ) {
+    return -ENOMEM;
+  }
+  memset( area, 0, sizeof( *area ) );
+  area->path = strdup( path );
+  if ( ! area->path ) {
+    free( area );
+    return -ENOMEM;
+  }
+  // keep a reference so that the area survives exit of the publisher
+  _memory_shared_attach( *shm_id, ( uintptr_t )NULL );
+  if ( errno ) {
+    free( area->path );
+    free( area );
+    return -EINVAL;
+  }
+  // only accept areas sealed by the publisher covering exactly the size
+  size_t area_size = _memory_shared_size( *shm_id );
+  pid_t owner = _memory_shared_owner( *shm_id );
+  if (
+    owner != publisher
+    || area_size < size
+    || area_size - size >= VFS_SHARED_PAGE_SIZE
+  ) {
+    _memory_shared_detach( *shm_id );
+    free( area->path );
+    free( area );
+    return -EPERM;
+  }
+  // drop replaced relocation cache
+  if ( item ) {
+    list_remove( shared_list, item );
+  }
+  area->type = type;
+  area->pid = node->pid;
+  area->publisher = publisher;
+  area->offset = offset;
+  area->size = size;
+  area->file_size = node->st->st_size;
+  area->file_mtime = node->st->st_mtime;
+  area->shm_id = *shm_id;
+  if ( ! list_push_back( shared_list, area ) ) {
+    _memory_shared_detach( area->shm_id );
+    free( area->path );
+    free( area );
+    return -ENOMEM;
+  }
+  shared_count++;
+  return 0;
+}
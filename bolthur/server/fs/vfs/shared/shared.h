@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+#include "../vfs.h"
+
+#if !defined( _SHARED_H )
+#define _SHARED_H
+
+struct shared_area {
+  uint32_t type;
+  pid_t pid;
+  pid_t publisher;
+  char* path;
+  off_t offset;
+  size_t size;
+  off_t file_size;
+  time_t file_mtime;
+  size_t shm_id;
+};
+typedef struct shared_area shared_area_t;
+typedef struct shared_area *shared_area_ptr_t;
+
+bool shared_init( void );
+size_t shared_lookup( vfs_node_ptr_t, const char*, uint32_t, off_t, size_t );
+int shared_publish( vfs_node_ptr_t, const char*, uint32_t, off_t, size_t, pid_t, size_t* );
+
+#endif
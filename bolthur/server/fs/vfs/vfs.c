@@ -19,12 +19,20 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include "collection/list.h"
 #include "vfs.h"
 #include "util.h"
+#include "../../libvfs.h"
 
 static vfs_node_ptr_t root;
 
+/**
+ * @brief Generation of the tree, bumped on every add and remove to invalidate
+ * cached link resolutions
+ */
+static size_t generation = 1;
+
 /**
  * @fn void vfs_destroy_node(vfs_node_ptr_t)
  * @brief helper to destroy a node
@@ -35,6 +43,8 @@ static void vfs_destroy_node( vfs_node_ptr_t node ) {
   if ( ! node ) {
     return;
   }
+  // invalidate cached link resolutions
+  generation++;
   if ( node->name ) {
     free( node->name );
   }
@@ -92,6 +102,8 @@ static vfs_node_ptr_t vfs_prepare_node(
   strncpy( node->name, name, name_length );
   memcpy( node->st, &st, sizeof( struct stat ) );
   node->pid = pid;
+  // nodes are ready until the handler publishes something else
+  node->events = VFS_NOTIFY_READABLE | VFS_NOTIFY_WRITABLE;
   if ( target ) {
     node->target = strdup( target );
     if ( ! node->target ) {
@@ -116,6 +128,8 @@ static vfs_node_ptr_t vfs_prepare_node(
     // set parent
     node->parent = parent;
   }
+  // invalidate cached link resolutions
+  generation++;
   // return constructed node
   return node;
 }
@@ -330,6 +344,35 @@ vfs_node_ptr_t vfs_node_by_name(
   return NULL;
 }
 
+/**
+ * @fn vfs_node_ptr_t vfs_node_by_name_length(vfs_node_ptr_t, const char*, size_t)
+ * @brief Helper to get children node by not terminated name
+ *
+ * @param node
+ * @param name
+ * @param length
+ * @return
+ */
+static vfs_node_ptr_t vfs_node_by_name_length(
+  vfs_node_ptr_t node,
+  const char* name,
+  size_t length
+) {
+  list_item_ptr_t current = node->children->first;
+  while ( current ) {
+    // get vfs node
+    vfs_node_ptr_t n = ( vfs_node_ptr_t )( current->data );
+    // check for match
+    if ( 0 == strncmp( name, n->name, length ) && '\0' == n->name[ length ] ) {
+      return n;
+    }
+    // continue with next child
+    current = current->next;
+  }
+  // return nothing found
+  return NULL;
+}
+
 /**
  * @brief Helper to get path node by name relative to global root
  *
@@ -337,71 +380,133 @@ vfs_node_ptr_t vfs_node_by_name(
  * @return found node or NULL
  */
 vfs_node_ptr_t vfs_node_by_path( const char* path ) {
-  // local pointer for path
-  char* p = ( char* )path;
-  // skip leading slash
-  if ( *p == '/' ) {
-    p++;
-  }
-
   // start with root
   vfs_node_ptr_t current = root;
-  // handle empty ( return root )
-  if ( 0 == strlen( p ) ) {
-    return current;
-  }
-
-  // setup index and length
-  size_t len = strlen( p );
-
-  // begin and end of path
-  char* begin = p;
-  char* end = p;
-
+  const char* begin = path;
   // loop until end
-  for( size_t idx = 0; idx <= len; idx++ ) {
-    // handle no separator yet
-    if( *end != '/' && *end != '\0' ) {
-      end++;
+  while ( *begin ) {
+    // skip separators
+    if ( '/' == *begin ) {
+      begin++;
       continue;
     }
-
-    // calculate size for path part
-    size_t inner = ( size_t )( end - begin + 1 );
-    // acquire space for new path
-    char* inner_path = malloc( sizeof( char ) * inner );
-    if ( ! inner_path ) {
-      return NULL;
-    }
-    // clear and copy over content
-    memset( inner_path, 0, sizeof( char ) * inner );
-    strncpy( inner_path, begin, inner - 1 );
-    inner_path[ inner - 1 ] = '\0';
-    // handle end, e.g. when trailing slash is existing it may be 0
-    if ( 0 == strlen( inner_path ) ) {
-      // free up memory again
-      free( inner_path );
-      // return current
-      return current;
+    // get end of path part
+    const char* end = begin;
+    while ( *end && '/' != *end ) {
+      end++;
     }
-    // try to get node by name
-    current = vfs_node_by_name( current, inner_path );
-    // handle no node found
-    if ( ! current ) {
-      // free up memory again
-      free( inner_path );
-      // return not found
-      return NULL;
+    size_t length = ( size_t )( end - begin );
+    // handle dot and dot dot
+    if ( 2 == length && '.' == begin[ 0 ] && '.' == begin[ 1 ] ) {
+      if ( current->parent ) {
+        current = current->parent;
+      }
+    } else if ( 1 != length || '.' != begin[ 0 ] ) {
+      // try to get node by name
+      current = vfs_node_by_name_length( current, begin, length );
+      // handle no node found
+      if ( ! current ) {
+        return NULL;
+      }
     }
-    // free up memory again
-    free( inner_path );
-    // reset begin and continue
-    begin = ++end;
+    // continue with next part
+    begin = end;
   }
   // return found node
   return current;
 }
 
+/**
+ * @fn size_t vfs_path_into(vfs_node_ptr_t, char*, size_t)
+ * @brief Method to build path from bottom up into buffer
+ *
+ * @param node
+ * @param buffer
+ * @param size
+ * @return length of built path or 0 if it doesn't fit
+ */
+size_t vfs_path_into( vfs_node_ptr_t node, char* buffer, size_t size ) {
+  vfs_node_ptr_t current;
+  size_t length = 0;
+  // handle root
+  if ( ! node->parent ) {
+    if ( 2 > size ) {
+      return 0;
+    }
+    buffer[ 0 ] = '/';
+    buffer[ 1 ] = '\0';
+    return 1;
+  }
+  // determine length
+  for ( current = node; current->parent; current = current->parent ) {
+    length += strlen( current->name ) + 1;
+  }
+  if ( length >= size ) {
+    return 0;
+  }
+  // fill buffer from the end
+  size_t offset = length;
+  buffer[ offset ] = '\0';
+  for ( current = node; current->parent; current = current->parent ) {
+    size_t name_length = strlen( current->name );
+    offset -= name_length;
+    memcpy( buffer + offset, current->name, name_length );
+    buffer[ --offset ] = '/';
+  }
+  return length;
+}
+
+/**
+ * @fn int vfs_resolve_link(vfs_node_ptr_t, vfs_node_ptr_t*, char*)
+ * @brief Resolve link node to final destination
+ *
+ * @param node link node
+ * @param result found destination
+ * @param scratch buffer with PATH_MAX size used for relative links
+ * @return 0 on success, else negative errno
+ */
+int vfs_resolve_link(
+  vfs_node_ptr_t node,
+  vfs_node_ptr_t* result,
+  char* scratch
+) {
+  vfs_node_ptr_t current = node;
+  // use cached resolution if still valid
+  if ( node->resolved && generation == node->resolved_generation ) {
+    *result = node->resolved;
+    return 0;
+  }
+  // follow links until budget is exceeded
+  for ( size_t hop = 0; current && S_ISLNK( current->st->st_mode ); hop++ ) {
+    if ( VFS_LINK_HOP_MAX <= hop ) {
+      return -ELOOP;
+    }
+    // absolute links are looked up directly
+    if ( '/' == current->target[ 0 ] ) {
+      current = vfs_node_by_path( current->target );
+      continue;
+    }
+    // build relative path within scratch buffer
+    size_t length = vfs_path_into( current->parent, scratch, PATH_MAX );
+    size_t target_length = strlen( current->target );
+    if ( ! length || PATH_MAX <= length + target_length + 1 ) {
+      return -ENAMETOOLONG;
+    }
+    scratch[ length ] = '/';
+    memcpy( scratch + length + 1, current->target, target_length + 1 );
+    current = vfs_node_by_path( scratch );
+  }
+  // handle not existing
+  if ( ! current ) {
+    return -ENOENT;
+  }
+  // cache resolution
+  node->resolved = current;
+  node->resolved_generation = generation;
+  *result = current;
+  return 0;
+}
+
 /**
  * @fn char vfs_path_bottom_up*(vfs_node_ptr_t)
  * @brief Method to build path from bottom up
@@ -419,27 +524,10 @@ char* vfs_path_bottom_up( vfs_node_ptr_t node ) {
   if ( ! path ) {
     return NULL;
   }
-  memset( path, 0, sizeof( char ) * PATH_MAX );
-  // traverse up until null and prepend
-  while ( node ) {
-    // copy only
-    if ( '\0' == path[ 0 ] ) {
-      strncpy( path, node->name, PATH_MAX - 1 );
-    } else {
-      // prepend!
-      size_t offset = 0;
-      if ( '/' != node->name[ 0 ] ) {
-        offset = 1;
-      }
-      size_t len = strlen( node->name ) + offset;
-      memmove( path + len, path, strlen( path ) + offset );
-      memcpy( path, node->name, len );
-      if ( '/' != node->name[ 0 ] ) {
-        path[ len - 1 ] = '/';
-      }
-    }
-    // continue with parent
-    node = node->parent;
+  // build path
+  if ( ! vfs_path_into( node, path, PATH_MAX ) ) {
+    free( path );
+    return NULL;
   }
   // return build path
   return path;
@@ -38,8 +38,14 @@ struct vfs_node {
   list_manager_ptr_t children;
   list_manager_ptr_t handle;
   vfs_node_ptr_t parent;
+  vfs_node_ptr_t resolved;
+  size_t resolved_generation;
+  uint32_t events;
 };
 
+// maximum amount of links followed during resolve
+#define VFS_LINK_HOP_MAX 8
+
 // functions
 vfs_node_ptr_t vfs_setup( pid_t );
 void vfs_destroy( vfs_node_ptr_t );
@@ -48,5 +54,7 @@ bool vfs_add_path( vfs_node_ptr_t, pid_t, const char*, char*, struct stat );
 vfs_node_ptr_t vfs_node_by_name( vfs_node_ptr_t, const char* );
 vfs_node_ptr_t vfs_node_by_path( const char* );
 char* vfs_path_bottom_up( vfs_node_ptr_t );
+size_t vfs_path_into( vfs_node_ptr_t, char*, size_t );
+int vfs_resolve_link( vfs_node_ptr_t, vfs_node_ptr_t*, char* );
 
 #endif
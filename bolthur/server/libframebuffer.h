@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <sys/ioctl.h>
 #include <sys/bolthur.h>
 
 #if ! defined( _LIBFRAMEBUFFER_H )
@@ -30,6 +31,13 @@
 #define FRAMEBUFFER_CLEAR FRAMEBUFFER_GET_RESOLUTION + 1
 #define FRAMEBUFFER_RENDER_SURFACE FRAMEBUFFER_CLEAR + 1
 #define FRAMEBUFFER_FLIP FRAMEBUFFER_RENDER_SURFACE+ 1
+#define FRAMEBUFFER_SURFACE_ATTACH FRAMEBUFFER_FLIP + 1
+#define FRAMEBUFFER_SURFACE_DETACH FRAMEBUFFER_SURFACE_ATTACH + 1
+#define FRAMEBUFFER_SURFACE_RENDER FRAMEBUFFER_SURFACE_DETACH + 1
+#define FRAMEBUFFER_SURFACE_RENDER_BATCH FRAMEBUFFER_SURFACE_RENDER + 1
+
+#define FRAMEBUFFER_RENDER_RECT_MAX 16
+#define FRAMEBUFFER_RENDER_FLIP 0x1
 
 struct framebuffer_render_surface {
   uint32_t scroll_y;
@@ -52,4 +60,200 @@ struct framebuffer_resolution {
 typedef struct framebuffer_resolution framebuffer_resolution_t;
 typedef struct framebuffer_resolution* framebuffer_resolution_ptr_t;
 
+/*
+ * Shared surface, created by the client and attached by the framebuffer
+ * server, so that render requests carry only a small descriptor
+ */
+struct framebuffer_surface {
+  size_t shm_id;
+  uint32_t width;
+  uint32_t height;
+  uint32_t pitch;
+  uint8_t* data;
+};
+typedef struct framebuffer_surface framebuffer_surface_t;
+typedef struct framebuffer_surface* framebuffer_surface_ptr_t;
+
+struct framebuffer_surface_attach {
+  int32_t status;
+  size_t shm_id;
+  uint32_t width;
+  uint32_t height;
+  uint32_t pitch;
+};
+typedef struct framebuffer_surface_attach framebuffer_surface_attach_t;
+typedef struct framebuffer_surface_attach* framebuffer_surface_attach_ptr_t;
+
+/*
+ * Copy rectangle at src_x / src_y of surface to x / y of screen, scroll_y is
+ * applied to the screen before
+ */
+struct framebuffer_surface_render {
+  size_t shm_id;
+  uint32_t scroll_y;
+  uint32_t src_x;
+  uint32_t src_y;
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+};
+typedef struct framebuffer_surface_render framebuffer_surface_render_t;
+typedef struct framebuffer_surface_render* framebuffer_surface_render_ptr_t;
+
+struct framebuffer_rect {
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+};
+typedef struct framebuffer_rect framebuffer_rect_t;
+typedef struct framebuffer_rect* framebuffer_rect_ptr_t;
+
+/*
+ * Copy list of rectangles from surface to the same position on screen,
+ * scroll_y is applied before and FRAMEBUFFER_RENDER_FLIP flips afterwards
+ */
+struct framebuffer_surface_render_batch {
+  size_t shm_id;
+  uint32_t scroll_y;
+  uint32_t flags;
+  uint32_t count;
+  framebuffer_rect_t rect[ FRAMEBUFFER_RENDER_RECT_MAX ];
+};
+typedef struct framebuffer_surface_render_batch framebuffer_surface_render_batch_t;
+typedef struct framebuffer_surface_render_batch* framebuffer_surface_render_batch_ptr_t;
+
+/**
+ * @fn int framebuffer_surface_create(int, framebuffer_surface_ptr_t, uint32_t, uint32_t)
+ * @brief Helper to create a shared 32 bit surface and attach it to framebuffer
+ *
+ * @param fd opened framebuffer device
+ * @param surface surface to populate
+ * @param width
+ * @param height
+ * @return 0 on success, negative errno else
+ */
+__maybe_unused static int framebuffer_surface_create(
+  int fd,
+  framebuffer_surface_ptr_t surface,
+  uint32_t width,
+  uint32_t height
+) {
+  memset( surface, 0, sizeof( *surface ) );
+  surface->width = width;
+  surface->height = height;
+  surface->pitch = width * sizeof( uint32_t );
+  // create and attach shared area
+  surface->shm_id = _memory_shared_create( surface->pitch * height );
+  if ( errno ) {
+    return -ENOMEM;
+  }
+  surface->data = _memory_shared_attach( surface->shm_id, ( uintptr_t )NULL );
+  if ( errno ) {
+    return -ENOMEM;
+  }
+  // attach at framebuffer
+  framebuffer_surface_attach_t attach = {
+    .shm_id = surface->shm_id,
+    .width = surface->width,
+    .height = surface->height,
+    .pitch = surface->pitch,
+  };
+  int result = ioctl(
+    fd,
+    IOCTL_BUILD_REQUEST(
+      FRAMEBUFFER_SURFACE_ATTACH,
+      sizeof( attach ),
+      IOCTL_RDWR
+    ),
+    &attach
+  );
+  if ( -1 == result || 0 != attach.status ) {
+    _memory_shared_detach( surface->shm_id );
+    surface->data = NULL;
+    return -1 == result ? -EIO : attach.status;
+  }
+  return 0;
+}
+
+/**
+ * @fn void framebuffer_batch_add(framebuffer_surface_render_batch_ptr_t, uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Helper to add rectangle to batch, merges into bounding rectangle when full
+ *
+ * @param batch
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ */
+__maybe_unused static void framebuffer_batch_add(
+  framebuffer_surface_render_batch_ptr_t batch,
+  uint32_t x,
+  uint32_t y,
+  uint32_t width,
+  uint32_t height
+) {
+  if ( FRAMEBUFFER_RENDER_RECT_MAX > batch->count ) {
+    framebuffer_rect_ptr_t rect = &batch->rect[ batch->count++ ];
+    rect->x = x;
+    rect->y = y;
+    rect->width = width;
+    rect->height = height;
+    return;
+  }
+  // collapse everything into one bounding rectangle
+  uint32_t x0 = x;
+  uint32_t y0 = y;
+  uint32_t x1 = x + width;
+  uint32_t y1 = y + height;
+  for ( uint32_t i = 0; i < batch->count; i++ ) {
+    framebuffer_rect_ptr_t rect = &batch->rect[ i ];
+    if ( rect->x < x0 ) {
+      x0 = rect->x;
+    }
+    if ( rect->y < y0 ) {
+      y0 = rect->y;
+    }
+    if ( rect->x + rect->width > x1 ) {
+      x1 = rect->x + rect->width;
+    }
+    if ( rect->y + rect->height > y1 ) {
+      y1 = rect->y + rect->height;
+    }
+  }
+  batch->count = 1;
+  batch->rect[ 0 ].x = x0;
+  batch->rect[ 0 ].y = y0;
+  batch->rect[ 0 ].width = x1 - x0;
+  batch->rect[ 0 ].height = y1 - y0;
+}
+
+/**
+ * @fn void framebuffer_surface_destroy(int, framebuffer_surface_ptr_t)
+ * @brief Helper to detach shared surface from framebuffer and client
+ *
+ * @param fd opened framebuffer device
+ * @param surface surface to destroy
+ */
+__maybe_unused static void framebuffer_surface_destroy(
+  int fd,
+  framebuffer_surface_ptr_t surface
+) {
+  if ( ! surface->data ) {
+    return;
+  }
+  ioctl(
+    fd,
+    IOCTL_BUILD_REQUEST(
+      FRAMEBUFFER_SURFACE_DETACH,
+      sizeof( surface->shm_id ),
+      IOCTL_WRONLY
+    ),
+    &surface->shm_id
+  );
+  _memory_shared_detach( surface->shm_id );
+  surface->data = NULL;
+}
+
 #endif
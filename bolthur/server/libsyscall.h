@@ -0,0 +1,198 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/types.h>
+#include "../kernel/syscall.h"
+
+#if ! defined( _LIBSYSCALL_H )
+#define _LIBSYSCALL_H
+
+// helper to embed syscall number as immediate
+#define _SYSCALL_STRINGIFY_HELPER( x ) #x
+#define _SYSCALL_STRINGIFY( x ) _SYSCALL_STRINGIFY_HELPER( x )
+
+// parameter and return registers
+#if defined( __aarch64__ )
+  #define _SYSCALL_REGISTER( n ) "x" #n
+#else
+  #define _SYSCALL_REGISTER( n ) "r" #n
+#endif
+
+/**
+ * @def _syscall5
+ * @brief Raise syscall with up to five parameters
+ *
+ * Value is returned within first register, error ( 0 or negative errno )
+ * within second one. errno is set on error.
+ */
+#define _syscall5( number, p0, p1, p2, p3, p4 ) \
+  ( { \
+    register size_t _r0 __asm__( _SYSCALL_REGISTER( 0 ) ) = ( size_t )( p0 ); \
+    register size_t _r1 __asm__( _SYSCALL_REGISTER( 1 ) ) = ( size_t )( p1 ); \
+    register size_t _r2 __asm__( _SYSCALL_REGISTER( 2 ) ) = ( size_t )( p2 ); \
+    register size_t _r3 __asm__( _SYSCALL_REGISTER( 3 ) ) = ( size_t )( p3 ); \
+    register size_t _r4 __asm__( _SYSCALL_REGISTER( 4 ) ) = ( size_t )( p4 ); \
+    __asm__ __volatile__( \
+      "svc #" _SYSCALL_STRINGIFY( number ) \
+      : "+r" ( _r0 ), "+r" ( _r1 ) \
+      : "r" ( _r2 ), "r" ( _r3 ), "r" ( _r4 ) \
+      : "memory" \
+    ); \
+    errno = 0 != _r1 ? -( int )_r1 : 0; \
+    _r0; \
+  } )
+
+/**
+ * @def _syscall
+ * @brief Raise syscall with up to four parameters
+ */
+#define _syscall( number, p0, p1, p2, p3 ) \
+  _syscall5( number, p0, p1, p2, p3, 0 )
+
+/**
+ * @fn size_t _memory_shared_size(size_t)
+ * @brief Get size of an attached shared area
+ *
+ * @param id
+ * @return size in bytes or 0 with errno set
+ */
+__maybe_unused static inline size_t _memory_shared_size( size_t id ) {
+  size_t size = _syscall( SYSCALL_MEMORY_SHARED_SIZE, id, 0, 0, 0 );
+  return errno ? 0 : size;
+}
+
+/**
+ * @fn pid_t _memory_shared_owner(size_t)
+ * @brief Get process that sealed an attached shared area
+ *
+ * @param id
+ * @return process id or 0 with errno set if not attached or not sealed
+ */
+__maybe_unused static inline pid_t _memory_shared_owner( size_t id ) {
+  pid_t owner = ( pid_t )_syscall( SYSCALL_MEMORY_SHARED_OWNER, id, 0, 0, 0 );
+  return errno ? 0 : owner;
+}
+
+/**
+ * @fn size_t _memory_shared_grant(uintptr_t, size_t, pid_t)
+ * @brief Create sealed area of pages within an attached area
+ *
+ * @param address
+ * @param size
+ * @param receiver process the area is passed to, released on its exit if
+ * not attached until then
+ * @return id of created area or 0 with errno set
+ */
+__maybe_unused static inline size_t _memory_shared_grant(
+  uintptr_t address,
+  size_t size,
+  pid_t receiver
+) {
+  size_t id = _syscall(
+    SYSCALL_MEMORY_SHARED_GRANT,
+    address,
+    size,
+    receiver,
+    0
+  );
+  return errno ? 0 : id;
+}
+
+/**
+ * @fn pid_t _rpc_get_data_origin(size_t)
+ * @brief Get process a rpc data block originates from, which differs from
+ * the sender for requests forwarded by vfs
+ *
+ * @param data_info
+ * @return process id or 0 with errno set
+ */
+__maybe_unused static inline pid_t _rpc_get_data_origin( size_t data_info ) {
+  pid_t origin = ( pid_t )_syscall(
+    SYSCALL_RPC_GET_DATA_ORIGIN,
+    data_info,
+    0,
+    0,
+    0
+  );
+  return errno ? 0 : origin;
+}
+
+/**
+ * @fn void _rpc_ret_deferred(size_t, void*, size_t, size_t)
+ * @brief Return a deferred rpc from within another one
+ *
+ * @param type
+ * @param data
+ * @param length
+ * @param rpc_id id of the rpc to return
+ */
+__maybe_unused static inline void _rpc_ret_deferred(
+  size_t type,
+  void* data,
+  size_t length,
+  size_t rpc_id
+) {
+  _syscall( SYSCALL_RPC_RET, type, data, length, rpc_id );
+}
+
+/**
+ * @fn size_t _rpc_raise_async(size_t, pid_t, void*, size_t)
+ * @brief Raise rpc without waiting and without library side bookkeeping,
+ * the response arrives with returned id as response info
+ *
+ * @param type
+ * @param target
+ * @param data
+ * @param length
+ * @return response id or 0 with errno set
+ */
+__maybe_unused static inline size_t _rpc_raise_async(
+  size_t type,
+  pid_t target,
+  void* data,
+  size_t length
+) {
+  size_t id = _syscall5(
+    SYSCALL_RPC_RAISE,
+    type,
+    target,
+    data,
+    length,
+    false
+  );
+  return errno ? 0 : id;
+}
+
+/**
+ * @fn bool _interrupt_acquire_number(size_t)
+ * @brief Acquire interrupt by number for current process without handler
+ *
+ * @param num
+ * @return true on success, else false with errno set
+ */
+__maybe_unused static inline bool _interrupt_acquire_number( size_t num ) {
+  _syscall( SYSCALL_INTERRUPT_ACQUIRE, num, 0, 0, 0 );
+  return ! errno;
+}
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/bolthur.h>
+
+#if ! defined( _LIBVFS_H )
+#define _LIBVFS_H
+
+#define RPC_VFS_READV RPC_CUSTOM_START
+#define RPC_VFS_WRITEV RPC_VFS_READV + 1
+#define RPC_VFS_QUEUE_SETUP RPC_VFS_WRITEV + 1
+#define RPC_VFS_QUEUE_SUBMIT RPC_VFS_QUEUE_SETUP + 1
+#define RPC_VFS_MOUNT RPC_VFS_QUEUE_SUBMIT + 1
+#define RPC_VFS_UMOUNT RPC_VFS_MOUNT + 1
+#define RPC_VFS_LOOKUP RPC_VFS_UMOUNT + 1
+#define RPC_VFS_NOTIFY_PUBLISH RPC_VFS_LOOKUP + 1
+#define RPC_VFS_NOTIFY_REGISTER RPC_VFS_NOTIFY_PUBLISH + 1
+#define RPC_VFS_NOTIFY_READY RPC_VFS_NOTIFY_REGISTER + 1
+#define RPC_VFS_SHARED_AREA RPC_VFS_NOTIFY_READY + 1
+#define RPC_VFS_MAP RPC_VFS_SHARED_AREA + 1
+
+#define VFS_IOV_MAX 16
+#define VFS_QUEUE_ENTRIES 64
+#define VFS_QUEUE_DATA_SIZE 0x4000
+
+#define VFS_NOTIFY_MAX 16
+#define VFS_NOTIFY_READABLE 0x1
+#define VFS_NOTIFY_WRITABLE 0x2
+#define VFS_NOTIFY_ERROR 0x4
+#define VFS_NOTIFY_HANGUP 0x8
+// transient, raised on directory when a child node was added
+#define VFS_NOTIFY_CHILD 0x10
+#define VFS_NOTIFY_EDGE 0x80000000
+
+#define VFS_SHARED_AREA_MAX 32
+#define VFS_SHARED_TEXT 0
+#define VFS_SHARED_RELOCATION 1
+// granularity of shared areas
+#define VFS_SHARED_PAGE_SIZE 0x1000
+
+enum vfs_queue_operation {
+  VFS_QUEUE_NOP = 0,
+  VFS_QUEUE_OPEN,
+  VFS_QUEUE_CLOSE,
+  VFS_QUEUE_READ,
+  VFS_QUEUE_WRITE,
+  VFS_QUEUE_SEEK,
+  VFS_QUEUE_STAT,
+};
+
+struct vfs_readv_request {
+  int handle;
+  size_t shm_id;
+  size_t count;
+  size_t len[ VFS_IOV_MAX ];
+};
+typedef struct vfs_readv_request vfs_readv_request_t;
+typedef struct vfs_readv_request* vfs_readv_request_ptr_t;
+
+struct vfs_writev_request {
+  int handle;
+  size_t count;
+  size_t len[ VFS_IOV_MAX ];
+  char data[ MAX_WRITE_LEN ];
+};
+typedef struct vfs_writev_request vfs_writev_request_t;
+typedef struct vfs_writev_request* vfs_writev_request_ptr_t;
+
+/*
+ * Submission entry, data is an offset into the data area of the queue and
+ * holds the path for open / stat, the payload for read / write and the
+ * resulting struct stat for stat
+ */
+struct vfs_queue_entry {
+  uint32_t operation;
+  int32_t handle;
+  int32_t flags;
+  int32_t mode;
+  off_t offset;
+  size_t len;
+  size_t data;
+  size_t user_data;
+};
+typedef struct vfs_queue_entry vfs_queue_entry_t;
+typedef struct vfs_queue_entry* vfs_queue_entry_ptr_t;
+
+struct vfs_queue_completion {
+  size_t user_data;
+  ssize_t result;
+};
+typedef struct vfs_queue_completion vfs_queue_completion_t;
+typedef struct vfs_queue_completion* vfs_queue_completion_ptr_t;
+
+/*
+ * Queue living within shared memory, client produces submit_tail and
+ * complete_head, vfs produces submit_head and complete_tail
+ */
+struct vfs_queue {
+  volatile uint32_t submit_head;
+  volatile uint32_t submit_tail;
+  volatile uint32_t complete_head;
+  volatile uint32_t complete_tail;
+  vfs_queue_entry_t submit[ VFS_QUEUE_ENTRIES ];
+  vfs_queue_completion_t complete[ VFS_QUEUE_ENTRIES ];
+  uint8_t data[ VFS_QUEUE_DATA_SIZE ];
+};
+typedef struct vfs_queue vfs_queue_t;
+typedef struct vfs_queue* vfs_queue_ptr_t;
+
+struct vfs_queue_setup_request {
+  size_t shm_id;
+};
+typedef struct vfs_queue_setup_request vfs_queue_setup_request_t;
+typedef struct vfs_queue_setup_request* vfs_queue_setup_request_ptr_t;
+
+struct vfs_queue_setup_response {
+  int status;
+};
+typedef struct vfs_queue_setup_response vfs_queue_setup_response_t;
+typedef struct vfs_queue_setup_response* vfs_queue_setup_response_ptr_t;
+
+struct vfs_queue_submit_response {
+  int status;
+};
+typedef struct vfs_queue_submit_response vfs_queue_submit_response_t;
+typedef struct vfs_queue_submit_response* vfs_queue_submit_response_ptr_t;
+
+/*
+ * Mount request, all paths below the mount point are delegated to the
+ * requesting process. Lookups are sent via RPC_VFS_LOOKUP using
+ * vfs_stat_request_t with full path and answered with vfs_stat_response_t.
+ */
+struct vfs_mount_request {
+  char path[ PATH_MAX ];
+};
+typedef struct vfs_mount_request vfs_mount_request_t;
+typedef struct vfs_mount_request* vfs_mount_request_ptr_t;
+
+struct vfs_mount_response {
+  int status;
+};
+typedef struct vfs_mount_response vfs_mount_response_t;
+typedef struct vfs_mount_response* vfs_mount_response_ptr_t;
+
+/*
+ * State published by the handling process of a path, watchers are notified
+ * via RPC_VFS_NOTIFY_READY raised by vfs
+ */
+struct vfs_notify_publish_request {
+  char path[ PATH_MAX ];
+  uint32_t events;
+};
+typedef struct vfs_notify_publish_request vfs_notify_publish_request_t;
+typedef struct vfs_notify_publish_request* vfs_notify_publish_request_ptr_t;
+
+struct vfs_notify_publish_response {
+  int status;
+};
+typedef struct vfs_notify_publish_response vfs_notify_publish_response_t;
+typedef struct vfs_notify_publish_response* vfs_notify_publish_response_ptr_t;
+
+struct vfs_notify_entry {
+  int handle;
+  uint32_t events;
+};
+typedef struct vfs_notify_entry vfs_notify_entry_t;
+typedef struct vfs_notify_entry* vfs_notify_entry_ptr_t;
+
+/*
+ * Interest set, events are a mask of VFS_NOTIFY_* with optional
+ * VFS_NOTIFY_EDGE, an empty mask removes the watch
+ */
+struct vfs_notify_register_request {
+  size_t count;
+  vfs_notify_entry_t entry[ VFS_NOTIFY_MAX ];
+};
+typedef struct vfs_notify_register_request vfs_notify_register_request_t;
+typedef struct vfs_notify_register_request* vfs_notify_register_request_ptr_t;
+
+/*
+ * Ready list returned by register and raised with RPC_VFS_NOTIFY_READY,
+ * status is negative errno on failure
+ */
+struct vfs_notify_ready {
+  int status;
+  size_t count;
+  vfs_notify_entry_t entry[ VFS_NOTIFY_MAX ];
+};
+typedef struct vfs_notify_ready vfs_notify_ready_t;
+typedef struct vfs_notify_ready* vfs_notify_ready_ptr_t;
+
+/*
+ * Shared read only area of an opened file, either text at offset with size
+ * or the relocation cache of an executable. A zero shm_id looks up the area,
+ * otherwise the area sealed by the caller is published. Text is registered
+ * by vfs from map responses of the handling process only, so publishing text
+ * is rejected. A relocation cache is only replaced by its publisher or once
+ * the publisher exited. Response contains the registered area or 0 if there
+ * is none.
+ */
+struct vfs_shared_area_request {
+  uint32_t type;
+  int handle;
+  off_t offset;
+  size_t size;
+  size_t shm_id;
+};
+typedef struct vfs_shared_area_request vfs_shared_area_request_t;
+typedef struct vfs_shared_area_request* vfs_shared_area_request_ptr_t;
+
+struct vfs_shared_area_response {
+  int status;
+  size_t shm_id;
+};
+typedef struct vfs_shared_area_response vfs_shared_area_response_t;
+typedef struct vfs_shared_area_response* vfs_shared_area_response_ptr_t;
+
+/*
+ * Read only mapping of a file range, forwarded by vfs with file path set to
+ * the handling process. Response contains a sealed area to be attached and
+ * the offset of the requested data within it, len may be shorter than
+ * requested at end of file.
+ */
+struct vfs_map_request {
+  int handle;
+  char file_path[ PATH_MAX ];
+  off_t offset;
+  size_t len;
+};
+typedef struct vfs_map_request vfs_map_request_t;
+typedef struct vfs_map_request* vfs_map_request_ptr_t;
+
+struct vfs_map_response {
+  int status;
+  size_t shm_id;
+  size_t offset;
+  size_t len;
+};
+typedef struct vfs_map_response vfs_map_response_t;
+typedef struct vfs_map_response* vfs_map_response_ptr_t;
+
+#endif
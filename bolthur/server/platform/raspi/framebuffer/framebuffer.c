@@ -28,8 +28,10 @@
 #include <sys/mman.h>
 #include <sys/bolthur.h>
 #include "framebuffer.h"
+#include "../../../libsyscall.h"
 #include "../libmailbox.h"
 #include "../../../libframebuffer.h"
+#include "../../../../library/framebuffer/framebuffer.h"
 
 uint32_t physical_width;
 uint32_t physical_height;
@@ -43,6 +45,29 @@ uint8_t* current_back;
 uint8_t* front_buffer;
 uint8_t* back_buffer;
 
+// dirty byte span per row, start >= end means clean
+uint32_t* damage_start;
+uint32_t* damage_end;
+// dirty row range, top >= bottom means clean
+uint32_t damage_top;
+uint32_t damage_bottom;
+// flip via virtual offset
+bool flip_virtual;
+// wait for vertical sync on flip, disabled if not handled by firmware
+bool flip_vsync;
+// back buffer ring start row in copy mode
+uint32_t back_offset;
+// window of back page within its page area in flip mode
+uint32_t back_window;
+// rows scrolled since last flip, applied to the other page after flip
+uint32_t scroll_pending;
+// hardware scroll via virtual offset of shown window in copy mode
+bool scroll_virtual;
+uint32_t screen_offset;
+uint32_t shown_offset;
+// attached shared surfaces
+struct framebuffer_shared_surface surface_list[ FRAMEBUFFER_SURFACE_MAX ];
+
 int mailbox_fd;
 
 struct framebuffer_rpc command_list[] = {
@@ -58,6 +83,18 @@ struct framebuffer_rpc command_list[] = {
   }, {
     .command = FRAMEBUFFER_FLIP,
     .callback = framebuffer_handle_flip
+  }, {
+    .command = FRAMEBUFFER_SURFACE_ATTACH,
+    .callback = framebuffer_handle_surface_attach
+  }, {
+    .command = FRAMEBUFFER_SURFACE_DETACH,
+    .callback = framebuffer_handle_surface_detach
+  }, {
+    .command = FRAMEBUFFER_SURFACE_RENDER,
+    .callback = framebuffer_handle_surface_render
+  }, {
+    .command = FRAMEBUFFER_SURFACE_RENDER_BATCH,
+    .callback = framebuffer_handle_surface_render_batch
   },
 };
 
@@ -142,9 +179,10 @@ bool framebuffer_init( void ) {
   request[ idx++ ] = 0x00048004;
   request[ idx++ ] = 8; // value buffer size (bytes)
   request[ idx++ ] = 8; // request + value length (bytes)
-  // FIXME: width and height multiplied by 2 for qemu framebuffer flipping
-  request[ idx++ ] = ( int32_t )physical_width; // * 2; // horizontal resolution
-  request[ idx++ ] = ( int32_t )physical_height * 2; // vertical resolution
+  // two pages of double height, so that each page scrolls by moving its
+  // shown window instead of moving its content
+  request[ idx++ ] = ( int32_t )physical_width; // horizontal resolution
+  request[ idx++ ] = ( int32_t )physical_height * 4; // vertical resolution
   // set depth
   request[ idx++ ] = 0x00048005;
   request[ idx++ ] = 4; // value buffer size (bytes)
@@ -230,10 +268,46 @@ bool framebuffer_init( void ) {
   screen = ( uint8_t* )tmp;
   // clear everything after init completely
   memset( screen, 0, total_size );
+  // allocate damage tracking
+  damage_start = malloc( sizeof( uint32_t ) * physical_height );
+  damage_end = malloc( sizeof( uint32_t ) * physical_height );
+  if ( ! damage_start || ! damage_end ) {
+    free( damage_start );
+    free( damage_end );
+    close( mailbox_fd );
+    return false;
+  }
+  framebuffer_damage_reset();
+  // virtual offset flip requires both pages within virtual area
+  flip_virtual = FRAMEBUFFER_FLIP_VIRTUAL_OFFSET
+    && virtual_height >= physical_height * 4
+    && total_size >= size * 4;
+  flip_vsync = true;
   // set front and back buffers
   front_buffer = screen;
-  back_buffer = ( uint8_t* )( screen + size );
+  back_buffer = ( uint8_t* )( screen + ( flip_virtual ? size * 2 : size ) );
   current_back = back_buffer;
+  back_offset = 0;
+  back_window = 0;
+  scroll_pending = 0;
+  screen_offset = 0;
+  shown_offset = 0;
+  scroll_virtual = false;
+  // copy mode scrolls the shown window within virtual area, so the back
+  // buffer has to move out of it
+  if (
+    ! flip_virtual
+    && virtual_height >= physical_height * 2
+    && total_size >= size * 2
+  ) {
+    uint8_t* heap_back = malloc( size );
+    if ( heap_back ) {
+      memset( heap_back, 0, size );
+      back_buffer = heap_back;
+      current_back = back_buffer;
+      scroll_virtual = true;
+    }
+  }
   // return with register of necessary rpc
   return framebuffer_register_rpc();
 }
@@ -258,33 +332,561 @@ bool framebuffer_register_rpc( void ) {
   return true;
 }
 
+/**
+ * @fn void framebuffer_damage_reset(void)
+ * @brief Mark whole screen as clean
+ */
+void framebuffer_damage_reset( void ) {
+  for ( uint32_t y = 0; y < physical_height; y++ ) {
+    damage_start[ y ] = pitch;
+    damage_end[ y ] = 0;
+  }
+  damage_top = physical_height;
+  damage_bottom = 0;
+}
+
+/**
+ * @fn void framebuffer_damage(uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Mark rectangle of back buffer as dirty
+ *
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ */
+void framebuffer_damage(
+  uint32_t x,
+  uint32_t y,
+  uint32_t width,
+  uint32_t height
+) {
+  // clip against screen
+  if ( x >= physical_width || y >= physical_height ) {
+    return;
+  }
+  if ( width > physical_width - x ) {
+    width = physical_width - x;
+  }
+  if ( height > physical_height - y ) {
+    height = physical_height - y;
+  }
+  // extend row spans
+  uint32_t start = x * BYTE_PER_PIXEL;
+  uint32_t end = ( x + width ) * BYTE_PER_PIXEL;
+  for ( uint32_t row = y; row < y + height; row++ ) {
+    if ( start < damage_start[ row ] ) {
+      damage_start[ row ] = start;
+    }
+    if ( end > damage_end[ row ] ) {
+      damage_end[ row ] = end;
+    }
+  }
+  // extend row range
+  if ( y < damage_top ) {
+    damage_top = y;
+  }
+  if ( y + height > damage_bottom ) {
+    damage_bottom = y + height;
+  }
+}
+
+/**
+ * @fn void framebuffer_damage_all(void)
+ * @brief Mark whole screen as dirty
+ */
+void framebuffer_damage_all( void ) {
+  framebuffer_damage( 0, 0, physical_width, physical_height );
+}
+
+/**
+ * @fn uint8_t* framebuffer_back_row(uint32_t)
+ * @brief Get address of back buffer row, back buffer is a ring in copy mode
+ *
+ * @param y
+ * @return
+ */
+static uint8_t* framebuffer_back_row( uint32_t y ) {
+  y += back_offset;
+  if ( y >= physical_height ) {
+    y -= physical_height;
+  }
+  return current_back + ( back_window + y ) * pitch;
+}
+
+/**
+ * @fn uint8_t* framebuffer_screen_row(uint32_t)
+ * @brief Get address of shown screen row within virtual area
+ *
+ * @param y
+ * @return
+ */
+static uint8_t* framebuffer_screen_row( uint32_t y ) {
+  return screen + ( screen_offset + y ) * pitch;
+}
+
+/**
+ * @fn void framebuffer_damage_copy(bool)
+ * @brief Copy dirty spans between back buffer and screen, rows with equal
+ * span are coalesced
+ *
+ * @param to_screen copy from back buffer to screen if true, else vice versa
+ */
+static void framebuffer_damage_copy( bool to_screen ) {
+  uint32_t row_size = physical_width * BYTE_PER_PIXEL;
+  uint32_t y = damage_top;
+  while ( y < damage_bottom ) {
+    uint32_t start = damage_start[ y ];
+    uint32_t end = damage_end[ y ];
+    // skip clean rows
+    if ( start >= end ) {
+      y++;
+      continue;
+    }
+    // collect following rows with same span
+    uint32_t rows = 1;
+    while (
+      y + rows < damage_bottom
+      && damage_start[ y + rows ] == start
+      && damage_end[ y + rows ] == end
+    ) {
+      rows++;
+    }
+    if ( 0 == start && row_size == end ) {
+      // full rows are contiguous up to the wrap of the back buffer ring
+      uint32_t remaining = rows;
+      uint32_t current = y;
+      while ( remaining ) {
+        uint32_t physical = ( back_offset + current ) % physical_height;
+        uint32_t chunk = physical_height - physical;
+        if ( chunk > remaining ) {
+          chunk = remaining;
+        }
+        uint8_t* back = framebuffer_back_row( current );
+        uint8_t* shown = framebuffer_screen_row( current );
+        memcpy(
+          to_screen ? shown : back,
+          to_screen ? back : shown,
+          chunk * pitch
+        );
+        remaining -= chunk;
+        current += chunk;
+      }
+    } else {
+      for ( uint32_t row = y; row < y + rows; row++ ) {
+        uint8_t* back = framebuffer_back_row( row ) + start;
+        uint8_t* shown = framebuffer_screen_row( row ) + start;
+        memcpy(
+          to_screen ? shown : back,
+          to_screen ? back : shown,
+          end - start
+        );
+      }
+    }
+    y += rows;
+  }
+}
+
+/**
+ * @fn bool framebuffer_set_virtual_offset(uint32_t, bool)
+ * @brief Set vertical virtual offset of shown area via mailbox
+ *
+ * @param y
+ * @param vsync wait for vertical sync within same request
+ * @return
+ */
+static bool framebuffer_set_virtual_offset( uint32_t y, bool vsync ) {
+  static int32_t request[ 12 ];
+  size_t idx = 0;
+  // populate request
+  request[ idx++ ] = 0; // buffer size
+  request[ idx++ ] = 0; // perform request
+  request[ idx++ ] = MAILBOX_TAG_SET_VIRTUAL_OFFSET;
+  request[ idx++ ] = 8; // value buffer size (bytes)
+  request[ idx++ ] = 8; // request + value length (bytes)
+  request[ idx++ ] = 0; // x
+  request[ idx++ ] = ( int32_t )y; // y
+  size_t vsync_idx = idx;
+  if ( vsync ) {
+    request[ idx++ ] = MAILBOX_TAG_SET_VSYNC;
+    request[ idx++ ] = 4; // value buffer size (bytes)
+    request[ idx++ ] = 4; // request + value length (bytes)
+    request[ idx++ ] = 0; // unused
+  }
+  request[ idx++ ] = 0; // end tag
+  size_t request_size = idx * sizeof( int32_t );
+  request[ 0 ] = ( int32_t )request_size;
+  // perform request
+  int result = ioctl(
+    mailbox_fd,
+    IOCTL_BUILD_REQUEST(
+      MAILBOX_REQUEST,
+      request_size,
+      IOCTL_RDWR
+    ),
+    request
+  );
+  // handle error or offset not applied by firmware
+  if (
+    -1 == result
+    || ! ( request[ 4 ] & ( int32_t )MAILBOX_TAG_RESPONSE )
+    || ( uint32_t )request[ 6 ] != y
+  ) {
+    return false;
+  }
+  // skip vsync for following flips if not handled
+  if (
+    vsync
+    && ! ( request[ vsync_idx + 2 ] & ( int32_t )MAILBOX_TAG_RESPONSE )
+  ) {
+    flip_vsync = false;
+  }
+  return true;
+}
+
+/**
+ * @fn bool framebuffer_flip_virtual(void)
+ * @brief Flip by moving virtual offset to current back buffer
+ *
+ * @return
+ */
+static bool framebuffer_flip_virtual( void ) {
+  uint32_t base = current_back == back_buffer ? physical_height * 2 : 0;
+  if ( ! framebuffer_set_virtual_offset( base + back_window, flip_vsync ) ) {
+    return false;
+  }
+  // swap pages and their windows
+  uint8_t* tmp = screen;
+  screen = current_back;
+  current_back = tmp;
+  uint32_t window = screen_offset;
+  screen_offset = back_window;
+  back_window = window;
+  return true;
+}
+
+/**
+ * @fn void framebuffer_page_scroll(uint32_t)
+ * @brief Scroll back page in flip mode by moving its window down
+ *
+ * @param rows
+ */
+static void framebuffer_page_scroll( uint32_t rows ) {
+  back_window += rows;
+  if ( back_window > physical_height ) {
+    // rebase still valid rows to the top of page area
+    memmove(
+      current_back,
+      current_back + back_window * pitch,
+      size - rows * pitch
+    );
+    back_window = 0;
+  }
+}
+
+/**
+ * @fn void framebuffer_damage_shift(uint32_t)
+ * @brief Move tracked damage up by amount of scrolled rows
+ *
+ * @param rows
+ */
+static void framebuffer_damage_shift( uint32_t rows ) {
+  if ( damage_bottom <= rows ) {
+    framebuffer_damage_reset();
+    return;
+  }
+  uint32_t top = damage_top > rows ? damage_top - rows : 0;
+  uint32_t bottom = damage_bottom - rows;
+  memmove(
+    damage_start + top,
+    damage_start + top + rows,
+    ( bottom - top ) * sizeof( uint32_t )
+  );
+  memmove(
+    damage_end + top,
+    damage_end + top + rows,
+    ( bottom - top ) * sizeof( uint32_t )
+  );
+  for ( uint32_t y = bottom; y < damage_bottom; y++ ) {
+    damage_start[ y ] = pitch;
+    damage_end[ y ] = 0;
+  }
+  damage_top = top;
+  damage_bottom = bottom;
+}
+
+/**
+ * @fn void framebuffer_scroll(uint32_t)
+ * @brief Scroll back buffer up by amount of pixel rows
+ *
+ * @param rows
+ */
+static void framebuffer_scroll( uint32_t rows ) {
+  if ( ! rows ) {
+    return;
+  }
+  if ( rows > physical_height ) {
+    rows = physical_height;
+  }
+  // page flipping moves the window of the back page, the other page
+  // follows after the flip
+  if ( flip_virtual ) {
+    framebuffer_damage_shift( rows );
+    framebuffer_page_scroll( rows );
+    scroll_pending += rows;
+    if ( scroll_pending > physical_height ) {
+      scroll_pending = physical_height;
+    }
+    framebuffer_fill(
+      ( uint32_t* )framebuffer_back_row( physical_height - rows ),
+      pitch,
+      physical_width,
+      rows,
+      0
+    );
+    framebuffer_damage( 0, physical_height - rows, physical_width, rows );
+    return;
+  }
+  // bring screen up to date, so that only new rows are dirty afterwards
+  if ( scroll_virtual ) {
+    framebuffer_damage_copy( true );
+    framebuffer_damage_reset();
+  }
+  // rotate back buffer ring and clear exposed rows
+  back_offset = ( back_offset + rows ) % physical_height;
+  // rows are contiguous up to the wrap of the back buffer ring
+  uint32_t exposed = physical_height - rows;
+  uint32_t physical = ( back_offset + exposed ) % physical_height;
+  uint32_t chunk = physical_height - physical;
+  if ( chunk > rows ) {
+    chunk = rows;
+  }
+  framebuffer_fill(
+    ( uint32_t* )framebuffer_back_row( exposed ),
+    pitch,
+    physical_width,
+    chunk,
+    0
+  );
+  // remaining rows after the wrap of the ring
+  if ( rows > chunk ) {
+    framebuffer_fill(
+      ( uint32_t* )framebuffer_back_row( exposed + chunk ),
+      pitch,
+      physical_width,
+      rows - chunk,
+      0
+    );
+  }
+  if ( ! scroll_virtual ) {
+    // wrap around blit of whole back buffer on next flip
+    framebuffer_damage_all();
+    return;
+  }
+  // move shown window down within virtual area
+  screen_offset += rows;
+  if ( screen_offset > physical_height ) {
+    // rebase still visible rows to the top of virtual area
+    memmove( screen, framebuffer_screen_row( 0 ), size - rows * pitch );
+    screen_offset = 0;
+  }
+  framebuffer_damage( 0, physical_height - rows, physical_width, rows );
+}
+
+/**
+ * @fn void framebuffer_blit(const uint8_t*, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Copy 32 bit pixel rectangle into back buffer
+ *
+ * @param source
+ * @param source_pitch
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ */
+static void framebuffer_blit(
+  const uint8_t* source,
+  uint32_t source_pitch,
+  uint32_t x,
+  uint32_t y,
+  uint32_t width,
+  uint32_t height
+) {
+  // clip against screen
+  if ( x >= physical_width || y >= physical_height ) {
+    return;
+  }
+  if ( width > physical_width - x ) {
+    width = physical_width - x;
+  }
+  if ( height > physical_height - y ) {
+    height = physical_height - y;
+  }
+  uint32_t row = 0;
+  while ( row < height ) {
+    // rows are contiguous up to the wrap of the back buffer ring
+    uint32_t physical = ( back_offset + y + row ) % physical_height;
+    uint32_t chunk = physical_height - physical;
+    if ( chunk > height - row ) {
+      chunk = height - row;
+    }
+    framebuffer_copy_rect(
+      ( uint32_t* )( framebuffer_back_row( y + row ) + x * BYTE_PER_PIXEL ),
+      pitch,
+      ( const uint32_t* )( source + row * source_pitch ),
+      source_pitch,
+      width,
+      chunk
+    );
+    row += chunk;
+  }
+  framebuffer_damage( x, y, width, height );
+}
+
+/**
+ * @fn struct framebuffer_shared_surface* framebuffer_surface_find(size_t)
+ * @brief Get attached surface by shared memory id
+ *
+ * @param shm_id
+ * @return
+ */
+static struct framebuffer_shared_surface* framebuffer_surface_find(
+  size_t shm_id
+) {
+  for ( size_t i = 0; i < FRAMEBUFFER_SURFACE_MAX; i++ ) {
+    if ( surface_list[ i ].data && surface_list[ i ].shm_id == shm_id ) {
+      return &surface_list[ i ];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @fn struct framebuffer_shared_surface* framebuffer_surface_get(size_t, size_t)
+ * @brief Get attached surface of process a request originates from
+ *
+ * @param shm_id
+ * @param data_info
+ * @return surface or NULL if not attached by origin of request
+ */
+static struct framebuffer_shared_surface* framebuffer_surface_get(
+  size_t shm_id,
+  size_t data_info
+) {
+  // get origin, vfs is only forwarding the request
+  pid_t origin = _rpc_get_data_origin( data_info );
+  if ( errno ) {
+    return NULL;
+  }
+  struct framebuffer_shared_surface* surface = framebuffer_surface_find(
+    shm_id
+  );
+  if ( ! surface || surface->origin != origin ) {
+    return NULL;
+  }
+  return surface;
+}
+
+/**
+ * @fn void framebuffer_surface_reap(void)
+ * @brief Detach surfaces of no longer existing processes
+ */
+static void framebuffer_surface_reap( void ) {
+  for ( size_t i = 0; i < FRAMEBUFFER_SURFACE_MAX; i++ ) {
+    if ( ! surface_list[ i ].data ) {
+      continue;
+    }
+    // lookup fails for exited processes
+    _process_parent_by_id( surface_list[ i ].origin );
+    if ( ! errno ) {
+      continue;
+    }
+    _memory_shared_detach( surface_list[ i ].shm_id );
+    memset( &surface_list[ i ], 0, sizeof( surface_list[ i ] ) );
+  }
+}
+
+/**
+ * @fn void framebuffer_blit_surface(struct framebuffer_shared_surface*, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Copy clipped rectangle of shared surface into back buffer
+ *
+ * @param surface
+ * @param src_x
+ * @param src_y
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ */
+static void framebuffer_blit_surface(
+  struct framebuffer_shared_surface* surface,
+  uint32_t src_x,
+  uint32_t src_y,
+  uint32_t x,
+  uint32_t y,
+  uint32_t width,
+  uint32_t height
+) {
+  // clip against surface
+  if ( src_x >= surface->width || src_y >= surface->height ) {
+    return;
+  }
+  if ( width > surface->width - src_x ) {
+    width = surface->width - src_x;
+  }
+  if ( height > surface->height - src_y ) {
+    height = surface->height - src_y;
+  }
+  framebuffer_blit(
+    surface->data + src_y * surface->pitch + src_x * BYTE_PER_PIXEL,
+    surface->pitch,
+    x,
+    y,
+    width,
+    height
+  );
+}
+
 /**
  * @fn void framebuffer_flip(void)
  * @brief Framebuffer flip to back buffer
  */
-void framebuffer_flip( void ) {/*
-  // default request for screen flip
-  static int32_t buffer[] = { 0, 0, 0x00048009, 0x8, 0, 0, 0 };
-  // handle switch
-  if ( screen == front_buffer ) {
-    mailbox_buffer[ 6 ] = ( int32_t )physical_height;
-    screen = back_buffer;
-    current_back = front_buffer;
-  } else {
-    mailbox_buffer[ 6 ] = 0;
-    screen = front_buffer;
-    current_back = back_buffer;
-  }
-  // perform mailbox action
-  _mailbox_action( buffer, 7 );
-  // handle no valid return
-  if ( errno ) {
+void framebuffer_flip( void ) {
+  // nothing changed
+  if ( damage_top >= damage_bottom ) {
     return;
   }
-  // copy over screen into back buffer
-  memcpy( current_back, screen, size );*/
-  // copy over back buffer into screen
-  memcpy( screen, current_back, size );
+  if ( flip_virtual ) {
+    if ( framebuffer_flip_virtual() ) {
+      // bring new back page up to date with shown one
+      framebuffer_page_scroll( scroll_pending );
+      scroll_pending = 0;
+      framebuffer_damage_copy( false );
+      framebuffer_damage_reset();
+      return;
+    }
+    // fallback to copy of whole back page if virtual offset is not supported
+    flip_virtual = false;
+    scroll_pending = 0;
+    framebuffer_damage_all();
+  }
+  // copy over damaged areas of back buffer into screen
+  framebuffer_damage_copy( true );
+  framebuffer_damage_reset();
+  // show moved window after scroll
+  if ( scroll_virtual && screen_offset != shown_offset ) {
+    if ( framebuffer_set_virtual_offset( screen_offset, false ) ) {
+      shown_offset = screen_offset;
+      return;
+    }
+    // fallback to wrap around blit into top of virtual area
+    scroll_virtual = false;
+    screen_offset = 0;
+    framebuffer_damage_all();
+    framebuffer_damage_copy( true );
+    framebuffer_damage_reset();
+    framebuffer_set_virtual_offset( 0, false );
+    shown_offset = 0;
+  }
 }
 
 /**
@@ -337,7 +939,14 @@ void framebuffer_handle_clear(
   if ( ! bolthur_rpc_validate_origin( origin, data_info ) ) {
     return;
   }
-  memset( current_back, 0, size );
+  framebuffer_fill(
+    ( uint32_t* )( current_back + back_window * pitch ),
+    pitch,
+    physical_width,
+    physical_height,
+    0
+  );
+  framebuffer_damage_all();
   framebuffer_flip();
 }
 
@@ -381,26 +990,17 @@ void framebuffer_handle_render_surface(
     return;
   }
   // handle scroll up
-  if ( info->scroll_y ) {
-    // determine offset
-    uint32_t offset = info->scroll_y * pitch;
-    // move up and reset last line
-    memmove( current_back, current_back + offset, size - offset );
-    memset( current_back + size - offset, 0, offset );
-  }
-  // render stuff
-  for ( uint32_t idx = 0; idx < info->max_y; idx += info->bpp ) {
-    uint32_t y = idx / info->max_x;
-    uint32_t x = idx % info->max_x;
-    // calculate x and y values for rendering
-    uint32_t final_x = info->x + ( x / info->bpp );
-    uint32_t final_y = info->y + y;
-    // extract color from data
-    uint32_t color = *( ( uint32_t* )&info->data[ y * info->max_x + x ] );
-    // determine render offset
-    uint32_t offset = final_y * pitch + final_x * BYTE_PER_PIXEL;
-    // push back color
-    *( ( uint32_t* )( current_back + offset ) ) = color;
+  framebuffer_scroll( info->scroll_y );
+  // render stuff row by row
+  if ( BYTE_PER_PIXEL == info->bpp && info->max_x ) {
+    framebuffer_blit(
+      info->data,
+      info->max_x,
+      info->x,
+      info->y,
+      info->max_x / info->bpp,
+      info->max_y / info->max_x
+    );
   }
   // free again
   free( info );
@@ -427,3 +1027,266 @@ void framebuffer_handle_flip(
   }
   framebuffer_flip();
 }
+
+/**
+ * @fn void framebuffer_handle_surface_attach(size_t, pid_t, size_t, size_t)
+ * @brief Handle attach of shared surface
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void framebuffer_handle_surface_attach(
+  __unused size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  // validate origin
+  if ( ! bolthur_rpc_validate_origin( origin, data_info ) ) {
+    return;
+  }
+  framebuffer_surface_attach_t attach;
+  memset( &attach, 0, sizeof( attach ) );
+  // handle no data
+  if( ! data_info ) {
+    attach.status = -EINVAL;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // surface belongs to the process the request originates from
+  pid_t surface_origin = _rpc_get_data_origin( data_info );
+  if ( errno ) {
+    attach.status = -EIO;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // fetch rpc data
+  _rpc_get_data( &attach, sizeof( attach ), data_info, false );
+  if ( errno ) {
+    attach.status = -EIO;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // only 32 bit surfaces are supported, size is checked against area below
+  size_t row_size;
+  size_t surface_size;
+  if (
+    ! attach.width
+    || ! attach.height
+    || __builtin_mul_overflow(
+      ( size_t )attach.width,
+      ( size_t )BYTE_PER_PIXEL,
+      &row_size
+    )
+    || attach.pitch < row_size
+    || __builtin_mul_overflow(
+      ( size_t )attach.pitch,
+      ( size_t )attach.height,
+      &surface_size
+    )
+  ) {
+    attach.status = -EINVAL;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // already attached
+  struct framebuffer_shared_surface* surface = framebuffer_surface_find(
+    attach.shm_id
+  );
+  if ( surface ) {
+    attach.status = surface->origin == surface_origin ? 0 : -EPERM;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // release slots of exited processes
+  framebuffer_surface_reap();
+  // get free slot
+  for ( size_t i = 0; i < FRAMEBUFFER_SURFACE_MAX && ! surface; i++ ) {
+    if ( ! surface_list[ i ].data ) {
+      surface = &surface_list[ i ];
+    }
+  }
+  if ( ! surface ) {
+    attach.status = -ENOSPC;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // attach shared area
+  uint8_t* data = _memory_shared_attach( attach.shm_id, ( uintptr_t )NULL );
+  if ( errno ) {
+    attach.status = -EIO;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  // area has to hold the whole surface
+  size_t area_size = _memory_shared_size( attach.shm_id );
+  if ( errno || surface_size > area_size ) {
+    _memory_shared_detach( attach.shm_id );
+    attach.status = -EINVAL;
+    bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+    return;
+  }
+  surface->shm_id = attach.shm_id;
+  surface->origin = surface_origin;
+  surface->data = data;
+  surface->width = attach.width;
+  surface->height = attach.height;
+  surface->pitch = attach.pitch;
+  attach.status = 0;
+  bolthur_rpc_return( RPC_VFS_IOCTL, &attach, sizeof( attach ), NULL );
+}
+
+/**
+ * @fn void framebuffer_handle_surface_detach(size_t, pid_t, size_t, size_t)
+ * @brief Handle detach of shared surface
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void framebuffer_handle_surface_detach(
+  __unused size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  // validate origin
+  if ( ! bolthur_rpc_validate_origin( origin, data_info ) ) {
+    return;
+  }
+  // handle no data
+  if( ! data_info ) {
+    return;
+  }
+  size_t shm_id;
+  // fetch rpc data, peek as origin is looked up by data
+  _rpc_get_data( &shm_id, sizeof( shm_id ), data_info, true );
+  if ( errno ) {
+    return;
+  }
+  struct framebuffer_shared_surface* surface = framebuffer_surface_get(
+    shm_id,
+    data_info
+  );
+  bolthur_rpc_remove_data( data_info );
+  if ( ! surface ) {
+    return;
+  }
+  _memory_shared_detach( surface->shm_id );
+  memset( surface, 0, sizeof( *surface ) );
+}
+
+/**
+ * @fn void framebuffer_handle_surface_render(size_t, pid_t, size_t, size_t)
+ * @brief Render rectangle of shared surface
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void framebuffer_handle_surface_render(
+  __unused size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  // validate origin
+  if ( ! bolthur_rpc_validate_origin( origin, data_info ) ) {
+    return;
+  }
+  // handle no data
+  if( ! data_info ) {
+    return;
+  }
+  framebuffer_surface_render_t render;
+  // fetch rpc data, peek as origin is looked up by data
+  _rpc_get_data( &render, sizeof( render ), data_info, true );
+  if ( errno ) {
+    return;
+  }
+  struct framebuffer_shared_surface* surface = framebuffer_surface_get(
+    render.shm_id,
+    data_info
+  );
+  bolthur_rpc_remove_data( data_info );
+  if ( ! surface ) {
+    return;
+  }
+  // handle scroll up
+  framebuffer_scroll( render.scroll_y );
+  // copy from shared pages
+  framebuffer_blit_surface(
+    surface,
+    render.src_x,
+    render.src_y,
+    render.x,
+    render.y,
+    render.width,
+    render.height
+  );
+}
+
+/**
+ * @fn void framebuffer_handle_surface_render_batch(size_t, pid_t, size_t, size_t)
+ * @brief Render list of shared surface rectangles with optional flip
+ *
+ * @param type
+ * @param origin
+ * @param data_info
+ * @param response_info
+ */
+void framebuffer_handle_surface_render_batch(
+  __unused size_t type,
+  pid_t origin,
+  size_t data_info,
+  __unused size_t response_info
+) {
+  // validate origin
+  if ( ! bolthur_rpc_validate_origin( origin, data_info ) ) {
+    return;
+  }
+  // handle no data
+  if( ! data_info ) {
+    return;
+  }
+  framebuffer_surface_render_batch_t batch;
+  // fetch rpc data, peek as origin is looked up by data
+  _rpc_get_data( &batch, sizeof( batch ), data_info, true );
+  if ( errno ) {
+    return;
+  }
+  struct framebuffer_shared_surface* surface = framebuffer_surface_get(
+    batch.shm_id,
+    data_info
+  );
+  bolthur_rpc_remove_data( data_info );
+  if ( ! surface ) {
+    return;
+  }
+  if ( batch.count > FRAMEBUFFER_RENDER_RECT_MAX ) {
+    batch.count = FRAMEBUFFER_RENDER_RECT_MAX;
+  }
+  // handle scroll up
+  framebuffer_scroll( batch.scroll_y );
+  // copy rectangles from shared pages
+  for ( uint32_t i = 0; i < batch.count; i++ ) {
+    framebuffer_rect_ptr_t rect = &batch.rect[ i ];
+    framebuffer_blit_surface(
+      surface,
+      rect->x,
+      rect->y,
+      rect->x,
+      rect->y,
+      rect->width,
+      rect->height
+    );
+  }
+  // implicit flip
+  if ( batch.flags & FRAMEBUFFER_RENDER_FLIP ) {
+    framebuffer_flip();
+  }
+}
@@ -26,21 +26,42 @@
 #define FRAMEBUFFER_SCREEN_HEIGHT 480
 #define FRAMEBUFFER_SCREEN_DEPTH 32
 #define BYTE_PER_PIXEL ( FRAMEBUFFER_SCREEN_DEPTH / CHAR_BIT )
+// flip via mailbox virtual offset instead of copying damaged back buffer areas,
+// falls back to copy mode if the virtual area is too small or not supported
+#define FRAMEBUFFER_FLIP_VIRTUAL_OFFSET 1
+// maximum amount of attached shared surfaces
+#define FRAMEBUFFER_SURFACE_MAX 8
 
 struct framebuffer_rpc {
   uint32_t command;
   rpc_handler_t callback;
 };
 
+struct framebuffer_shared_surface {
+  size_t shm_id;
+  pid_t origin;
+  uint8_t* data;
+  uint32_t width;
+  uint32_t height;
+  uint32_t pitch;
+};
+
 bool framebuffer_init( void );
 bool framebuffer_register_rpc( void );
 void framebuffer_flip( void );
+void framebuffer_damage( uint32_t, uint32_t, uint32_t, uint32_t );
+void framebuffer_damage_all( void );
+void framebuffer_damage_reset( void );
 
 void framebuffer_handle_resolution( size_t, pid_t, size_t, size_t );
 void framebuffer_handle_clear( size_t, pid_t, size_t, size_t );
 void framebuffer_handle_render_surface( size_t, pid_t, size_t, size_t );
 void framebuffer_handle_flip( size_t, pid_t, size_t, size_t );
+void framebuffer_handle_surface_attach( size_t, pid_t, size_t, size_t );
+void framebuffer_handle_surface_detach( size_t, pid_t, size_t, size_t );
+void framebuffer_handle_surface_render( size_t, pid_t, size_t, size_t );
+void framebuffer_handle_surface_render_batch( size_t, pid_t, size_t, size_t );
 
-extern struct framebuffer_rpc command_list[ 4 ];
+extern struct framebuffer_rpc command_list[ 8 ];
 
 #endif
@@ -44,7 +44,7 @@ int main( __unused int argc, __unused char* argv[] ) {
 
   EARLY_STARTUP_PRINT( "Sending device to vfs\r\n" )
   // allocate memory for add request
-  size_t msg_size = sizeof( vfs_add_request_t ) + 4 * sizeof( size_t );
+  size_t msg_size = sizeof( vfs_add_request_t ) + 8 * sizeof( size_t );
   vfs_add_request_ptr_t msg = malloc( msg_size );
   if ( ! msg ) {
     return -1;
@@ -58,6 +58,10 @@ int main( __unused int argc, __unused char* argv[] ) {
   msg->device_info[ 1 ] = FRAMEBUFFER_CLEAR;
   msg->device_info[ 2 ] = FRAMEBUFFER_RENDER_SURFACE;
   msg->device_info[ 3 ] = FRAMEBUFFER_FLIP;
+  msg->device_info[ 4 ] = FRAMEBUFFER_SURFACE_ATTACH;
+  msg->device_info[ 5 ] = FRAMEBUFFER_SURFACE_DETACH;
+  msg->device_info[ 6 ] = FRAMEBUFFER_SURFACE_RENDER;
+  msg->device_info[ 7 ] = FRAMEBUFFER_SURFACE_RENDER_BATCH;
   // perform add request
   send_vfs_add_request( msg, msg_size, 0 );
   // free again
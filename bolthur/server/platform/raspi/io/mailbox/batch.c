@@ -0,0 +1,221 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/bolthur.h>
+#include "batch.h"
+#include "generic.h"
+#include "mailbox.h"
+#include "property.h"
+#include "../../../../libsyscall.h"
+
+/**
+ * @brief flag set when mailbox interrupt is used for completion
+ */
+bool batch_enabled = false;
+
+// queued and submitted requests in arrival order
+static batch_request_ptr_t batch_pending = NULL;
+static batch_request_ptr_t batch_pending_last = NULL;
+static batch_request_ptr_t batch_submitted = NULL;
+
+/**
+ * @fn void batch_return(batch_request_ptr_t, void*, size_t)
+ * @brief Return deferred request from within another rpc
+ *
+ * @param request
+ * @param data
+ * @param size
+ */
+static void batch_return(
+  batch_request_ptr_t request,
+  void* data,
+  size_t size
+) {
+  _rpc_ret_deferred( request->type, data, size, request->data_info );
+}
+
+/**
+ * @fn void batch_finish(batch_request_ptr_t, int)
+ * @brief Return result or error of a request and free it
+ *
+ * @param request
+ * @param err
+ */
+static void batch_finish( batch_request_ptr_t request, int err ) {
+  if ( err ) {
+    batch_return( request, &err, sizeof( err ) );
+  } else {
+    batch_return( request, request->data, request->size );
+  }
+  free( request->data );
+  free( request );
+}
+
+/**
+ * @fn size_t batch_tag_words(int32_t*, size_t)
+ * @brief Get amount of words used by tags of a request
+ *
+ * @param data
+ * @param size
+ * @return amount of words or 0 if request is malformed
+ */
+static size_t batch_tag_words( int32_t* data, size_t size ) {
+  size_t count = size / sizeof( int32_t );
+  size_t idx = BATCH_HEADER_WORDS;
+  while ( idx < count && 0 != data[ idx ] ) {
+    // tag id, value buffer size, code and value buffer
+    if ( idx + 3 > count ) {
+      return 0;
+    }
+    idx += 3 + ( ( size_t )data[ idx + 1 ] + 3 ) / 4;
+  }
+  // end tag is necessary
+  if ( idx >= count ) {
+    return 0;
+  }
+  return idx - BATCH_HEADER_WORDS;
+}
+
+/**
+ * @fn void batch_submit(void)
+ * @brief Submit as many queued requests as fit into property buffer
+ */
+static void batch_submit( void ) {
+  batch_request_ptr_t* last = &batch_submitted;
+  size_t used = 0;
+  // nothing to do if a buffer is in flight or nothing is queued
+  if ( batch_submitted || ! batch_pending ) {
+    return;
+  }
+  property_init();
+  while (
+    batch_pending
+    && used + batch_pending->tag_words <= BATCH_FREE_WORDS
+  ) {
+    batch_request_ptr_t request = batch_pending;
+    batch_pending = request->next;
+    // append tags of request
+    request->position = ( size_t )property_index;
+    memcpy(
+      &property_buffer[ property_index ],
+      &request->data[ BATCH_HEADER_WORDS ],
+      request->tag_words * sizeof( int32_t )
+    );
+    property_index += ( int32_t )request->tag_words;
+    used += request->tag_words;
+    // move to submitted list
+    request->next = NULL;
+    *last = request;
+    last = &request->next;
+  }
+  if ( ! batch_pending ) {
+    batch_pending_last = NULL;
+  }
+  // end tag
+  property_buffer[ property_index ] = 0;
+  // pass to firmware, completion is signaled by interrupt
+  if ( ! property_submit() ) {
+    while ( batch_submitted ) {
+      batch_request_ptr_t request = batch_submitted;
+      batch_submitted = request->next;
+      batch_finish( request, -EIO );
+    }
+  }
+}
+
+/**
+ * @fn bool batch_setup(void)
+ * @brief Setup interrupt driven batching of property requests
+ *
+ * @return false if requests have to be processed synchronously
+ */
+bool batch_setup( void ) {
+  batch_enabled = mailbox_interrupt_acquire();
+  return batch_enabled;
+}
+
+/**
+ * @fn int batch_enqueue(size_t, size_t, int32_t*, size_t)
+ * @brief Queue request for next property buffer submission
+ *
+ * @param type return type
+ * @param data_info rpc data kept for deferred return
+ * @param data request data, freed when finished
+ * @param size
+ * @return 0 on success, negative errno if request is invalid
+ */
+int batch_enqueue( size_t type, size_t data_info, int32_t* data, size_t size ) {
+  size_t tag_words = batch_tag_words( data, size );
+  if ( 0 == tag_words || BATCH_FREE_WORDS < tag_words ) {
+    return -EINVAL;
+  }
+  batch_request_ptr_t request = malloc( sizeof( batch_request_t ) );
+  if ( ! request ) {
+    return -ENOMEM;
+  }
+  memset( request, 0, sizeof( batch_request_t ) );
+  request->type = type;
+  request->data_info = data_info;
+  request->data = data;
+  request->size = size;
+  request->tag_words = tag_words;
+  // append to pending list
+  if ( batch_pending_last ) {
+    batch_pending_last->next = request;
+  } else {
+    batch_pending = request;
+  }
+  batch_pending_last = request;
+  // submit directly if nothing is in flight
+  batch_submit();
+  return 0;
+}
+
+/**
+ * @fn void batch_complete(void)
+ * @brief Handle mailbox interrupt, return submitted requests and submit
+ * queued ones
+ */
+void batch_complete( void ) {
+  uint32_t value;
+  // handle spurious interrupt
+  if ( ! mailbox_poll( MAILBOX0_TAGS_ARM_TO_VC, &value ) ) {
+    mailbox_interrupt_acquire();
+    return;
+  }
+  int32_t code = property_buffer[ PT_OREQUEST_OR_RESPONSE ];
+  while ( batch_submitted ) {
+    batch_request_ptr_t request = batch_submitted;
+    batch_submitted = request->next;
+    // copy back response code and tags
+    request->data[ PT_OREQUEST_OR_RESPONSE ] = code;
+    memcpy(
+      &request->data[ BATCH_HEADER_WORDS ],
+      &property_buffer[ request->position ],
+      request->tag_words * sizeof( int32_t )
+    );
+    batch_finish( request, 0 );
+  }
+  // submit queued requests and enable interrupt again
+  batch_submit();
+  mailbox_interrupt_acquire();
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+#include "generic.h"
+
+#if ! defined( _BATCH_H )
+#define _BATCH_H
+
+// property tag buffer header words and end tag
+#define BATCH_HEADER_WORDS 2
+#define BATCH_FREE_WORDS ( PAGE_SIZE / sizeof( int32_t ) - BATCH_HEADER_WORDS - 1 )
+
+typedef struct batch_request batch_request_t;
+typedef struct batch_request* batch_request_ptr_t;
+
+struct batch_request {
+  batch_request_ptr_t next;
+  size_t type;
+  size_t data_info;
+  int32_t* data;
+  size_t size;
+  // tag words within request and position within submitted buffer
+  size_t tag_words;
+  size_t position;
+};
+
+extern bool batch_enabled;
+
+bool batch_setup( void );
+int batch_enqueue( size_t, size_t, int32_t*, size_t );
+void batch_complete( void );
+
+#endif
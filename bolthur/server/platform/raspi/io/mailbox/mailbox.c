@@ -23,6 +23,7 @@
 #include "mailbox.h"
 #include "peripheral.h"
 #include "generic.h"
+#include "../../../../libsyscall.h"
 
 static volatile mailbox_t* mailbox = NULL;
 
@@ -50,6 +51,42 @@ bool mailbox_setup( void ) {
   return true;
 }
 
+/**
+ * @fn bool mailbox_interrupt_acquire(void)
+ * @brief Acquire mailbox interrupt, has to be called again after each raise
+ * as kernel keeps the level triggered interrupt disabled until then
+ *
+ * @return
+ */
+bool mailbox_interrupt_acquire( void ) {
+  if ( ! _interrupt_acquire_number( MAILBOX_INTERRUPT ) ) {
+    return false;
+  }
+  // raise interrupt when data is available
+  mailbox->configuration |= MAILBOX_CONFIG_IRQ_DATA;
+  return true;
+}
+
+/**
+ * @fn bool mailbox_poll(mailbox0_channel_t, uint32_t*)
+ * @brief Read mailbox without waiting
+ *
+ * @param channel channel to read
+ * @param value value without channel information
+ * @return true if a value of channel was read
+ */
+bool mailbox_poll( mailbox0_channel_t channel, uint32_t* value ) {
+  while ( ! ( mailbox->status & MAILBOX_EMPTY ) ) {
+    uint32_t data = mailbox->read;
+    // skip values of other channels
+    if ( ( data & 0xF ) == channel ) {
+      *value = data >> 4;
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * @brief Function for reading mailbox
  *
@@ -81,13 +118,20 @@ uint32_t mailbox_read( mailbox0_channel_t channel ) {
  *
  * @param channel Function to use via mailbox
  * @param data Data to write depending on function
+ * @return false if mailbox stays full
  */
-void mailbox_write( mailbox0_channel_t channel, uint32_t data ) {
+bool mailbox_write( mailbox0_channel_t channel, uint32_t data ) {
+  uint32_t count = 0;
   // add channel number at the lower 4 bit
   data = ( uint32_t )( ( int32_t )data & ~0xF );
   data |= channel;
-  // wait for mailbox to be ready
-  while ( ( mailbox->status & MAILBOX_FULL ) != 0 ) {}
+  // wait for mailbox to be ready, only one property buffer is in flight
+  while ( ( mailbox->status & MAILBOX_FULL ) != 0 ) {
+    if ( count++ > ( 1 << 25 ) ) {
+      return false;
+    }
+  }
   // write data to mailbox
   mailbox->write = data;
+  return true;
 }
@@ -30,6 +30,10 @@
 #define MAILBOX_EMPTY 0x40000000
 #define MAILBOX_ERROR 0xFFFFFFFF
 
+// basic arm interrupt raised while mailbox 0 contains data
+#define MAILBOX_INTERRUPT 65
+#define MAILBOX_CONFIG_IRQ_DATA 0x1
+
 typedef enum {
   MAILBOX0_POWER_MANAGEMENT = 0,
   MAILBOX0_FRAMEBUFFER,
@@ -54,7 +58,9 @@ typedef struct {
 } mailbox_t;
 
 bool mailbox_setup( void );
+bool mailbox_interrupt_acquire( void );
+bool mailbox_poll( mailbox0_channel_t, uint32_t* );
 uint32_t mailbox_read( mailbox0_channel_t );
-void mailbox_write( mailbox0_channel_t, uint32_t );
+bool mailbox_write( mailbox0_channel_t, uint32_t );
 
 #endif
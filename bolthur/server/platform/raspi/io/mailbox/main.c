@@ -25,6 +25,7 @@
 #include <sys/mman.h>
 #include <sys/bolthur.h>
 #include <inttypes.h>
+#include "batch.h"
 #include "property.h"
 #include "mailbox.h"
 #include "rpc.h"
@@ -58,6 +59,11 @@ int main( __unused int argc, __unused char* argv[] ) {
     EARLY_STARTUP_PRINT( "Error while binding rpc: %s\r\n", strerror( errno ) )
     return -1;
   }
+  EARLY_STARTUP_PRINT( "Setup interrupt driven batching\r\n" )
+  // fallback to synchronous processing
+  if ( ! batch_setup() ) {
+    EARLY_STARTUP_PRINT( "Mailbox interrupt not available, polling\r\n" )
+  }
 
   EARLY_STARTUP_PRINT( "Sending device to vfs\r\n" )
   // calculate add message size
@@ -196,6 +196,7 @@ void property_add_tag( raspi_mailbox_tag_t tag, ... ) {
     case TAG_GET_PIXEL_ORDER:
     case TAG_SET_PIXEL_ORDER:
     case TAG_GET_PITCH:
+    case TAG_SET_VSYNC:
       property_buffer[ property_index++ ] = 4;
       // request
       property_buffer[ property_index++ ] = 0;
@@ -275,24 +276,35 @@ void property_add_tag( raspi_mailbox_tag_t tag, ... ) {
 }
 
 /**
- * @fn uint32_t property_process(void)
- * @brief Execute mailbox property process
+ * @fn bool property_submit(void)
+ * @brief Pass property buffer to firmware without waiting for completion
  *
- * @return_t mailbox read result after write
+ * @return
  */
-uint32_t property_process( void ) {
-  uint32_t result;
+bool property_submit( void ) {
   // set correct size
   property_buffer[ PT_OSIZE ] = ( property_index + 1 ) << 2;
   property_buffer[ PT_OREQUEST_OR_RESPONSE ] = 0;
   // write to mailbox
-  mailbox_write(
+  return mailbox_write(
     MAILBOX0_TAGS_ARM_TO_VC,
     ( uint32_t )property_buffer_phys
   );
+}
+
+/**
+ * @fn uint32_t property_process(void)
+ * @brief Execute mailbox property process
+ *
+ * @return_t mailbox read result after write
+ */
+uint32_t property_process( void ) {
+  // write to mailbox
+  if ( ! property_submit() ) {
+    return MAILBOX_ERROR;
+  }
   // read and return result
-  result = mailbox_read( MAILBOX0_TAGS_ARM_TO_VC );
-  return result;
+  return mailbox_read( MAILBOX0_TAGS_ARM_TO_VC );
 }
 
 /**
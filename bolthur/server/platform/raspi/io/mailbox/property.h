@@ -101,6 +101,7 @@ typedef enum {
   TAG_GET_PALETTE = 0x4000B,
   TAG_TEST_PALETTE = 0x4400B,
   TAG_SET_PALETTE = 0x4800B,
+  TAG_SET_VSYNC = 0x4800E,
   TAG_SET_CURSOR_INFO = 0x8011,
   TAG_SET_CURSOR_STATE = 0x8010
 } raspi_mailbox_tag_t;
@@ -176,6 +177,7 @@ extern volatile int32_t* property_buffer_phys;
 bool property_setup( void );
 void property_init( void );
 void property_add_tag( raspi_mailbox_tag_t, ... );
+bool property_submit( void );
 uint32_t property_process( void );
 raspi_property_t* property_get( raspi_mailbox_tag_t );
 
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/bolthur.h>
+#include "mailbox.h"
 #include "rpc.h"
 #include "../../libmailbox.h"
 
@@ -30,6 +31,10 @@ struct mailbox_rpc command_list[] = {
     .command = MAILBOX_REQUEST,
     .callback = rpc_handle_request
   },
+  {
+    .command = MAILBOX_INTERRUPT,
+    .callback = rpc_handle_interrupt
+  },
 };
 
 /**
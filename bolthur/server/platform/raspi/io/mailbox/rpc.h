@@ -28,9 +28,10 @@ struct mailbox_rpc {
   uint32_t command;
   rpc_handler_t callback;
 };
-extern struct mailbox_rpc command_list[ 1 ];
+extern struct mailbox_rpc command_list[ 2 ];
 
 bool rpc_register( void );
+void rpc_handle_interrupt( size_t, pid_t, size_t, size_t );
 void rpc_handle_request( size_t, pid_t, size_t, size_t );
 
 #endif
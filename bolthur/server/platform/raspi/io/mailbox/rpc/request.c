@@ -22,8 +22,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/bolthur.h>
+#include "../batch.h"
 #include "../mailbox.h"
 #include "../property.h"
+#include "../generic.h"
 #include "../rpc.h"
 #include "../../../libmailbox.h"
 
@@ -61,6 +63,11 @@ void rpc_handle_request(
     bolthur_rpc_return( RPC_VFS_IOCTL, &err, sizeof( err ), NULL );
     return;
   }
+  // request has to fit into property buffer
+  if ( PAGE_SIZE < data_size ) {
+    bolthur_rpc_return( RPC_VFS_IOCTL, &err, sizeof( err ), NULL );
+    return;
+  }
   // allocate space for request
   int32_t* request = malloc( data_size );
   if ( ! request ) {
@@ -71,8 +78,8 @@ void rpc_handle_request(
   int32_t count = ( int32_t )( data_size / sizeof( int32_t ) );
   // clear request
   memset( request, 0, data_size );
-  // fetch rpc data
-  _rpc_get_data( request, data_size, data_info, false );
+  // fetch rpc data, kept with batching for deferred return
+  _rpc_get_data( request, data_size, data_info, batch_enabled );
   // handle error
   if ( errno ) {
     err = -EIO;
@@ -80,6 +87,16 @@ void rpc_handle_request(
     free( request );
     return;
   }
+  // queue request, answered when property buffer was processed
+  if ( batch_enabled ) {
+    err = batch_enqueue( RPC_VFS_IOCTL, data_info, request, data_size );
+    if ( err ) {
+      bolthur_rpc_return( RPC_VFS_IOCTL, &err, sizeof( err ), NULL );
+      bolthur_rpc_remove_data( data_info );
+      free( request );
+    }
+    return;
+  }
   // copy stuff to property buffer
   memcpy( property_buffer, request, data_size );
   // overwrite current property index
@@ -90,6 +107,7 @@ void rpc_handle_request(
   if ( MAILBOX_ERROR == result ) {
     err = -EIO;
     bolthur_rpc_return( RPC_VFS_IOCTL, &err, sizeof( err ), NULL );
+    free( request );
     return;
   }
   // copy response into original request
@@ -28,4 +28,10 @@
 
 #define MAILBOX_REQUEST RPC_CUSTOM_START
 
+// property tags used by other servers
+#define MAILBOX_TAG_SET_VIRTUAL_OFFSET 0x00048009
+#define MAILBOX_TAG_SET_VSYNC 0x0004800E
+// set within request / response code of a tag processed by firmware
+#define MAILBOX_TAG_RESPONSE 0x80000000
+
 #endif
@@ -0,0 +1,212 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "glyph.h"
+#include "psf.h"
+
+/**
+ * @brief hash buckets of cached tiles
+ */
+static glyph_tile_ptr_t glyph_bucket[ GLYPH_CACHE_BUCKETS ];
+
+/**
+ * @brief lru list, head is most recently used
+ */
+static glyph_tile_ptr_t glyph_lru_head = NULL;
+static glyph_tile_ptr_t glyph_lru_tail = NULL;
+
+/**
+ * @brief tile information
+ */
+static uint32_t glyph_width;
+static uint32_t glyph_height;
+static size_t glyph_tile_size;
+static size_t glyph_count;
+static size_t glyph_count_max;
+
+/**
+ * @fn uint32_t glyph_hash(uint32_t, uint32_t, uint32_t)
+ * @brief Hash of codepoint and colors
+ *
+ * @param c
+ * @param fg
+ * @param bg
+ * @return
+ */
+static uint32_t glyph_hash( uint32_t c, uint32_t fg, uint32_t bg ) {
+  uint32_t hash = c * 0x9e3779b1;
+  hash ^= fg + 0x7f4a7c15 + ( hash << 6 ) + ( hash >> 2 );
+  hash ^= bg + 0x7f4a7c15 + ( hash << 6 ) + ( hash >> 2 );
+  return hash & ( GLYPH_CACHE_BUCKETS - 1 );
+}
+
+/**
+ * @fn void glyph_lru_unlink(glyph_tile_ptr_t)
+ * @brief Remove tile from lru list
+ *
+ * @param tile
+ */
+static void glyph_lru_unlink( glyph_tile_ptr_t tile ) {
+  if ( tile->lru_previous ) {
+    tile->lru_previous->lru_next = tile->lru_next;
+  } else {
+    glyph_lru_head = tile->lru_next;
+  }
+  if ( tile->lru_next ) {
+    tile->lru_next->lru_previous = tile->lru_previous;
+  } else {
+    glyph_lru_tail = tile->lru_previous;
+  }
+  tile->lru_previous = NULL;
+  tile->lru_next = NULL;
+}
+
+/**
+ * @fn void glyph_lru_push(glyph_tile_ptr_t)
+ * @brief Push tile as most recently used
+ *
+ * @param tile
+ */
+static void glyph_lru_push( glyph_tile_ptr_t tile ) {
+  tile->lru_previous = NULL;
+  tile->lru_next = glyph_lru_head;
+  if ( glyph_lru_head ) {
+    glyph_lru_head->lru_previous = tile;
+  }
+  glyph_lru_head = tile;
+  if ( ! glyph_lru_tail ) {
+    glyph_lru_tail = tile;
+  }
+}
+
+/**
+ * @fn void glyph_hash_unlink(glyph_tile_ptr_t)
+ * @brief Remove tile from hash bucket
+ *
+ * @param tile
+ */
+static void glyph_hash_unlink( glyph_tile_ptr_t tile ) {
+  glyph_tile_ptr_t* link = &glyph_bucket[
+    glyph_hash( tile->c, tile->fg, tile->bg ) ];
+  while ( *link && *link != tile ) {
+    link = &( *link )->hash_next;
+  }
+  if ( *link ) {
+    *link = tile->hash_next;
+  }
+  tile->hash_next = NULL;
+}
+
+/**
+ * @fn void glyph_expand(glyph_tile_ptr_t)
+ * @brief Expand psf bitmap of tile character into 32 bit pixels
+ *
+ * @param tile
+ */
+static void glyph_expand( glyph_tile_ptr_t tile ) {
+  uint8_t* glyph = psf_char_to_glyph( tile->c );
+  uint32_t* pixel = tile->pixel;
+  // missing glyphs are rendered as background
+  if ( ! glyph ) {
+    for ( size_t idx = 0; idx < glyph_width * glyph_height; idx++ ) {
+      pixel[ idx ] = tile->bg;
+    }
+    return;
+  }
+  uint32_t bytesperline = ( glyph_width + 7 ) / 8;
+  for ( uint32_t y = 0; y < glyph_height; y++ ) {
+    for ( uint32_t x = 0; x < glyph_width; x++ ) {
+      *pixel++ = ( glyph[ x / 8 ] & ( 0x80 >> ( x & 7 ) ) )
+        ? tile->fg : tile->bg;
+    }
+    glyph += bytesperline;
+  }
+}
+
+/**
+ * @fn bool glyph_init(void)
+ * @brief Setup glyph cache, psf has to be initialized before
+ *
+ * @return
+ */
+bool glyph_init( void ) {
+  glyph_width = psf_glyph_width();
+  glyph_height = psf_glyph_height();
+  glyph_tile_size = sizeof( glyph_tile_t )
+    + sizeof( uint32_t ) * glyph_width * glyph_height;
+  glyph_count = 0;
+  glyph_count_max = GLYPH_CACHE_BUDGET / glyph_tile_size;
+  // at least one tile is necessary
+  if ( ! glyph_count_max ) {
+    glyph_count_max = 1;
+  }
+  memset( glyph_bucket, 0, sizeof( glyph_bucket ) );
+  glyph_lru_head = NULL;
+  glyph_lru_tail = NULL;
+  return glyph_width && glyph_height;
+}
+
+/**
+ * @fn const uint32_t* glyph_get(uint32_t, uint32_t, uint32_t)
+ * @brief Get expanded tile of character with colors
+ *
+ * @param c
+ * @param fg
+ * @param bg
+ * @return glyph width * glyph height pixels or NULL
+ */
+const uint32_t* glyph_get( uint32_t c, uint32_t fg, uint32_t bg ) {
+  glyph_tile_ptr_t* bucket = &glyph_bucket[ glyph_hash( c, fg, bg ) ];
+  // lookup cached tile
+  for ( glyph_tile_ptr_t tile = *bucket; tile; tile = tile->hash_next ) {
+    if ( tile->c == c && tile->fg == fg && tile->bg == bg ) {
+      // mark as most recently used
+      if ( tile != glyph_lru_head ) {
+        glyph_lru_unlink( tile );
+        glyph_lru_push( tile );
+      }
+      return tile->pixel;
+    }
+  }
+  glyph_tile_ptr_t tile;
+  // reuse least recently used tile when budget is exhausted
+  if ( glyph_count >= glyph_count_max ) {
+    tile = glyph_lru_tail;
+    glyph_lru_unlink( tile );
+    glyph_hash_unlink( tile );
+  } else {
+    tile = malloc( glyph_tile_size );
+    if ( ! tile ) {
+      return NULL;
+    }
+    glyph_count++;
+  }
+  // populate and expand tile
+  tile->c = c;
+  tile->fg = fg;
+  tile->bg = bg;
+  glyph_expand( tile );
+  // insert into bucket and lru
+  tile->hash_next = *bucket;
+  *bucket = tile;
+  glyph_lru_push( tile );
+  return tile->pixel;
+}
@@ -0,0 +1,47 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if ! defined( _GLYPH_H )
+#define _GLYPH_H
+
+// memory budget of expanded glyph tiles
+#define GLYPH_CACHE_BUDGET 0x40000
+// hash buckets, has to be a power of two
+#define GLYPH_CACHE_BUCKETS 256
+
+typedef struct glyph_tile glyph_tile_t;
+typedef struct glyph_tile* glyph_tile_ptr_t;
+
+struct glyph_tile {
+  glyph_tile_ptr_t hash_next;
+  glyph_tile_ptr_t lru_previous;
+  glyph_tile_ptr_t lru_next;
+  uint32_t c;
+  uint32_t fg;
+  uint32_t bg;
+  uint32_t pixel[];
+};
+
+bool glyph_init( void );
+const uint32_t* glyph_get( uint32_t, uint32_t, uint32_t );
+
+#endif
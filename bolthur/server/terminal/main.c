@@ -29,6 +29,7 @@
 #include "../libconsole.h"
 #include "../libhelper.h"
 #include "psf.h"
+#include "glyph.h"
 #include "output.h"
 #include "terminal.h"
 #include "main.h"
@@ -76,6 +77,14 @@ int main( __unused int argc, __unused char* argv[] ) {
     return -1;
   }
 
+  EARLY_STARTUP_PRINT( "Setup glyph cache\r\n" )
+  // glyph cache init
+  if ( ! glyph_init() ) {
+    close( console_manager_fd );
+    close( output_driver_fd );
+    return -1;
+  }
+
   EARLY_STARTUP_PRINT( "Setup terminal\r\n" )
   // init terminal
   if ( ! terminal_init() ) {
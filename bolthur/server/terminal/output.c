@@ -57,8 +57,8 @@ bool output_init( void ) {
     EARLY_STARTUP_PRINT( "ioctl error!\r\n" )
     return false;
   }
-  // return success
-  return true;
+  // setup shared render surface
+  return render_init();
 }
 
 /**
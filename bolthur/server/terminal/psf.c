@@ -21,13 +21,13 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <stddef.h>
-#include <limits.h>
 #include <string.h>
 #include <stdio.h>
 #include <endian.h>
 #include <inttypes.h>
 #include <sys/bolthur.h>
 #include "psf.h"
+#include "utf8.h"
 
 // FIXME: ADD VALUE CONVERSION FROM ENDIAN HEADER OVERALL
 
@@ -86,13 +86,161 @@ static bool psf_load_font( psf_font_ptr_t f ) {
   return true;
 }
 
+/**
+ * @fn uint32_t psf_unicode_hash(uint32_t)
+ * @brief Hash codepoint for unicode mapping table
+ *
+ * @param c
+ * @return
+ */
+static inline uint32_t psf_unicode_hash( uint32_t c ) {
+  return c * 0x9e3779b1;
+}
+
+/**
+ * @fn void psf_unicode_insert(uint32_t, uint32_t)
+ * @brief Insert mapping from codepoint to glyph, first mapping wins
+ *
+ * @param c
+ * @param glyph
+ */
+static void psf_unicode_insert( uint32_t c, uint32_t glyph ) {
+  // ignore mappings to not existing glyphs
+  if ( glyph >= psf_glyph_total() ) {
+    return;
+  }
+  uint32_t idx = psf_unicode_hash( c ) & font->unicode_mask;
+  while ( PSF_UNICODE_EMPTY != font->unicode[ idx ].codepoint ) {
+    if ( c == font->unicode[ idx ].codepoint ) {
+      return;
+    }
+    idx = ( idx + 1 ) & font->unicode_mask;
+  }
+  font->unicode[ idx ].codepoint = c;
+  font->unicode[ idx ].glyph = glyph;
+}
+
+/**
+ * @fn size_t psf_unicode_parse(bool)
+ * @brief Walk unicode table of font
+ *
+ * @param insert flag whether mappings shall be inserted or only counted
+ * @return amount of mappings
+ */
+static size_t psf_unicode_parse( bool insert ) {
+  uint32_t unicode_offset = psf_unicode_table_offset();
+  size_t count = 0;
+  if ( ! unicode_offset || unicode_offset >= font->font_buffer_size ) {
+    return 0;
+  }
+  if ( PSF_FONT_HEADER_TYPE_V1 == font->type ) {
+    // get unicode table and calculate end of buffer
+    uint16_t* table = ( uint16_t* )( font->font_buffer + unicode_offset );
+    uint16_t* end = ( uint16_t* )( font->font_buffer + font->font_buffer_size );
+    uint32_t glyph = 0;
+    bool sequence = false;
+    // loop until end has been reached
+    for ( ; table < end; table++ ) {
+      // handle next glyph
+      if ( PSF1_SEPARATOR == *table ) {
+        sequence = false;
+        glyph++;
+        continue;
+      }
+      // combining sequences are skipped up to the separator
+      if ( PSF1_STARTSEQ == *table ) {
+        sequence = true;
+        continue;
+      }
+      if ( sequence ) {
+        continue;
+      }
+      // add mapping
+      if ( insert ) {
+        psf_unicode_insert( *table, glyph );
+      }
+      count++;
+    }
+  } else if ( PSF_FONT_HEADER_TYPE_V2 == font->type ) {
+    // get unicode table and calculate end of buffer
+    uint8_t* table = font->font_buffer + unicode_offset;
+    uint8_t* end = font->font_buffer + font->font_buffer_size;
+    uint32_t glyph = 0;
+    bool sequence = false;
+    // loop until end has been reached
+    while ( table < end ) {
+      // handle next glyph
+      if ( PSF2_SEPARATOR == *table ) {
+        sequence = false;
+        glyph++;
+        table++;
+        continue;
+      }
+      // combining sequences are skipped up to the separator
+      if ( PSF2_STARTSEQ == *table ) {
+        sequence = true;
+        table++;
+        continue;
+      }
+      size_t length;
+      uint32_t uc = utf8_decode(
+        ( const char* )table,
+        ( size_t )( end - table ),
+        &length
+      );
+      // stop on truncated entries
+      if ( UTF8_INCOMPLETE == uc ) {
+        break;
+      }
+      table += length;
+      // skip malformed entries
+      if ( sequence || UTF8_REPLACEMENT == uc ) {
+        continue;
+      }
+      // add mapping
+      if ( insert ) {
+        psf_unicode_insert( uc, glyph );
+      }
+      count++;
+    }
+  }
+  return count;
+}
+
+/**
+ * @fn bool psf_unicode_init(void)
+ * @brief Build sparse unicode to glyph mapping
+ *
+ * @return
+ */
+static bool psf_unicode_init( void ) {
+  font->unicode = NULL;
+  font->unicode_mask = 0;
+  size_t count = psf_unicode_parse( false );
+  if ( ! count ) {
+    return true;
+  }
+  // keep load factor at or below one half
+  size_t capacity = 16;
+  while ( capacity < count * 2 ) {
+    capacity <<= 1;
+  }
+  font->unicode = malloc( capacity * sizeof( psf_unicode_entry_t ) );
+  if ( ! font->unicode ) {
+    return false;
+  }
+  memset( font->unicode, 0xff, capacity * sizeof( psf_unicode_entry_t ) );
+  font->unicode_mask = ( uint32_t )capacity - 1;
+  psf_unicode_parse( true );
+  return true;
+}
+
 /**
  * @fn bool psf_init(void)
  * @brief Initialize all necessary
  *
  * @return
  *
- * @todo add parse of unicode table for v2
  */
 bool psf_init( void ) {
   // allocate management structure
@@ -160,51 +308,20 @@ bool psf_init( void ) {
     return false;
   }
 
-  // handle unicode offset
-  uint32_t unicode_offset = psf_unicode_table_offset();
-  if (
-    PSF_FONT_HEADER_TYPE_V1 == font->type
-    && 0 < unicode_offset
-  ) {
-    // get unicode table and calculate end of buffer
-    uint16_t* table = ( uint16_t* )( font->font_buffer + unicode_offset );
-    uint16_t* end = ( uint16_t* )( font->font_buffer + font->font_buffer_size );
-    uint16_t glyph = 0;
-    // allocate unicode mapping table
-    font->unicode = calloc( USHRT_MAX, 2 );
-    if ( ! font->unicode ) {
-      free( font->font_buffer );
-      free( font );
-      return false;
-    }
-    // loop until end has been reached
-    while ( table < end ) {
-      // fetch unicode for mapping
-      uint16_t uc = *table;
-      // handle next glyph
-      if ( PSF1_SEPARATOR == uc ) {
-        glyph++;
-        table++;
-        continue;
-      }
-      // skip start sequence
-      if ( PSF1_STARTSEQ == uc ) {
-        table++;
-        continue;
-      }
-      // add mapping
-      font->unicode[ uc ] = glyph;
-      table++;
-    }
-  } else if (
-    PSF_FONT_HEADER_TYPE_V2 == font->type
-    && 0 < unicode_offset
-  ) {
-    // FIXME: ADD SUPPORT!
+  // build unicode mapping if existing
+  if ( ! psf_unicode_init() ) {
     free( font->font_buffer );
     free( font );
     return false;
   }
+  // cache glyph data information used by every lookup
+  font->glyph_base = font->font_buffer + (
+    PSF_FONT_HEADER_TYPE_V1 == font->type
+      ? sizeof( font->header.v1 )
+      : sizeof( font->header.v2 )
+  );
+  font->glyph_size = psf_glyph_size();
+  font->glyph_total = psf_glyph_total();
 
   // return success
   return true;
@@ -313,19 +430,15 @@ uint32_t psf_unicode_table_offset( void ) {
  * @return
  */
 uint8_t* psf_char_to_glyph( uint32_t c ) {
-  // determine header size of font
-  size_t header_size;
-  if ( PSF_FONT_HEADER_TYPE_V1 == font->type ) {
-    header_size = sizeof( font->header.v1 );
-  } else if ( PSF_FONT_HEADER_TYPE_V2 == font->type ) {
-    header_size = sizeof( font->header.v2 );
-  } else {
-    return NULL;
-  }
-
-  // overwrite glyph if mapping exists
-  if ( font->unicode && font->unicode[ c ] ) {
-    c = font->unicode[ c ];
+  // use glyph of mapping if existing
+  if ( font->unicode ) {
+    uint32_t idx = psf_unicode_hash( c ) & font->unicode_mask;
+    while ( PSF_UNICODE_EMPTY != font->unicode[ idx ].codepoint ) {
+      if ( c == font->unicode[ idx ].codepoint ) {
+        return font->glyph_base + font->unicode[ idx ].glyph * font->glyph_size;
+      }
+      idx = ( idx + 1 ) & font->unicode_mask;
+    }
   }
   if ( ! c ) {
     return NULL;
@@ -333,8 +446,8 @@ uint8_t* psf_char_to_glyph( uint32_t c ) {
 
   // determine glyph
   uint32_t off = 0;
-  if ( c < psf_glyph_total() ) {
-    off += c * psf_glyph_size();
+  if ( c < font->glyph_total ) {
+    off += c * font->glyph_size;
   }
-  return ( uint8_t* )( font->font_buffer + header_size + off );
+  return font->glyph_base + off;
 }
@@ -75,11 +75,25 @@ enum psf_font_header_type {
 };
 typedef enum psf_font_header_type psf_font_header_type_t;
 
+// unicode mapping hash table slot, unused slots have PSF_UNICODE_EMPTY
+#define PSF_UNICODE_EMPTY UINT32_MAX
+
+struct psf_unicode_entry {
+  uint32_t codepoint;
+  uint32_t glyph;
+};
+typedef struct psf_unicode_entry psf_unicode_entry_t;
+typedef struct psf_unicode_entry* psf_unicode_entry_ptr_t;
+
 struct psf_font {
   psf_font_header_type_t type;
   uint8_t* font_buffer;
   uint32_t font_buffer_size;
-  uint16_t* unicode;
+  psf_unicode_entry_ptr_t unicode;
+  uint32_t unicode_mask;
+  uint8_t* glyph_base;
+  uint32_t glyph_size;
+  uint32_t glyph_total;
   union {
     psf_font_header_v1_t v1;
     psf_font_header_v2_t v2;
@@ -27,9 +27,46 @@
 #include "render.h"
 #include "terminal.h"
 #include "psf.h"
+#include "glyph.h"
 #include "main.h"
+#include "output.h"
 #include "../libframebuffer.h"
 
+/**
+ * @brief Shared surface terminal content is rendered into
+ */
+framebuffer_surface_t render_surface;
+
+/**
+ * @brief Color palette indexed by cell attribute, normal followed by bright
+ */
+static const uint32_t render_palette[ 16 ] = {
+  0x000000, 0xaa0000, 0x00aa00, 0xaa5500,
+  0x0000aa, 0xaa00aa, 0x00aaaa, 0xf0f0f0,
+  0x555555, 0xff5555, 0x55ff55, 0xffff55,
+  0x5555ff, 0xff55ff, 0x55ffff, 0xffffff,
+};
+
+/**
+ * @fn bool render_init(void)
+ * @brief Create shared render surface with screen size
+ *
+ * @return
+ */
+bool render_init( void ) {
+  int result = framebuffer_surface_create(
+    output_driver_fd,
+    &render_surface,
+    resolution_data.width,
+    resolution_data.height
+  );
+  if ( 0 > result ) {
+    EARLY_STARTUP_PRINT( "Unable to create render surface: %s\r\n", strerror( -result ) )
+    return false;
+  }
+  return true;
+}
+
 /**
  * @fn void render_char_to_surface(uint8_t*, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t)
  * @brief Helper to render character to passed surface
@@ -53,35 +90,19 @@ void render_char_to_surface(
   uint32_t color_fg,
   uint32_t color_bg
 ) {
-  // get glyph of character
-  uint8_t* glyph = psf_char_to_glyph( c );
-  if ( ! glyph ) {
+  // get expanded glyph tile
+  const uint32_t* tile = glyph_get( c, color_fg, color_bg );
+  if ( ! tile ) {
     return;
   }
   uint32_t font_height = psf_glyph_height();
-  uint32_t font_width = psf_glyph_width();
-  uint32_t off = ( start_y * pitch ) +
-    ( start_x * depth / CHAR_BIT );
-  uint32_t line = off;
-  uint32_t bytesperline = ( font_width + 7 ) / 8;
-  for ( uint32_t idx = 0; idx < font_width * font_height; idx++ ) {
-    uint32_t x = idx % font_width;
-    //EARLY_STARTUP_PRINT( "surface + line = %p\r\n", ( void* )( ( uint32_t* )( surface + line ) ) )
-    *( ( uint32_t* )( surface + line ) ) =
-      ( glyph[ x / 8 ] & ( 0x80 >> ( x & 7 ) ) ) ? color_fg : color_bg;
-    line += 4;
-    // handle new line
-    if (
-      0 == ( idx + 1 ) % font_width
-      && ( idx + 1 ) < font_width * font_height
-    ) {
-      //EARLY_STARTUP_PRINT( "surface + line = %p\r\n", ( void* )( ( uint32_t* )( surface + line ) ) )
-      *( ( uint32_t* )( surface + line ) ) = 0;
-      glyph += bytesperline;
-      off += pitch;
-      // reset line to new offset
-      line = off;
-    }
+  size_t line_size = psf_glyph_width() * depth / CHAR_BIT;
+  uint8_t* line = surface + ( start_y * pitch ) + ( start_x * depth / CHAR_BIT );
+  // copy tile line by line
+  for ( uint32_t y = 0; y < font_height; y++ ) {
+    memcpy( line, tile, line_size );
+    tile = ( const uint32_t* )( ( const uint8_t* )tile + line_size );
+    line += pitch;
   }
 }
 
@@ -117,14 +138,18 @@ ssize_t render_terminal( terminal_ptr_t term, const char* s ) {
   // get some glyph information for rendering
   uint32_t font_width = psf_glyph_width();
   uint32_t font_height = psf_glyph_height();
-  uint32_t byte_per_pixel = term->bpp / CHAR_BIT;
   ssize_t character_rendered = 0;
+  // prepare batch, surface and screen coordinates are equal
+  framebuffer_surface_render_batch_t batch;
+  memset( &batch, 0, sizeof( batch ) );
+  batch.shm_id = render_surface.shm_id;
+  batch.scroll_y = scrolled * font_height;
+  batch.flags = FRAMEBUFFER_RENDER_FLIP;
   //EARLY_STARTUP_PRINT( "Scroll: %ld!\r\n", scrolled )
 
   //EARLY_STARTUP_PRINT( "Render row by row!\r\n" )
   //EARLY_STARTUP_PRINT( "start_row = %ld, end_row = %ld\r\n", start_row, end_row )
   for ( uint32_t row = start_row; row <= end_row; row++ ) {
-    //EARLY_STARTUP_PRINT( "row = %ld, end_row = %ld\r\n", row, end_row )
     // get correct start and end column
     uint32_t tmp_start_col = 0;
     if ( row == start_row ) {
@@ -134,104 +159,53 @@ ssize_t render_terminal( terminal_ptr_t term, const char* s ) {
     if ( row == end_row ) {
       tmp_end_col = end_col;
     }
-    //EARLY_STARTUP_PRINT( "tmp_start_col = %ld, tmp_end_col = %ld\r\n", tmp_start_col, tmp_end_col )
-    // column count
-    size_t row_size = ( tmp_end_col - tmp_start_col + 1 ) * font_width * byte_per_pixel;
-    /*EARLY_STARTUP_PRINT(
-      "( %ld - %ld + 1 ) = %ld\r\n",
-      tmp_end_col,
-      tmp_start_col,
-      ( tmp_end_col - tmp_start_col + 1 )
-    )*/
-    // calculate action size
-    size_t action_size = sizeof( framebuffer_render_surface_t )
-        + row_size * font_height * sizeof( uint8_t );
-    // allocate rpc parameter block
-    framebuffer_render_surface_ptr_t action = malloc( action_size );
-    if ( ! action ) {
-      //EARLY_STARTUP_PRINT( "malloc error\r\n" )
-      return -ENOMEM;
-    }
-    /*EARLY_STARTUP_PRINT(
-      "start = %p, data = %p, end = %p\r\n",
-      ( void* )action,
-      ( void* )action->data,
-      ( void* )( ( uintptr_t )action + action_size )
-    )*/
-    // initialize space with 0
-    memset( action, 0, action_size );
-    // push scrolled if set
-    if ( scrolled ) {
-      action->scroll_y = scrolled * font_height;
-      scrolled = 0;
-    }
-    // loop through columns
-    for (
-      uint32_t col = tmp_start_col, render_col = 0;
-      col <= tmp_end_col;
-      col++, render_col++
-    ) {
-      // get character to print
-      uint16_t c = term->buffer[ row * term->max_col + col ];
-      /*EARLY_STARTUP_PRINT( "render char %c / %ld / %ld to surface\r\n",
-        ( uint8_t )c, render_col, row * term->max_col + col )*/
+    // render characters directly into shared surface
+    for ( uint32_t col = tmp_start_col; col <= tmp_end_col; col++ ) {
+      // get cell to print
+      uint32_t cell = TERMINAL_ROW( term, row )[ col ];
+      uint8_t attribute = TERMINAL_CELL_ATTRIBUTE( cell );
       // render character to buffer
       render_char_to_surface(
-        action->data,
+        render_surface.data,
         term->bpp,
-        row_size,
-        c,
-        render_col * font_width,
-        0,
-        0xf0f0f0,
-        0
+        render_surface.pitch,
+        TERMINAL_CELL_CHAR( cell ),
+        col * font_width,
+        row * font_height,
+        render_palette[ TERMINAL_ATTRIBUTE_FG( attribute ) ],
+        render_palette[ TERMINAL_ATTRIBUTE_BG( attribute ) ]
       );
       character_rendered++;
     }
-
-    // populate necessary data
-    action->x = tmp_start_col * font_width;
-    action->y = row * font_height;
-    action->max_x = row_size;
-    action->max_y = action->max_x * font_height;
-    action->bpp = term->bpp / CHAR_BIT;
-    //EARLY_STARTUP_PRINT( "send surface to framebuffer!\r\n" )
-    // call render surface
-    int result = ioctl(
-      output_driver_fd,
-      IOCTL_BUILD_REQUEST(
-        FRAMEBUFFER_RENDER_SURFACE,
-        action_size,
-        IOCTL_WRONLY
-      ),
-      action
-    );
-    // handle error
-    if ( -1 == result ) {
-      //EARLY_STARTUP_PRINT( "IOCTL error!\r\n" )
-      free( action );
-      return -EIO;
+    uint32_t x = tmp_start_col * font_width;
+    uint32_t width = ( tmp_end_col - tmp_start_col + 1 ) * font_width;
+    framebuffer_rect_ptr_t last = batch.count
+      ? &batch.rect[ batch.count - 1 ] : NULL;
+    // extend previous rectangle when spanning the same columns
+    if (
+      last
+      && last->x == x
+      && last->width == width
+      && last->y + last->height == row * font_height
+    ) {
+      last->height += font_height;
+    } else {
+      framebuffer_batch_add( &batch, x, row * font_height, width, font_height );
     }
-    //EARLY_STARTUP_PRINT( "Continue with next, action = %p!\r\n", ( void* )action )
-    // free again
-    free( action );
-    //EARLY_STARTUP_PRINT( "Continue with next after free!\r\n" )
   }
 
-  //EARLY_STARTUP_PRINT( "Flip request after completing rendering!\r\n" )
-  // call render surface
+  // single render request including flip
   int result = ioctl(
     output_driver_fd,
     IOCTL_BUILD_REQUEST(
-      FRAMEBUFFER_FLIP,
-      0,
-      IOCTL_NONE
+      FRAMEBUFFER_SURFACE_RENDER_BATCH,
+      sizeof( batch ),
+      IOCTL_WRONLY
     ),
-    NULL
+    &batch
   );
   // handle error
   if ( -1 == result ) {
-    //EARLY_STARTUP_PRINT( "flip ioctl error!\r\n" )
     return -EIO;
   }
   return character_rendered;
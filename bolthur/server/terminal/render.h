@@ -20,10 +20,14 @@
 #include <stddef.h>
 #include <unistd.h>
 #include "terminal.h"
+#include "../libframebuffer.h"
 
 #if ! defined( _RENDER_H )
 #define _RENDER_H
 
+extern framebuffer_surface_t render_surface;
+
+bool render_init( void );
 void render_char_to_surface( uint8_t*, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t );
 ssize_t render_terminal( terminal_ptr_t, const char* );
 
@@ -26,6 +26,7 @@
 #include "collection/list.h"
 #include "psf.h"
 #include "utf8.h"
+#include "vt100.h"
 #include "main.h"
 #include "../libconsole.h"
 #include "../libhelper.h"
@@ -61,15 +62,15 @@ static void terminal_cleanup( const list_item_ptr_t a ) {
 }
 
 /**
- * @fn void memset16*(void*, uint16_t, size_t)
- * @brief Internal memset implementation for 16 bit
+ * @fn void memset32*(void*, uint32_t, size_t)
+ * @brief Internal memset implementation for 32 bit
  *
  * @param buf
  * @param value
  * @param size
  */
-static void* memset16( void* buf, uint16_t value, size_t size ) {
-  uint16_t* _buf = ( uint16_t* )buf;
+static void* memset32( void* buf, uint32_t value, size_t size ) {
+  uint32_t* _buf = ( uint32_t* )buf;
   for ( size_t i = 0; i < size; i++ ) {
     _buf[ i ] = value;
   }
@@ -194,7 +195,7 @@ bool terminal_init( void ) {
     strncpy( term->path, tty_path, TERMINAL_MAX_PATH );
     term->bpp = resolution_data.depth;
     // allocate terminal buffer
-    size_t buffer_size = sizeof( uint16_t ) * term->max_col * term->max_row;
+    size_t buffer_size = sizeof( uint32_t ) * term->max_col * term->max_row;
     term->buffer = malloc( buffer_size );
     if ( ! term->buffer ) {
       free( term );
@@ -204,7 +205,12 @@ bool terminal_init( void ) {
       list_destruct( terminal_list );
       return false;
     }
-    memset16( term->buffer, ' ', buffer_size / sizeof( uint16_t ) );
+    terminal_reset( term );
+    memset32(
+      term->buffer,
+      TERMINAL_CELL( ' ', term->current_attribute ),
+      buffer_size / sizeof( uint32_t )
+    );
     // push back
     if ( ! list_push_back( terminal_list, term ) ) {
       free( term->buffer );
@@ -278,6 +284,76 @@ bool terminal_init( void ) {
   return 0 == response;
 }
 
+/**
+ * @fn void terminal_reset(terminal_ptr_t)
+ * @brief Reset parser state and graphic rendition
+ *
+ * @param term
+ */
+void terminal_reset( terminal_ptr_t term ) {
+  term->state = 0;
+  term->param_count = 0;
+  term->param_private = false;
+  term->utf8_pending_length = 0;
+  term->fg = TERMINAL_DEFAULT_FG;
+  term->bg = TERMINAL_DEFAULT_BG;
+  term->bold = false;
+  term->reverse = false;
+  term->saved_col = 0;
+  term->saved_row = 0;
+  terminal_update_attribute( term );
+}
+
+/**
+ * @fn void terminal_update_attribute(terminal_ptr_t)
+ * @brief Calculate attribute used for new cells from graphic rendition
+ *
+ * @param term
+ */
+void terminal_update_attribute( terminal_ptr_t term ) {
+  uint8_t fg = term->bold ? ( uint8_t )( term->fg | 0x8 ) : term->fg;
+  uint8_t bg = term->bg;
+  if ( term->reverse ) {
+    uint8_t tmp = fg;
+    fg = bg;
+    bg = tmp;
+  }
+  term->current_attribute = TERMINAL_ATTRIBUTE( fg, bg );
+}
+
+/**
+ * @fn void terminal_mark(terminal_ptr_t, uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Extend changed range by cells from start to end position
+ *
+ * @param term
+ * @param start_col
+ * @param start_row
+ * @param end_col
+ * @param end_row
+ */
+void terminal_mark(
+  terminal_ptr_t term,
+  uint32_t start_col,
+  uint32_t start_row,
+  uint32_t end_col,
+  uint32_t end_row
+) {
+  uint32_t start = start_row * term->max_col + start_col;
+  uint32_t end = end_row * term->max_col + end_col;
+  if ( ! term->dirty ) {
+    term->dirty = true;
+    term->dirty_start = start;
+    term->dirty_end = end;
+    return;
+  }
+  if ( start < term->dirty_start ) {
+    term->dirty_start = start;
+  }
+  if ( end > term->dirty_end ) {
+    term->dirty_end = end;
+  }
+}
+
 /**
  * @fn void terminal_scroll(terminal_ptr_t)
  * @brief Scroll up terminal buffer
@@ -285,18 +361,136 @@ bool terminal_init( void ) {
  * @param term
  */
 void terminal_scroll( terminal_ptr_t term ) {
-  // move up one line
-  memmove(
-    term->buffer,
-    &term->buffer[ 1 * term->max_col ],
-    sizeof( uint16_t ) * ( term->max_row - 1 ) * term->max_col
-  );
-  // erase last one
-  memset16(
-    &term->buffer[ ( term->max_row - 1 ) * term->max_col ],
-    ' ',
-    sizeof( uint16_t ) * term->max_col / 2
+  // first row becomes the last one
+  term->head = ( term->head + 1 ) % term->max_row;
+  // erase last one, framebuffer clears scrolled in area with default colors
+  memset32(
+    TERMINAL_ROW( term, term->max_row - 1 ),
+    TERMINAL_CELL(
+      ' ',
+      TERMINAL_ATTRIBUTE( TERMINAL_DEFAULT_FG, TERMINAL_DEFAULT_BG )
+    ),
+    term->max_col
   );
+  term->scrolled++;
+  // move changed range up with content
+  if ( term->dirty ) {
+    if ( term->dirty_end < term->max_col ) {
+      term->dirty = false;
+    } else {
+      term->dirty_end -= term->max_col;
+      term->dirty_start = term->dirty_start >= term->max_col
+        ? term->dirty_start - term->max_col : 0;
+    }
+  }
+}
+
+/**
+ * @fn void terminal_linefeed(terminal_ptr_t)
+ * @brief Move cursor one row down and scroll at the bottom
+ *
+ * @param term
+ */
+void terminal_linefeed( terminal_ptr_t term ) {
+  term->row++;
+  if ( term->max_row <= term->row ) {
+    terminal_scroll( term );
+    term->row = term->max_row - 1;
+  }
+}
+
+/**
+ * @fn void terminal_wrap(terminal_ptr_t)
+ * @brief Wrap to next row if cursor is behind last column
+ *
+ * @param term
+ */
+static void terminal_wrap( terminal_ptr_t term ) {
+  if ( term->max_col <= term->col ) {
+    term->col = 0;
+    terminal_linefeed( term );
+  }
+}
+
+/**
+ * @fn void terminal_put(terminal_ptr_t, uint32_t)
+ * @brief Put character at cursor with current attribute
+ *
+ * @param term
+ * @param c
+ */
+void terminal_put( terminal_ptr_t term, uint32_t c ) {
+  terminal_wrap( term );
+  TERMINAL_ROW( term, term->row )[ term->col ] =
+    TERMINAL_CELL( c, term->current_attribute );
+  terminal_mark( term, term->col, term->row, term->col, term->row );
+  term->col++;
+}
+
+/**
+ * @fn void terminal_put_ascii(terminal_ptr_t, const char*, size_t)
+ * @brief Copy run of printable ascii characters at cursor
+ *
+ * @param term
+ * @param s
+ * @param len
+ */
+void terminal_put_ascii( terminal_ptr_t term, const char* s, size_t len ) {
+  while ( len ) {
+    terminal_wrap( term );
+    // copy up to end of row in one go
+    size_t count = term->max_col - term->col;
+    if ( count > len ) {
+      count = len;
+    }
+    uint32_t* cell = TERMINAL_ROW( term, term->row ) + term->col;
+    uint32_t attribute = TERMINAL_CELL( 0, term->current_attribute );
+    for ( size_t idx = 0; idx < count; idx++ ) {
+      cell[ idx ] = ( uint8_t )s[ idx ] | attribute;
+    }
+    terminal_mark(
+      term,
+      term->col,
+      term->row,
+      term->col + ( uint32_t )count - 1,
+      term->row
+    );
+    term->col += ( uint32_t )count;
+    s += count;
+    len -= count;
+  }
+}
+
+/**
+ * @fn void terminal_erase(terminal_ptr_t, uint32_t, uint32_t, uint32_t, uint32_t)
+ * @brief Erase cells from start to end position including
+ *
+ * @param term
+ * @param start_col
+ * @param start_row
+ * @param end_col
+ * @param end_row
+ */
+void terminal_erase(
+  terminal_ptr_t term,
+  uint32_t start_col,
+  uint32_t start_row,
+  uint32_t end_col,
+  uint32_t end_row
+) {
+  for ( uint32_t row = start_row; row <= end_row; row++ ) {
+    uint32_t first = row == start_row ? start_col : 0;
+    uint32_t last = row == end_row ? end_col : term->max_col - 1;
+    if ( first > last ) {
+      continue;
+    }
+    memset32(
+      TERMINAL_ROW( term, row ) + first,
+      TERMINAL_CELL( ' ', term->current_attribute ),
+      last - first + 1
+    );
+  }
+  terminal_mark( term, start_col, start_row, end_col, end_row );
 }
 
 /**
@@ -304,12 +498,14 @@ void terminal_scroll( terminal_ptr_t term ) {
  * @brief Push string to terminal buffer
  *
  * @param term terminal to push to
- * @param s utf8 string to push
- * @param start_x pointer to return start_x if not null
- * @param start_y pointer to return start_y if not null
- * @param end_x pointer to return end_x if not null
- * @param end_y pointer to return end_y if not null
- * @return
+ * @param s utf8 string with possible escape sequences to push
+ * @param start_x pointer to return start_x
+ * @param start_y pointer to return start_y
+ * @param end_x pointer to return end_x
+ * @param end_y pointer to return end_y
+ * @return amount of scrolled lines
+ *
+ * @note When nothing changed, start_y is returned greater than end_y
  */
 uint32_t terminal_push(
   terminal_ptr_t term,
@@ -319,103 +515,21 @@ uint32_t terminal_push(
   uint32_t* end_x,
   uint32_t* end_y
 ) {
-  uint32_t scrolled = 0;
-  // set start x and y
-  if ( start_x ) {
-    *start_x = term->col;
-  }
-  if ( start_y ) {
-    *start_y = term->row;
-  }
-  bool first = true;
-  bool newline_in_middle = false;
-  bool newline = false;
-  while( *s ) {
-    // set flag indicating that a newline is in the middle
-    if ( newline ) {
-      newline_in_middle = true;
-    }
-    // handle end of row reached
-    if ( term->max_col <= term->col ) {
-      term->col = 0;
-      term->row++;
-      newline = true;
-    }
-    // handle scroll
-    if ( term->max_row <= term->row ) {
-      // scroll up content
-      terminal_scroll( term );
-      // increase scrolled lines
-      scrolled++;
-      // set row and col correctly
-      term->row--;
-      term->col = 0;
-      // set start x and y different if during first run
-      if ( first && start_x ) {
-        *start_x = term->col;
-      }
-      if ( first && start_y ) {
-        *start_y = term->row;
-      }
-    }
-    // decode churrent character to unicode for save
-    size_t len = 0;
-    uint16_t c = utf8_decode( s, &len );
-    s += --len;
-    // check character for actions
-    switch ( c ) {
-      // newline just increase row
-      case '\n':
-        term->row++;
-        newline = true;
-        break;
-      // carriage return reset column
-      case '\r':
-        // set end x before reset
-        if ( end_x ) {
-          *end_x = term->col - 1;
-        }
-        term->col = 0;
-        break;
-      case '\t':
-        // insert 4 spaces
-        if ( first ) {
-          terminal_push( term, "    ", start_x, start_y, end_x, end_y );
-        } else {
-          terminal_push( term, "    ", NULL, NULL, end_x, end_y );
-        }
-        break;
-      default:
-        /*EARLY_STARTUP_PRINT(
-          "c = %c, idx = %ld\r\n",
-          c, term->row * term->max_col + term->col
-        )*/
-        // push back character
-        term->buffer[ term->row * term->max_col + term->col ] = c;
-        // set end x
-        if ( end_x ) {
-          *end_x = term->col;
-        }
-        // increment column
-        term->col++;
-    }
-
-    // next character
-    first = false;
-    s++;
-  }
-  // set end x / y in case of scroll action
-  if ( end_x && newline && newline_in_middle ) {
-    *end_x = term->col;
-  }
-  if ( end_y ) {
-    *end_y = ( newline && ! newline_in_middle )
-      ? term->row - 1 : term->row;
-  }
-  // adjust start if scrolled with newline in middle
-  if ( start_y && scrolled && newline && newline_in_middle ) {
-    *start_y = term->row - 1;
+  term->dirty = false;
+  term->scrolled = 0;
+  // parse and apply
+  vt100_parse( term, s, strlen( s ) );
+  // return changed range
+  if ( term->dirty ) {
+    *start_x = term->dirty_start % term->max_col;
+    *start_y = term->dirty_start / term->max_col;
+    *end_x = term->dirty_end % term->max_col;
+    *end_y = term->dirty_end / term->max_col;
+  } else {
+    *start_x = 0;
+    *start_y = 1;
+    *end_x = 0;
+    *end_y = 0;
   }
-  // return indicator whether scrolling was done or not
-  return scrolled;
+  return term->scrolled;
 }
@@ -17,7 +17,11 @@
  * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "collection/list.h"
+#include "utf8.h"
 #include "../libterminal.h"
 
 #if ! defined( _TERMINAL_H )
@@ -26,23 +30,72 @@
 #define TERMINAL_BASE_PATH "/dev/tty"
 #define TERMINAL_MAX_PATH 32
 #define TERMINAL_MAX_NUM 7
+#define TERMINAL_PARAM_MAX 16
+#define TERMINAL_TAB_WIDTH 4
+
+// cell attribute, foreground palette index in low and background in high nibble
+#define TERMINAL_ATTRIBUTE( fg, bg ) ( ( uint8_t )( ( fg ) | ( ( bg ) << 4 ) ) )
+#define TERMINAL_ATTRIBUTE_FG( a ) ( ( a ) & 0xf )
+#define TERMINAL_ATTRIBUTE_BG( a ) ( ( ( a ) >> 4 ) & 0xf )
+#define TERMINAL_DEFAULT_FG 7
+#define TERMINAL_DEFAULT_BG 0
+
+// cell with codepoint in low 21 bits and attribute in high byte
+#define TERMINAL_CELL( c, a ) ( ( uint32_t )( c ) | ( ( uint32_t )( a ) << 24 ) )
+#define TERMINAL_CELL_CHAR( cell ) ( ( cell ) & 0x1fffff )
+#define TERMINAL_CELL_ATTRIBUTE( cell ) ( ( uint8_t )( ( cell ) >> 24 ) )
 
 struct terminal {
   char path[ TERMINAL_MAX_PATH ];
-  uint16_t* buffer;
+  uint32_t* buffer;
+  uint32_t head;
   uint32_t col;
   uint32_t row;
   uint32_t max_col;
   uint32_t max_row;
   uint32_t bpp;
+  // escape sequence parser state
+  uint32_t state;
+  uint32_t param[ TERMINAL_PARAM_MAX ];
+  uint32_t param_count;
+  bool param_private;
+  // utf8 sequence split across pushes
+  char utf8_pending[ UTF8_MAX_LENGTH ];
+  uint32_t utf8_pending_length;
+  // current graphic rendition
+  uint8_t fg;
+  uint8_t bg;
+  bool bold;
+  bool reverse;
+  uint8_t current_attribute;
+  // saved cursor
+  uint32_t saved_col;
+  uint32_t saved_row;
+  // changed cells as row major index range and scrolled lines of current push
+  bool dirty;
+  uint32_t dirty_start;
+  uint32_t dirty_end;
+  uint32_t scrolled;
 };
 typedef struct terminal terminal_t;
 typedef struct terminal* terminal_ptr_t;
 
+// buffer is a ring of rows starting at head
+#define TERMINAL_ROW( term, r ) \
+  ( &( term )->buffer[ ( ( ( term )->head + ( r ) ) % ( term )->max_row ) \
+    * ( term )->max_col ] )
+
 extern list_manager_ptr_t terminal_list;
 
 bool terminal_init( void );
 void terminal_scroll( terminal_ptr_t );
+void terminal_mark( terminal_ptr_t, uint32_t, uint32_t, uint32_t, uint32_t );
+void terminal_linefeed( terminal_ptr_t );
+void terminal_put( terminal_ptr_t, uint32_t );
+void terminal_put_ascii( terminal_ptr_t, const char*, size_t );
+void terminal_erase( terminal_ptr_t, uint32_t, uint32_t, uint32_t, uint32_t );
+void terminal_update_attribute( terminal_ptr_t );
+void terminal_reset( terminal_ptr_t );
 uint32_t terminal_push( terminal_ptr_t, const char*, uint32_t*, uint32_t*, uint32_t*, uint32_t* );
 
 #endif
@@ -17,42 +17,145 @@
  * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+#if defined( __ARM_NEON )
+  #include <arm_neon.h>
+#endif
 #include "utf8.h"
 
+// helper constants for word wise scanning
+#define UTF8_ONES ( ( size_t )-1 / 0xff )
+#define UTF8_HIGH ( UTF8_ONES * 0x80 )
+
 /**
- * @fn uint16_t utf8_decode(const char*, size_t*)
- * @brief Helper to decode utf8 character
+ * @fn uint32_t utf8_decode(const char*, size_t, size_t*)
+ * @brief Decode and validate one utf8 sequence
  *
- * @param str
- * @param ol
- * @return
+ * @param s string to decode
+ * @param len remaining bytes within s
+ * @param consumed pointer receiving amount of consumed bytes
+ * @return decoded codepoint, UTF8_REPLACEMENT or UTF8_INCOMPLETE
+ *
+ * @note Overlong encodings, surrogates and codepoints above 0x10ffff are
+ * malformed. Only the maximal valid prefix is consumed, so a following
+ * lead byte is decoded by the next call.
  */
-uint16_t utf8_decode( const char* s, size_t* ol ) {
-  const uint8_t* str = ( const uint8_t* )s; // Use unsigned chars
-  uint16_t u = *str;
-  uint32_t l = 1;
+uint32_t utf8_decode( const char* s, size_t len, size_t* consumed ) {
+  const uint8_t* str = ( const uint8_t* )s;
+  if ( ! len ) {
+    *consumed = 0;
+    return UTF8_INCOMPLETE;
+  }
+  uint8_t lead = str[ 0 ];
   // handle no unicode
-  if ( ! isunicode( u ) ) {
-    // push len to pointer
-    if ( ol ) {
-      *ol += 1;
-    }
-    // return code
-    return u;
+  if ( 0x80 > lead ) {
+    *consumed = 1;
+    return lead;
   }
-  // decode
-  uint16_t a = (u&0x20)? ((u&0x10)? ((u&0x08)? ((u&0x04)? 6 : 5) : 4) : 3) : 2;
-  if ( a < 6 || !( u & 0x02 ) ) {
-    u = ((u<<(a+1))&0xff)>>(a+1);
-    for ( int b=1; b<a; ++b ) {
-      u = ( uint16_t )( ( u << 6 ) | ( str[ l++ ] & 0x3f ) );
+  // determine length and allowed range of second byte
+  size_t length;
+  uint32_t codepoint;
+  uint8_t lower = 0x80;
+  uint8_t upper = 0xbf;
+  if ( 0xc2 <= lead && 0xdf >= lead ) {
+    length = 2;
+    codepoint = lead & 0x1f;
+  } else if ( 0xe0 <= lead && 0xef >= lead ) {
+    length = 3;
+    codepoint = lead & 0x0f;
+    if ( 0xe0 == lead ) {
+      lower = 0xa0;
+    } else if ( 0xed == lead ) {
+      upper = 0x9f;
     }
+  } else if ( 0xf0 <= lead && 0xf4 >= lead ) {
+    length = 4;
+    codepoint = lead & 0x07;
+    if ( 0xf0 == lead ) {
+      lower = 0x90;
+    } else if ( 0xf4 == lead ) {
+      upper = 0x8f;
+    }
+  } else {
+    *consumed = 1;
+    return UTF8_REPLACEMENT;
   }
-  // push len to pointer
-  if ( ol ) {
-    *ol += l;
+  // decode continuation bytes
+  for ( size_t idx = 1; idx < length; idx++ ) {
+    if ( idx >= len ) {
+      *consumed = idx;
+      return UTF8_INCOMPLETE;
+    }
+    uint8_t c = str[ idx ];
+    if ( lower > c || upper < c ) {
+      *consumed = idx;
+      return UTF8_REPLACEMENT;
+    }
+    lower = 0x80;
+    upper = 0xbf;
+    codepoint = ( codepoint << 6 ) | ( c & 0x3f );
   }
-  // return decoded
-  return u;
+  *consumed = length;
+  return codepoint;
 }
 
+/**
+ * @fn size_t utf8_printable_length(const char*, size_t)
+ * @brief Get length of leading printable ascii run
+ *
+ * @param s
+ * @param len
+ * @return
+ */
+size_t utf8_printable_length( const char* s, size_t len ) {
+  size_t idx = 0;
+  #if defined( __ARM_NEON )
+    uint8x16_t space = vdupq_n_u8( 0x20 );
+    uint8x16_t del = vdupq_n_u8( 0x7f );
+    // sixteen byte per iteration
+    for ( ; idx + 16 <= len; idx += 16 ) {
+      uint8x16_t v = vld1q_u8( ( const uint8_t* )s + idx );
+      // set lanes not within space up to tilde
+      uint8x16_t bad = vorrq_u8( vcltq_u8( v, space ), vcgeq_u8( v, del ) );
+      uint64x2_t wide = vreinterpretq_u64_u8( bad );
+      if ( vgetq_lane_u64( wide, 0 ) | vgetq_lane_u64( wide, 1 ) ) {
+        break;
+      }
+    }
+  #else
+    // scan bytewise until aligned
+    while (
+      idx < len
+      && ( ( uintptr_t )( s + idx ) & ( sizeof( size_t ) - 1 ) )
+    ) {
+      uint8_t c = ( uint8_t )s[ idx ];
+      if ( 0x20 > c || 0x7f <= c ) {
+        return idx;
+      }
+      idx++;
+    }
+    // scan word wise while no byte is high, below space or delete
+    while ( idx + sizeof( size_t ) <= len ) {
+      size_t w;
+      memcpy( &w, s + idx, sizeof( w ) );
+      size_t d = w ^ ( UTF8_ONES * 0x7f );
+      if (
+        ( w & UTF8_HIGH )
+        || ( ( w - UTF8_ONES * 0x20 ) & ~w & UTF8_HIGH )
+        || ( ( d - UTF8_ONES ) & ~d & UTF8_HIGH )
+      ) {
+        break;
+      }
+      idx += sizeof( size_t );
+    }
+  #endif
+  // scan remaining bytewise
+  while ( idx < len ) {
+    uint8_t c = ( uint8_t )s[ idx ];
+    if ( 0x20 > c || 0x7f <= c ) {
+      break;
+    }
+    idx++;
+  }
+  return idx;
+}
@@ -25,6 +25,14 @@
 
 #define isunicode( c ) ( ( ( c ) & 0xc0 ) == 0xc0 )
 
-uint16_t utf8_decode( const char*, size_t* );
+// returned for malformed sequences
+#define UTF8_REPLACEMENT 0xfffd
+// returned when the buffer ends within a valid sequence
+#define UTF8_INCOMPLETE UINT32_MAX
+// maximum encoded length of a codepoint
+#define UTF8_MAX_LENGTH 4
+
+uint32_t utf8_decode( const char*, size_t, size_t* );
+size_t utf8_printable_length( const char*, size_t );
 
 #endif
@@ -0,0 +1,575 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "vt100.h"
+#include "terminal.h"
+#include "utf8.h"
+
+// byte classes used as column within transition table
+enum vt100_class {
+  VT100_CLASS_CONTROL = 0,
+  VT100_CLASS_CANCEL,
+  VT100_CLASS_ESCAPE,
+  VT100_CLASS_INTERMEDIATE,
+  VT100_CLASS_DIGIT,
+  VT100_CLASS_SEPARATOR,
+  VT100_CLASS_PRIVATE,
+  VT100_CLASS_BRACKET,
+  VT100_CLASS_FINAL,
+  VT100_CLASS_DELETE,
+  VT100_CLASS_HIGH,
+  VT100_CLASS_COUNT,
+};
+
+// actions executed on transition
+enum vt100_action {
+  VT100_ACTION_NONE = 0,
+  VT100_ACTION_PRINT,
+  VT100_ACTION_EXECUTE,
+  VT100_ACTION_CLEAR,
+  VT100_ACTION_PARAM,
+  VT100_ACTION_PRIVATE,
+  VT100_ACTION_ESC_DISPATCH,
+  VT100_ACTION_CSI_DISPATCH,
+  VT100_ACTION_UTF8,
+};
+
+typedef struct {
+  uint8_t action;
+  uint8_t next;
+} vt100_transition_t;
+
+#define T( a, n ) { VT100_ACTION_ ## a, VT100_STATE_ ## n }
+
+/**
+ * @brief Transition table indexed by state and byte class
+ */
+static const vt100_transition_t vt100_table[ VT100_STATE_COUNT ][ VT100_CLASS_COUNT ] = {
+  [ VT100_STATE_GROUND ] = {
+    [ VT100_CLASS_CONTROL ] = T( EXECUTE, GROUND ),
+    [ VT100_CLASS_CANCEL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_ESCAPE ] = T( CLEAR, ESCAPE ),
+    [ VT100_CLASS_INTERMEDIATE ] = T( PRINT, GROUND ),
+    [ VT100_CLASS_DIGIT ] = T( PRINT, GROUND ),
+    [ VT100_CLASS_SEPARATOR ] = T( PRINT, GROUND ),
+    [ VT100_CLASS_PRIVATE ] = T( PRINT, GROUND ),
+    [ VT100_CLASS_BRACKET ] = T( PRINT, GROUND ),
+    [ VT100_CLASS_FINAL ] = T( PRINT, GROUND ),
+    [ VT100_CLASS_DELETE ] = T( NONE, GROUND ),
+    [ VT100_CLASS_HIGH ] = T( UTF8, GROUND ),
+  },
+  [ VT100_STATE_ESCAPE ] = {
+    [ VT100_CLASS_CONTROL ] = T( EXECUTE, ESCAPE ),
+    [ VT100_CLASS_CANCEL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_ESCAPE ] = T( CLEAR, ESCAPE ),
+    [ VT100_CLASS_INTERMEDIATE ] = T( NONE, ESCAPE_INTERMEDIATE ),
+    [ VT100_CLASS_DIGIT ] = T( ESC_DISPATCH, GROUND ),
+    [ VT100_CLASS_SEPARATOR ] = T( ESC_DISPATCH, GROUND ),
+    [ VT100_CLASS_PRIVATE ] = T( ESC_DISPATCH, GROUND ),
+    [ VT100_CLASS_BRACKET ] = T( CLEAR, CSI_ENTRY ),
+    [ VT100_CLASS_FINAL ] = T( ESC_DISPATCH, GROUND ),
+    [ VT100_CLASS_DELETE ] = T( NONE, ESCAPE ),
+    [ VT100_CLASS_HIGH ] = T( NONE, GROUND ),
+  },
+  [ VT100_STATE_ESCAPE_INTERMEDIATE ] = {
+    [ VT100_CLASS_CONTROL ] = T( EXECUTE, ESCAPE_INTERMEDIATE ),
+    [ VT100_CLASS_CANCEL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_ESCAPE ] = T( CLEAR, ESCAPE ),
+    [ VT100_CLASS_INTERMEDIATE ] = T( NONE, ESCAPE_INTERMEDIATE ),
+    // character set designation and similar are not supported
+    [ VT100_CLASS_DIGIT ] = T( NONE, GROUND ),
+    [ VT100_CLASS_SEPARATOR ] = T( NONE, GROUND ),
+    [ VT100_CLASS_PRIVATE ] = T( NONE, GROUND ),
+    [ VT100_CLASS_BRACKET ] = T( NONE, GROUND ),
+    [ VT100_CLASS_FINAL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_DELETE ] = T( NONE, ESCAPE_INTERMEDIATE ),
+    [ VT100_CLASS_HIGH ] = T( NONE, GROUND ),
+  },
+  [ VT100_STATE_CSI_ENTRY ] = {
+    [ VT100_CLASS_CONTROL ] = T( EXECUTE, CSI_ENTRY ),
+    [ VT100_CLASS_CANCEL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_ESCAPE ] = T( CLEAR, ESCAPE ),
+    [ VT100_CLASS_INTERMEDIATE ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_DIGIT ] = T( PARAM, CSI_PARAM ),
+    [ VT100_CLASS_SEPARATOR ] = T( PARAM, CSI_PARAM ),
+    [ VT100_CLASS_PRIVATE ] = T( PRIVATE, CSI_PARAM ),
+    [ VT100_CLASS_BRACKET ] = T( CSI_DISPATCH, GROUND ),
+    [ VT100_CLASS_FINAL ] = T( CSI_DISPATCH, GROUND ),
+    [ VT100_CLASS_DELETE ] = T( NONE, CSI_ENTRY ),
+    [ VT100_CLASS_HIGH ] = T( NONE, GROUND ),
+  },
+  [ VT100_STATE_CSI_PARAM ] = {
+    [ VT100_CLASS_CONTROL ] = T( EXECUTE, CSI_PARAM ),
+    [ VT100_CLASS_CANCEL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_ESCAPE ] = T( CLEAR, ESCAPE ),
+    [ VT100_CLASS_INTERMEDIATE ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_DIGIT ] = T( PARAM, CSI_PARAM ),
+    [ VT100_CLASS_SEPARATOR ] = T( PARAM, CSI_PARAM ),
+    [ VT100_CLASS_PRIVATE ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_BRACKET ] = T( CSI_DISPATCH, GROUND ),
+    [ VT100_CLASS_FINAL ] = T( CSI_DISPATCH, GROUND ),
+    [ VT100_CLASS_DELETE ] = T( NONE, CSI_PARAM ),
+    [ VT100_CLASS_HIGH ] = T( NONE, GROUND ),
+  },
+  [ VT100_STATE_CSI_IGNORE ] = {
+    [ VT100_CLASS_CONTROL ] = T( EXECUTE, CSI_IGNORE ),
+    [ VT100_CLASS_CANCEL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_ESCAPE ] = T( CLEAR, ESCAPE ),
+    [ VT100_CLASS_INTERMEDIATE ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_DIGIT ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_SEPARATOR ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_PRIVATE ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_BRACKET ] = T( NONE, GROUND ),
+    [ VT100_CLASS_FINAL ] = T( NONE, GROUND ),
+    [ VT100_CLASS_DELETE ] = T( NONE, CSI_IGNORE ),
+    [ VT100_CLASS_HIGH ] = T( NONE, GROUND ),
+  },
+};
+
+#undef T
+
+/**
+ * @fn uint8_t vt100_class(uint8_t)
+ * @brief Get byte class of character
+ *
+ * @param c
+ * @return
+ */
+static uint8_t vt100_class( uint8_t c ) {
+  if ( 0x18 == c || 0x1a == c ) {
+    return VT100_CLASS_CANCEL;
+  }
+  if ( 0x1b == c ) {
+    return VT100_CLASS_ESCAPE;
+  }
+  if ( 0x20 > c ) {
+    return VT100_CLASS_CONTROL;
+  }
+  if ( 0x30 > c ) {
+    return VT100_CLASS_INTERMEDIATE;
+  }
+  if ( 0x3a > c ) {
+    return VT100_CLASS_DIGIT;
+  }
+  if ( 0x3c > c ) {
+    return VT100_CLASS_SEPARATOR;
+  }
+  if ( 0x40 > c ) {
+    return VT100_CLASS_PRIVATE;
+  }
+  if ( '[' == c ) {
+    return VT100_CLASS_BRACKET;
+  }
+  if ( 0x7f > c ) {
+    return VT100_CLASS_FINAL;
+  }
+  if ( 0x7f == c ) {
+    return VT100_CLASS_DELETE;
+  }
+  return VT100_CLASS_HIGH;
+}
+
+/**
+ * @fn uint32_t vt100_param(terminal_ptr_t, uint32_t, uint32_t)
+ * @brief Get parameter or default if not set
+ *
+ * @param term
+ * @param idx
+ * @param def
+ * @return
+ */
+static uint32_t vt100_param( terminal_ptr_t term, uint32_t idx, uint32_t def ) {
+  if ( idx >= term->param_count || ! term->param[ idx ] ) {
+    return def;
+  }
+  return term->param[ idx ];
+}
+
+/**
+ * @fn uint32_t vt100_clamp(uint32_t, uint32_t)
+ * @brief Clamp value to maximum - 1
+ *
+ * @param value
+ * @param max
+ * @return
+ */
+static inline uint32_t vt100_clamp( uint32_t value, uint32_t max ) {
+  return value < max ? value : max - 1;
+}
+
+/**
+ * @fn void vt100_clear(terminal_ptr_t)
+ * @brief Clear collected parameters
+ *
+ * @param term
+ */
+static void vt100_clear( terminal_ptr_t term ) {
+  memset( term->param, 0, sizeof( term->param ) );
+  term->param_count = 0;
+  term->param_private = false;
+}
+
+/**
+ * @fn void vt100_collect(terminal_ptr_t, uint8_t)
+ * @brief Collect parameter digit or separator
+ *
+ * @param term
+ * @param c
+ */
+static void vt100_collect( terminal_ptr_t term, uint8_t c ) {
+  if ( ! term->param_count ) {
+    term->param_count = 1;
+  }
+  // separator starts next parameter
+  if ( ! ( '0' <= c && '9' >= c ) ) {
+    if ( TERMINAL_PARAM_MAX > term->param_count ) {
+      term->param[ term->param_count++ ] = 0;
+    }
+    return;
+  }
+  uint32_t* param = &term->param[ term->param_count - 1 ];
+  // cap value to prevent overflow
+  if ( 9999 > *param ) {
+    *param = *param * 10 + ( uint32_t )( c - '0' );
+  }
+}
+
+/**
+ * @fn void vt100_execute(terminal_ptr_t, uint8_t)
+ * @brief Execute control character
+ *
+ * @param term
+ * @param c
+ */
+static void vt100_execute( terminal_ptr_t term, uint8_t c ) {
+  switch ( c ) {
+    // newline just increase row
+    case '\n':
+    case '\v':
+    case '\f':
+      terminal_linefeed( term );
+      break;
+    // carriage return reset column
+    case '\r':
+      term->col = 0;
+      break;
+    case '\b':
+      if ( term->col ) {
+        term->col = vt100_clamp( term->col, term->max_col ) - 1;
+      }
+      break;
+    case '\t':
+      // insert spaces
+      terminal_put_ascii( term, "        ", TERMINAL_TAB_WIDTH );
+      break;
+  }
+}
+
+/**
+ * @fn void vt100_sgr(terminal_ptr_t)
+ * @brief Select graphic rendition
+ *
+ * @param term
+ */
+static void vt100_sgr( terminal_ptr_t term ) {
+  uint32_t count = term->param_count ? term->param_count : 1;
+  for ( uint32_t idx = 0; idx < count; idx++ ) {
+    uint32_t p = term->param[ idx ];
+    if ( 0 == p ) {
+      term->fg = TERMINAL_DEFAULT_FG;
+      term->bg = TERMINAL_DEFAULT_BG;
+      term->bold = false;
+      term->reverse = false;
+    } else if ( 1 == p ) {
+      term->bold = true;
+    } else if ( 22 == p ) {
+      term->bold = false;
+    } else if ( 7 == p ) {
+      term->reverse = true;
+    } else if ( 27 == p ) {
+      term->reverse = false;
+    } else if ( 30 <= p && 37 >= p ) {
+      term->fg = ( uint8_t )( p - 30 );
+    } else if ( 39 == p ) {
+      term->fg = TERMINAL_DEFAULT_FG;
+    } else if ( 40 <= p && 47 >= p ) {
+      term->bg = ( uint8_t )( p - 40 );
+    } else if ( 49 == p ) {
+      term->bg = TERMINAL_DEFAULT_BG;
+    } else if ( 90 <= p && 97 >= p ) {
+      term->fg = ( uint8_t )( p - 90 + 8 );
+    } else if ( 100 <= p && 107 >= p ) {
+      term->bg = ( uint8_t )( p - 100 + 8 );
+    } else if ( 38 == p || 48 == p ) {
+      // extended color, only first 16 palette entries are supported
+      uint32_t mode = vt100_param( term, idx + 1, 0 );
+      if ( 5 == mode ) {
+        uint32_t color = vt100_param( term, idx + 2, 0 );
+        if ( 16 > color ) {
+          if ( 38 == p ) {
+            term->fg = ( uint8_t )color;
+          } else {
+            term->bg = ( uint8_t )color;
+          }
+        }
+        idx += 2;
+      } else if ( 2 == mode ) {
+        idx += 4;
+      }
+    }
+  }
+  terminal_update_attribute( term );
+}
+
+/**
+ * @fn void vt100_csi_dispatch(terminal_ptr_t, uint8_t)
+ * @brief Execute control sequence
+ *
+ * @param term
+ * @param c final character
+ */
+static void vt100_csi_dispatch( terminal_ptr_t term, uint8_t c ) {
+  // private sequences like cursor visibility are not supported
+  if ( term->param_private ) {
+    return;
+  }
+  uint32_t n = vt100_param( term, 0, 1 );
+  uint32_t col = vt100_clamp( term->col, term->max_col );
+  uint32_t last_col = term->max_col - 1;
+  uint32_t last_row = term->max_row - 1;
+  switch ( c ) {
+    case 'A':
+      term->row -= n < term->row ? n : term->row;
+      break;
+    case 'B':
+      term->row = vt100_clamp( term->row + n, term->max_row );
+      break;
+    case 'C':
+      term->col = vt100_clamp( col + n, term->max_col );
+      break;
+    case 'D':
+      term->col = col - ( n < col ? n : col );
+      break;
+    case 'E':
+      term->row = vt100_clamp( term->row + n, term->max_row );
+      term->col = 0;
+      break;
+    case 'F':
+      term->row -= n < term->row ? n : term->row;
+      term->col = 0;
+      break;
+    case 'G':
+      term->col = vt100_clamp( n - 1, term->max_col );
+      break;
+    case 'd':
+      term->row = vt100_clamp( n - 1, term->max_row );
+      break;
+    case 'H':
+    case 'f':
+      term->row = vt100_clamp( n - 1, term->max_row );
+      term->col = vt100_clamp( vt100_param( term, 1, 1 ) - 1, term->max_col );
+      break;
+    case 'J':
+      switch ( vt100_param( term, 0, 0 ) ) {
+        case 0:
+          terminal_erase( term, col, term->row, last_col, last_row );
+          break;
+        case 1:
+          terminal_erase( term, 0, 0, col, term->row );
+          break;
+        case 2:
+        case 3:
+          terminal_erase( term, 0, 0, last_col, last_row );
+          break;
+      }
+      break;
+    case 'K':
+      switch ( vt100_param( term, 0, 0 ) ) {
+        case 0:
+          terminal_erase( term, col, term->row, last_col, term->row );
+          break;
+        case 1:
+          terminal_erase( term, 0, term->row, col, term->row );
+          break;
+        case 2:
+          terminal_erase( term, 0, term->row, last_col, term->row );
+          break;
+      }
+      break;
+    case 'm':
+      vt100_sgr( term );
+      break;
+    case 's':
+      term->saved_col = term->col;
+      term->saved_row = term->row;
+      break;
+    case 'u':
+      term->col = term->saved_col;
+      term->row = term->saved_row;
+      break;
+  }
+}
+
+/**
+ * @fn void vt100_esc_dispatch(terminal_ptr_t, uint8_t)
+ * @brief Execute escape sequence
+ *
+ * @param term
+ * @param c final character
+ */
+static void vt100_esc_dispatch( terminal_ptr_t term, uint8_t c ) {
+  switch ( c ) {
+    case '7':
+      term->saved_col = term->col;
+      term->saved_row = term->row;
+      break;
+    case '8':
+      term->col = term->saved_col;
+      term->row = term->saved_row;
+      break;
+    case 'c':
+      terminal_reset( term );
+      terminal_erase( term, 0, 0, term->max_col - 1, term->max_row - 1 );
+      term->col = 0;
+      term->row = 0;
+      break;
+    case 'D':
+      terminal_linefeed( term );
+      break;
+    case 'E':
+      term->col = 0;
+      terminal_linefeed( term );
+      break;
+    case 'M':
+      // reverse scroll is not supported, just move up
+      if ( term->row ) {
+        term->row--;
+      }
+      break;
+  }
+}
+
+/**
+ * @fn size_t vt100_utf8(terminal_ptr_t, const char*, size_t)
+ * @brief Decode and print utf8 sequence
+ *
+ * @param term
+ * @param s
+ * @param len remaining length
+ * @return consumed bytes
+ */
+static size_t vt100_utf8( terminal_ptr_t term, const char* s, size_t len ) {
+  size_t consumed;
+  uint32_t c = utf8_decode( s, len, &consumed );
+  // keep sequence split across writes for next push
+  if ( UTF8_INCOMPLETE == c ) {
+    memcpy( term->utf8_pending, s, consumed );
+    term->utf8_pending_length = ( uint32_t )consumed;
+    return consumed;
+  }
+  terminal_put( term, c );
+  return consumed;
+}
+
+/**
+ * @fn size_t vt100_utf8_pending(terminal_ptr_t, const char*, size_t)
+ * @brief Complete utf8 sequence left over from previous push
+ *
+ * @param term
+ * @param s
+ * @param len
+ * @return consumed bytes of s
+ */
+static size_t vt100_utf8_pending( terminal_ptr_t term, const char* s, size_t len ) {
+  size_t used = 0;
+  while ( term->utf8_pending_length && used < len ) {
+    term->utf8_pending[ term->utf8_pending_length++ ] = s[ used++ ];
+    size_t consumed;
+    uint32_t c = utf8_decode(
+      term->utf8_pending,
+      term->utf8_pending_length,
+      &consumed
+    );
+    if ( UTF8_INCOMPLETE == c ) {
+      continue;
+    }
+    terminal_put( term, c );
+    // byte breaking the sequence is handled by the parser again
+    used -= term->utf8_pending_length - consumed;
+    term->utf8_pending_length = 0;
+  }
+  return used;
+}
+
+/**
+ * @fn void vt100_parse(terminal_ptr_t, const char*, size_t)
+ * @brief Parse string and apply it to terminal
+ *
+ * @param term
+ * @param s
+ * @param len
+ */
+void vt100_parse( terminal_ptr_t term, const char* s, size_t len ) {
+  size_t idx = vt100_utf8_pending( term, s, len );
+  while ( idx < len ) {
+    // fast path for runs of printable ascii
+    if ( VT100_STATE_GROUND == term->state ) {
+      size_t run = utf8_printable_length( s + idx, len - idx );
+      if ( run ) {
+        terminal_put_ascii( term, s + idx, run );
+        idx += run;
+        continue;
+      }
+    }
+    uint8_t c = ( uint8_t )s[ idx ];
+    const vt100_transition_t* transition =
+      &vt100_table[ term->state ][ vt100_class( c ) ];
+    term->state = transition->next;
+    switch ( transition->action ) {
+      case VT100_ACTION_PRINT:
+        terminal_put( term, c );
+        break;
+      case VT100_ACTION_EXECUTE:
+        vt100_execute( term, c );
+        break;
+      case VT100_ACTION_CLEAR:
+        vt100_clear( term );
+        break;
+      case VT100_ACTION_PARAM:
+        vt100_collect( term, c );
+        break;
+      case VT100_ACTION_PRIVATE:
+        term->param_private = true;
+        break;
+      case VT100_ACTION_ESC_DISPATCH:
+        vt100_esc_dispatch( term, c );
+        break;
+      case VT100_ACTION_CSI_DISPATCH:
+        vt100_csi_dispatch( term, c );
+        break;
+      case VT100_ACTION_UTF8:
+        idx += vt100_utf8( term, s + idx, len - idx );
+        continue;
+    }
+    idx++;
+  }
+}
@@ -0,0 +1,38 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include "terminal.h"
+
+#if ! defined( _VT100_H )
+#define _VT100_H
+
+enum vt100_state {
+  VT100_STATE_GROUND = 0,
+  VT100_STATE_ESCAPE,
+  VT100_STATE_ESCAPE_INTERMEDIATE,
+  VT100_STATE_CSI_ENTRY,
+  VT100_STATE_CSI_PARAM,
+  VT100_STATE_CSI_IGNORE,
+  VT100_STATE_COUNT,
+};
+
+void vt100_parse( terminal_ptr_t, const char*, size_t );
+
+#endif
@@ -23,6 +23,7 @@ AC_DEFUN([BOLTHUR_KERNEL_SET_HOST], [
   AH_TEMPLATE([PRINT_SYSCALL], [Define to 1 to enable output of syscall initialization])
   AH_TEMPLATE([PRINT_SERIAL], [Define to 1 to enable output of serial handling])
   AH_TEMPLATE([PRINT_MM_SHARED], [Define to 1 to enable output of shared memory functions])
+  AH_TEMPLATE([PRINT_MM_IMAGE], [Define to 1 to enable output of demand paged image functions])
   AH_TEMPLATE([PRINT_MESSAGE], [Define to 1 to enable output of message functions])
   AH_TEMPLATE([PRINT_RPC], [Define to 1 to enable output of rpc functions])
   AH_TEMPLATE([PRINT_SSP], [Define to 1 to enable more info from ssp faults])
@@ -57,6 +58,11 @@ AC_DEFUN([BOLTHUR_KERNEL_SET_HOST], [
     AC_DEFINE([PRINT_MM_SHARED],[1])
   ])
 
+  # Test for demand paged image output
+  AS_IF([test "x$enable_output_mm_image" == "xyes"], [
+    AC_DEFINE([PRINT_MM_IMAGE],[1])
+  ])
+
   # Test for mailbox output
   AS_IF([test "x$enable_output_mailbox" == "xyes"], [
     AC_DEFINE([PRINT_MAILBOX], [1])
@@ -53,6 +53,10 @@ int main( int argc, char* argv[] ) {
   #endif
 
   char* file = argv[ 1 ];
+  // measure load time including relocation
+  #if defined( OUTPUT_ENABLE )
+    size_t load_start = _timer_get_tick();
+  #endif
   void* handle = dlopen( file, RTLD_NOW | RTLD_GLOBAL );
   if ( ! handle ) {
     EARLY_STARTUP_PRINT(
@@ -69,6 +73,14 @@ int main( int argc, char* argv[] ) {
       file,
       handle
     )
+    EARLY_STARTUP_PRINT(
+      "Loaded within %zu ticks, %zu symbol lookups, %zu from cache, "
+      "%zu relocations from prelink cache\r\n",
+      _timer_get_tick() - load_start,
+      dl_symbol_lookup_count,
+      dl_symbol_cache_hit,
+      dl_prelink_hit
+    )
   #endif
 
   // get main  object
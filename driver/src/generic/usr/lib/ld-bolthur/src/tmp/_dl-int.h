@@ -20,6 +20,10 @@
 // FIXME: RESTRICT TO COMPILING NEWLIB ONLY IF NECESSARY
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/types.h>
 #include <elf.h>
 #include <dlfcn.h>
 
@@ -35,9 +39,70 @@
     + ROUND_DOWN_TO_FULL_PAGE( ( a ) ) )
 #define ROUND_PAGE_OFFSET( a ) ( ( uintptr_t )( a ) & ( ( PAGE_SIZE ) -1 ) )
 
+// shared area registry of vfs, has to match RPC_VFS_SHARED_AREA of libvfs.h
+#define DL_RPC_VFS_SHARED_AREA ( RPC_CUSTOM_START + 10 )
+#define DL_SHARED_TEXT 0
+#define DL_SHARED_RELOCATION 1
+
+typedef struct {
+  uint32_t type;
+  int handle;
+  off_t offset;
+  size_t size;
+  size_t shm_id;
+} dl_shared_area_request_t;
+
+typedef struct {
+  int status;
+  size_t shm_id;
+} dl_shared_area_response_t;
+
+// read only file mapping, has to match RPC_VFS_MAP of libvfs.h
+#define DL_RPC_VFS_MAP ( RPC_CUSTOM_START + 11 )
+
+typedef struct {
+  int handle;
+  char file_path[ PATH_MAX ];
+  off_t offset;
+  size_t len;
+} dl_map_request_t;
+
+typedef struct {
+  int status;
+  size_t shm_id;
+  size_t offset;
+  size_t len;
+} dl_map_response_t;
+
+// relocation cache of executable and loaded libraries
+#define DL_PRELINK_MAGIC 0x4b4e4c50
+#define DL_PRELINK_OBJECT_MAX 16
+#define DL_PRELINK_NONE UINT32_MAX
+
+typedef struct {
+  uint32_t name_hash;
+  uint32_t memory_size;
+  off_t size;
+  time_t mtime;
+} dl_prelink_object_t;
+
+// resolved symbol as offset into defining object
+typedef struct {
+  uint32_t name_hash;
+  uint32_t object;
+  uint32_t offset;
+} dl_prelink_entry_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t object_count;
+  uint32_t entry_count;
+  dl_prelink_object_t object[ DL_PRELINK_OBJECT_MAX ];
+  dl_prelink_entry_t entry[];
+} dl_prelink_cache_t;
+
 typedef void ( *init_callback_t )( void );
 typedef void ( **init_array_callback_t )( void );
-typedef uint32_t ( *hash_callback_t )( const char* );
 typedef void ( *main_entry_point )( void );
 
 typedef enum {
@@ -72,6 +137,9 @@ struct dl_image_handle {
   // more general information for linking / loading
   char* memory_start;
   size_t memory_size;
+  // shared read only text area, 0 if mapped privately
+  size_t text_shm_id;
+  size_t text_size;
 
   // necessary elf section attributes
   Elf32_Dyn* dyn;
@@ -83,8 +151,15 @@ struct dl_image_handle {
     uint32_t* table;
     dl_image_hash_style_t style;
     uint32_t nbucket;
+    // amount of chain entries, limited by mapped memory for gnu hash
     uint32_t nchain;
-    hash_callback_t build;
+    uint32_t* bucket;
+    uint32_t* chain;
+    // gnu hash only
+    uint32_t symoffset;
+    uint32_t* bloom;
+    uint32_t bloom_size;
+    uint32_t bloom_shift;
   } hash;
   void* jmprel;
   uint32_t pltrel;
@@ -98,6 +173,21 @@ struct dl_image_handle {
   void** pltgot;
 };
 
+// resolved global symbols, valid until a library is unloaded
+#define DL_SYMBOL_CACHE_MIN 256
+
+typedef struct dl_symbol_cache_entry dl_symbol_cache_entry_t;
+typedef struct dl_symbol_cache_entry* dl_symbol_cache_entry_ptr_t;
+struct dl_symbol_cache_entry {
+  uint32_t hash;
+  const char* name;
+  void* value;
+};
+
+extern size_t dl_symbol_lookup_count;
+extern size_t dl_symbol_cache_hit;
+extern size_t dl_prelink_hit;
+
 dl_image_handle_ptr_t dl_find_loaded_library( const char* );
 int dl_lookup_library( char*, size_t, const char* );
 dl_image_handle_ptr_t dl_allocate_handle( void );
@@ -105,11 +195,22 @@ void dl_free_handle( dl_image_handle_ptr_t );
 dl_image_handle_ptr_t dl_load_entry( const char*, int, int );
 dl_image_handle_ptr_t dl_load_dependency( dl_image_handle_ptr_t );
 void* dl_map_load_section( void*, size_t, Elf32_Word, int, off_t );
+size_t dl_shared_area( dl_shared_area_request_t* );
+size_t dl_map_file( int, off_t, size_t );
+void* dl_map_shared_text( dl_image_handle_ptr_t, void*, size_t, off_t );
+int dl_unmap_image( dl_image_handle_ptr_t );
+int dl_memory_shared_seal( size_t );
+size_t dl_memory_shared_size( size_t );
+void dl_prelink_begin( int );
+void dl_prelink_add_object( dl_image_handle_ptr_t );
+void* dl_prelink_resolve( dl_image_handle_ptr_t, const char* );
+void dl_prelink_end( bool );
 dl_image_handle_ptr_t dl_relocate( dl_image_handle_ptr_t );
 void dl_handle_rel_symbol( dl_image_handle_ptr_t, void*, size_t );
 bool dl_handle_rel_relocate( dl_image_handle_ptr_t, void*, size_t );
 dl_image_handle_ptr_t dl_post_init( dl_image_handle_ptr_t );
 void* dl_lookup_symbol( dl_image_handle_ptr_t, const char* );
+void dl_symbol_cache_flush( void );
 void* dl_resolve_lazy( dl_image_handle_ptr_t, uint32_t );
 uintptr_t dl_resolve_stub( void );
 
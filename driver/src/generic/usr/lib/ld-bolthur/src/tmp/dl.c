@@ -78,6 +78,14 @@ dl_image_handle_ptr_t root_object_handle = NULL;
 
 static char dl_open_buffer[ PATH_MAX ];
 
+// global symbol cache
+static dl_symbol_cache_entry_ptr_t dl_symbol_cache = NULL;
+static uint32_t dl_symbol_cache_mask = 0;
+static uint32_t dl_symbol_cache_used = 0;
+// lookup statistics
+size_t dl_symbol_lookup_count = 0;
+size_t dl_symbol_cache_hit = 0;
+
 /**
  * @fn char dlerror*(void)
  * @brief Method to get the possible set error code of dynamic linking
@@ -165,7 +173,7 @@ char* dlerror( void ) {
 uint32_t dl_elf_symbol_name_hash( const char* name ) {
   uint32_t h = 0;
   while( *name ) {
-    h = ( h << 4 ) + *name++;
+    h = ( h << 4 ) + ( uint8_t )*name++;
     uint32_t g = h & 0xf0000000;
     if ( g ) {
       h ^= g >> 24;
@@ -176,8 +184,8 @@ uint32_t dl_elf_symbol_name_hash( const char* name ) {
 }
 
 /**
- * @fn uint32_t dl_elf_symbol_name_hash(const char*)
- * @brief Helper to build elf symbol name hash
+ * @fn uint32_t dl_gnu_symbol_name_hash(const char*)
+ * @brief Helper to build gnu symbol name hash
  *
  * @param name
  * @return
@@ -185,11 +193,198 @@ uint32_t dl_elf_symbol_name_hash( const char* name ) {
 uint32_t dl_gnu_symbol_name_hash( const char* name ) {
   uint32_t h = 5381;
   while( *name ) {
-    h = ( h << 5 ) + h + *name++;
+    h = ( h << 5 ) + h + ( uint8_t )*name++;
   }
   return h;
 }
 
+/**
+ * @fn void* dl_symbol_cache_get(uint32_t, const char*)
+ * @brief Get cached global symbol
+ *
+ * @param hash gnu hash of name
+ * @param name
+ * @return
+ */
+static void* dl_symbol_cache_get( uint32_t hash, const char* name ) {
+  if ( ! dl_symbol_cache ) {
+    return NULL;
+  }
+  uint32_t idx = hash & dl_symbol_cache_mask;
+  while ( dl_symbol_cache[ idx ].name ) {
+    dl_symbol_cache_entry_ptr_t entry = &dl_symbol_cache[ idx ];
+    if ( hash == entry->hash && 0 == strcmp( name, entry->name ) ) {
+      return entry->value;
+    }
+    idx = ( idx + 1 ) & dl_symbol_cache_mask;
+  }
+  return NULL;
+}
+
+/**
+ * @fn bool dl_symbol_cache_resize(uint32_t)
+ * @brief Resize symbol cache and rehash existing entries
+ *
+ * @param capacity power of two
+ * @return
+ */
+static bool dl_symbol_cache_resize( uint32_t capacity ) {
+  dl_symbol_cache_entry_ptr_t cache = malloc(
+    capacity * sizeof( dl_symbol_cache_entry_t )
+  );
+  if ( ! cache ) {
+    return false;
+  }
+  memset( cache, 0, capacity * sizeof( dl_symbol_cache_entry_t ) );
+  // rehash existing entries
+  for (
+    uint32_t old = 0;
+    dl_symbol_cache && old <= dl_symbol_cache_mask;
+    old++
+  ) {
+    if ( ! dl_symbol_cache[ old ].name ) {
+      continue;
+    }
+    uint32_t idx = dl_symbol_cache[ old ].hash & ( capacity - 1 );
+    while ( cache[ idx ].name ) {
+      idx = ( idx + 1 ) & ( capacity - 1 );
+    }
+    cache[ idx ] = dl_symbol_cache[ old ];
+  }
+  free( dl_symbol_cache );
+  dl_symbol_cache = cache;
+  dl_symbol_cache_mask = capacity - 1;
+  return true;
+}
+
+/**
+ * @fn void dl_symbol_cache_put(uint32_t, const char*, void*)
+ * @brief Add resolved global symbol to cache
+ *
+ * @param hash gnu hash of name
+ * @param name name within string table of defining object
+ * @param value
+ */
+static void dl_symbol_cache_put( uint32_t hash, const char* name, void* value ) {
+  // keep load factor at or below one half, cache is optional on failure
+  if (
+    ! dl_symbol_cache
+    || ( dl_symbol_cache_used + 1 ) * 2 > dl_symbol_cache_mask + 1
+  ) {
+    if ( ! dl_symbol_cache_resize(
+      dl_symbol_cache
+        ? ( dl_symbol_cache_mask + 1 ) * 2
+        : DL_SYMBOL_CACHE_MIN
+    ) ) {
+      return;
+    }
+  }
+  uint32_t idx = hash & dl_symbol_cache_mask;
+  while ( dl_symbol_cache[ idx ].name ) {
+    idx = ( idx + 1 ) & dl_symbol_cache_mask;
+  }
+  dl_symbol_cache[ idx ].hash = hash;
+  dl_symbol_cache[ idx ].name = name;
+  dl_symbol_cache[ idx ].value = value;
+  dl_symbol_cache_used++;
+}
+
+/**
+ * @fn void dl_symbol_cache_flush(void)
+ * @brief Drop symbol cache, necessary when a library is unloaded
+ */
+void dl_symbol_cache_flush( void ) {
+  free( dl_symbol_cache );
+  dl_symbol_cache = NULL;
+  dl_symbol_cache_mask = 0;
+  dl_symbol_cache_used = 0;
+}
+
+/**
+ * @fn Elf32_Sym* dl_lookup_symbol_sysv(dl_image_handle_ptr_t, const char*, uint32_t)
+ * @brief Lookup symbol within system v hash table
+ *
+ * @param handle
+ * @param name
+ * @param hash
+ * @return
+ */
+static Elf32_Sym* dl_lookup_symbol_sysv(
+  dl_image_handle_ptr_t handle,
+  const char* name,
+  uint32_t hash
+) {
+  uint32_t index = handle->hash.bucket[ hash % handle->hash.nbucket ];
+  // amount of steps is limited to prevent endless loops on broken chains
+  for (
+    uint32_t step = 0;
+    STN_UNDEF != index && index < handle->hash.nchain
+      && step < handle->hash.nchain;
+    step++
+  ) {
+    Elf32_Sym* sym = &handle->symtab[ index ];
+    if (
+      sym->st_name < handle->strsz
+      && 0 == strcmp( handle->strtab + sym->st_name, name )
+    ) {
+      return sym;
+    }
+    index = handle->hash.chain[ index ];
+  }
+  return NULL;
+}
+
+/**
+ * @fn Elf32_Sym* dl_lookup_symbol_gnu(dl_image_handle_ptr_t, const char*, uint32_t)
+ * @brief Lookup symbol within gnu hash table
+ *
+ * @param handle
+ * @param name
+ * @param hash
+ * @return
+ */
+static Elf32_Sym* dl_lookup_symbol_gnu(
+  dl_image_handle_ptr_t handle,
+  const char* name,
+  uint32_t hash
+) {
+  // bloom filter with two bits per symbol rejects most misses early
+  uint32_t word = handle->hash.bloom[
+    ( hash / 32 ) & ( handle->hash.bloom_size - 1 )
+  ];
+  uint32_t mask = ( 1U << ( hash % 32 ) )
+    | ( 1U << ( ( hash >> handle->hash.bloom_shift ) % 32 ) );
+  if ( ( word & mask ) != mask ) {
+    return NULL;
+  }
+  uint32_t index = handle->hash.bucket[ hash % handle->hash.nbucket ];
+  if ( ! index || index < handle->hash.symoffset ) {
+    return NULL;
+  }
+  // chain holds hashes of sorted symbols, last one of bucket has bit 0 set
+  for (
+    uint32_t chain = index - handle->hash.symoffset;
+    chain < handle->hash.nchain;
+    chain++
+  ) {
+    uint32_t chain_hash = handle->hash.chain[ chain ];
+    // compare hash before name
+    if ( ( hash | 1 ) == ( chain_hash | 1 ) ) {
+      Elf32_Sym* sym = &handle->symtab[ chain + handle->hash.symoffset ];
+      if (
+        sym->st_name < handle->strsz
+        && 0 == strcmp( handle->strtab + sym->st_name, name )
+      ) {
+        return sym;
+      }
+    }
+    if ( chain_hash & 1 ) {
+      break;
+    }
+  }
+  return NULL;
+}
+
 /**
  * @fn void dl_lookup_symbol*(dl_image_handle_ptr_t, const char*)
  * @brief Helper to lookup a symbol
@@ -198,58 +393,60 @@ uint32_t dl_gnu_symbol_name_hash( const char* name ) {
  * @param name
  */
 void* dl_lookup_symbol( dl_image_handle_ptr_t handle, const char* name ) {
-  void* found_symbol = NULL;
   dl_image_handle_ptr_t current = handle;
   if ( ! handle ) {
     current = root_object_handle;
   }
+  // only lookups within global scope are cached
+  bool global = current && current == root_object_handle;
+  // hashes are built once per lookup
+  uint32_t gnu_hash = dl_gnu_symbol_name_hash( name );
+  uint32_t sysv_hash = 0;
+  bool sysv_built = false;
+  dl_symbol_lookup_count++;
+  if ( global ) {
+    void* cached = dl_symbol_cache_get( gnu_hash, name );
+    if ( cached ) {
+      dl_symbol_cache_hit++;
+      return cached;
+    }
+  }
   // loop through handles
-  while ( current && ! found_symbol ) {
-    // get hash from name
-    uint32_t hash = current->hash.build( name );
-    uint32_t nbucket = current->hash.nbucket;
-    uint32_t nchain = current->hash.nchain;
-    uint32_t* buckets = &current->hash.table[ 2 ];
-    uint32_t* chain = &current->hash.table[ 2 + nbucket ];
-    uint32_t index = buckets[ hash % nbucket ];
-    while ( index != STN_UNDEF) {
-      // skip if wrong
-      if ( index > nchain) {
-        break;
-      }
-      // get symbol
-      Elf32_Sym* sym = &current->symtab[ index ];
-      // skip if wrong
-      if ( sym->st_name > current->strsz ) {
-        break;
-      }
-      // get symbol name
-      const char* sym_name = current->strtab + sym->st_name;
-      // check for matching symbol
-      if ( 0 == strcmp( sym_name, name ) ) {
-        // check for not undefined
-        if ( sym->st_shndx != SHN_UNDEF ) {
-          // set found symbol to value
-          found_symbol = ( void* )sym->st_value;
-          // apply relocation offset if relocated
-          if ( current->relocated ) {
-            found_symbol = ( void* )( current->memory_start
-              + ( uint32_t )found_symbol );
-          }
-          break;
-        } else {
-          // undefined symbol
-          break;
-        }
+  for ( ; current; current = current->next ) {
+    Elf32_Sym* sym;
+    if ( DL_IMAGE_HASH_STYLE_GNU == current->hash.style ) {
+      sym = dl_lookup_symbol_gnu( current, name, gnu_hash );
+    } else {
+      if ( ! sysv_built ) {
+        sysv_hash = dl_elf_symbol_name_hash( name );
+        sysv_built = true;
       }
-      // next index
-      index = chain[ index ];
+      sym = dl_lookup_symbol_sysv( current, name, sysv_hash );
     }
-    // next handle
-    current = current->next;
+    // undefined symbols are resolved by another object
+    if ( ! sym || SHN_UNDEF == sym->st_shndx ) {
+      continue;
+    }
+    // set found symbol to value
+    void* found_symbol = ( void* )sym->st_value;
+    // apply relocation offset if relocated
+    if ( current->relocated ) {
+      found_symbol = ( void* )( current->memory_start
+        + ( uint32_t )found_symbol );
+    }
+    if ( ! found_symbol ) {
+      continue;
+    }
+    if ( global ) {
+      dl_symbol_cache_put(
+        gnu_hash,
+        current->strtab + sym->st_name,
+        found_symbol
+      );
+    }
+    return found_symbol;
   }
-  // return found symbol
-  return found_symbol;
+  return NULL;
 }
 
 /**
@@ -392,14 +589,14 @@ void dl_free_handle( dl_image_handle_ptr_t handle ) {
   if ( handle->previous ) {
     handle->previous->next = handle->next;
   }
+  // cached symbols may reference the handle
+  dl_symbol_cache_flush();
   // free inner allocations
   free( handle->filename );
   // close descriptor
   close( handle->descriptor );
   // unmap without success check
-  if ( handle->memory_start ) {
-    munmap( handle->memory_start, handle->memory_size );
-  }
+  dl_unmap_image( handle );
   // free handle itself
   free( handle );
 }
@@ -489,6 +686,301 @@ void* dl_map_load_section(
   return mmap( base, size, prot, mapping, descriptor, offset );
 }
 
+/**
+ * @fn bool dl_text_relocation(dl_image_handle_ptr_t, Elf32_Phdr*)
+ * @brief Check dynamic section within file for relocations within text
+ *
+ * @param handle
+ * @param dyn
+ * @return true if text needs relocations or on error
+ */
+static bool dl_text_relocation(
+  dl_image_handle_ptr_t handle,
+  Elf32_Phdr* dyn
+) {
+  Elf32_Dyn entry;
+  if ( ! dyn ) {
+    return false;
+  }
+  if ( -1 == lseek( handle->descriptor, ( off_t )dyn->p_offset, SEEK_SET ) ) {
+    return true;
+  }
+  for (
+    size_t idx = 0;
+    idx < dyn->p_filesz / sizeof( Elf32_Dyn );
+    idx++
+  ) {
+    if ( sizeof( entry ) != read( handle->descriptor, &entry, sizeof( entry ) ) ) {
+      return true;
+    }
+    if ( DT_NULL == entry.d_tag ) {
+      break;
+    }
+    if (
+      DT_TEXTREL == entry.d_tag
+      || ( DT_FLAGS == entry.d_tag && entry.d_un.d_val & DF_TEXTREL )
+    ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @fn size_t dl_shared_area(dl_shared_area_request_t*)
+ * @brief Lookup or publish shared area at vfs
+ *
+ * @param request
+ * @return registered area or 0
+ */
+size_t dl_shared_area( dl_shared_area_request_t* request ) {
+  dl_shared_area_response_t response;
+  size_t response_id = bolthur_rpc_raise(
+    DL_RPC_VFS_SHARED_AREA,
+    VFS_DAEMON_ID,
+    request,
+    sizeof( *request ),
+    true,
+    false,
+    DL_RPC_VFS_SHARED_AREA,
+    request,
+    sizeof( *request ),
+    0,
+    0
+  );
+  if ( errno ) {
+    return 0;
+  }
+  memset( &response, 0, sizeof( response ) );
+  _rpc_get_data( &response, sizeof( response ), response_id, false );
+  if ( errno || 0 > response.status ) {
+    return 0;
+  }
+  return response.shm_id;
+}
+
+/**
+ * @fn size_t dl_map_file(int, off_t, size_t)
+ * @brief Request read only area of file pages from handling process
+ *
+ * @param descriptor
+ * @param offset
+ * @param size
+ * @return sealed area starting exactly at offset or 0
+ */
+size_t dl_map_file( int descriptor, off_t offset, size_t size ) {
+  dl_map_request_t* request = malloc( sizeof( *request ) );
+  dl_map_response_t response;
+  if ( ! request ) {
+    return 0;
+  }
+  memset( request, 0, sizeof( *request ) );
+  request->handle = descriptor;
+  request->offset = offset;
+  request->len = size;
+  size_t response_id = bolthur_rpc_raise(
+    DL_RPC_VFS_MAP,
+    VFS_DAEMON_ID,
+    request,
+    sizeof( *request ),
+    true,
+    false,
+    DL_RPC_VFS_MAP,
+    request,
+    sizeof( *request ),
+    0,
+    0
+  );
+  free( request );
+  if ( errno ) {
+    return 0;
+  }
+  memset( &response, 0, sizeof( response ) );
+  _rpc_get_data( &response, sizeof( response ), response_id, false );
+  if ( errno || 0 > response.status || 0 == response.shm_id ) {
+    return 0;
+  }
+  // only usable when file data starts page aligned and covers whole range,
+  // otherwise release the never attached area again
+  if ( 0 != response.offset || size != response.len ) {
+    _memory_shared_detach( response.shm_id );
+    return 0;
+  }
+  return response.shm_id;
+}
+
+/**
+ * @fn void dl_map_shared_text*(dl_image_handle_ptr_t, void*, size_t, off_t)
+ * @brief Map read only text shared between processes loading the same file
+ *
+ * @param handle
+ * @param base
+ * @param size
+ * @param offset
+ * @return
+ */
+void* dl_map_shared_text(
+  dl_image_handle_ptr_t handle,
+  void* base,
+  size_t size,
+  off_t offset
+) {
+  dl_shared_area_request_t request = {
+    .type = DL_SHARED_TEXT,
+    .handle = handle->descriptor,
+    .offset = offset,
+    .size = size,
+  };
+  // attach already loaded text
+  size_t id = dl_shared_area( &request );
+  if ( id ) {
+    char* memory = _memory_shared_attach( id, ( uintptr_t )base );
+    if ( ! errno ) {
+      EARLY_STARTUP_PRINT( "attached shared text %zu at %p\r\n", id, memory )
+      handle->text_shm_id = id;
+      handle->text_size = size;
+      return memory;
+    }
+  }
+  // use pages of the file directly if the handling process provides them,
+  // vfs registers them as shared text for further loads
+  id = dl_map_file( handle->descriptor, offset, size );
+  if ( id ) {
+    char* memory = _memory_shared_attach( id, ( uintptr_t )base );
+    if ( ! errno ) {
+      EARLY_STARTUP_PRINT( "mapped file text %zu at %p\r\n", id, memory )
+      handle->text_shm_id = id;
+      handle->text_size = size;
+      return memory;
+    }
+    _memory_shared_detach( id );
+  }
+  // create new private area and fill it from file
+  id = _memory_shared_create( size );
+  if ( errno ) {
+    return MAP_FAILED;
+  }
+  char* memory = _memory_shared_attach( id, ( uintptr_t )base );
+  if ( errno ) {
+    _memory_shared_detach( id );
+    return MAP_FAILED;
+  }
+  if ( -1 == lseek( handle->descriptor, offset, SEEK_SET ) ) {
+    _memory_shared_detach( id );
+    return MAP_FAILED;
+  }
+  size_t total = 0;
+  while ( total < size ) {
+    ssize_t r = read( handle->descriptor, memory + total, size - total );
+    if ( 0 > r ) {
+      _memory_shared_detach( id );
+      return MAP_FAILED;
+    }
+    // end of file
+    if ( 0 == r ) {
+      break;
+    }
+    total += ( size_t )r;
+  }
+  memset( memory + total, 0, size - total );
+  // make it read only like text mapped from file
+  if ( 0 != dl_memory_shared_seal( id ) ) {
+    _memory_shared_detach( id );
+    return MAP_FAILED;
+  }
+  EARLY_STARTUP_PRINT( "created shared text %zu at %p\r\n", id, memory )
+  handle->text_shm_id = id;
+  handle->text_size = size;
+  return memory;
+}
+
+/**
+ * @fn int dl_unmap_image(dl_image_handle_ptr_t)
+ * @brief Unmap loaded image, shared text is detached
+ *
+ * @param handle
+ * @return
+ */
+int dl_unmap_image( dl_image_handle_ptr_t handle ) {
+  int result = 0;
+  if ( ! handle->memory_start ) {
+    return 0;
+  }
+  if ( handle->text_shm_id ) {
+    _memory_shared_detach( handle->text_shm_id );
+    if ( handle->memory_size > handle->text_size ) {
+      result = munmap(
+        handle->memory_start + handle->text_size,
+        handle->memory_size - handle->text_size
+      );
+    }
+  } else {
+    result = munmap( handle->memory_start, handle->memory_size );
+  }
+  handle->memory_start = NULL;
+  handle->text_shm_id = 0;
+  return result;
+}
+
+/**
+ * @fn bool dl_setup_hash(dl_image_handle_ptr_t, Elf32_Addr, dl_image_hash_style_t)
+ * @brief Validate and populate hash table information of handle
+ *
+ * @param handle
+ * @param hash offset of hash table within mapped image
+ * @param style
+ * @return
+ */
+static bool dl_setup_hash(
+  dl_image_handle_ptr_t handle,
+  Elf32_Addr hash,
+  dl_image_hash_style_t style
+) {
+  if ( ! style || hash > handle->memory_size - 16 ) {
+    return false;
+  }
+  uint32_t* table = ( uint32_t* )( handle->memory_start + hash );
+  uint32_t available = ( uint32_t )( ( handle->memory_size - hash ) / 4 );
+  handle->hash.table = table;
+  handle->hash.style = style;
+  handle->hash.nbucket = table[ 0 ];
+  if ( ! handle->hash.nbucket ) {
+    return false;
+  }
+  if ( DL_IMAGE_HASH_STYLE_GNU == style ) {
+    // header followed by bloom filter, buckets and chain
+    handle->hash.symoffset = table[ 1 ];
+    handle->hash.bloom_size = table[ 2 ];
+    handle->hash.bloom_shift = table[ 3 ];
+    if (
+      ! handle->hash.bloom_size
+      || handle->hash.bloom_size & ( handle->hash.bloom_size - 1 )
+      || handle->hash.bloom_shift >= 32
+      || handle->hash.bloom_size > available - 4
+      || handle->hash.nbucket > available - 4 - handle->hash.bloom_size
+    ) {
+      return false;
+    }
+    handle->hash.bloom = table + 4;
+    handle->hash.bucket = handle->hash.bloom + handle->hash.bloom_size;
+    handle->hash.chain = handle->hash.bucket + handle->hash.nbucket;
+    // chain length isn't stored, so it's limited by mapped memory
+    handle->hash.nchain = available - 4 - handle->hash.bloom_size
+      - handle->hash.nbucket;
+    return true;
+  }
+  handle->hash.nchain = table[ 1 ];
+  if (
+    handle->hash.nbucket > UINT32_MAX - handle->hash.nchain
+    || handle->hash.nbucket + handle->hash.nchain > available - 2
+  ) {
+    return false;
+  }
+  handle->hash.bucket = table + 2;
+  handle->hash.chain = handle->hash.bucket + handle->hash.nbucket;
+  return true;
+}
+
 /**
  * @fn dl_image_handle_ptr_t dl_load_entry(const char*, int, int)
  * @brief Helper to load handle
@@ -497,8 +989,6 @@ void* dl_map_load_section(
  * @param mode
  * @param descriptor
  * @return
- *
- * @todo map library read-only code into shared object
  */
 dl_image_handle_ptr_t dl_load_entry(
   const char* file,
@@ -683,15 +1173,29 @@ dl_image_handle_ptr_t dl_load_entry(
       load_header[ 1 ].p_memsz, load_header[ 1 ].p_filesz
     )
 
-    // map text section with data size to get everything loaded correctly
-    // FIXME: MAP SECTION IN CASE OF DEPENDENCY INTO SHARED AREA
-    memory = dl_map_load_section(
-      ( void* )text_address,
-      text_size,
-      load_header[ 0 ].p_flags,
-      handle->descriptor,
-      text_offset
-    );
+    // share read only text without relocations between processes
+    memory = MAP_FAILED;
+    if (
+      ! ( load_header[ 0 ].p_flags & PF_W )
+      && ! dl_text_relocation( handle, dyn )
+    ) {
+      memory = dl_map_shared_text(
+        handle,
+        ( void* )text_address,
+        text_size,
+        text_offset
+      );
+    }
+    // map text section privately as fallback
+    if ( memory == MAP_FAILED ) {
+      memory = dl_map_load_section(
+        ( void* )text_address,
+        text_size,
+        load_header[ 0 ].p_flags,
+        handle->descriptor,
+        text_offset
+      );
+    }
     if ( memory == MAP_FAILED ) {
       dl_error = E_DL_NO_MEMORY;
       dl_free_handle( handle );
@@ -702,8 +1206,7 @@ dl_image_handle_ptr_t dl_load_entry(
       ( uintptr_t )memory, text_size, text_offset,
       ( void* )( memory + load_header[ 1 ].p_vaddr - load_header[ 0 ].p_vaddr )
     )
-    // map data section again with only file size
-    // FIXME: MAP SECTION IN CASE OF DEPENDENCY INTO SHARED AREA
+    // map data section privately with only file size
     data = dl_map_load_section(
       ( void* )( memory + data_address - text_address ),
       data_file_size,
@@ -783,7 +1286,6 @@ dl_image_handle_ptr_t dl_load_entry(
     Elf32_Addr symtab = 0;
     Elf32_Addr hash = 0;
     dl_image_hash_style_t hash_style = 0;
-    hash_callback_t build = NULL;
     Elf32_Addr jmprel = 0;
     Elf32_Word pltrel = 0;
     Elf32_Word pltrelsz = 0;
@@ -811,14 +1313,15 @@ dl_image_handle_ptr_t dl_load_entry(
           strsz = current->d_un.d_val;
           break;
         case DT_HASH:
-          hash = current->d_un.d_ptr - ( uintptr_t )load_header[ 0 ].p_vaddr;
-          hash_style = DL_IMAGE_HASH_STYLE_SYSTEM_V;
-          build = dl_elf_symbol_name_hash;
+          // gnu hash is preferred when both are present
+          if ( DL_IMAGE_HASH_STYLE_GNU != hash_style ) {
+            hash = current->d_un.d_ptr - ( uintptr_t )load_header[ 0 ].p_vaddr;
+            hash_style = DL_IMAGE_HASH_STYLE_SYSTEM_V;
+          }
           break;
         case DT_GNU_HASH:
           hash = current->d_un.d_ptr - ( uintptr_t )load_header[ 0 ].p_vaddr;
           hash_style = DL_IMAGE_HASH_STYLE_GNU;
-          build = dl_gnu_symbol_name_hash;
           break;
         case DT_SYMTAB:
           symtab = current->d_un.d_ptr - ( uintptr_t )load_header[ 0 ].p_vaddr;
@@ -910,21 +1413,7 @@ dl_image_handle_ptr_t dl_load_entry(
     handle->symtab = ( Elf32_Sym* )( handle->memory_start + symtab );
 
     // hash table
-    if ( hash > handle->memory_size - 8 ) {
-      dl_error = E_DL_MALFORMED;
-      dl_free_handle( handle );
-      return NULL;
-    }
-    handle->hash.table = ( uint32_t* )( handle->memory_start + hash );
-    handle->hash.style = hash_style;
-    handle->hash.nbucket = handle->hash.table[ 0 ];
-    handle->hash.nchain = handle->hash.table[ 1 ];
-    handle->hash.build = build;
-    // validate
-    if (
-      handle->hash.nbucket > UINT32_MAX - handle->hash.nchain
-      || handle->hash.nbucket + handle->hash.nchain > ( handle->memory_size - hash ) / 4
-    ) {
+    if ( ! dl_setup_hash( handle, hash, hash_style ) ) {
       dl_error = E_DL_MALFORMED;
       dl_free_handle( handle );
       return NULL;
@@ -991,6 +1480,8 @@ dl_image_handle_ptr_t dl_load_entry(
   }
   // free load header again
   free( load_header );
+  // validate against relocation cache
+  dl_prelink_add_object( handle );
   // return with load of dependencies
   return dl_load_dependency( handle );
 }
@@ -1068,7 +1559,7 @@ void dl_handle_rel_symbol( dl_image_handle_ptr_t handle, void* address, size_t s
       uint32_t symbol_index = ELF32_R_SYM( rel->r_info );
       // get symbol name and symbol by name
       char* symbol_name = handle->strtab + handle->symtab[ symbol_index ].st_name;
-      void* symbol_value = dlsym( NULL, symbol_name );
+      void* symbol_value = dl_prelink_resolve( NULL, symbol_name );
       // handle no symbol found!
       if ( ! symbol_value ) {
         continue;
@@ -1123,16 +1614,16 @@ bool dl_handle_rel_relocate( dl_image_handle_ptr_t handle, void* address, size_t
       new_address = *relocation;
     } else if ( R_ARM_COPY == symbol_type ) {
       size_t copy_size = handle->symtab[ symbol_index ].st_size;
-      void* from = dlsym( handle->next, name );
+      void* from = dl_prelink_resolve( handle->next, name );
       memcpy( relocation, from, copy_size );
     } else if ( R_ARM_GLOB_DAT == symbol_type ) {
-      new_address = ( uintptr_t )dlsym( handle, name );
+      new_address = ( uintptr_t )dl_prelink_resolve( handle, name );
     } else if ( R_ARM_ABS32 == symbol_type ) {
       uint32_t val = handle->symtab[ symbol_type ].st_value;
       if ( val ) {
         new_address = ( uintptr_t )( handle->memory_start + val );
       } else {
-        new_address = ( uintptr_t )dlsym( NULL, name );
+        new_address = ( uintptr_t )dl_prelink_resolve( NULL, name );
       }
     } else if (
       R_ARM_JUMP_SLOT == symbol_type
@@ -1256,15 +1747,27 @@ void* dlopen( const char* file, int mode ) {
       dl_error = E_DL_CANNOT_OPEN;
       return NULL;
     }
+    // relocation cache covers executable and everything loaded with it
+    bool prelink = ! root_object_handle;
+    if ( prelink ) {
+      dl_prelink_begin( fd );
+    }
     // load given handle with dependencies
     dl_image_handle_ptr_t handle = dl_load_entry( p, mode, fd );
     // handle error
     if ( ! handle ) {
+      if ( prelink ) {
+        dl_prelink_end( false );
+      }
       close( fd );
       return NULL;
     }
-    // return with possible relocation
-    return dl_relocate( handle );
+    // relocate and finish recording
+    handle = dl_relocate( handle );
+    if ( prelink ) {
+      dl_prelink_end( NULL != handle );
+    }
+    return handle;
   }
   // no file parameter? => return current root handle
   return root_object_handle;
@@ -1316,7 +1819,7 @@ static int dl_close( dl_image_handle_ptr_t handle ) {
   }
 
   // unmap memory
-  if ( -1 == munmap( handle->memory_start, handle->memory_size ) ) {
+  if ( -1 == dl_unmap_image( handle ) ) {
     return -1;
   }
   // remove handle from list
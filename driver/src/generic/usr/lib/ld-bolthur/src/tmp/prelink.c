@@ -0,0 +1,295 @@
+/**
+ * Copyright (C) 2018 - 2022 bolthur project.
+ *
+ * This file is part of bolthur/kernel.
+ *
+ * bolthur/kernel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * bolthur/kernel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with bolthur/kernel.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/bolthur.h>
+#include "_dl-int.h"
+
+// FIXME: PUSH VARIABLES TO REENT WHEN IMPORTING TO NEWLIB
+size_t dl_prelink_hit = 0;
+
+// descriptor of executable the cache belongs to
+static int dl_prelink_descriptor = -1;
+// recording in progress
+static bool dl_prelink_active = false;
+// cache matches everything loaded and resolved so far
+static bool dl_prelink_valid = false;
+// attached cache of previous start
+static dl_prelink_cache_t* dl_prelink_cache = NULL;
+static size_t dl_prelink_cache_id = 0;
+// loaded objects and resolved symbols of current start
+static dl_image_handle_ptr_t dl_prelink_handle[ DL_PRELINK_OBJECT_MAX ];
+static dl_prelink_object_t dl_prelink_object[ DL_PRELINK_OBJECT_MAX ];
+static uint32_t dl_prelink_object_count = 0;
+static dl_prelink_entry_t* dl_prelink_entry = NULL;
+static uint32_t dl_prelink_entry_count = 0;
+static uint32_t dl_prelink_entry_capacity = 0;
+
+/**
+ * @fn void dl_prelink_record(uint32_t, uint32_t, uint32_t)
+ * @brief Append resolved symbol, stops recording on error
+ *
+ * @param name_hash
+ * @param object
+ * @param offset
+ */
+static void dl_prelink_record(
+  uint32_t name_hash,
+  uint32_t object,
+  uint32_t offset
+) {
+  if ( dl_prelink_entry_count == dl_prelink_entry_capacity ) {
+    uint32_t capacity = dl_prelink_entry_capacity
+      ? dl_prelink_entry_capacity * 2 : 64;
+    dl_prelink_entry_t* entry = realloc(
+      dl_prelink_entry,
+      capacity * sizeof( *entry )
+    );
+    if ( ! entry ) {
+      dl_prelink_end( false );
+      return;
+    }
+    dl_prelink_entry = entry;
+    dl_prelink_entry_capacity = capacity;
+  }
+  dl_prelink_entry[ dl_prelink_entry_count ].name_hash = name_hash;
+  dl_prelink_entry[ dl_prelink_entry_count ].object = object;
+  dl_prelink_entry[ dl_prelink_entry_count ].offset = offset;
+  dl_prelink_entry_count++;
+}
+
+/**
+ * @fn void dl_prelink_publish(void)
+ * @brief Create relocation cache of current start and publish it at vfs
+ */
+static void dl_prelink_publish( void ) {
+  size_t size = sizeof( dl_prelink_cache_t )
+    + dl_prelink_entry_count * sizeof( dl_prelink_entry_t );
+  size_t id = _memory_shared_create( size );
+  if ( errno ) {
+    return;
+  }
+  dl_prelink_cache_t* cache = _memory_shared_attach( id, ( uintptr_t )NULL );
+  if ( errno ) {
+    _memory_shared_detach( id );
+    return;
+  }
+  memset( cache, 0, sizeof( *cache ) );
+  cache->magic = DL_PRELINK_MAGIC;
+  cache->object_count = dl_prelink_object_count;
+  cache->entry_count = dl_prelink_entry_count;
+  memcpy(
+    cache->object,
+    dl_prelink_object,
+    dl_prelink_object_count * sizeof( dl_prelink_object_t )
+  );
+  memcpy(
+    cache->entry,
+    dl_prelink_entry,
+    dl_prelink_entry_count * sizeof( dl_prelink_entry_t )
+  );
+  // publish sealed cache, vfs keeps a reference
+  if ( 0 == dl_memory_shared_seal( id ) ) {
+    dl_shared_area_request_t request = {
+      .type = DL_SHARED_RELOCATION,
+      .handle = dl_prelink_descriptor,
+      .size = size,
+      .shm_id = id,
+    };
+    dl_shared_area( &request );
+  }
+  _memory_shared_detach( id );
+}
+
+/**
+ * @fn void dl_prelink_begin(int)
+ * @brief Start recording of relocations and attach cache of executable
+ *
+ * @param descriptor
+ */
+void dl_prelink_begin( int descriptor ) {
+  dl_prelink_descriptor = descriptor;
+  dl_prelink_active = true;
+  dl_prelink_valid = false;
+  dl_prelink_object_count = 0;
+  dl_prelink_entry_count = 0;
+  // lookup cache of previous start
+  dl_shared_area_request_t request = {
+    .type = DL_SHARED_RELOCATION,
+    .handle = descriptor,
+  };
+  size_t id = dl_shared_area( &request );
+  if ( ! id ) {
+    return;
+  }
+  dl_prelink_cache_t* cache = _memory_shared_attach( id, ( uintptr_t )NULL );
+  if ( errno ) {
+    return;
+  }
+  dl_prelink_cache = cache;
+  dl_prelink_cache_id = id;
+  // header and all entries have to be within the area
+  size_t size = dl_memory_shared_size( id );
+  dl_prelink_valid = sizeof( *cache ) <= size
+    && DL_PRELINK_MAGIC == cache->magic
+    && DL_PRELINK_OBJECT_MAX >= cache->object_count
+    && cache->entry_count <= ( size - sizeof( *cache ) )
+      / sizeof( dl_prelink_entry_t );
+}
+
+/**
+ * @fn void dl_prelink_add_object(dl_image_handle_ptr_t)
+ * @brief Add loaded object and validate it against the cache
+ *
+ * @param handle
+ */
+void dl_prelink_add_object( dl_image_handle_ptr_t handle ) {
+  struct stat st;
+  if ( ! dl_prelink_active ) {
+    return;
+  }
+  if (
+    DL_PRELINK_OBJECT_MAX <= dl_prelink_object_count
+    || -1 == fstat( handle->descriptor, &st )
+  ) {
+    dl_prelink_end( false );
+    return;
+  }
+  dl_prelink_object_t* object = &dl_prelink_object[ dl_prelink_object_count ];
+  memset( object, 0, sizeof( *object ) );
+  object->name_hash = dl_elf_symbol_name_hash( handle->filename );
+  object->memory_size = ( uint32_t )handle->memory_size;
+  object->size = st.st_size;
+  object->mtime = st.st_mtime;
+  dl_prelink_handle[ dl_prelink_object_count ] = handle;
+  // cached symbols are only valid while all objects match
+  if (
+    dl_prelink_valid
+    && (
+      dl_prelink_object_count >= dl_prelink_cache->object_count
+      || 0 != memcmp(
+        object,
+        &dl_prelink_cache->object[ dl_prelink_object_count ],
+        sizeof( *object )
+      )
+    )
+  ) {
+    dl_prelink_valid = false;
+  }
+  dl_prelink_object_count++;
+}
+
+/**
+ * @fn void dl_prelink_resolve*(dl_image_handle_ptr_t, const char*)
+ * @brief Resolve symbol for relocation, served from cache if valid
+ *
+ * @param handle lookup scope passed to dlsym
+ * @param name
+ * @return
+ */
+void* dl_prelink_resolve( dl_image_handle_ptr_t handle, const char* name ) {
+  if ( ! dl_prelink_active ) {
+    return dlsym( handle, name );
+  }
+  uint32_t name_hash = dl_elf_symbol_name_hash( name );
+  // apply cached result of same symbol within a loaded object, absolute
+  // values are never taken from cache, only unresolved ones
+  if (
+    dl_prelink_valid
+    && dl_prelink_entry_count < dl_prelink_cache->entry_count
+  ) {
+    dl_prelink_entry_t* entry = &dl_prelink_cache->entry[
+      dl_prelink_entry_count ];
+    if (
+      entry->name_hash == name_hash
+      && (
+        ( DL_PRELINK_NONE == entry->object && 0 == entry->offset )
+        || (
+          entry->object < dl_prelink_object_count
+          && entry->offset < dl_prelink_handle[ entry->object ]->memory_size
+        )
+      )
+    ) {
+      void* value = DL_PRELINK_NONE == entry->object
+        ? NULL
+        : dl_prelink_handle[ entry->object ]->memory_start + entry->offset;
+      dl_prelink_hit++;
+      dl_prelink_record( name_hash, entry->object, entry->offset );
+      return value;
+    }
+  }
+  // cache exhausted or broken, fall back to lookup
+  dl_prelink_valid = false;
+  void* value = dlsym( handle, name );
+  // encode as offset into defining object
+  uint32_t object = DL_PRELINK_NONE;
+  uint32_t offset = ( uint32_t )( uintptr_t )value;
+  for ( uint32_t idx = 0; value && idx < dl_prelink_object_count; idx++ ) {
+    char* start = dl_prelink_handle[ idx ]->memory_start;
+    if (
+      ( char* )value >= start
+      && ( char* )value < start + dl_prelink_handle[ idx ]->memory_size
+    ) {
+      object = idx;
+      offset = ( uint32_t )( ( char* )value - start );
+      break;
+    }
+  }
+  dl_prelink_record( name_hash, object, offset );
+  return value;
+}
+
+/**
+ * @fn void dl_prelink_end(bool)
+ * @brief Stop recording, publishes a new cache if the old one didn't match
+ *
+ * @param success
+ */
+void dl_prelink_end( bool success ) {
+  if ( ! dl_prelink_active ) {
+    return;
+  }
+  dl_prelink_active = false;
+  if (
+    success
+    && (
+      ! dl_prelink_valid
+      || dl_prelink_object_count != dl_prelink_cache->object_count
+      || dl_prelink_entry_count != dl_prelink_cache->entry_count
+    )
+  ) {
+    dl_prelink_publish();
+  }
+  if ( dl_prelink_cache ) {
+    _memory_shared_detach( dl_prelink_cache_id );
+    dl_prelink_cache = NULL;
+    dl_prelink_cache_id = 0;
+  }
+  free( dl_prelink_entry );
+  dl_prelink_entry = NULL;
+  dl_prelink_entry_count = 0;
+  dl_prelink_entry_capacity = 0;
+  dl_prelink_valid = false;
+  dl_prelink_descriptor = -1;
+}
@@ -133,6 +133,117 @@ scan_directory( font, "PC Screen Font", "", sysroot, false )
 scan_directory( server, "ELF", "executable", sysroot, false )
 scan_directory( driver, "ELF", "executable", sysroot, false )
 
+# ramdisk index, has to match server/boot/ramdisk.h
+const index_name: string = "ramdisk.idx"
+const index_magic: string = "BRDIDX01"
+
+proc add_u32( s: var string, value: uint32 ): void =
+  for i in 0 ..< 4:
+    s.add( char( ( value shr ( 8 * i ) ) and 0xff ) )
+
+proc fnv1a( path: string ): uint32 =
+  result = 0x811c9dc5'u32
+  for c in path:
+    result = ( result xor uint32( ord( c ) ) ) * 0x01000193'u32
+
+proc tar_field( header: string, offset: int, length: int ): string =
+  result = header[ offset ..< offset + length ].split( '\0' )[ 0 ]
+
+proc tar_octal( header: string, offset: int, length: int ): int =
+  let value = tar_field( header, offset, length ).strip()
+  if "" == value: return 0
+  result = parseOctInt( value )
+
+proc tar_header( name: string, size: int ): string =
+  result = newString( 512 )
+  proc put( s: var string, offset: int, value: string ) =
+    for idx, c in value: s[ offset + idx ] = c
+  put( result, 0, name )
+  put( result, 100, "0000644\0" )
+  put( result, 108, "0000000\0" )
+  put( result, 116, "0000000\0" )
+  put( result, 124, toOct( size, 11 ) & "\0" )
+  put( result, 136, "00000000000\0" )
+  put( result, 148, "        " )
+  put( result, 156, "0" )
+  put( result, 257, "ustar\0" )
+  put( result, 263, "00" )
+  var checksum = 0
+  for c in result: checksum += ord( c )
+  put( result, 148, toOct( checksum, 6 ) & "\0 " )
+
+# collect path, data offset and size of regular files within tar
+proc tar_entries( tar: string ): seq[ tuple[ path: string, offset: int, size: int ] ] =
+  var position = 0
+  var long_name = ""
+  while position + 512 <= len( tar ):
+    let header = tar[ position ..< position + 512 ]
+    # end of archive
+    if '\0' == header[ 0 ]: break
+    let size = tar_octal( header, 124, 12 )
+    let type_flag = header[ 156 ]
+    var path = tar_field( header, 0, 100 )
+    let prefix = tar_field( header, 345, 155 )
+    if "" != prefix: path = prefix & "/" & path
+    if "" != long_name:
+      path = long_name
+      long_name = ""
+    # gnu long name applies to following entry
+    if 'L' == type_flag:
+      long_name = tar[ position + 512 ..< position + 512 + size ].split( '\0' )[ 0 ]
+    elif '0' == type_flag or '\0' == type_flag:
+      result.add( ( path, position + 512, size ) )
+    position += 512 + ( ( size + 511 ) div 512 ) * 512
+
+# prepend index of regular files to tar
+proc add_index( tar: string ): string =
+  let entries = tar_entries( tar )
+  var strings = ""
+  var paths: seq[ int ] = @[]
+  for entry in entries:
+    paths.add( len( strings ) )
+    strings &= entry.path & "\0"
+  let index_size = 16 + 16 * len( entries ) + len( strings )
+  # data moves behind index header and padded index
+  let shift = 512 + ( ( index_size + 511 ) div 512 ) * 512
+  var index = index_magic
+  index.add_u32( uint32( len( entries ) ) )
+  index.add_u32( uint32( len( strings ) ) )
+  for idx, entry in entries:
+    index.add_u32( fnv1a( entry.path ) )
+    index.add_u32( uint32( paths[ idx ] ) )
+    index.add_u32( uint32( entry.offset + shift ) )
+    index.add_u32( uint32( entry.size ) )
+  index &= strings
+  result = tar_header( index_name, len( index ) ) & index
+  result &= repeat( '\0', shift - len( result ) )
+  result &= tar
+
+# seekable ramdisk, has to match server/boot/ramdisk.h
+const block_magic: string = "BRDBLK01"
+const block_size: int = 65536
+
+# compress fixed size blocks independently, prefixed by block offset table
+proc compress_blocks( data: string ): string =
+  let block_count = ( len( data ) + block_size - 1 ) div block_size
+  var blocks: seq[ string ] = @[]
+  for i in 0 ..< block_count:
+    let start = i * block_size
+    let stop = min( start + block_size, len( data ) )
+    blocks.add( zippy.compress( data[ start ..< stop ], zippy.DefaultCompression, zippy.dfZlib ) )
+  result = block_magic
+  result.add_u32( uint32( block_size ) )
+  result.add_u32( uint32( block_count ) )
+  result.add_u32( uint32( len( data ) ) )
+  # offsets relative to image start with end offset as last entry
+  var offset = 20 + 4 * ( block_count + 1 )
+  for compressed in blocks:
+    result.add_u32( uint32( offset ) )
+    offset += len( compressed )
+  result.add_u32( uint32( offset ) )
+  for compressed in blocks:
+    result &= compressed
+
 #[
 # loop through files of folder including subfolders and adjust interpreter and run path for ramdisk
 for file in walkDirRec( joinPath( getCurrentDir(), "tmp", "ramdisk" ) ):
@@ -160,8 +271,15 @@ if existsDir( config ):
     copyFile( file, joinPath( base_path, path ) )
 
 # create ramdisk and remove normal directory
-echo execProcess( "tar czvf ../ramdisk.tar.gz * --owner=0 --group=0", "tmp/ramdisk" )
+echo execProcess( "tar cvf ../ramdisk.tar * --owner=0 --group=0", "tmp/ramdisk" )
 removeDir( "tmp/ramdisk" )
+# prepend file index and compress block wise
+let ramdisk_tar: string = joinPath( "tmp", "ramdisk.tar" )
+writeFile(
+  joinPath( "tmp", "ramdisk.tar.gz" ),
+  compress_blocks( add_index( readFile( ramdisk_tar ) ) )
+)
+removeFile( ramdisk_tar )
 # create initrd with init and compressed ramdisk and cleanup directory
 if output.isAbsolute:
   echo execProcess( "tar cvf " & output & " * --owner=0 --group=0", "tmp" )